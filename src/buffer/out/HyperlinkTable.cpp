@@ -0,0 +1,315 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "HyperlinkTable.hpp"
+
+#include <til/hash.h>
+
+size_t HyperlinkTable::size() const noexcept
+{
+    return _size;
+}
+
+bool HyperlinkTable::empty() const noexcept
+{
+    return _size == 0;
+}
+
+bool HyperlinkTable::Contains(const uint16_t id) const noexcept
+{
+    return id < _entries.size() && til::at(_entries, id).used;
+}
+
+// Returns the ID for the given hyperlink. Hyperlinks without a custom ID always get a new ID, while
+// hyperlinks with a custom ID share theirs with all previous ones with the same custom ID and URI.
+// Returns 0 if all IDs are in use, in which case the text should simply not be marked as a hyperlink.
+uint16_t HyperlinkTable::Intern(const std::wstring_view uri, const std::wstring_view customId)
+{
+    if (_arenaGarbage > 1024 && _arenaGarbage > _arena.size() / 2)
+    {
+        _compactArena();
+    }
+
+    if (customId.empty())
+    {
+        return _allocate(uri, {});
+    }
+
+    const auto key = _makeCustomIdKey(uri, customId);
+    if (const auto it = _customIds.find(key); it != _customIds.end())
+    {
+        return it->second;
+    }
+
+    const auto id = _allocate(uri, key);
+    if (id != 0)
+    {
+        try
+        {
+            _customIds.emplace(key, id);
+        }
+        catch (...)
+        {
+            Erase(id);
+            throw;
+        }
+    }
+    return id;
+}
+
+// Replaces the URI of an existing hyperlink. Does nothing if the ID isn't in use.
+void HyperlinkTable::SetUri(const uint16_t id, const std::wstring_view uri)
+{
+    if (!Contains(id) || GetUri(id) == uri)
+    {
+        return;
+    }
+
+    auto& entry = til::at(_entries, id);
+    const std::wstring customId{ GetCustomId(id) };
+    THROW_HR_IF(E_OUTOFMEMORY, _arena.size() + uri.size() + customId.size() >= UINT32_MAX);
+
+    const auto offset = _arena.size();
+    try
+    {
+        _arena.append(uri);
+        _arena.append(customId);
+    }
+    catch (...)
+    {
+        _arena.resize(offset);
+        throw;
+    }
+
+    _releaseText(entry);
+    entry.offset = gsl::narrow_cast<uint32_t>(offset);
+    entry.uriLength = gsl::narrow_cast<uint32_t>(uri.size());
+    entry.customIdLength = gsl::narrow_cast<uint32_t>(customId.size());
+}
+
+// Returns the URI of the given hyperlink or an empty string if the ID isn't in use.
+// The returned text stays valid until the next call to Intern() or SetUri().
+std::wstring_view HyperlinkTable::GetUri(const uint16_t id) const noexcept
+{
+    if (!Contains(id))
+    {
+        return {};
+    }
+    const auto& entry = til::at(_entries, id);
+    return { _arena.data() + entry.offset, entry.uriLength };
+}
+
+// Returns the custom ID of the given hyperlink (suffixed with the hash of its URI) or an empty string if it has none.
+std::wstring_view HyperlinkTable::GetCustomId(const uint16_t id) const noexcept
+{
+    if (!Contains(id))
+    {
+        return {};
+    }
+    const auto& entry = til::at(_entries, id);
+    return { _arena.data() + entry.offset + entry.uriLength, entry.customIdLength };
+}
+
+uint32_t HyperlinkTable::GetRefCount(const uint16_t id) const noexcept
+{
+    return Contains(id) ? til::at(_entries, id).refs : 0;
+}
+
+// Increments the reference count of the given ID. IDs that aren't in use are ignored.
+void HyperlinkTable::AddRef(const uint16_t id) noexcept
+{
+    if (Contains(id))
+    {
+        til::at(_entries, id).refs++;
+    }
+}
+
+// Decrements the reference count of the given ID and returns true if it dropped to 0.
+// The ID isn't erased, because the caller usually adds a reference again shortly after.
+bool HyperlinkTable::Release(const uint16_t id) noexcept
+{
+    if (!Contains(id))
+    {
+        return false;
+    }
+    auto& refs = til::at(_entries, id).refs;
+    assert(refs != 0);
+    if (refs != 0)
+    {
+        --refs;
+    }
+    return refs == 0;
+}
+
+// Sets the reference count of all IDs to 0, for callers that are about to recount all references.
+void HyperlinkTable::ClearRefs() noexcept
+{
+    for (auto& entry : _entries)
+    {
+        entry.refs = 0;
+    }
+}
+
+// Removes the given hyperlink and appends its ID to the free list.
+void HyperlinkTable::Erase(const uint16_t id) noexcept
+{
+    if (!Contains(id))
+    {
+        return;
+    }
+
+    if (const auto customId = GetCustomId(id); !customId.empty())
+    {
+        if (const auto it = _customIds.find(customId); it != _customIds.end() && it->second == id)
+        {
+            _customIds.erase(it);
+        }
+    }
+
+    auto& entry = til::at(_entries, id);
+    _releaseText(entry);
+    entry = {};
+
+    if (_freeTail == EndOfList)
+    {
+        _freeHead = id;
+    }
+    else
+    {
+        til::at(_entries, _freeTail).nextFree = id;
+    }
+    _freeTail = id;
+    ++_freeCount;
+    --_size;
+}
+
+// Removes all hyperlinks with a reference count of 0, except for the given one.
+void HyperlinkTable::EraseUnreferenced(const uint16_t keep) noexcept
+{
+    for (size_t id = 1; id < _entries.size(); ++id)
+    {
+        const auto& entry = til::at(_entries, id);
+        if (entry.used && entry.refs == 0 && id != keep)
+        {
+            Erase(gsl::narrow_cast<uint16_t>(id));
+        }
+    }
+}
+
+void HyperlinkTable::Clear() noexcept
+{
+    _entries.clear();
+    _freeHead = EndOfList;
+    _freeTail = EndOfList;
+    _freeCount = 0;
+    _size = 0;
+    _arena.clear();
+    _arenaGarbage = 0;
+    _customIds.clear();
+}
+
+size_t HyperlinkTable::CustomIdHash::operator()(const std::wstring_view key) const noexcept
+{
+    return til::hash(key);
+}
+
+std::wstring HyperlinkTable::_makeCustomIdKey(const std::wstring_view uri, const std::wstring_view customId)
+{
+    // hash the URL and add it to the custom ID - GH#7698
+    std::wstring key{ customId };
+    key += L"%" + std::to_wstring(til::hash(uri));
+    return key;
+}
+
+// Stores the given text under an unused ID. Erased IDs are reused, the one that has been unused the longest first,
+// once more than ReuseDelay of them accumulated or once we ran out of new ones.
+uint16_t HyperlinkTable::_allocate(const std::wstring_view uri, const std::wstring_view customId)
+{
+    const auto exhausted = _entries.size() > MaxSize;
+    if (_freeHead == EndOfList && exhausted)
+    {
+        return 0;
+    }
+
+    THROW_HR_IF(E_OUTOFMEMORY, _arena.size() + uri.size() + customId.size() >= UINT32_MAX);
+
+    if (_entries.empty())
+    {
+        // ID 0 means "no hyperlink" and is never handed out.
+        _entries.emplace_back();
+    }
+
+    uint16_t id;
+    if (_freeHead != EndOfList && (_freeCount > ReuseDelay || exhausted))
+    {
+        id = _freeHead;
+    }
+    else
+    {
+        id = gsl::narrow_cast<uint16_t>(_entries.size());
+        _entries.emplace_back();
+    }
+
+    const auto offset = _arena.size();
+    try
+    {
+        _arena.append(uri);
+        _arena.append(customId);
+    }
+    catch (...)
+    {
+        _arena.resize(offset);
+        if (id != _freeHead)
+        {
+            _entries.pop_back();
+        }
+        throw;
+    }
+
+    auto& entry = til::at(_entries, id);
+    if (id == _freeHead)
+    {
+        _freeHead = entry.nextFree;
+        if (_freeHead == EndOfList)
+        {
+            _freeTail = EndOfList;
+        }
+        --_freeCount;
+    }
+
+    entry.offset = gsl::narrow_cast<uint32_t>(offset);
+    entry.uriLength = gsl::narrow_cast<uint32_t>(uri.size());
+    entry.customIdLength = gsl::narrow_cast<uint32_t>(customId.size());
+    entry.refs = 0;
+    entry.nextFree = EndOfList;
+    entry.used = true;
+    ++_size;
+    return id;
+}
+
+void HyperlinkTable::_releaseText(Entry& entry) noexcept
+{
+    _arenaGarbage += entry.uriLength + entry.customIdLength;
+}
+
+// Copies the text of all used IDs into a new arena, dropping the text of erased ones.
+void HyperlinkTable::_compactArena()
+{
+    std::wstring arena;
+    arena.reserve(_arena.size() - _arenaGarbage);
+
+    // With the capacity reserved, nothing below can throw and leave the offsets half updated.
+    for (auto& entry : _entries)
+    {
+        if (entry.used)
+        {
+            const auto offset = arena.size();
+            arena.append(_arena, entry.offset, entry.uriLength + entry.customIdLength);
+            entry.offset = gsl::narrow_cast<uint32_t>(offset);
+        }
+    }
+
+    _arena = std::move(arena);
+    _arenaGarbage = 0;
+}
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+// Maps the hyperlink IDs stored in TextAttributes to their URIs and optional custom IDs (OSC 8 "id=" parameter).
+// All strings are stored in a shared arena and each ID holds a count of the attribute runs that refer to it,
+// which TextBuffer maintains as rows are modified. This allows it to drop hyperlinks once they scroll out of
+// the buffer without having to search the remaining rows for other references.
+// Unused IDs are recycled, oldest first, so that long-running sessions don't run out of the 16-bit ID space.
+class HyperlinkTable
+{
+public:
+    // 0 is the ID of "no hyperlink" and so it's never handed out.
+    static constexpr size_t MaxSize = 0xffff;
+    // Erased IDs are only handed out again once more than this many IDs are unused (or all other IDs are in use).
+    // Not every holder of an ID holds a reference to it, like ControlCore's last hovered hyperlink,
+    // and those must not see their ID resolve to an unrelated URI right after the buffer pruned it.
+    static constexpr size_t ReuseDelay = 1024;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+    bool Contains(uint16_t id) const noexcept;
+
+    uint16_t Intern(std::wstring_view uri, std::wstring_view customId);
+    void SetUri(uint16_t id, std::wstring_view uri);
+    std::wstring_view GetUri(uint16_t id) const noexcept;
+    std::wstring_view GetCustomId(uint16_t id) const noexcept;
+
+    uint32_t GetRefCount(uint16_t id) const noexcept;
+    void AddRef(uint16_t id) noexcept;
+    bool Release(uint16_t id) noexcept;
+    void ClearRefs() noexcept;
+
+    void Erase(uint16_t id) noexcept;
+    void EraseUnreferenced(uint16_t keep) noexcept;
+    void Clear() noexcept;
+
+private:
+    // Marks the end of the free list. It's also the ID of "no hyperlink" and so it can't be a valid ID.
+    static constexpr uint16_t EndOfList = 0;
+
+    struct Entry
+    {
+        // The URI is stored at offset in _arena, immediately followed by the custom ID (if any).
+        uint32_t offset = 0;
+        uint32_t uriLength = 0;
+        uint32_t customIdLength = 0;
+        // The number of attribute runs in the TextBuffer that refer to this ID.
+        uint32_t refs = 0;
+        // The next ID in the free list, if this ID is unused.
+        uint16_t nextFree = EndOfList;
+        bool used = false;
+    };
+
+    static std::wstring _makeCustomIdKey(std::wstring_view uri, std::wstring_view customId);
+    uint16_t _allocate(std::wstring_view uri, std::wstring_view customId);
+    void _releaseText(Entry& entry) noexcept;
+    void _compactArena();
+
+    // _entries[id] describes the hyperlink with the given ID. _entries[0] is unused.
+    std::vector<Entry> _entries;
+    // Unused IDs form a FIFO queue, so that a recently erased ID isn't immediately handed out again.
+    uint16_t _freeHead = EndOfList;
+    uint16_t _freeTail = EndOfList;
+    // The length of the free list.
+    size_t _freeCount = 0;
+    size_t _size = 0;
+    std::wstring _arena;
+    // The number of characters in _arena that belong to erased entries.
+    size_t _arenaGarbage = 0;
+
+    struct CustomIdHash
+    {
+        using is_transparent = void;
+        size_t operator()(const std::wstring_view key) const noexcept;
+    };
+
+    // Maps from custom IDs (suffixed with the hash of their URI, see GH#7698) to their numeric ID.
+    // The hash is transparent, which allows Erase() to look up the custom IDs stored in _arena without copying them.
+    std::unordered_map<std::wstring, uint16_t, CustomIdHash, std::equal_to<>> _customIds;
+};
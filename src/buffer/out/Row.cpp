@@ -4,11 +4,14 @@
 #include "precomp.h"
 #include "Row.hpp"
 
+#include <bit>
 #include <isa_availability.h>
 #include <til/unicode.h>
 
 #include "textBuffer.hpp"
+#include "WordIndex.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/GraphemeBreak.hpp"
 
 // It would be nice to add checked array access in the future, but it's a little annoying to do so without impacting
 // performance (including Debug performance). Other languages are a little bit more ergonomic there than C++.
@@ -18,6 +21,8 @@
 
 extern "C" int __isa_available;
 
+using namespace Microsoft::Console;
+
 constexpr auto clamp(auto value, auto lo, auto hi)
 {
     return value < lo ? lo : (value > hi ? hi : value);
@@ -82,6 +87,82 @@ constexpr OutIt copy_n_small(InIt first, Diff count, OutIt dest)
     return dest;
 }
 
+// Returns the offset of the first character in [chars, chars + count) that isn't whitespace, or count if there's none.
+static size_t findFirstNonSpace(const wchar_t* chars, const size_t count) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    size_t i = 0;
+
+#if defined(TIL_SSE_INTRINSICS)
+    const auto whitespace = _mm_set1_epi16(L' ');
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+        // Each wchar_t maps to 2 bits in the mask, which are set if it's NOT whitespace.
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(vec, whitespace))) ^ 0xffff;
+        if (mask)
+        {
+            return i + std::countr_zero(mask) / 2;
+        }
+    }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    const auto whitespace = vdupq_n_u16(L' ');
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto vec = vld1q_u16(reinterpret_cast<const uint16_t*>(chars + i));
+        // Narrowing the comparison result turns each wchar_t into 8 bits of a 64-bit mask.
+        const auto mask = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vceqq_u16(vec, whitespace), 4)), 0);
+        if (mask)
+        {
+            return i + std::countr_zero(mask) / 8;
+        }
+    }
+#endif
+
+    for (; i != count && chars[i] == L' '; ++i)
+    {
+    }
+    return i;
+#pragma warning(pop)
+}
+
+// Returns the offset one past the last character in [chars, chars + count) that isn't whitespace, or 0 if there's none.
+static size_t findLastNonSpace(const wchar_t* chars, size_t count) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+#if defined(TIL_SSE_INTRINSICS)
+    const auto whitespace = _mm_set1_epi16(L' ');
+    for (; count >= 8; count -= 8)
+    {
+        const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + count - 8));
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(vec, whitespace))) ^ 0xffff;
+        if (mask)
+        {
+            return count - 8 + (31 - std::countl_zero(mask)) / 2 + 1;
+        }
+    }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    const auto whitespace = vdupq_n_u16(L' ');
+    for (; count >= 8; count -= 8)
+    {
+        const auto vec = vld1q_u16(reinterpret_cast<const uint16_t*>(chars + count - 8));
+        const auto mask = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vceqq_u16(vec, whitespace), 4)), 0);
+        if (mask)
+        {
+            return count - 8 + (63 - std::countl_zero(mask)) / 8 + 1;
+        }
+    }
+#endif
+
+    for (; count != 0 && chars[count - 1] == L' '; --count)
+    {
+    }
+    return count;
+#pragma warning(pop)
+}
+
 CharToColumnMapper::CharToColumnMapper(const wchar_t* chars, const uint16_t* charOffsets, ptrdiff_t lastCharOffset, til::CoordType currentColumn) noexcept :
     _chars{ chars },
     _charOffsets{ charOffsets },
@@ -158,19 +239,44 @@ til::CoordType CharToColumnMapper::GetTrailingColumnAt(const wchar_t* str) noexc
 // - constructor
 // Arguments:
 // - rowWidth - the width of the row, cell elements
-// - fillAttribute - the default text attribute
+// - attrTable - the table of the TextBuffer this row belongs to
+// - fillAttribute - the ID of the default text attribute in attrTable
 // Return Value:
 // - constructed object
-ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute) :
+ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, TextAttributeTable& attrTable, TextAttributeId fillAttribute) :
     _charsBuffer{ charsBuffer },
     _chars{ charsBuffer, rowWidth },
     _charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(rowWidth) + 1u },
+    _attrTable{ &attrTable },
     _attr{ rowWidth, fillAttribute },
     _columnCount{ rowWidth }
 {
     _init();
 }
 
+// Creates a copy of `other` for TextBuffer::Snapshot(), which has already block-copied the contents of other's
+// _charsBuffer and _charOffsets into the given buffers. attrTable must be a copy of other's table, because
+// the attribute IDs are taken over as is. Only text that spilled onto the heap needs to be copied here.
+ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, TextAttributeTable& attrTable, const ROW& other) :
+    _charsBuffer{ charsBuffer },
+    _chars{ charsBuffer, other._chars.size() },
+    _charOffsets{ charOffsetsBuffer, other._charOffsets.size() },
+    _attrTable{ &attrTable },
+    _attr{ other._attr },
+    _columnCount{ other._columnCount },
+    _textExtent{ other._textExtent },
+    _lineRendition{ other._lineRendition },
+    _wrapForced{ other._wrapForced },
+    _doubleBytePadded{ other._doubleBytePadded }
+{
+    if (other._charsHeap)
+    {
+        _charsHeap = std::make_unique_for_overwrite<wchar_t[]>(other._chars.size());
+        std::copy_n(other._chars.begin(), other._charSize(), _charsHeap.get());
+        _chars = { _charsHeap.get(), other._chars.size() };
+    }
+}
+
 void ROW::SetWrapForced(const bool wrap) noexcept
 {
     _wrapForced = wrap;
@@ -218,9 +324,22 @@ til::CoordType ROW::GetReadableColumnCount() const noexcept
 // - Sets all properties of the ROW to default values
 // Arguments:
 // - Attr - The default attribute (color) to fill
+//   If it can't be interned because we're out of memory, the buffer's initial attributes are used instead.
 // Return Value:
 // - <none>
 void ROW::Reset(const TextAttribute& attr) noexcept
+{
+    TextAttributeId id = 0;
+    try
+    {
+        id = _attrTable->Intern(attr);
+    }
+    CATCH_LOG();
+    Reset(id);
+}
+
+// Same as Reset(const TextAttribute&), but with an ID from the TextBuffer's TextAttributeTable.
+void ROW::Reset(const TextAttributeId attr) noexcept
 {
     _charsHeap.reset();
     _chars = { _charsBuffer, _columnCount };
@@ -235,6 +354,8 @@ void ROW::Reset(const TextAttribute& attr) noexcept
 
 void ROW::_init() noexcept
 {
+    _textExtent = 0;
+
 #pragma warning(push)
 #pragma warning(disable : 26462) // The value pointed to by '...' is assigned only once, mark it as a pointer to const (con.4).
 #pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
@@ -348,10 +469,24 @@ void ROW::_init() noexcept
 #pragma warning(push)
 }
 
-void ROW::TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth)
+// Copies the attributes of source starting at sourceColumnBegin into this row starting at columnBegin.
+// The last copied attribute is extended or truncated to fit the width of this row.
+void ROW::CopyAttributesFrom(const ROW& source, const til::CoordType sourceColumnBegin, const til::CoordType columnBegin)
 {
-    _attr = attr;
-    _attr.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
+    auto attributes = source._attr.slice(_clampedUint16(sourceColumnBegin), source._attr.size());
+
+    // IDs are only meaningful within the table they came from. Both tables map
+    // distinct IDs to distinct attributes, so adjacent runs stay distinct.
+    if (source._attrTable != _attrTable)
+    {
+        for (auto& run : attributes.runs())
+        {
+            run.value = _attrTable->Intern(source._attrTable->Get(run.value));
+        }
+    }
+
+    _attr.replace(_clampedUint16(columnBegin), _attr.size(), attributes);
+    _attr.resize_trailing_extent(_columnCount);
 }
 
 void ROW::CopyFrom(const ROW& source)
@@ -365,7 +500,7 @@ void ROW::CopyFrom(const ROW& source)
     };
     CopyTextFrom(state);
 
-    TransferAttributes(source.Attributes(), _columnCount);
+    CopyAttributesFrom(source);
 }
 
 // Returns the previous possible cursor position, preceding the given column.
@@ -433,6 +568,9 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     // If we're given a right-side column limit, use it. Otherwise, the write limit is the final column index available in the char row.
     const auto finalColumnInRow = limitRight.value_or(size() - 1);
 
+    // The attributes are collected and applied in a single pass at the end,
+    // because output that changes colors every few cells is common.
+    til::small_vector<TextAttributeRle::edit_type, 16> attrEdits;
     auto currentColor = it->TextAttr();
     uint16_t colorUses = 0;
     auto colorStarts = gsl::narrow_cast<uint16_t>(columnBegin);
@@ -452,8 +590,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
             else
             {
                 // Otherwise, commit this color into the run and save off the new one.
-                // Now commit the new color runs into the attr row.
-                _attr.replace(colorStarts, currentIndex, currentColor);
+                attrEdits.push_back({ colorStarts, currentIndex, _attrTable->Intern(currentColor) });
                 currentColor = it->TextAttr();
                 colorUses = 1;
                 colorStarts = currentIndex;
@@ -530,23 +667,24 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
         ++currentIndex;
     }
 
-    // Now commit the final color into the attr row
+    // Now commit the final color and then all color runs into the attr row
     if (colorUses)
     {
-        _attr.replace(colorStarts, currentIndex, currentColor);
+        attrEdits.push_back({ colorStarts, currentIndex, _attrTable->Intern(currentColor) });
     }
+    _attr.replace_sorted({ attrEdits.data(), attrEdits.size() });
 
     return it;
 }
 
 void ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
-    _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
+    _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), _attrTable->Intern(attr));
 }
 
 void ROW::ReplaceAttributes(const til::CoordType beginIndex, const til::CoordType endIndex, const TextAttribute& newAttr)
 {
-    _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), newAttr);
+    _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), _attrTable->Intern(newAttr));
 }
 
 [[msvc::forceinline]] ROW::WriteHelper::WriteHelper(ROW& row, til::CoordType columnBegin, til::CoordType columnLimit, const std::wstring_view& chars) noexcept :
@@ -650,55 +788,74 @@ catch (...)
     const auto end = it + std::min<size_t>(chars.size(), colLimit - colBeg);
     size_t ch = chBeg;
 
-    while (it != end)
+    while (it != end && *it < 0x80)
     {
-        if (*it >= 0x80) [[unlikely]]
-        {
-            _replaceTextUnicode(ch, it);
-            return;
-        }
-
         til::at(row._charOffsets, colEnd) = gsl::narrow_cast<uint16_t>(ch);
         ++colEnd;
         ++ch;
         ++it;
     }
 
+    if (it != chars.end() && *it >= 0x80) [[unlikely]]
+    {
+        // The last ASCII character may be the base of a grapheme cluster, like "e" followed by U+0301.
+        // We need to hand it over to the slow-path so that it can be measured as a whole.
+        if (it != chars.begin())
+        {
+            --it;
+            --ch;
+            --colEnd;
+        }
+        _replaceTextUnicode(ch, it);
+        return;
+    }
+
     colEndDirty = colEnd;
     charsConsumed = ch - chBeg;
 }
 
 [[msvc::forceinline]] void ROW::WriteHelper::_replaceTextUnicode(size_t ch, std::wstring_view::const_iterator it) noexcept
 {
-    const auto end = chars.end();
+    const auto size = chars.size();
+    auto pos = gsl::narrow_cast<size_t>(it - chars.begin());
+    size_t trivialEnd = 0;
+    // Limiting each column to this many code units keeps even a row full of such clusters below CharOffsetsMask.
+    const auto maxClusterLength = std::clamp<size_t>(CharOffsetsMask / row._columnCount, 2, MaxClusterLength);
 
-    while (it != end)
+    while (pos < size)
     {
         unsigned int width = 1;
-        auto ptr = &*it;
-        const auto wch = *ptr;
-        size_t advance = 1;
+        size_t next;
 
-        ++it;
+        // Most code units form a grapheme cluster of their own. SkipTrivial() finds them in bulk,
+        // so that we only need to run the full UAX #29 segmentation for the remaining ones.
+        if (pos >= trivialEnd)
+        {
+            trivialEnd = GraphemeBreak::SkipTrivial(chars, pos);
+        }
 
-        // Even in our slow-path we can avoid calling IsGlyphFullWidth if the current character is ASCII.
-        // It also allows us to skip the surrogate pair decoding at the same time.
-        if (wch >= 0x80)
+        if (pos < trivialEnd)
         {
-            if (til::is_surrogate(wch))
+            const auto wch = til::at(chars, pos);
+            next = pos + 1;
+
+            // Even in our slow-path we can avoid calling IsGlyphFullWidth if the current character is ASCII.
+            if (wch >= 0x80)
             {
-                if (it != end && til::is_leading_surrogate(wch) && til::is_trailing_surrogate(*it))
-                {
-                    advance = 2;
-                    ++it;
-                }
-                else
-                {
-                    ptr = &UNICODE_REPLACEMENT;
-                }
+                width += IsGlyphFullWidth(wch);
             }
+        }
+        else
+        {
+            next = GraphemeBreak::NextBounded(chars, pos, maxClusterLength);
 
-            width = IsGlyphFullWidth({ ptr, advance }) + 1u;
+            auto glyph = chars.substr(pos, next - pos);
+            if (glyph.size() == 1 && til::is_surrogate(glyph.front()))
+            {
+                glyph = { &UNICODE_REPLACEMENT, 1 };
+            }
+
+            width += IsGlyphFullWidth(glyph);
         }
 
         const auto colEndNew = gsl::narrow_cast<uint16_t>(colEnd + width);
@@ -719,13 +876,68 @@ catch (...)
             til::at(row._charOffsets, colEnd++) = gsl::narrow_cast<uint16_t>(ch | CharOffsetsTrailer);
         }
 
-        ch += advance;
+        ch += next - pos;
+        pos = next;
     }
 
     colEndDirty = colEnd;
     charsConsumed = ch - chBeg;
 }
 
+// Writes 1 character per column, each 1 column wide, along with the given legacy attributes.
+// This is the bulk equivalent of calling WriteCells() with CHAR_INFOs that have no DBCS flags set
+// and is used to implement WriteConsoleOutput. `chars` and `attributes` must be of equal length.
+void ROW::ReplaceLegacyCells(const til::CoordType columnBegin, const std::wstring_view& chars, const std::span<const WORD> attributes)
+try
+{
+    WriteHelper h{ *this, columnBegin, _columnCount, chars };
+    if (!h.IsValid())
+    {
+        return;
+    }
+    h.ReplaceSingleWidthText();
+    h.Finish();
+
+    // Splice the attributes into _attr in one go, instead of calling replace() for every run.
+    til::small_vector<TextAttributeRle::rle_type, 16> runs;
+    auto it = attributes.begin();
+    const auto end = it + std::min<size_t>(attributes.size(), h.charsConsumed);
+    while (it != end)
+    {
+        const auto attr = *it;
+        const auto beg = it;
+        for (++it; it != end && *it == attr; ++it)
+        {
+        }
+
+        const auto id = _attrTable->Intern(TextAttribute{ attr });
+        const auto length = gsl::narrow_cast<uint16_t>(it - beg);
+        if (!runs.empty() && runs.back().value == id)
+        {
+            runs.back().length += length;
+        }
+        else
+        {
+            runs.emplace_back(id, length);
+        }
+    }
+    _attr.replace(h.colBeg, h.colEnd, std::span<const TextAttributeRle::rle_type>{ runs.data(), runs.size() });
+}
+catch (...)
+{
+    Reset(TextAttribute{});
+    throw;
+}
+
+[[msvc::forceinline]] void ROW::WriteHelper::ReplaceSingleWidthText() noexcept
+{
+    const auto count = gsl::narrow_cast<uint16_t>(std::min<size_t>(chars.size(), colLimit - colBeg));
+    iota_n(row._charOffsets.begin() + colBeg, count, chBeg);
+    colEnd = gsl::narrow_cast<uint16_t>(colBeg + count);
+    colEndDirty = colEnd;
+    charsConsumed = count;
+}
+
 void ROW::CopyTextFrom(RowCopyTextFromState& state)
 try
 {
@@ -867,6 +1079,22 @@ catch (...)
     {
         row.SetDoubleBytePadded(colEnd < row._columnCount);
     }
+
+    // Update `_textExtent` without rescanning the row, unless the last text in it was just overwritten with whitespace.
+    // The dirty range [chBegDirty, chEndDirty) contains nothing but the written text and whitespace padding.
+    if (row._textExtent > chEndDirtyOld)
+    {
+        // There's text past the dirty range, which has been shifted by the change in the range's length.
+        row._textExtent = gsl::narrow_cast<uint16_t>(row._textExtent - chEndDirtyOld + chEndDirty);
+    }
+    else if (const auto written = findLastNonSpace(row._chars.data() + chBeg, charsConsumed))
+    {
+        row._textExtent = gsl::narrow_cast<uint16_t>(chBeg + written);
+    }
+    else if (row._textExtent > chBegDirty)
+    {
+        row._textExtent = gsl::narrow_cast<uint16_t>(findLastNonSpace(row._chars.data(), chBegDirty));
+    }
 }
 
 // This function represents the slow path of ReplaceCharacters(),
@@ -879,6 +1107,10 @@ void ROW::_resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDi
     const auto currentLength = _charSize();
     const auto newLength = currentLength + diff;
 
+    // Offsets past CharOffsetsMask would collide with the CharOffsetsTrailer bit. MaxClusterLength keeps text written
+    // via ReplaceText() below that, but this protects the row against getting corrupted through any other way.
+    THROW_HR_IF(E_OUTOFMEMORY, newLength > CharOffsetsMask);
+
     if (newLength <= _chars.size())
     {
         std::copy_n(_chars.begin() + chEndDirtyOld, currentLength - chEndDirtyOld, _chars.begin() + chEndDirty);
@@ -906,32 +1138,25 @@ void ROW::_resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDi
     }
 }
 
-til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() noexcept
+TextAttributeRle& ROW::Attributes() noexcept
 {
     return _attr;
 }
 
-const til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() const noexcept
+const TextAttributeRle& ROW::Attributes() const noexcept
 {
     return _attr;
 }
 
-TextAttribute ROW::GetAttrByColumn(const til::CoordType column) const
+// Returns the table that maps the IDs in Attributes() to TextAttributes.
+const TextAttributeTable& ROW::AttributeTable() const noexcept
 {
-    return _attr.at(_clampedUint16(column));
+    return *_attrTable;
 }
 
-std::vector<uint16_t> ROW::GetHyperlinks() const
+TextAttribute ROW::GetAttrByColumn(const til::CoordType column) const
 {
-    std::vector<uint16_t> ids;
-    for (const auto& run : _attr.runs())
-    {
-        if (run.value.IsHyperlink())
-        {
-            ids.emplace_back(run.value.GetHyperlinkId());
-        }
-    }
-    return ids;
+    return _attrTable->Get(_attr.at(_clampedUint16(column)));
 }
 
 uint16_t ROW::size() const noexcept
@@ -944,43 +1169,19 @@ uint16_t ROW::size() const noexcept
 til::CoordType ROW::GetLastNonSpaceColumn() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = end;
-
-    for (; it != beg; --it)
-    {
-        // it[-1] is safe as `it` is always greater than `beg` (loop invariant).
-        if (til::at(it, -1) != L' ')
-        {
-            break;
-        }
-    }
 
     // We're supposed to return the measurement in cells and not characters
-    // and therefore simply calculating `it - beg` would be wrong.
+    // and therefore simply returning the extent of the text would be wrong.
     //
-    // An example: The row is 10 cells wide and `it` points to the second character.
-    // `it - beg` would return 1, but it's possible it's actually 1 wide glyph and 8 whitespace.
-    return gsl::narrow_cast<til::CoordType>(GetReadableColumnCount() - (end - it));
+    // An example: The row is 10 cells wide and the text ends after the first character.
+    // Returning 1 would be right, but it's possible it's actually 1 wide glyph and 8 whitespace.
+    return gsl::narrow_cast<til::CoordType>(GetReadableColumnCount() - (text.size() - _getTextExtent()));
 }
 
 til::CoordType ROW::MeasureLeft() const noexcept
 {
     const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = beg;
-
-    for (; it != end; ++it)
-    {
-        if (*it != L' ')
-        {
-            break;
-        }
-    }
-
-    return gsl::narrow_cast<til::CoordType>(it - beg);
+    return gsl::narrow_cast<til::CoordType>(findFirstNonSpace(text.data(), text.size()));
 }
 
 // Routine Description:
@@ -1002,20 +1203,63 @@ til::CoordType ROW::MeasureRight() const noexcept
 
 bool ROW::ContainsText() const noexcept
 {
-    const auto text = GetText();
-    const auto beg = text.begin();
-    const auto end = text.end();
-    auto it = beg;
+    return _getTextExtent() != 0;
+}
 
-    for (; it != end; ++it)
+// Returns true if both rows have the same text, attributes and line rendition and would thus look identical.
+// The other row may belong to a different TextBuffer.
+bool ROW::IsContentEqual(const ROW& other) const noexcept
+{
+    if (_columnCount != other._columnCount ||
+        _lineRendition != other._lineRendition ||
+        GetText() != other.GetText() ||
+        !std::equal(_charOffsets.begin(), _charOffsets.end(), other._charOffsets.begin(), other._charOffsets.end()))
     {
-        if (*it != L' ')
+        return false;
+    }
+
+    const auto& runs = _attr.runs();
+    const auto& otherRuns = other._attr.runs();
+    if (runs.size() != otherRuns.size())
+    {
+        return false;
+    }
+
+    const auto sameTable = _attrTable == other._attrTable;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const auto& run = til::at(runs, i);
+        const auto& otherRun = til::at(otherRuns, i);
+        if (run.length != otherRun.length)
         {
-            return true;
+            return false;
+        }
+        if (sameTable ? run.value != otherRun.value : _attrTable->Get(run.value) != other._attrTable->Get(otherRun.value))
+        {
+            return false;
         }
     }
 
-    return false;
+    return true;
+}
+
+// Returns true if each column in [columnBegin, columnEnd) holds exactly 1 character that's 1 column wide.
+// In that case GetText(columnBegin, columnEnd) returns exactly 1 character per column.
+bool ROW::IsSingleWidth(const til::CoordType columnBegin, const til::CoordType columnEnd) const noexcept
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = std::max(colBeg, _clampedColumnInclusive(columnEnd));
+    const auto base = _uncheckedCharOffset(colBeg);
+    // Column colBeg must not be a trailer and each following offset (including the one at colEnd)
+    // must be exactly 1 larger than the previous one. A wide glyph breaks that sequence, because its
+    // trailing columns repeat the offset with the CharOffsetsTrailer bit set, and so does any glyph
+    // that consists of more than 1 character. All tested compilers vectorize this loop.
+    uint32_t mismatch = til::at(_charOffsets, colBeg) & CharOffsetsTrailer;
+    for (uint32_t col = colBeg + 1u, expected = base + 1u; col <= colEnd; ++col, ++expected)
+    {
+        mismatch |= til::at(_charOffsets, col) ^ expected;
+    }
+    return mismatch == 0;
 }
 
 std::wstring_view ROW::GlyphAt(til::CoordType column) const noexcept
@@ -1101,6 +1345,27 @@ DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_v
     }
 }
 
+// Sets bit x of regular or control if column x contains a RegularChar or ControlChar respectively (see DelimiterClassAt()).
+// Both spans must hold one bit per column and are expected to be zeroed by the caller.
+void ROW::ClassifyDelimiters(const DelimiterTable& table, const std::span<uint64_t> regular, const std::span<uint64_t> control) const noexcept
+{
+    for (uint16_t col = 0; col < _columnCount; ++col)
+    {
+        const auto bit = uint64_t{ 1 } << (col % 64);
+        switch (table.Classify(_uncheckedChar(_uncheckedCharOffset(col))))
+        {
+        case DelimiterClass::RegularChar:
+            regular[col / 64] |= bit;
+            break;
+        case DelimiterClass::ControlChar:
+            control[col / 64] |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 template<typename T>
 constexpr uint16_t ROW::_clampedUint16(T v) noexcept
 {
@@ -1125,6 +1390,19 @@ uint16_t ROW::_charSize() const noexcept
     return _charOffsets[_columnCount];
 }
 
+// Returns the offset one past the last character in GetText() that isn't whitespace.
+size_t ROW::_getTextExtent() const noexcept
+{
+    const auto text = GetText();
+    if (_textExtent <= text.size()) [[likely]]
+    {
+        return _textExtent;
+    }
+    // GetText() excludes the last column if it's marked as padding. If it
+    // nevertheless contains text, _textExtent doesn't apply to GetText().
+    return findLastNonSpace(text.data(), text.size());
+}
+
 // Safety: off must be [0, _charSize()].
 template<typename T>
 wchar_t ROW::_uncheckedChar(T off) const noexcept
@@ -8,7 +8,9 @@
 #include "LineRendition.hpp"
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
+#include "TextAttributeTable.hpp"
 
+class DelimiterTable;
 class ROW;
 class TextBuffer;
 
@@ -90,6 +92,11 @@ private:
 class ROW final
 {
 public:
+    // The maximum number of code units in a single grapheme cluster. UAX #29 allows clusters of any length
+    // (for instance "e" followed by thousands of U+0301), but _charOffsets can only address CharOffsetsMask
+    // characters per row. Any excess forms clusters of its own, as if it had been written separately.
+    static constexpr size_t MaxClusterLength = 32;
+
     // The implicit agreement between ROW and TextBuffer is that the `charsBuffer` and `charOffsetsBuffer`
     // arrays have a minimum alignment of 16 Bytes and a size of `rowWidth+1`. The former is used to
     // implement Reset() efficiently via SIMD and the latter is used to store the past-the-end offset
@@ -114,7 +121,8 @@ public:
     }
 
     ROW() = default;
-    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute);
+    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, TextAttributeTable& attrTable, TextAttributeId fillAttribute);
+    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, TextAttributeTable& attrTable, const ROW& other);
 
     ROW(const ROW& other) = delete;
     ROW& operator=(const ROW& other) = delete;
@@ -131,7 +139,8 @@ public:
     til::CoordType GetReadableColumnCount() const noexcept;
 
     void Reset(const TextAttribute& attr) noexcept;
-    void TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth);
+    void Reset(TextAttributeId attr) noexcept;
+    void CopyAttributesFrom(const ROW& source, til::CoordType sourceColumnBegin = 0, til::CoordType columnBegin = 0);
     void CopyFrom(const ROW& source);
 
     til::CoordType NavigateToPrevious(til::CoordType column) const noexcept;
@@ -143,19 +152,24 @@ public:
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
     void SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
+    template<typename Func>
+    void TransformAttributes(til::CoordType columnBegin, til::CoordType columnEnd, Func&& func);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
     void ReplaceText(RowWriteState& state);
+    void ReplaceLegacyCells(til::CoordType columnBegin, const std::wstring_view& chars, std::span<const WORD> attributes);
     void CopyTextFrom(RowCopyTextFromState& state);
 
-    til::small_rle<TextAttribute, uint16_t, 1>& Attributes() noexcept;
-    const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
+    TextAttributeRle& Attributes() noexcept;
+    const TextAttributeRle& Attributes() const noexcept;
+    const TextAttributeTable& AttributeTable() const noexcept;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
-    std::vector<uint16_t> GetHyperlinks() const;
     uint16_t size() const noexcept;
     til::CoordType GetLastNonSpaceColumn() const noexcept;
     til::CoordType MeasureLeft() const noexcept;
     til::CoordType MeasureRight() const noexcept;
     bool ContainsText() const noexcept;
+    bool IsContentEqual(const ROW& other) const noexcept;
+    bool IsSingleWidth(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept;
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
@@ -163,9 +177,10 @@ public:
     til::CoordType GetLeadingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     til::CoordType GetTrailingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
+    void ClassifyDelimiters(const DelimiterTable& table, std::span<uint64_t> regular, std::span<uint64_t> control) const noexcept;
 
-    auto AttrBegin() const noexcept { return _attr.begin(); }
-    auto AttrEnd() const noexcept { return _attr.end(); }
+    TextAttributeIterator AttrBegin() const noexcept { return { _attrTable, _attr.begin() }; }
+    TextAttributeIterator AttrEnd() const noexcept { return { _attrTable, _attr.end() }; }
 
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
@@ -182,6 +197,7 @@ private:
         void ReplaceCharacters(til::CoordType width) noexcept;
         void ReplaceText() noexcept;
         void _replaceTextUnicode(size_t ch, std::wstring_view::const_iterator it) noexcept;
+        void ReplaceSingleWidthText() noexcept;
         void CopyTextFrom(const std::span<const uint16_t>& charOffsets) noexcept;
         static void _copyOffsets(uint16_t* dst, const uint16_t* src, uint16_t size, uint16_t offset) noexcept;
         void Finish();
@@ -233,6 +249,7 @@ private:
     constexpr uint16_t _clampedColumnInclusive(T v) const noexcept;
 
     uint16_t _charSize() const noexcept;
+    size_t _getTextExtent() const noexcept;
     template<typename T>
     wchar_t _uncheckedChar(T off) const noexcept;
     template<typename T>
@@ -288,11 +305,16 @@ private:
     // In other words, _charOffsets tells us both the width in chars and width in columns.
     // See CharOffsetsTrailer for more information.
     std::span<uint16_t> _charOffsets;
-    // _attr is a run-length-encoded vector of TextAttribute with a decompressed
+    // The table owned by our TextBuffer which maps the IDs in _attr to TextAttributes.
+    TextAttributeTable* _attrTable = nullptr;
+    // _attr is a run-length-encoded vector of TextAttributeIds with a decompressed
     // length equal to _columnCount (= 1 TextAttribute per column).
-    til::small_rle<TextAttribute, uint16_t, 1> _attr;
+    TextAttributeRle _attr;
     // The width of the row in visual columns.
     uint16_t _columnCount = 0;
+    // The offset in _chars one past the last character that isn't whitespace (0 if the row is blank).
+    // WriteHelper::Finish() keeps it up to date, so that measuring a row doesn't require scanning it.
+    uint16_t _textExtent = 0;
     // Stores double-width/height (DECSWL/DECDWL/DECDHL) attributes.
     LineRendition _lineRendition = LineRendition::SingleWidth;
     // Occurs when the user runs out of text in a given row and we're forced to wrap the cursor to the next line
@@ -301,6 +323,35 @@ private:
     bool _doubleBytePadded = false;
 };
 
+// Replaces each attribute in the range [columnBegin, columnEnd) with the result of func(attribute).
+// func is called once per attribute run instead of once per column and all runs are replaced in a single pass.
+template<typename Func>
+void ROW::TransformAttributes(const til::CoordType columnBegin, const til::CoordType columnEnd, Func&& func)
+{
+    const auto colBeg = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnBegin, 0, _columnCount));
+    const auto colEnd = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnEnd, colBeg, _columnCount));
+    til::small_vector<TextAttributeRle::edit_type, 16> edits;
+    uint16_t runBeg = 0;
+
+    for (const auto& run : _attr.runs())
+    {
+        if (runBeg >= colEnd)
+        {
+            break;
+        }
+
+        const auto runEnd = gsl::narrow_cast<uint16_t>(runBeg + run.length);
+        if (runEnd > colBeg)
+        {
+            const TextAttribute attr = func(_attrTable->Get(run.value));
+            edits.push_back({ std::max(runBeg, colBeg), std::min(runEnd, colEnd), _attrTable->Intern(attr) });
+        }
+        runBeg = runEnd;
+    }
+
+    _attr.replace_sorted({ edits.data(), edits.size() });
+}
+
 #ifdef UNIT_TESTING
 constexpr bool operator==(const ROW& a, const ROW& b) noexcept
 {
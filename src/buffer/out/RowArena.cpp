@@ -0,0 +1,266 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "RowArena.hpp"
+
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+
+// VirtualAlloc() commits memory in pages. 4KiB is the page size on all architectures we support.
+static constexpr size_t pageSize = 4096;
+
+static constexpr size_t alignToPage(const size_t size) noexcept
+{
+    return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+RowArena::RowArena(RowArenaPool* pool, std::byte* base, const size_t size, const size_t committed) noexcept :
+    _pool{ pool },
+    _base{ base },
+    _size{ size },
+    _committed{ committed }
+{
+}
+
+RowArena::~RowArena()
+{
+    reset();
+}
+
+RowArena::RowArena(RowArena&& other) noexcept :
+    _pool{ std::exchange(other._pool, nullptr) },
+    _base{ std::exchange(other._base, nullptr) },
+    _size{ std::exchange(other._size, 0) },
+    _committed{ std::exchange(other._committed, 0) }
+{
+}
+
+RowArena& RowArena::operator=(RowArena&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        _pool = std::exchange(other._pool, nullptr);
+        _base = std::exchange(other._base, nullptr);
+        _size = std::exchange(other._size, 0);
+        _committed = std::exchange(other._committed, 0);
+    }
+    return *this;
+}
+
+RowArena::operator bool() const noexcept
+{
+    return _base != nullptr;
+}
+
+std::byte* RowArena::get() const noexcept
+{
+    return _base;
+}
+
+size_t RowArena::size() const noexcept
+{
+    return _size;
+}
+
+size_t RowArena::committed() const noexcept
+{
+    return _committed;
+}
+
+// Ensures that the first `size` bytes of the arena are committed.
+// Memory that's already committed (for instance because the arena was adopted from the pool) is left as is.
+void RowArena::Commit(const size_t size)
+{
+    assert(size <= _size);
+    if (size <= _committed)
+    {
+        return;
+    }
+
+    THROW_LAST_ERROR_IF_NULL(VirtualAlloc(_base + _committed, size - _committed, MEM_COMMIT, PAGE_READWRITE));
+    _pool->_addCommitted(size - _committed);
+    _committed = size;
+}
+
+void RowArena::Decommit() noexcept
+{
+    if (_committed)
+    {
+        VirtualFree(_base, 0, MEM_DECOMMIT);
+        _pool->_removeCommitted(_committed);
+        _committed = 0;
+    }
+}
+
+// Returns the arena to its pool.
+void RowArena::reset() noexcept
+{
+    if (_base)
+    {
+        _pool->_release(_base, _size, _committed);
+        _pool = nullptr;
+        _base = nullptr;
+        _size = 0;
+        _committed = 0;
+    }
+}
+
+RowArenaPool& RowArenaPool::Instance() noexcept
+{
+    // The pool is intentionally leaked, as TextBuffers with static storage duration may outlive it otherwise.
+#pragma warning(suppress : 26409) // Avoid calling new and delete explicitly, use std::make_unique<T> instead (r.11).
+    static const auto pool = new RowArenaPool();
+    return *pool;
+}
+
+RowArenaPool::~RowArenaPool()
+{
+    Trim();
+}
+
+// Returns an arena of at least the given size. It prefers the smallest idle arena that fits, as long as it isn't
+// much larger than requested, as that would waste address space that a larger request could've made use of.
+// Its committed memory is kept (up to the given size), but its contents are unspecified.
+RowArena RowArenaPool::Acquire(const size_t size)
+{
+    IdleArena arena;
+
+    {
+        const std::lock_guard guard{ _lock };
+
+        auto best = _idle.end();
+        for (auto it = _idle.begin(); it != _idle.end(); ++it)
+        {
+            if (it->size >= size && it->size / 2 <= size && (best == _idle.end() || it->size < best->size))
+            {
+                best = it;
+            }
+        }
+
+        if (best != _idle.end())
+        {
+            arena = *best;
+            _idle.erase(best);
+            _idleBytes -= arena.committed;
+        }
+    }
+
+    if (!arena.base)
+    {
+        const auto base = static_cast<std::byte*>(THROW_LAST_ERROR_IF_NULL(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE)));
+        return { this, base, size, 0 };
+    }
+
+    // Don't keep committed memory the new owner might never use.
+    const auto keep = std::min(alignToPage(size), alignToPage(arena.committed));
+    if (alignToPage(arena.committed) > keep)
+    {
+        VirtualFree(arena.base + keep, alignToPage(arena.committed) - keep, MEM_DECOMMIT);
+        arena.committed = keep;
+    }
+
+    _addCommitted(arena.committed);
+    return { this, arena.base, arena.size, arena.committed };
+}
+
+// Sets the maximum amount of committed memory kept in idle arenas.
+void RowArenaPool::SetIdleLimit(const size_t bytes) noexcept
+{
+    const std::lock_guard guard{ _lock };
+    _idleLimit = bytes;
+    _trim();
+}
+
+// Sets the maximum amount of memory committed by all arenas together, beyond which idle arenas get released.
+// It's unlimited by default.
+void RowArenaPool::SetCommitLimit(const size_t bytes) noexcept
+{
+    const std::lock_guard guard{ _lock };
+    _commitLimit.store(bytes, std::memory_order_relaxed);
+    _trim();
+}
+
+// Returns the amount of memory committed by all arenas, in use or idle.
+size_t RowArenaPool::GetCommittedBytes() const noexcept
+{
+    const std::lock_guard guard{ _lock };
+    return _liveBytes.load(std::memory_order_relaxed) + _idleBytes;
+}
+
+size_t RowArenaPool::GetIdleBytes() const noexcept
+{
+    const std::lock_guard guard{ _lock };
+    return _idleBytes;
+}
+
+size_t RowArenaPool::GetIdleCount() const noexcept
+{
+    const std::lock_guard guard{ _lock };
+    return _idle.size();
+}
+
+// Releases all idle arenas.
+void RowArenaPool::Trim() noexcept
+{
+    const std::lock_guard guard{ _lock };
+    for (const auto& arena : _idle)
+    {
+        VirtualFree(arena.base, 0, MEM_RELEASE);
+    }
+    _idle.clear();
+    _idleBytes = 0;
+}
+
+void RowArenaPool::_addCommitted(const size_t bytes) noexcept
+{
+    const auto live = _liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (live > _commitLimit.load(std::memory_order_relaxed))
+    {
+        const std::lock_guard guard{ _lock };
+        _trim();
+    }
+}
+
+void RowArenaPool::_removeCommitted(const size_t bytes) noexcept
+{
+    _liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void RowArenaPool::_release(std::byte* base, const size_t size, const size_t committed) noexcept
+{
+    _removeCommitted(committed);
+
+    const std::lock_guard guard{ _lock };
+    try
+    {
+        _idle.push_back({ base, size, committed });
+        _idleBytes += committed;
+    }
+    catch (...)
+    {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return;
+    }
+    _trim();
+}
+
+// Releases idle arenas, least recently returned first, until the pool is within its limits.
+// The caller must hold _lock.
+void RowArenaPool::_trim() noexcept
+{
+    const auto live = _liveBytes.load(std::memory_order_relaxed);
+    const auto commitLimit = _commitLimit.load(std::memory_order_relaxed);
+    size_t count = 0;
+    for (const auto& arena : _idle)
+    {
+        if (_idle.size() - count <= MaxIdleArenas && _idleBytes <= _idleLimit && live + _idleBytes <= commitLimit)
+        {
+            break;
+        }
+        VirtualFree(arena.base, 0, MEM_RELEASE);
+        _idleBytes -= arena.committed;
+        ++count;
+    }
+    _idle.erase(_idle.begin(), _idle.begin() + count);
+}
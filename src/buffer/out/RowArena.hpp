@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+class RowArenaPool;
+
+// Owns a MEM_RESERVE'd region of memory that TextBuffer stores its ROWs in and keeps track of how much of it has
+// been committed. When it's destroyed, the region is returned to the RowArenaPool it came from instead of being
+// released, so that the next TextBuffer can reuse it, including its committed pages.
+class RowArena
+{
+public:
+    RowArena() = default;
+    ~RowArena();
+
+    RowArena(const RowArena& other) = delete;
+    RowArena& operator=(const RowArena& other) = delete;
+
+    RowArena(RowArena&& other) noexcept;
+    RowArena& operator=(RowArena&& other) noexcept;
+
+    explicit operator bool() const noexcept;
+    std::byte* get() const noexcept;
+    size_t size() const noexcept;
+    size_t committed() const noexcept;
+
+    void Commit(size_t size);
+    void Decommit() noexcept;
+    void reset() noexcept;
+
+private:
+    friend class RowArenaPool;
+
+    RowArena(RowArenaPool* pool, std::byte* base, size_t size, size_t committed) noexcept;
+
+    RowArenaPool* _pool = nullptr;
+    std::byte* _base = nullptr;
+    // The size of the reservation in bytes.
+    size_t _size = 0;
+    // The range [_base, _base + _committed) is committed memory.
+    size_t _committed = 0;
+};
+
+// A process-wide cache of the memory that TextBuffers store their ROWs in.
+// Every resize, reflow and alternate screen buffer switch creates a new TextBuffer, as does every snapshot. Reserving
+// and committing fresh memory for each of them is expensive, fragments the address space and, with many panes open,
+// results in large spikes of committed memory. Instead, TextBuffers return their memory here when they're destroyed,
+// still committed, and the next TextBuffer of a similar size adopts it.
+//
+// The pool keeps track of the memory committed by all arenas, in use or not. Idle arenas are released, least recently
+// returned first, once they hold more than the idle limit, or once all arenas together exceed the commit limit.
+// Arenas that are in use are never trimmed, as that would discard the contents of their TextBuffer.
+class RowArenaPool
+{
+public:
+    // The maximum amount of committed memory that's kept around in idle arenas. A fully used buffer of the default
+    // size (120x9001) commits about 6 MiB, so this keeps roughly one buffer around: Enough for the new buffer of
+    // a resize, reflow or alternate screen buffer switch to adopt the memory of the one it replaces.
+    static constexpr size_t DefaultIdleLimit = 8 * 1024 * 1024;
+    // The maximum number of idle arenas, which bounds the address space reserved by the pool.
+    static constexpr size_t MaxIdleArenas = 16;
+
+    static RowArenaPool& Instance() noexcept;
+
+    RowArenaPool() = default;
+    ~RowArenaPool();
+
+    RowArenaPool(const RowArenaPool& other) = delete;
+    RowArenaPool& operator=(const RowArenaPool& other) = delete;
+
+    RowArena Acquire(size_t size);
+
+    void SetIdleLimit(size_t bytes) noexcept;
+    void SetCommitLimit(size_t bytes) noexcept;
+    size_t GetCommittedBytes() const noexcept;
+    size_t GetIdleBytes() const noexcept;
+    size_t GetIdleCount() const noexcept;
+    void Trim() noexcept;
+
+private:
+    friend class RowArena;
+
+    struct IdleArena
+    {
+        std::byte* base = nullptr;
+        size_t size = 0;
+        size_t committed = 0;
+    };
+
+    void _addCommitted(size_t bytes) noexcept;
+    void _removeCommitted(size_t bytes) noexcept;
+    void _release(std::byte* base, size_t size, size_t committed) noexcept;
+    void _trim() noexcept;
+
+    mutable std::mutex _lock;
+    // Sorted by the time they were returned, the least recently returned one first.
+    std::vector<IdleArena> _idle;
+    // The sum of IdleArena::committed of all _idle arenas.
+    size_t _idleBytes = 0;
+    size_t _idleLimit = DefaultIdleLimit;
+    // The memory committed by arenas that are in use and its limit are accessed without holding _lock,
+    // because TextBuffers commit memory frequently and independently of each other.
+    std::atomic<size_t> _commitLimit{ SIZE_MAX };
+    std::atomic<size_t> _liveBytes{ 0 };
+};
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeTable.hpp"
+
+#include <til/hash.h>
+
+TextAttributeTable::TextAttributeTable(const TextAttribute& initial) :
+    _lastAttr{ initial }
+{
+    _entries.emplace_back(initial);
+    _rehash(64);
+}
+
+// Returns the ID for the given attribute, adding it to the table if necessary.
+// IDs stay valid until the next call to Reset() or Compact(). ID 0 always refers to the initial attributes.
+TextAttributeId TextAttributeTable::Intern(const TextAttribute& attr)
+{
+    if (attr == _lastAttr)
+    {
+        return _lastId;
+    }
+
+    const auto slot = _findSlot(attr);
+    auto id = til::at(_slots, slot);
+
+    if (id == EmptySlot)
+    {
+        // The table would need 64GiB of memory before it runs out of IDs.
+        THROW_HR_IF(E_OUTOFMEMORY, _entries.size() >= EmptySlot);
+
+        id = gsl::narrow_cast<TextAttributeId>(_entries.size());
+        _entries.emplace_back(attr);
+
+        // Keep the load factor at or below 50%, because linear probing degrades quickly past that.
+        if (_entries.size() * 2 > _slots.size())
+        {
+            _rehash(_slots.size() * 2);
+        }
+        else
+        {
+            til::at(_slots, slot) = id;
+        }
+    }
+
+    _lastAttr = attr;
+    _lastId = id;
+    return id;
+}
+
+const TextAttribute& TextAttributeTable::Get(const TextAttributeId id) const noexcept
+{
+    return til::at(_entries, id);
+}
+
+size_t TextAttributeTable::size() const noexcept
+{
+    return _entries.size();
+}
+
+bool TextAttributeTable::NeedsCompaction() const noexcept
+{
+    return _entries.size() >= _compactionThreshold;
+}
+
+// Removes all attributes from the table, except for the given one, which is assigned the ID 0.
+// This doesn't release any memory and as such can't fail.
+void TextAttributeTable::Reset(const TextAttribute& initial) noexcept
+{
+    _entries.resize(1);
+    til::at(_entries, 0) = initial;
+    std::fill(_slots.begin(), _slots.end(), EmptySlot);
+    _insertSlot(0);
+    _lastAttr = initial;
+    _lastId = 0;
+    _compactionThreshold = CompactionThreshold;
+}
+
+// Removes all IDs for which used[id] is 0 and returns a mapping from the old to the new IDs.
+// The caller is expected to apply the mapping to all IDs it holds.
+// IDs keep their relative order, so as long as ID 0 is marked as used it stays 0.
+std::vector<TextAttributeId> TextAttributeTable::Compact(const std::vector<uint8_t>& used)
+{
+    std::vector<TextAttributeId> remap(_entries.size());
+    size_t size = 0;
+
+    for (size_t id = 0; id < _entries.size(); ++id)
+    {
+        if (til::at(used, id))
+        {
+            til::at(remap, id) = gsl::narrow_cast<TextAttributeId>(size);
+            til::at(_entries, size) = til::at(_entries, id);
+            ++size;
+        }
+    }
+
+    // The caller should always hold on to at least the ID of its default attributes.
+    // But if it doesn't, we still need to keep a valid entry for _lastId.
+    size = std::max<size_t>(size, 1);
+    _entries.resize(size);
+    _rehash(_slots.size());
+
+    _lastAttr = til::at(_entries, 0);
+    _lastId = 0;
+    // Compacting requires a scan of the entire buffer. Doubling the threshold ensures that the
+    // table grows by at least as many new attributes as it retained until the next scan.
+    _compactionThreshold = std::max(CompactionThreshold, size * 2);
+
+    return remap;
+}
+
+// Returns the index of the slot that either holds the ID for the given attribute or is empty.
+size_t TextAttributeTable::_findSlot(const TextAttribute& attr) const noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto slot = til::hash(attr) & mask;
+
+    for (;;)
+    {
+        const auto id = til::at(_slots, slot);
+        if (id == EmptySlot || til::at(_entries, id) == attr)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void TextAttributeTable::_rehash(const size_t slotCount)
+{
+    _slots.assign(slotCount, EmptySlot);
+
+    for (size_t id = 0; id < _entries.size(); ++id)
+    {
+        _insertSlot(gsl::narrow_cast<TextAttributeId>(id));
+    }
+}
+
+void TextAttributeTable::_insertSlot(const TextAttributeId id) noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto slot = til::hash(til::at(_entries, id)) & mask;
+
+    while (til::at(_slots, slot) != EmptySlot)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    til::at(_slots, slot) = id;
+}
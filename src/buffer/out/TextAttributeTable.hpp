@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <til/rle.h>
+
+#include "TextAttribute.hpp"
+
+// ROWs don't store TextAttributes directly, but rather IDs into a TextAttributeTable owned by their TextBuffer.
+// A TextAttribute is 16 bytes large, so this shrinks each run in ROW::_attr from 18 down to 8 bytes and
+// turns the comparisons til::rle does during replace() and _compact() into simple integer compares.
+// IDs are 32-bit, because a buffer can easily hold more than 64Ki distinct attributes (for instance
+// truecolor gradients or one hyperlink per cell) and interning a valid attribute must never fail.
+using TextAttributeId = uint32_t;
+using TextAttributeRle = til::small_rle<TextAttributeId, uint16_t, 1>;
+
+class TextAttributeTable
+{
+public:
+    // TextBuffer compacts the table once it has grown this large. After a compaction the threshold is
+    // raised to twice the number of retained attributes, so that buffers with many distinct live
+    // attributes don't have to be rescanned over and over again.
+    static constexpr size_t CompactionThreshold = 64 * 1024;
+
+    explicit TextAttributeTable(const TextAttribute& initial);
+
+    TextAttributeId Intern(const TextAttribute& attr);
+    const TextAttribute& Get(TextAttributeId id) const noexcept;
+
+    size_t size() const noexcept;
+    bool NeedsCompaction() const noexcept;
+    void Reset(const TextAttribute& initial) noexcept;
+    std::vector<TextAttributeId> Compact(const std::vector<uint8_t>& used);
+
+private:
+    // Used to mark empty hash slots and so it can't be a valid ID.
+    static constexpr TextAttributeId EmptySlot = UINT32_MAX;
+
+    size_t _findSlot(const TextAttribute& attr) const noexcept;
+    void _rehash(size_t slotCount);
+    void _insertSlot(TextAttributeId id) noexcept;
+
+    // _entries[id] holds the TextAttribute for the given ID.
+    std::vector<TextAttribute> _entries;
+    // An open addressing hash table (linear probing) mapping from TextAttribute to its ID.
+    // Its size is always a power of 2 and at most half full.
+    std::vector<TextAttributeId> _slots;
+    // Most writes use the same attributes as the previous one and this skips the hash lookup for those.
+    TextAttribute _lastAttr;
+    TextAttributeId _lastId = 0;
+    size_t _compactionThreshold = CompactionThreshold;
+};
+
+// Wraps a TextAttributeRle iterator and yields the TextAttribute for each ID.
+// This allows users of ROW::AttrBegin() to iterate over the attributes of each column.
+class TextAttributeIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TextAttribute;
+    using difference_type = ptrdiff_t;
+    using pointer = const TextAttribute*;
+    using reference = const TextAttribute&;
+
+    TextAttributeIterator(const TextAttributeTable* table, TextAttributeRle::const_iterator it) noexcept :
+        _table{ table },
+        _it{ it }
+    {
+    }
+
+    [[nodiscard]] reference operator*() const noexcept
+    {
+        return _table->Get(*_it);
+    }
+
+    [[nodiscard]] pointer operator->() const noexcept
+    {
+        return &operator*();
+    }
+
+    [[nodiscard]] TextAttributeId Id() const noexcept
+    {
+        return *_it;
+    }
+
+    TextAttributeIterator& operator++() noexcept
+    {
+        ++_it;
+        return *this;
+    }
+
+    TextAttributeIterator operator++(int) noexcept
+    {
+        auto tmp = *this;
+        ++_it;
+        return tmp;
+    }
+
+    TextAttributeIterator& operator+=(const difference_type offset) noexcept
+    {
+        _it += offset;
+        return *this;
+    }
+
+    [[nodiscard]] TextAttributeIterator operator+(const difference_type offset) const noexcept
+    {
+        auto tmp = *this;
+        return tmp += offset;
+    }
+
+    [[nodiscard]] bool operator==(const TextAttributeIterator& other) const noexcept
+    {
+        return _it == other._it;
+    }
+
+    [[nodiscard]] bool operator!=(const TextAttributeIterator& other) const noexcept
+    {
+        return _it != other._it;
+    }
+
+private:
+    const TextAttributeTable* _table;
+    TextAttributeRle::const_iterator _it;
+};
@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WordIndex.hpp"
+
+#include <bit>
+
+DelimiterTable::DelimiterTable(const std::wstring_view wordDelimiters) :
+    _delimiters{ wordDelimiters }
+{
+    for (const auto ch : wordDelimiters)
+    {
+        _isDelimiter.set(ch);
+    }
+}
+
+std::wstring_view DelimiterTable::Delimiters() const noexcept
+{
+    return _delimiters;
+}
+
+DelimiterClass DelimiterTable::Classify(const wchar_t ch) const noexcept
+{
+    if (ch <= L' ')
+    {
+        return DelimiterClass::ControlChar;
+    }
+    if (_isDelimiter.test(ch))
+    {
+        return DelimiterClass::DelimiterChar;
+    }
+    return DelimiterClass::RegularChar;
+}
+
+void WordIndex::Clear() noexcept
+{
+    _width = 0;
+    _stride = 0;
+    _masks.clear();
+    _valid.clear();
+}
+
+void WordIndex::Invalidate(const size_t offset) noexcept
+{
+    if (offset < _valid.size())
+    {
+        til::at(_valid, offset) = 0;
+    }
+}
+
+DelimiterClass WordIndex::ClassAt(const ROW& row, const size_t offset, const std::wstring_view wordDelimiters, til::CoordType column)
+{
+    const auto masks = _getMasks(row, offset, wordDelimiters);
+    column = std::clamp(column, 0, _width - 1);
+    const auto index = gsl::narrow_cast<size_t>(column) / 64;
+    const auto bit = uint64_t{ 1 } << (column % 64);
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    if (masks[index] & bit)
+    {
+        return DelimiterClass::RegularChar;
+    }
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    if (masks[_stride + index] & bit)
+    {
+        return DelimiterClass::ControlChar;
+    }
+    return DelimiterClass::DelimiterChar;
+}
+
+// Returns the first column in [column, width) whose DelimiterClass is cls (match = true)
+// or isn't cls (match = false). Returns the width of the row if there's none.
+til::CoordType WordIndex::FindNext(const ROW& row, const size_t offset, const std::wstring_view wordDelimiters, const til::CoordType column, const DelimiterClass cls, const bool match)
+{
+    const auto masks = _getMasks(row, offset, wordDelimiters);
+    if (column >= _width)
+    {
+        return _width;
+    }
+
+    const auto first = gsl::narrow_cast<size_t>(std::max(0, column));
+    auto word = _getWord(masks, first / 64, cls, match) & (~uint64_t{ 0 } << (first % 64));
+    for (auto index = first / 64;;)
+    {
+        if (word)
+        {
+            return gsl::narrow_cast<til::CoordType>(index * 64 + std::countr_zero(word));
+        }
+        if (++index >= _stride)
+        {
+            return _width;
+        }
+        word = _getWord(masks, index, cls, match);
+    }
+}
+
+// Returns the last column in [0, column] whose DelimiterClass is cls (match = true)
+// or isn't cls (match = false). Returns -1 if there's none.
+til::CoordType WordIndex::FindPrevious(const ROW& row, const size_t offset, const std::wstring_view wordDelimiters, const til::CoordType column, const DelimiterClass cls, const bool match)
+{
+    const auto masks = _getMasks(row, offset, wordDelimiters);
+    if (column < 0)
+    {
+        return -1;
+    }
+
+    const auto last = gsl::narrow_cast<size_t>(std::min(column, _width - 1));
+    auto word = _getWord(masks, last / 64, cls, match) & (~uint64_t{ 0 } >> (63 - last % 64));
+    for (auto index = last / 64;;)
+    {
+        if (word)
+        {
+            return gsl::narrow_cast<til::CoordType>(index * 64 + 63 - std::countl_zero(word));
+        }
+        if (index-- == 0)
+        {
+            return -1;
+        }
+        word = _getWord(masks, index, cls, match);
+    }
+}
+
+// Returns the masks of the given ROW, computing them if they're out of date.
+const uint64_t* WordIndex::_getMasks(const ROW& row, const size_t offset, const std::wstring_view wordDelimiters)
+{
+    if (wordDelimiters != _table.Delimiters())
+    {
+        _table = DelimiterTable{ wordDelimiters };
+        std::fill(_valid.begin(), _valid.end(), uint8_t{ 0 });
+    }
+
+    const auto width = row.size();
+    if (width != _width)
+    {
+        Clear();
+        _width = width;
+        _stride = (gsl::narrow_cast<size_t>(width) + 63) / 64;
+    }
+
+    if (offset >= _valid.size())
+    {
+        _masks.resize((offset + 1) * 2 * _stride);
+        _valid.resize(offset + 1);
+    }
+
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    const auto masks = _masks.data() + offset * 2 * _stride;
+    if (!til::at(_valid, offset))
+    {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        const std::span regular{ masks, _stride };
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        const std::span control{ masks + _stride, _stride };
+        std::fill(regular.begin(), regular.end(), uint64_t{ 0 });
+        std::fill(control.begin(), control.end(), uint64_t{ 0 });
+        row.ClassifyDelimiters(_table, regular, control);
+        til::at(_valid, offset) = 1;
+    }
+    return masks;
+}
+
+// Returns the given word of the mask of columns whose DelimiterClass is (or isn't) cls.
+// Bits past the width of the ROW are always 0.
+uint64_t WordIndex::_getWord(const uint64_t* masks, const size_t index, const DelimiterClass cls, const bool match) const noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    const auto regular = masks[index];
+    const auto control = masks[_stride + index];
+#pragma warning(pop)
+
+    uint64_t word;
+    switch (cls)
+    {
+    case DelimiterClass::RegularChar:
+        word = regular;
+        break;
+    case DelimiterClass::ControlChar:
+        word = control;
+        break;
+    default:
+        word = ~(regular | control);
+        break;
+    }
+    if (!match)
+    {
+        word = ~word;
+    }
+
+    // Mask off the columns past the end of the ROW.
+    const auto remaining = gsl::narrow_cast<size_t>(_width) - index * 64;
+    if (remaining < 64)
+    {
+        word &= (uint64_t{ 1 } << remaining) - 1;
+    }
+    return word;
+}
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <bitset>
+
+#include "Row.hpp"
+
+// Classifies characters into DelimiterClasses with a single bit test, instead of searching through
+// the delimiter string for each one. It's built once per set of word delimiters (8 KiB).
+class DelimiterTable
+{
+public:
+    DelimiterTable() = default;
+    explicit DelimiterTable(std::wstring_view wordDelimiters);
+
+    std::wstring_view Delimiters() const noexcept;
+    DelimiterClass Classify(wchar_t ch) const noexcept;
+
+private:
+    std::wstring _delimiters;
+    std::bitset<0x10000> _isDelimiter;
+};
+
+// Caches the DelimiterClass of each cell in a TextBuffer as bitmaps, so that word navigation
+// can skip over entire words with a bit scan instead of classifying one cell at a time.
+// The bitmaps of each ROW are computed the first time they're needed. TextBuffer invalidates
+// them whenever it hands out a ROW for modification and drops all of them when the delimiters change.
+class WordIndex
+{
+public:
+    void Clear() noexcept;
+    void Invalidate(size_t offset) noexcept;
+
+    DelimiterClass ClassAt(const ROW& row, size_t offset, std::wstring_view wordDelimiters, til::CoordType column);
+    til::CoordType FindNext(const ROW& row, size_t offset, std::wstring_view wordDelimiters, til::CoordType column, DelimiterClass cls, bool match);
+    til::CoordType FindPrevious(const ROW& row, size_t offset, std::wstring_view wordDelimiters, til::CoordType column, DelimiterClass cls, bool match);
+
+private:
+    const uint64_t* _getMasks(const ROW& row, size_t offset, std::wstring_view wordDelimiters);
+    uint64_t _getWord(const uint64_t* masks, size_t index, DelimiterClass cls, bool match) const noexcept;
+
+    DelimiterTable _table;
+    til::CoordType _width = 0;
+    // The number of uint64_t in each of the two masks of a ROW.
+    size_t _stride = 0;
+    // Indexed by the offset of a ROW in the TextBuffer (see TextBuffer::_getRowByOffsetDirect()).
+    // Each ROW has a mask of its RegularChar columns followed by a mask of its ControlChar columns.
+    // Columns that are neither are DelimiterChars.
+    std::vector<uint64_t> _masks;
+    // 1 if the masks of the ROW at the given offset are up to date.
+    std::vector<uint8_t> _valid;
+};
@@ -10,6 +10,7 @@
 
 #include "UTextAdapter.h"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/GraphemeBreak.hpp"
 #include "../renderer/base/renderer.hpp"
 #include "../types/inc/convert.hpp"
 #include "../types/inc/utils.hpp"
@@ -86,6 +87,8 @@ TextBuffer::~TextBuffer()
 // with our huge allocation, as well as to be able to reduce the private working set of
 // the application by only committing what we actually need. This reduces conhost's
 // memory usage from ~7MB down to just ~2MB at startup in the general case.
+// The allocation is borrowed from RowArenaPool, because TextBuffers are frequently
+// recreated (resize, reflow, alternate screen buffer) and usually with a similar size.
 void TextBuffer::_reserve(til::size screenBufferSize, const TextAttribute& defaultAttributes)
 {
     const auto w = gsl::narrow<uint16_t>(screenBufferSize.width);
@@ -105,12 +108,12 @@ void TextBuffer::_reserve(til::size screenBufferSize, const TextAttribute& defau
 
     // NOTE: Modifications to this block of code might have to be mirrored over to ResizeTraditional().
     // It constructs a temporary TextBuffer and then extracts the members below, overwriting itself.
-    _buffer = wil::unique_virtualalloc_ptr<std::byte>{
-        static_cast<std::byte*>(THROW_LAST_ERROR_IF_NULL(VirtualAlloc(nullptr, allocSize, MEM_RESERVE, PAGE_READWRITE)))
-    };
+    _buffer = RowArenaPool::Instance().Acquire(allocSize);
     _bufferEnd = _buffer.get() + allocSize;
     _commitWatermark = _buffer.get();
+    _attributeTable = std::make_unique<TextAttributeTable>(defaultAttributes);
     _initialAttributes = defaultAttributes;
+    _initialAttributesId = 0;
     _bufferRowStride = rowStride;
     _bufferOffsetChars = rowSize;
     _bufferOffsetCharOffsets = rowSize + charsBufferSize;
@@ -134,7 +137,7 @@ __declspec(noinline) void TextBuffer::_commit(const std::byte* row)
     const auto ideal = minimum + _bufferRowStride * _commitReadAheadRowCount;
     const auto size = std::min(remaining, ideal);
 
-    THROW_LAST_ERROR_IF_NULL(VirtualAlloc(_commitWatermark, size, MEM_COMMIT, PAGE_READWRITE));
+    _buffer.Commit(gsl::narrow_cast<size_t>(_commitWatermark + size - _buffer.get()));
 
     _construct(_commitWatermark + size);
 }
@@ -144,8 +147,10 @@ __declspec(noinline) void TextBuffer::_commit(const std::byte* row)
 void TextBuffer::_decommit() noexcept
 {
     _destroy();
-    VirtualFree(_buffer.get(), 0, MEM_DECOMMIT);
+    _buffer.Decommit();
     _commitWatermark = _buffer.get();
+    _wordIndex.Clear();
+    _touchAllRows();
 }
 
 // Constructs ROWs between [_commitWatermark,until).
@@ -156,7 +161,7 @@ void TextBuffer::_construct(const std::byte* until) noexcept
         const auto row = reinterpret_cast<ROW*>(_commitWatermark);
         const auto chars = reinterpret_cast<wchar_t*>(_commitWatermark + _bufferOffsetChars);
         const auto indices = reinterpret_cast<uint16_t*>(_commitWatermark + _bufferOffsetCharOffsets);
-        std::construct_at(row, chars, indices, _width, _initialAttributes);
+        std::construct_at(row, chars, indices, _width, *_attributeTable, _initialAttributesId);
     }
 }
 
@@ -216,6 +221,88 @@ til::CoordType TextBuffer::_estimateOffsetOfLastCommittedRow() const noexcept
     return std::max(0, gsl::narrow_cast<til::CoordType>(lastRowOffset - 2));
 }
 
+// Returns the offset of the given ROW in _buffer (see _getRowByOffsetDirect()).
+size_t TextBuffer::_getRowOffset(const ROW& row) const noexcept
+{
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+    return gsl::narrow_cast<size_t>(reinterpret_cast<const std::byte*>(&row) - _buffer.get()) / _bufferRowStride;
+}
+
+// Sets the generation of the ROW at the given offset to the current _lastMutationId
+// and moves it to the end of the _rowGenerations list. See _rowGenerations.
+void TextBuffer::_touchRow(const size_t offset)
+{
+    if (_rowGenerations.empty())
+    {
+        _rowGenerations.resize(gsl::narrow_cast<size_t>(_height) + 1);
+    }
+
+    const auto index = gsl::narrow_cast<uint32_t>(offset);
+    auto& entry = til::at(_rowGenerations, index);
+    entry.generation = _lastMutationId;
+
+    // Most writes go to the same ROW as the previous one.
+    if (index == _rowGenerationsTail)
+    {
+        return;
+    }
+
+    if (entry.prev != RowGeneration::None)
+    {
+        til::at(_rowGenerations, entry.prev).next = entry.next;
+    }
+    if (entry.next != RowGeneration::None)
+    {
+        til::at(_rowGenerations, entry.next).prev = entry.prev;
+    }
+
+    entry.prev = _rowGenerationsTail;
+    entry.next = RowGeneration::None;
+    if (_rowGenerationsTail != RowGeneration::None)
+    {
+        til::at(_rowGenerations, _rowGenerationsTail).next = index;
+    }
+    _rowGenerationsTail = index;
+}
+
+// Marks all ROWs as changed, for operations that replace them without going through GetMutableRowByOffset().
+void TextBuffer::_touchAllRows() noexcept
+{
+    _lastMutationId++;
+    _allRowsGeneration = _lastMutationId;
+    _rowGenerations.clear();
+    _rowGenerationsTail = RowGeneration::None;
+}
+
+// ROWs only ever add IDs to the _attributeTable. Once it grows too large we mark
+// all IDs that are still in use by any committed ROW and drop all the others.
+__declspec(noinline) void TextBuffer::_compactAttributeTable()
+{
+    std::vector<uint8_t> used(_attributeTable->size());
+    til::at(used, _initialAttributesId) = 1;
+
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        for (const auto& run : reinterpret_cast<const ROW*>(it)->Attributes().runs())
+        {
+            til::at(used, run.value) = 1;
+        }
+    }
+
+    const auto remap = _attributeTable->Compact(used);
+
+    // The mapping is injective, so we can update the runs in place without having to merge any of them.
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    {
+        for (auto& run : reinterpret_cast<ROW*>(it)->Attributes().runs())
+        {
+            run.value = til::at(remap, run.value);
+        }
+    }
+
+    _initialAttributesId = til::at(remap, _initialAttributesId);
+}
+
 // Retrieves a row from the buffer by its offset from the first row of the text buffer
 // (what corresponds to the top row of the screen buffer).
 const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const
@@ -228,7 +315,19 @@ const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const
 ROW& TextBuffer::GetMutableRowByOffset(const til::CoordType index)
 {
     _lastMutationId++;
-    return _getRow(index);
+    if (_attributeTable->NeedsCompaction()) [[unlikely]]
+    {
+        _compactAttributeTable();
+    }
+    auto& row = _getRow(index);
+    const auto offset = _getRowOffset(row);
+    _wordIndex.Invalidate(offset);
+    _touchRow(offset);
+    if (!_hyperlinks.empty()) [[unlikely]]
+    {
+        _releaseRowHyperlinks(row);
+    }
+    return row;
 }
 
 // Returns a row filled with whitespace and the current attributes, for you to freely use.
@@ -243,6 +342,10 @@ ROW& TextBuffer::GetScratchpadRow(const TextAttribute& attributes)
     // The scratchpad row is mapped to the underlying index 0, whereas all regular rows are mapped to
     // index 1 and up. We do it this way instead of the other way around (scratchpad row at index _height),
     // because that would force us to MEM_COMMIT the entire buffer whenever this function is called.
+    if (_attributeTable->NeedsCompaction()) [[unlikely]]
+    {
+        _compactAttributeTable();
+    }
     auto& r = _getRowByOffsetDirect(0);
     r.Reset(attributes);
     return r;
@@ -263,6 +366,67 @@ void TextBuffer::CopyProperties(const TextBuffer& OtherBuffer) noexcept
     GetCursor().CopyProperties(OtherBuffer.GetCursor());
 }
 
+// Creates a frozen copy of the buffer for readers that need a consistent view of it for longer than they
+// can afford to hold the console lock, like exports. The snapshot has the same size, contents, cursor
+// position, hyperlinks and marks, and row y of the snapshot is row y of this buffer.
+// The committed part of the arena is block-copied as is and the attribute table is cloned, so that the
+// rows keep their attribute IDs. Afterwards each ROW only needs its pointers fixed up and its attribute
+// runs and any text that spilled onto the heap copied. The snapshot still needs an arena of its own
+// (usually a recycled one from RowArenaPool) and this is O(committed rows), not O(1), so don't call it per frame.
+// A snapshot is never rendered. It refers to the same renderer though and so it must not outlive it.
+// Like any other TextBuffer it may only be read by one thread at a time, as rows are committed lazily.
+std::shared_ptr<const TextBuffer> TextBuffer::Snapshot() const
+{
+    auto snapshot = std::make_shared<TextBuffer>(til::size{ _width, _height }, _initialAttributes, _cursor.GetSize(), false, _renderer);
+    // Using the same layout allows the snapshot to share our row generations. See _rowGenerations.
+    snapshot->_firstRow = _firstRow;
+    *snapshot->_attributeTable = *_attributeTable;
+    snapshot->_initialAttributesId = _initialAttributesId;
+
+    // Rows that were never committed are still blank and can stay uncommitted in the snapshot as well.
+    const auto committed = gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get());
+    if (committed != 0)
+    {
+        const auto dst = snapshot->_buffer.get();
+        const auto src = _buffer.get();
+        snapshot->_buffer.Commit(committed);
+        memcpy(dst, src, committed);
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+        // The copied ROW structs still point into our arena and share our heap allocations. They're only raw
+        // bytes at this point and get overwritten with proper copies. _commitWatermark is advanced
+        // one row at a time, so that the snapshot's destructor only destroys fully constructed ROWs.
+        for (size_t off = 0; off < committed; off += _bufferRowStride)
+        {
+            const auto chars = reinterpret_cast<wchar_t*>(dst + off + _bufferOffsetChars);
+            const auto indices = reinterpret_cast<uint16_t*>(dst + off + _bufferOffsetCharOffsets);
+            std::construct_at(reinterpret_cast<ROW*>(dst + off), chars, indices, *snapshot->_attributeTable, *reinterpret_cast<const ROW*>(src + off));
+            snapshot->_commitWatermark = dst + off + _bufferRowStride;
+        }
+#pragma warning(pop)
+    }
+
+    snapshot->_currentAttributes = _currentAttributes;
+    snapshot->_cursor.CopyProperties(_cursor);
+    snapshot->_cursor.SetPosition(_cursor.GetPosition());
+    // The rows are at the same offsets and refer to the same hyperlink IDs, so the bookkeeping can be taken over as is.
+    snapshot->_hyperlinks = _hyperlinks;
+    snapshot->_hyperlinkRowIsDirty = _hyperlinkRowIsDirty;
+    snapshot->_hyperlinkDirtyRows = _hyperlinkDirtyRows;
+    snapshot->_hyperlinkUnreferenced = _hyperlinkUnreferenced;
+    snapshot->_marks = _marks;
+    snapshot->_marksOrigin = _marksOrigin;
+    snapshot->_currentPromptMark = _currentPromptMark;
+    // This allows readers to tell which state of the buffer the snapshot represents.
+    snapshot->_lastMutationId = _lastMutationId;
+    snapshot->_rowGenerations = _rowGenerations;
+    snapshot->_rowGenerationsTail = _rowGenerationsTail;
+    snapshot->_allRowsGeneration = _allRowsGeneration;
+    return snapshot;
+}
+
 // Routine Description:
 // - Gets the number of rows in the buffer
 // Arguments:
@@ -407,18 +571,18 @@ void TextBuffer::_PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute
 
 // Given the character offset `position` in the `chars` string, this function returns the starting position of the next grapheme.
 // For instance, given a `chars` of L"x\uD83D\uDE42y" and a `position` of 1 it'll return 3.
+// Graphemes are extended grapheme clusters as per UAX #29, which means that "e" followed by U+0301,
+// emoji ZWJ sequences, flags and so on are all treated as one. See GraphemeBreak.hpp.
 // GraphemePrev would do the exact inverse of this operation.
-// In the future, these functions are expected to also deliver information about how many columns a grapheme occupies.
-// (I know that mere UTF-16 code point iteration doesn't handle graphemes, but that's what we're working towards.)
 size_t TextBuffer::GraphemeNext(const std::wstring_view& chars, size_t position) noexcept
 {
-    return til::utf16_iterate_next(chars, position);
+    return GraphemeBreak::Next(chars, position);
 }
 
 // It's the counterpart to GraphemeNext. See GraphemeNext.
 size_t TextBuffer::GraphemePrev(const std::wstring_view& chars, size_t position) noexcept
 {
-    return til::utf16_iterate_prev(chars, position);
+    return GraphemeBreak::Prev(chars, position);
 }
 
 // Ever wondered how much space a piece of text needs before inserting it? This function will tell you!
@@ -445,42 +609,60 @@ size_t TextBuffer::FitTextIntoColumns(const std::wstring_view& chars, til::Coord
     {
     }
 
-    const auto dist = gsl::narrow_cast<size_t>(it - beg);
-    auto col = gsl::narrow_cast<til::CoordType>(dist);
-
-    if (it == asciiEnd) [[likely]]
+    if (it == asciiEnd && (it == end || *it < 0x80)) [[likely]]
     {
-        columns = col;
+        const auto dist = gsl::narrow_cast<size_t>(it - beg);
+        columns = gsl::narrow_cast<til::CoordType>(dist);
         return dist;
     }
 
+    // The last ASCII character may be the base of a grapheme cluster, like "e" followed by U+0301,
+    // in which case it needs to be measured as a whole by the slow-path below.
+    if (it != beg)
+    {
+        --it;
+    }
+
+    const auto size = chars.size();
+    auto pos = gsl::narrow_cast<size_t>(it - beg);
+    auto col = gsl::narrow_cast<til::CoordType>(pos);
+    size_t trivialEnd = 0;
+
     // Unicode slow-path where we need to count text and columns separately.
     for (;;)
     {
-        auto ptr = &*it;
-        const auto wch = *ptr;
-        size_t len = 1;
+        size_t next;
 
         col++;
 
-        // Even in our slow-path we can avoid calling IsGlyphFullWidth if the current character is ASCII.
-        // It also allows us to skip the surrogate pair decoding at the same time.
-        if (wch >= 0x80)
+        // See ROW::WriteHelper::_replaceTextUnicode.
+        if (pos >= trivialEnd)
+        {
+            trivialEnd = GraphemeBreak::SkipTrivial(chars, pos);
+        }
+
+        if (pos < trivialEnd)
         {
-            if (til::is_surrogate(wch))
+            const auto wch = til::at(chars, pos);
+            next = pos + 1;
+
+            // Even in our slow-path we can avoid calling IsGlyphFullWidth if the current character is ASCII.
+            if (wch >= 0x80)
             {
-                const auto it2 = it + 1;
-                if (til::is_leading_surrogate(wch) && it2 != end && til::is_trailing_surrogate(*it2))
-                {
-                    len = 2;
-                }
-                else
-                {
-                    ptr = &UNICODE_REPLACEMENT;
-                }
+                col += IsGlyphFullWidth(wch);
+            }
+        }
+        else
+        {
+            next = GraphemeBreak::NextBounded(chars, pos, ROW::MaxClusterLength);
+
+            auto glyph = chars.substr(pos, next - pos);
+            if (glyph.size() == 1 && til::is_surrogate(glyph.front()))
+            {
+                glyph = { &UNICODE_REPLACEMENT, 1 };
             }
 
-            col += IsGlyphFullWidth({ ptr, len });
+            col += IsGlyphFullWidth(glyph);
         }
 
         // If we ran out of columns, we need to always return `columnLimit` and not `cols`,
@@ -490,15 +672,15 @@ size_t TextBuffer::FitTextIntoColumns(const std::wstring_view& chars, til::Coord
         if (col > columnLimit)
         {
             columns = columnLimit;
-            return gsl::narrow_cast<size_t>(it - beg);
+            return pos;
         }
 
         // But if we simply ran out of text we just need to return the actual number of columns.
-        it += len;
-        if (it == end)
+        pos = next;
+        if (pos == size)
         {
             columns = col;
-            return chars.size();
+            return size;
         }
     }
 }
@@ -863,11 +1045,11 @@ void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
         _renderer.TriggerFlush(true);
     }
 
+    // First, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
+    GetMutableRowByOffset(0).Reset(fillAttributes);
+
     // Prune hyperlinks to delete obsolete references
     _PruneHyperlinks();
-
-    // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
-    GetMutableRowByOffset(0).Reset(fillAttributes);
     {
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
@@ -1056,6 +1238,55 @@ uint64_t TextBuffer::GetLastMutationId() const noexcept
     return _lastMutationId;
 }
 
+// Returns the generation of the given row: The value of GetLastMutationId() right after it was last modified.
+// Scrolling the buffer doesn't modify rows, it only changes which row is at a given offset. See GetFirstRowIndex().
+uint64_t TextBuffer::GetRowGeneration(const til::CoordType y) const
+{
+    auto generation = _allRowsGeneration;
+    if (!_rowGenerations.empty())
+    {
+        // Same as _getRow(), but without committing the ROW.
+        auto offset = (_firstRow + y) % _height;
+        if (offset < 0)
+        {
+            offset += _height;
+        }
+        generation = std::max(generation, til::at(_rowGenerations, gsl::narrow_cast<size_t>(offset) + 1).generation);
+    }
+    return generation;
+}
+
+// Returns the rows, as offsets for GetRowByOffset() in ascending order, that were modified after the given
+// generation, which is a value previously returned by GetLastMutationId(). This allows consumers that cache
+// information about the buffer contents (search results, detected URLs, etc.) to only update the changed rows.
+// The cost is proportional to the number of changed rows, not the size of the buffer.
+std::vector<til::CoordType> TextBuffer::GetRowsChangedSince(const uint64_t generation) const
+{
+    std::vector<til::CoordType> rows;
+
+    if (generation < _allRowsGeneration)
+    {
+        rows.resize(_height);
+        std::iota(rows.begin(), rows.end(), 0);
+        return rows;
+    }
+
+    for (auto index = _rowGenerationsTail; index != RowGeneration::None;)
+    {
+        const auto& entry = til::at(_rowGenerations, index);
+        if (entry.generation <= generation)
+        {
+            break;
+        }
+        // The inverse of _getRow(): Offset 0 is the scratchpad row, which is never handed out by GetMutableRowByOffset().
+        rows.emplace_back((gsl::narrow_cast<til::CoordType>(index) - 1 - _firstRow + _height) % _height);
+        index = entry.prev;
+    }
+
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
 const TextAttribute& TextBuffer::GetCurrentAttributes() const noexcept
 {
     return _currentAttributes;
@@ -1148,6 +1379,10 @@ void TextBuffer::Reset() noexcept
 {
     _decommit();
     _initialAttributes = _currentAttributes;
+    // With all ROWs gone, no IDs are in use anymore.
+    _attributeTable->Reset(_initialAttributes);
+    _initialAttributesId = 0;
+    _recountHyperlinks();
 }
 
 void TextBuffer::ClearScrollback(const til::CoordType start, const til::CoordType height)
@@ -1160,6 +1395,9 @@ void TextBuffer::ClearScrollback(const til::CoordType start, const til::CoordTyp
     if (height <= 0)
     {
         _decommit();
+        _attributeTable->Reset(_initialAttributes);
+        _initialAttributesId = 0;
+        _recountHyperlinks();
         return;
     }
 
@@ -1176,7 +1414,7 @@ void TextBuffer::ClearScrollback(const til::CoordType start, const til::CoordTyp
     const auto end = _estimateOffsetOfLastCommittedRow();
     for (auto y = height; y <= end; ++y)
     {
-        GetMutableRowByOffset(y).Reset(_initialAttributes);
+        GetMutableRowByOffset(y).Reset(_initialAttributesId);
     }
 
     ScrollMarks(-start);
@@ -1212,10 +1450,14 @@ void TextBuffer::ResizeTraditional(til::size newSize)
     }
 
     // NOTE: Keep this in sync with _reserve().
+    // Our ROWs must be destroyed before our arena is returned to the pool.
+    _destroy();
     _buffer = std::move(newBuffer._buffer);
     _bufferEnd = newBuffer._bufferEnd;
     _commitWatermark = newBuffer._commitWatermark;
+    _attributeTable = std::move(newBuffer._attributeTable);
     _initialAttributes = newBuffer._initialAttributes;
+    _initialAttributesId = newBuffer._initialAttributesId;
     _bufferRowStride = newBuffer._bufferRowStride;
     _bufferOffsetChars = newBuffer._bufferOffsetChars;
     _bufferOffsetCharOffsets = newBuffer._bufferOffsetCharOffsets;
@@ -1223,6 +1465,10 @@ void TextBuffer::ResizeTraditional(til::size newSize)
     _height = newBuffer._height;
 
     _SetFirstRowIndex(0);
+    _wordIndex.Clear();
+    _touchAllRows();
+    // The ROWs have been replaced and some hyperlinks may have been cut off.
+    _recountHyperlinks();
 }
 
 void TextBuffer::SetAsActiveBuffer(const bool isActiveBuffer) noexcept
@@ -1298,7 +1544,44 @@ void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
 // - the delimiter class for the given char
 DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const
 {
-    return GetRowByOffset(pos.y).DelimiterClassAt(pos.x, wordDelimiters);
+    const auto& row = GetRowByOffset(pos.y);
+    return _wordIndex.ClassAt(row, _getRowOffset(row), wordDelimiters, pos.x);
+}
+
+// Returns the first position in [pos, end) whose delimiter class is cls (match = true) or isn't cls (match = false).
+// Returns end if there's none. Whole rows are skipped with a bit scan over the _wordIndex.
+til::point TextBuffer::_FindNextDelimiterClass(const til::point pos, const til::point end, const std::wstring_view wordDelimiters, const DelimiterClass cls, const bool match) const
+{
+    for (auto y = pos.y, x = pos.x; y < end.y || (y == end.y && x < end.x); ++y, x = 0)
+    {
+        const auto& row = GetRowByOffset(y);
+        const auto column = _wordIndex.FindNext(row, _getRowOffset(row), wordDelimiters, x, cls, match);
+        if (y == end.y)
+        {
+            return column < end.x ? til::point{ column, y } : end;
+        }
+        if (column < _width)
+        {
+            return { column, y };
+        }
+    }
+    return end;
+}
+
+// Returns the last position in [origin, pos] whose delimiter class is cls (match = true) or isn't cls (match = false).
+// Returns nullopt if there's none.
+std::optional<til::point> TextBuffer::_FindPreviousDelimiterClass(const til::point pos, const std::wstring_view wordDelimiters, const DelimiterClass cls, const bool match) const
+{
+    for (auto y = pos.y, x = pos.x; y >= 0; --y, x = _width - 1)
+    {
+        const auto& row = GetRowByOffset(y);
+        const auto column = _wordIndex.FindPrevious(row, _getRowOffset(row), wordDelimiters, x, cls, match);
+        if (column >= 0)
+        {
+            return til::point{ column, y };
+        }
+    }
+    return std::nullopt;
 }
 
 // Method Description:
@@ -1364,36 +1647,29 @@ til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_
 // - The til::point for the first character on the current/previous READABLE "word" (inclusive)
 til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const
 {
-    auto result = target;
     const auto bufferSize = GetSize();
 
     // ignore left boundary. Continue until readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    const auto lastRegular = _FindPreviousDelimiterClass(target, wordDelimiters, DelimiterClass::RegularChar, true);
+    if (!lastRegular)
     {
-        if (result == bufferSize.Origin())
-        {
-            //looped around and hit origin (no word between origin and target)
-            return result;
-        }
-        bufferSize.DecrementInBounds(result);
+        //looped around and hit origin (no word between origin and target)
+        return bufferSize.Origin();
     }
 
     // make sure we expand to the left boundary or the beginning of the word
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
+    auto result = _FindPreviousDelimiterClass(*lastRegular, wordDelimiters, DelimiterClass::RegularChar, false);
+    if (!result)
     {
-        if (result == bufferSize.Origin())
-        {
-            // first char in buffer is a RegularChar
-            // we can't move any further back
-            return result;
-        }
-        bufferSize.DecrementInBounds(result);
+        // first char in buffer is a RegularChar
+        // we can't move any further back
+        return bufferSize.Origin();
     }
 
     // move off of delimiter
-    bufferSize.IncrementInBounds(result);
+    bufferSize.IncrementInBounds(*result);
 
-    return result;
+    return *result;
 }
 
 // Method Description:
@@ -1405,30 +1681,37 @@ til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, co
 // - The til::point for the first character on the current word or delimiter run (stopped by the left margin)
 til::point TextBuffer::_GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const
 {
-    auto result = target;
     const auto bufferSize = GetSize();
 
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto initialDelimiter = _GetDelimiterClassAt(target, wordDelimiters);
     const bool isControlChar = initialDelimiter == DelimiterClass::ControlChar;
 
     // expand left until we hit the left boundary or a different delimiter class
-    while (result != bufferSize.Origin() && _GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter)
+    std::optional<til::point> delimiter;
+    if (isControlChar)
     {
         //prevent selection wrapping on whitespace selection
-        if (isControlChar && result.x == bufferSize.Left())
+        const auto& row = GetRowByOffset(target.y);
+        const auto column = _wordIndex.FindPrevious(row, _getRowOffset(row), wordDelimiters, target.x, initialDelimiter, false);
+        if (column < 0)
         {
-            break;
+            return { bufferSize.Left(), target.y };
         }
-        bufferSize.DecrementInBounds(result);
+        delimiter = til::point{ column, target.y };
     }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    else
     {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
+        delimiter = _FindPreviousDelimiterClass(target, wordDelimiters, initialDelimiter, false);
+        if (!delimiter)
+        {
+            return bufferSize.Origin();
+        }
     }
 
-    return result;
+    // move off of delimiter
+    bufferSize.IncrementInBounds(*delimiter);
+
+    return *delimiter;
 }
 
 // Method Description:
@@ -1496,17 +1779,14 @@ til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, cons
     }
     else
     {
-        while (result != limit && result != bufferSize.BottomRightInclusive() && _GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
-        {
-            // Iterate through readable text
-            bufferSize.IncrementInBounds(result);
-        }
+        // Don't move past the limit or the last cell of the buffer, whichever comes first.
+        const auto end = bufferSize.CompareInBounds(limit, bufferSize.BottomRightInclusive(), true) < 0 ? limit : bufferSize.BottomRightInclusive();
 
-        while (result != limit && result != bufferSize.BottomRightInclusive() && _GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-        {
-            // expand to the beginning of the NEXT word
-            bufferSize.IncrementInBounds(result);
-        }
+        // Iterate through readable text
+        result = _FindNextDelimiterClass(result, end, wordDelimiters, DelimiterClass::RegularChar, false);
+
+        // expand to the beginning of the NEXT word
+        result = _FindNextDelimiterClass(result, end, wordDelimiters, DelimiterClass::RegularChar, true);
 
         // Special case: we tried to move one past the end of the buffer
         // Manually increment onto the EndExclusive point.
@@ -1530,73 +1810,136 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
 {
     const auto bufferSize = GetSize();
 
-    auto result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto initialDelimiter = _GetDelimiterClassAt(target, wordDelimiters);
     const bool isControlChar = initialDelimiter == DelimiterClass::ControlChar;
 
     // expand right until we hit the right boundary as a ControlChar or a different delimiter class
-    while (result != bufferSize.BottomRightInclusive() && _GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter)
+    if (isControlChar)
     {
-        if (isControlChar && result.x == bufferSize.RightInclusive())
-        {
-            break;
-        }
-        bufferSize.IncrementInBoundsCircular(result);
+        const auto& row = GetRowByOffset(target.y);
+        const auto column = _wordIndex.FindNext(row, _getRowOffset(row), wordDelimiters, target.x, initialDelimiter, false);
+        // move off of delimiter (or the right boundary)
+        return { column - 1, target.y };
     }
 
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    auto result = _FindNextDelimiterClass(target, bufferSize.EndExclusive(), wordDelimiters, initialDelimiter, false);
+    if (result == bufferSize.EndExclusive())
     {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
+        return bufferSize.BottomRightInclusive();
     }
 
+    // move off of delimiter
+    bufferSize.DecrementInBounds(result);
+
     return result;
 }
 
-void TextBuffer::_PruneHyperlinks()
+// Releases the hyperlink references of a ROW that is about to be modified and lists it as dirty. See _hyperlinks.
+void TextBuffer::_releaseRowHyperlinks(const ROW& row)
 {
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
-    // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = GetRowByOffset(0).GetHyperlinks();
+    const auto offset = _getRowOffset(row);
 
-    if (!hyperlinks.empty())
+    if (_hyperlinkRowIsDirty.empty())
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
+        _hyperlinkRowIsDirty.resize(gsl::narrow_cast<size_t>(_height) + 1);
+    }
+
+    auto& dirty = til::at(_hyperlinkRowIsDirty, offset);
+    if (dirty)
+    {
+        return;
+    }
+
+    // Allocate upfront, so that we can't fail halfway through releasing the references.
+    const auto& runs = row.Attributes().runs();
+    _hyperlinkUnreferenced.reserve(_hyperlinkUnreferenced.size() + runs.size());
+    _hyperlinkDirtyRows.emplace_back(gsl::narrow_cast<uint32_t>(offset));
+    dirty = 1;
 
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (til::CoordType i = 1; i < total; ++i)
+    for (const auto& run : runs)
+    {
+        const auto id = _attributeTable->Get(run.value).GetHyperlinkId();
+        if (id != 0 && _hyperlinks.Release(id))
         {
-            const auto nextRowRefs = GetRowByOffset(i).GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
+            _hyperlinkUnreferenced.emplace_back(id);
+        }
+    }
+}
+
+// Adds a reference for each run of attributes in the ROW that is a hyperlink.
+void TextBuffer::_addRowHyperlinks(const ROW& row) noexcept
+{
+    for (const auto& run : row.Attributes().runs())
+    {
+        const auto id = _attributeTable->Get(run.value).GetHyperlinkId();
+        if (id != 0)
+        {
+            _hyperlinks.AddRef(id);
         }
+    }
+}
+
+// Counts the hyperlink references of all ROWs modified since the last call and then deletes all hyperlinks that
+// are no longer referenced. This way, obsolete hyperlink references are cleared from our hyperlink map instead of
+// hanging around, without having to search the entire buffer for references whenever a hyperlink scrolls out of it.
+void TextBuffer::_PruneHyperlinks() noexcept
+{
+    if (_hyperlinkUnreferenced.empty())
+    {
+        return;
+    }
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    for (const auto offset : _hyperlinkDirtyRows)
+    {
+        til::at(_hyperlinkRowIsDirty, offset) = 0;
+        _addRowHyperlinks(*reinterpret_cast<const ROW*>(_buffer.get() + _bufferRowStride * offset));
+    }
+#pragma warning(pop)
+    _hyperlinkDirtyRows.clear();
 
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
+    // The current attributes aren't part of any ROW yet, but their hyperlink will be once text is written.
+    const auto current = _currentAttributes.GetHyperlinkId();
+    std::erase_if(_hyperlinkUnreferenced, [&](const uint16_t id) {
+        if (id == current && _hyperlinks.Contains(id))
+        {
+            return false;
+        }
+        if (_hyperlinks.GetRefCount(id) == 0)
         {
-            RemoveHyperlinkFromMap(hyperlinkReference);
+            _hyperlinks.Erase(id);
         }
+        return true;
+    });
+}
+
+// Counts the hyperlink references of all ROWs from scratch and deletes all hyperlinks that are no longer referenced.
+// This is used whenever the ROWs got replaced without going through GetMutableRowByOffset().
+void TextBuffer::_recountHyperlinks() noexcept
+{
+    _hyperlinks.ClearRefs();
+    _hyperlinkRowIsDirty.clear();
+    _hyperlinkDirtyRows.clear();
+    _hyperlinkUnreferenced.clear();
+
+    if (_hyperlinks.empty())
+    {
+        return;
+    }
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    // The scratchpad row at offset 0 isn't part of the buffer and is skipped.
+    for (auto it = _buffer.get() + _bufferRowStride; it < _commitWatermark; it += _bufferRowStride)
+    {
+        _addRowHyperlinks(*reinterpret_cast<const ROW*>(it));
     }
+#pragma warning(pop)
+
+    _hyperlinks.EraseUnreferenced(_currentAttributes.GetHyperlinkId());
 }
 
 // Method Description:
@@ -2044,6 +2387,28 @@ std::tuple<til::CoordType, til::CoordType, bool> TextBuffer::_RowCopyHelper(cons
     return { rowBeg, rowEnd, addLineBreak };
 }
 
+namespace
+{
+    // The Serialize*() functions accumulate their output in a buffer of about this size before passing it to the sink.
+    // This keeps the memory usage constant no matter how large the selection is, while making the cost of the sink negligible.
+    constexpr size_t serializeChunkSize = 64 * 1024;
+
+    constexpr std::string_view htmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
+    constexpr std::string_view htmlFooter = "</BODY></HTML>";
+
+    // Passes the chunk to the sink once it's full (or if `force` is set) and clears it.
+    // Callers must only call this between rows or runs, so that surrogate pairs are never split up.
+    template<typename T, typename Sink>
+    void flushChunk(std::basic_string<T>& chunk, const Sink& sink, const bool force = false)
+    {
+        if (chunk.size() >= serializeChunkSize || (force && !chunk.empty()))
+        {
+            sink(std::basic_string_view<T>{ chunk });
+            chunk.clear();
+        }
+    }
+}
+
 // Routine Description:
 // - Retrieves the text data from the buffer and presents it in a clipboard-ready format.
 // Arguments:
@@ -2051,13 +2416,28 @@ std::tuple<til::CoordType, til::CoordType, bool> TextBuffer::_RowCopyHelper(cons
 // Return Value:
 // - The text data from the selected region of the text buffer. Empty if the copy request is invalid.
 std::wstring TextBuffer::GetPlainText(const CopyRequest& req) const
+{
+    std::wstring selectedText;
+    SerializePlainText(req, [&](const std::wstring_view chunk) {
+        selectedText.append(chunk);
+    });
+    return selectedText;
+}
+
+// Routine Description:
+// - Same as GetPlainText(), but passes the text to the sink in chunks instead of returning it all at once.
+// Arguments:
+// - req - the copy request having the bounds of the selected region and other related configuration flags.
+// - sink - receives the text in chunks.
+void TextBuffer::SerializePlainText(const CopyRequest& req, const PlainTextSink& sink) const
 {
     if (req.beg > req.end)
     {
-        return {};
+        return;
     }
 
-    std::wstring selectedText;
+    std::wstring chunk;
+    chunk.reserve(serializeChunkSize + 2 * _width + 2);
 
     for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
     {
@@ -2065,15 +2445,17 @@ std::wstring TextBuffer::GetPlainText(const CopyRequest& req) const
         const auto& [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
 
         // save selected text
-        selectedText += row.GetText(rowBeg, rowEnd);
+        chunk += row.GetText(rowBeg, rowEnd);
 
         if (addLineBreak && iRow != req.end.y)
         {
-            selectedText += L"\r\n";
+            chunk += L"\r\n";
         }
+
+        flushChunk(chunk, sink);
     }
 
-    return selectedText;
+    flushChunk(chunk, sink, true);
 }
 
 // Routine Description:
@@ -2092,12 +2474,8 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
                                 const std::wstring_view fontFaceName,
                                 const COLORREF backgroundColor,
                                 const bool isIntenseBold,
-                                std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept
+                                const AttributeColorsCallback& GetAttributeColors) const noexcept
 {
-    // GH#5347 - Don't provide a title for the generated HTML, as many
-    // web applications will paste the title first, followed by the HTML
-    // content, which is unexpected.
-
     if (req.beg > req.end)
     {
         return {};
@@ -2106,183 +2484,228 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
     try
     {
         std::string htmlBuilder;
+        SerializeHTML(req, fontHeightPoints, fontFaceName, backgroundColor, isIntenseBold, GetAttributeColors, [&](const std::string_view chunk) {
+            htmlBuilder.append(chunk);
+        });
 
-        // First we have to add some standard HTML boiler plate required for
-        // CF_HTML as part of the HTML Clipboard format
-        constexpr std::string_view htmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
-        htmlBuilder += htmlHeader;
-
-        htmlBuilder += "<!--StartFragment -->";
-
-        // apply global style in div element
-        {
-            htmlBuilder += "<DIV STYLE=\"";
-            htmlBuilder += "display:inline-block;";
-            htmlBuilder += "white-space:pre;";
-            fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("background-color:{};"), Utils::ColorToHexString(backgroundColor));
-
-            // even with different font, add monospace as fallback
-            fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("font-family:'{}',monospace;"), til::u16u8(fontFaceName));
-
-            fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("font-size:{}pt;"), fontHeightPoints);
+        // once filled with values, there will be exactly 157 bytes in the clipboard header
+        constexpr size_t ClipboardHeaderSize = 157;
 
-            // note: MS Word doesn't support padding (in this way at least)
-            // todo: customizable padding
-            htmlBuilder += "padding:4px;";
+        // these values are byte offsets from start of clipboard
+        const auto htmlStartPos = ClipboardHeaderSize;
+        const auto htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.length());
+        const auto fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
+        const auto fragEndPos = htmlEndPos - htmlFooter.length();
 
-            htmlBuilder += "\">";
-        }
+        // header required by HTML 0.9 format
+        std::string clipHeaderBuilder;
+        clipHeaderBuilder += "Version:0.9\r\n";
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartHTML:{:0>10}\r\n"), htmlStartPos);
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndHTML:{:0>10}\r\n"), htmlEndPos);
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartFragment:{:0>10}\r\n"), fragStartPos);
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndFragment:{:0>10}\r\n"), fragEndPos);
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartSelection:{:0>10}\r\n"), fragStartPos);
+        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndSelection:{:0>10}\r\n"), fragEndPos);
 
-        for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
-        {
-            const auto& row = GetRowByOffset(iRow);
-            const auto [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
-            const auto rowBegU16 = gsl::narrow_cast<uint16_t>(rowBeg);
-            const auto rowEndU16 = gsl::narrow_cast<uint16_t>(rowEnd);
-            const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
+        return clipHeaderBuilder + htmlBuilder;
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return {};
+    }
+}
 
-            auto x = rowBegU16;
-            for (const auto& [attr, length] : runs)
-            {
-                const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
-                const auto [fg, bg, ul] = GetAttributeColors(attr);
-                const auto fgHex = Utils::ColorToHexString(fg);
-                const auto bgHex = Utils::ColorToHexString(bg);
-                const auto ulHex = Utils::ColorToHexString(ul);
-                const auto ulStyle = attr.GetUnderlineStyle();
-                const auto isUnderlined = ulStyle != UnderlineStyle::NoUnderline;
-                const auto isCrossedOut = attr.IsCrossedOut();
-                const auto isOverlined = attr.IsOverlined();
-
-                htmlBuilder += "<SPAN STYLE=\"";
-                fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("color:{};"), fgHex);
-                fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("background-color:{};"), bgHex);
-
-                if (isIntenseBold && attr.IsIntense())
-                {
-                    htmlBuilder += "font-weight:bold;";
-                }
+// Routine Description:
+// - Generates an HTML document from the selected region of the buffer and passes it to the sink in chunks.
+//   Unlike GenHTML() it doesn't prepend the CF_HTML header, which requires knowing the length of the document.
+// Arguments:
+// - req - the copy request having the bounds of the selected region and other related configuration flags.
+// - fontHeightPoints - the unscaled font height
+// - fontFaceName - the name of the font used
+// - backgroundColor - default background color for characters, also used in padding
+// - isIntenseBold - true if being intense is treated as being bold
+// - GetAttributeColors - function to get the colors of the text attributes as they're rendered
+// - sink - receives the HTML in chunks.
+void TextBuffer::SerializeHTML(const CopyRequest& req,
+                               const int fontHeightPoints,
+                               const std::wstring_view fontFaceName,
+                               const COLORREF backgroundColor,
+                               const bool isIntenseBold,
+                               const AttributeColorsCallback& GetAttributeColors,
+                               const FormattedTextSink& sink) const
+{
+    // GH#5347 - Don't provide a title for the generated HTML, as many
+    // web applications will paste the title first, followed by the HTML
+    // content, which is unexpected.
 
-                if (attr.IsItalic())
-                {
-                    htmlBuilder += "font-style:italic;";
-                }
+    if (req.beg > req.end)
+    {
+        return;
+    }
 
-                if (isCrossedOut || isOverlined)
-                {
-                    fmt::format_to(std::back_inserter(htmlBuilder),
-                                   FMT_COMPILE("text-decoration:{} {} {};"),
-                                   isCrossedOut ? "line-through" : "",
-                                   isOverlined ? "overline" : "",
-                                   fgHex);
-                }
+    std::string htmlBuilder;
+    htmlBuilder.reserve(serializeChunkSize + 4096);
 
-                if (isUnderlined)
-                {
-                    // Since underline, overline and strikethrough use the same css property,
-                    // we cannot apply different colors to them at the same time. However, we
-                    // can achieve the desired result by creating a nested <span> and applying
-                    // underline style and color to it.
-                    htmlBuilder += "\"><SPAN STYLE=\"";
-
-                    switch (ulStyle)
-                    {
-                    case UnderlineStyle::NoUnderline:
-                        break;
-                    case UnderlineStyle::DoublyUnderlined:
-                        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("text-decoration:underline double {};"), ulHex);
-                        break;
-                    case UnderlineStyle::CurlyUnderlined:
-                        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("text-decoration:underline wavy {};"), ulHex);
-                        break;
-                    case UnderlineStyle::DottedUnderlined:
-                        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("text-decoration:underline dotted {};"), ulHex);
-                        break;
-                    case UnderlineStyle::DashedUnderlined:
-                        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("text-decoration:underline dashed {};"), ulHex);
-                        break;
-                    case UnderlineStyle::SinglyUnderlined:
-                    default:
-                        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("text-decoration:underline {};"), ulHex);
-                        break;
-                    }
-                }
+    // First we have to add some standard HTML boiler plate required for
+    // CF_HTML as part of the HTML Clipboard format
+    htmlBuilder += htmlHeader;
 
-                htmlBuilder += "\">";
+    htmlBuilder += "<!--StartFragment -->";
 
-                // text
-                std::string unescapedText;
-                THROW_IF_FAILED(til::u16u8(row.GetText(x, nextX), unescapedText));
-                for (const auto c : unescapedText)
-                {
-                    switch (c)
-                    {
-                    case '<':
-                        htmlBuilder += "&lt;";
-                        break;
-                    case '>':
-                        htmlBuilder += "&gt;";
-                        break;
-                    case '&':
-                        htmlBuilder += "&amp;";
-                        break;
-                    default:
-                        htmlBuilder += c;
-                    }
-                }
+    // apply global style in div element
+    {
+        htmlBuilder += "<DIV STYLE=\"";
+        htmlBuilder += "display:inline-block;";
+        htmlBuilder += "white-space:pre;";
+        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("background-color:{};"), Utils::ColorToHexString(backgroundColor));
 
-                if (isUnderlined)
-                {
-                    // close the nested span we created for underline
-                    htmlBuilder += "</SPAN>";
-                }
+        // even with different font, add monospace as fallback
+        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("font-family:'{}',monospace;"), til::u16u8(fontFaceName));
 
-                htmlBuilder += "</SPAN>";
+        fmt::format_to(std::back_inserter(htmlBuilder), FMT_COMPILE("font-size:{}pt;"), fontHeightPoints);
 
-                // advance to next run of text
-                x = nextX;
-            }
+        // note: MS Word doesn't support padding (in this way at least)
+        // todo: customizable padding
+        htmlBuilder += "padding:4px;";
+
+        htmlBuilder += "\">";
+    }
 
-            // never add line break to the last row.
-            if (addLineBreak && iRow < req.end.y)
+    // The markup that starts a run of text only depends on its attributes.
+    // It's thus built once for each interned attribute, which saves us from
+    // calling GetAttributeColors() and formatting colors for every single run.
+    const auto buildRunStart = [&](const TextAttribute& attr) {
+        std::string markup;
+
+        const auto [fg, bg, ul] = GetAttributeColors(attr);
+        const auto fgHex = Utils::ColorToHexString(fg);
+        const auto bgHex = Utils::ColorToHexString(bg);
+        const auto ulHex = Utils::ColorToHexString(ul);
+        const auto ulStyle = attr.GetUnderlineStyle();
+        const auto isUnderlined = ulStyle != UnderlineStyle::NoUnderline;
+        const auto isCrossedOut = attr.IsCrossedOut();
+        const auto isOverlined = attr.IsOverlined();
+
+        markup += "<SPAN STYLE=\"";
+        fmt::format_to(std::back_inserter(markup), FMT_COMPILE("color:{};"), fgHex);
+        fmt::format_to(std::back_inserter(markup), FMT_COMPILE("background-color:{};"), bgHex);
+
+        if (isIntenseBold && attr.IsIntense())
+        {
+            markup += "font-weight:bold;";
+        }
+
+        if (attr.IsItalic())
+        {
+            markup += "font-style:italic;";
+        }
+
+        if (isCrossedOut || isOverlined)
+        {
+            fmt::format_to(std::back_inserter(markup),
+                           FMT_COMPILE("text-decoration:{} {} {};"),
+                           isCrossedOut ? "line-through" : "",
+                           isOverlined ? "overline" : "",
+                           fgHex);
+        }
+
+        if (isUnderlined)
+        {
+            // Since underline, overline and strikethrough use the same css property,
+            // we cannot apply different colors to them at the same time. However, we
+            // can achieve the desired result by creating a nested <span> and applying
+            // underline style and color to it.
+            markup += "\"><SPAN STYLE=\"";
+
+            switch (ulStyle)
             {
-                htmlBuilder += "<BR>";
+            case UnderlineStyle::NoUnderline:
+                break;
+            case UnderlineStyle::DoublyUnderlined:
+                fmt::format_to(std::back_inserter(markup), FMT_COMPILE("text-decoration:underline double {};"), ulHex);
+                break;
+            case UnderlineStyle::CurlyUnderlined:
+                fmt::format_to(std::back_inserter(markup), FMT_COMPILE("text-decoration:underline wavy {};"), ulHex);
+                break;
+            case UnderlineStyle::DottedUnderlined:
+                fmt::format_to(std::back_inserter(markup), FMT_COMPILE("text-decoration:underline dotted {};"), ulHex);
+                break;
+            case UnderlineStyle::DashedUnderlined:
+                fmt::format_to(std::back_inserter(markup), FMT_COMPILE("text-decoration:underline dashed {};"), ulHex);
+                break;
+            case UnderlineStyle::SinglyUnderlined:
+            default:
+                fmt::format_to(std::back_inserter(markup), FMT_COMPILE("text-decoration:underline {};"), ulHex);
+                break;
             }
         }
 
-        htmlBuilder += "</DIV>";
+        markup += "\">";
+        return markup;
+    };
 
-        htmlBuilder += "<!--EndFragment -->";
+    // Indexed by TextAttributeId. An empty string means that it hasn't been built yet.
+    std::vector<std::string> runStarts;
+    std::string scratch;
 
-        constexpr std::string_view HtmlFooter = "</BODY></HTML>";
-        htmlBuilder += HtmlFooter;
+    for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+    {
+        const auto& row = GetRowByOffset(iRow);
+        const auto [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
+        const auto rowBegU16 = gsl::narrow_cast<uint16_t>(rowBeg);
+        const auto rowEndU16 = gsl::narrow_cast<uint16_t>(rowEnd);
+        const auto& attrTable = row.AttributeTable();
+        const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
+
+        auto x = rowBegU16;
+        for (const auto& [attrId, length] : runs)
+        {
+            const auto& attr = attrTable.Get(attrId);
+            const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
 
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
+            if (attrId >= runStarts.size())
+            {
+                runStarts.resize(attrId + size_t{ 1 });
+            }
+            auto& runStart = til::at(runStarts, attrId);
+            if (runStart.empty())
+            {
+                runStart = buildRunStart(attr);
+            }
+            htmlBuilder += runStart;
 
-        // these values are byte offsets from start of clipboard
-        const auto htmlStartPos = ClipboardHeaderSize;
-        const auto htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.length());
-        const auto fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
-        const auto fragEndPos = htmlEndPos - HtmlFooter.length();
+            // text
+            _AppendHTMLText(htmlBuilder, scratch, row.GetText(x, nextX));
 
-        // header required by HTML 0.9 format
-        std::string clipHeaderBuilder;
-        clipHeaderBuilder += "Version:0.9\r\n";
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartHTML:{:0>10}\r\n"), htmlStartPos);
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndHTML:{:0>10}\r\n"), htmlEndPos);
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartFragment:{:0>10}\r\n"), fragStartPos);
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndFragment:{:0>10}\r\n"), fragEndPos);
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartSelection:{:0>10}\r\n"), fragStartPos);
-        fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndSelection:{:0>10}\r\n"), fragEndPos);
+            if (attr.GetUnderlineStyle() != UnderlineStyle::NoUnderline)
+            {
+                // close the nested span we created for underline
+                htmlBuilder += "</SPAN>";
+            }
 
-        return clipHeaderBuilder + htmlBuilder;
-    }
-    catch (...)
-    {
-        LOG_HR(wil::ResultFromCaughtException());
-        return {};
+            htmlBuilder += "</SPAN>";
+
+            // advance to next run of text
+            x = nextX;
+        }
+
+        // never add line break to the last row.
+        if (addLineBreak && iRow < req.end.y)
+        {
+            htmlBuilder += "<BR>";
+        }
+
+        flushChunk(htmlBuilder, sink);
     }
+
+    htmlBuilder += "</DIV>";
+
+    htmlBuilder += "<!--EndFragment -->";
+
+    htmlBuilder += htmlFooter;
+
+    flushChunk(htmlBuilder, sink, true);
 }
 
 // Routine Description:
@@ -2303,181 +2726,267 @@ std::string TextBuffer::GenRTF(const CopyRequest& req,
                                const std::wstring_view fontFaceName,
                                const COLORREF backgroundColor,
                                const bool isIntenseBold,
-                               std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept
+                               const AttributeColorsCallback& GetAttributeColors) const noexcept
 {
-    if (req.beg > req.end)
+    try
     {
+        std::string rtfBuilder;
+        SerializeRTF(req, fontHeightPoints, fontFaceName, backgroundColor, isIntenseBold, GetAttributeColors, [&](const std::string_view chunk) {
+            rtfBuilder.append(chunk);
+        });
+        return rtfBuilder;
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
         return {};
     }
+}
 
-    try
+// Routine Description:
+// - Same as GenRTF(), but passes the RTF document to the sink in chunks instead of returning it all at once.
+// Arguments:
+// - req - the copy request having the bounds of the selected region and other related configuration flags.
+// - fontHeightPoints - the unscaled font height
+// - fontFaceName - the name of the font used
+// - backgroundColor - default background color for characters, also used in padding
+// - isIntenseBold - true if being intense is treated as being bold
+// - GetAttributeColors - function to get the colors of the text attributes as they're rendered
+// - sink - receives the RTF in chunks.
+void TextBuffer::SerializeRTF(const CopyRequest& req,
+                              const int fontHeightPoints,
+                              const std::wstring_view fontFaceName,
+                              const COLORREF backgroundColor,
+                              const bool isIntenseBold,
+                              const AttributeColorsCallback& GetAttributeColors,
+                              const FormattedTextSink& sink) const
+{
+    if (req.beg > req.end)
     {
-        std::string rtfBuilder;
+        return;
+    }
 
-        // start rtf
-        rtfBuilder += "{";
-
-        // Standard RTF header.
-        // This is similar to the header generated by WordPad.
-        // \ansi:
-        //   Specifies that the ANSI char set is used in the current doc.
-        // \ansicpg1252:
-        //   Represents the ANSI code page which is used to perform
-        //   the Unicode to ANSI conversion when writing RTF text.
-        // \deff0:
-        //   Specifies that the default font for the document is the one
-        //   at index 0 in the font table.
-        // \nouicompat:
-        //   Some features are blocked by default to maintain compatibility
-        //   with older programs (Eg. Word 97-2003). `nouicompat` disables this
-        //   behavior, and unblocks these features. See: Spec 1.9.1, Pg. 51.
-        rtfBuilder += "\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
-
-        // font table
-        // Brace escape: add an extra brace (of same kind) after a brace to escape it within the format string.
-        fmt::format_to(std::back_inserter(rtfBuilder), FMT_COMPILE("{{\\fonttbl{{\\f0\\fmodern\\fcharset0 {};}}}}"), til::u16u8(fontFaceName));
-
-        // map to keep track of colors:
-        // keys are colors represented by COLORREF
-        // values are indices of the corresponding colors in the color table
-        std::unordered_map<COLORREF, size_t> colorMap;
-
-        // RTF color table
-        std::string colorTableBuilder;
-        colorTableBuilder += "{\\colortbl ;";
-
-        const auto getColorTableIndex = [&](const COLORREF color) -> size_t {
-            // Exclude the 0 index for the default color, and start with 1.
-
-            const auto [it, inserted] = colorMap.emplace(color, colorMap.size() + 1);
-            if (inserted)
-            {
-                const auto red = static_cast<int>(GetRValue(color));
-                const auto green = static_cast<int>(GetGValue(color));
-                const auto blue = static_cast<int>(GetBValue(color));
-                fmt::format_to(std::back_inserter(colorTableBuilder), FMT_COMPILE("\\red{}\\green{}\\blue{};"), red, green, blue);
-            }
-            return it->second;
-        };
+    std::string rtfBuilder;
+    rtfBuilder.reserve(serializeChunkSize + 4096);
+
+    // start rtf
+    rtfBuilder += "{";
+
+    // Standard RTF header.
+    // This is similar to the header generated by WordPad.
+    // \ansi:
+    //   Specifies that the ANSI char set is used in the current doc.
+    // \ansicpg1252:
+    //   Represents the ANSI code page which is used to perform
+    //   the Unicode to ANSI conversion when writing RTF text.
+    // \deff0:
+    //   Specifies that the default font for the document is the one
+    //   at index 0 in the font table.
+    // \nouicompat:
+    //   Some features are blocked by default to maintain compatibility
+    //   with older programs (Eg. Word 97-2003). `nouicompat` disables this
+    //   behavior, and unblocks these features. See: Spec 1.9.1, Pg. 51.
+    rtfBuilder += "\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
+
+    // font table
+    // Brace escape: add an extra brace (of same kind) after a brace to escape it within the format string.
+    fmt::format_to(std::back_inserter(rtfBuilder), FMT_COMPILE("{{\\fonttbl{{\\f0\\fmodern\\fcharset0 {};}}}}"), til::u16u8(fontFaceName));
+
+    // map to keep track of colors:
+    // keys are colors represented by COLORREF
+    // values are indices of the corresponding colors in the color table
+    std::unordered_map<COLORREF, size_t> colorMap;
+
+    // RTF color table
+    rtfBuilder += "{\\colortbl ;";
+
+    const auto getColorTableIndex = [&](const COLORREF color) -> size_t {
+        // Exclude the 0 index for the default color, and start with 1.
+
+        const auto [it, inserted] = colorMap.emplace(color, colorMap.size() + 1);
+        if (inserted)
+        {
+            const auto red = static_cast<int>(GetRValue(color));
+            const auto green = static_cast<int>(GetGValue(color));
+            const auto blue = static_cast<int>(GetBValue(color));
+            fmt::format_to(std::back_inserter(rtfBuilder), FMT_COMPILE("\\red{}\\green{}\\blue{};"), red, green, blue);
+        }
+        return it->second;
+    };
+
+    const auto backgroundColorIndex = getColorTableIndex(backgroundColor);
+
+    // The control words that start a run of text only depend on its attributes.
+    // It's thus built once for each interned attribute, which saves us from
+    // calling GetAttributeColors() and looking up colors for every single run.
+    const auto buildRunStart = [&](const TextAttribute& attr) {
+        std::string controlWords;
 
-        // content
-        std::string contentBuilder;
+        const auto [fg, bg, ul] = GetAttributeColors(attr);
+        const auto fgIdx = getColorTableIndex(fg);
+        const auto bgIdx = getColorTableIndex(bg);
+        const auto ulIdx = getColorTableIndex(ul);
+        const auto ulStyle = attr.GetUnderlineStyle();
 
-        // \viewkindN: View mode of the document to be used. N=4 specifies that the document is in Normal view. (maybe unnecessary?)
-        // \ucN: Number of unicode fallback characters after each codepoint. (global)
-        contentBuilder += "\\viewkind4\\uc1";
+        // start an RTF group that can be closed later to restore the
+        // default attribute.
+        controlWords += "{";
 
-        // paragraph styles
-        // \pard: paragraph description
-        // \slmultN: line-spacing multiple
-        // \fN: font to be used for the paragraph, where N is the font index in the font table
-        contentBuilder += "\\pard\\slmult1\\f0";
+        fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\cf{}"), fgIdx);
+        fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\chshdng0\\chcbpat{}"), bgIdx);
 
-        // \fsN: specifies font size in half-points. E.g. \fs20 results in a font
-        // size of 10 pts. That's why, font size is multiplied by 2 here.
-        fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\fs{}"), std::to_string(2 * fontHeightPoints));
+        if (isIntenseBold && attr.IsIntense())
+        {
+            controlWords += "\\b";
+        }
+
+        if (attr.IsItalic())
+        {
+            controlWords += "\\i";
+        }
 
-        // Set the background color for the page. But the standard way (\cbN) to do
-        // this isn't supported in Word. However, the following control words sequence
-        // works in Word (and other RTF editors also) for applying the text background
-        // color. See: Spec 1.9.1, Pg. 23.
-        fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\chshdng0\\chcbpat{}"), getColorTableIndex(backgroundColor));
+        if (attr.IsCrossedOut())
+        {
+            controlWords += "\\strike";
+        }
 
-        for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+        switch (ulStyle)
         {
-            const auto& row = GetRowByOffset(iRow);
-            const auto [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
-            const auto rowBegU16 = gsl::narrow_cast<uint16_t>(rowBeg);
-            const auto rowEndU16 = gsl::narrow_cast<uint16_t>(rowEnd);
-            const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
+        case UnderlineStyle::NoUnderline:
+            break;
+        case UnderlineStyle::DoublyUnderlined:
+            fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\uldb\\ulc{}"), ulIdx);
+            break;
+        case UnderlineStyle::CurlyUnderlined:
+            fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\ulwave\\ulc{}"), ulIdx);
+            break;
+        case UnderlineStyle::DottedUnderlined:
+            fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\uld\\ulc{}"), ulIdx);
+            break;
+        case UnderlineStyle::DashedUnderlined:
+            fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\uldash\\ulc{}"), ulIdx);
+            break;
+        case UnderlineStyle::SinglyUnderlined:
+        default:
+            fmt::format_to(std::back_inserter(controlWords), FMT_COMPILE("\\ul\\ulc{}"), ulIdx);
+            break;
+        }
+
+        // RTF commands and the text data must be separated by a space.
+        // Otherwise, if the text begins with a space then that space will
+        // be interpreted as part of the last command, and will be lost.
+        controlWords += " ";
+        return controlWords;
+    };
+
+    // The color table precedes the text, but we only know all colors once we've seen all attributes.
+    // The first pass thus only visits the attribute runs and builds the control words for each of them,
+    // which fills the color table. The second pass below then only needs to copy the text.
+    // Indexed by TextAttributeId. An empty string means that it hasn't been built yet.
+    std::vector<std::string> runStarts;
+
+    for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+    {
+        const auto& row = GetRowByOffset(iRow);
+        const auto [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
+        const auto& attrTable = row.AttributeTable();
+        const auto runs = row.Attributes().slice(gsl::narrow_cast<uint16_t>(rowBeg), gsl::narrow_cast<uint16_t>(rowEnd)).runs();
 
-            auto x = rowBegU16;
-            for (auto& [attr, length] : runs)
+        for (const auto& [attrId, length] : runs)
+        {
+            if (attrId >= runStarts.size())
             {
-                const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
-                const auto [fg, bg, ul] = GetAttributeColors(attr);
-                const auto fgIdx = getColorTableIndex(fg);
-                const auto bgIdx = getColorTableIndex(bg);
-                const auto ulIdx = getColorTableIndex(ul);
-                const auto ulStyle = attr.GetUnderlineStyle();
+                runStarts.resize(attrId + size_t{ 1 });
+            }
+            auto& runStart = til::at(runStarts, attrId);
+            if (runStart.empty())
+            {
+                runStart = buildRunStart(attrTable.Get(attrId));
+            }
+        }
+    }
 
-                // start an RTF group that can be closed later to restore the
-                // default attribute.
-                contentBuilder += "{";
+    // close the color table
+    rtfBuilder += "}";
 
-                fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\cf{}"), fgIdx);
-                fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\chshdng0\\chcbpat{}"), bgIdx);
+    // \viewkindN: View mode of the document to be used. N=4 specifies that the document is in Normal view. (maybe unnecessary?)
+    // \ucN: Number of unicode fallback characters after each codepoint. (global)
+    rtfBuilder += "\\viewkind4\\uc1";
 
-                if (isIntenseBold && attr.IsIntense())
-                {
-                    contentBuilder += "\\b";
-                }
+    // paragraph styles
+    // \pard: paragraph description
+    // \slmultN: line-spacing multiple
+    // \fN: font to be used for the paragraph, where N is the font index in the font table
+    rtfBuilder += "\\pard\\slmult1\\f0";
 
-                if (attr.IsItalic())
-                {
-                    contentBuilder += "\\i";
-                }
+    // \fsN: specifies font size in half-points. E.g. \fs20 results in a font
+    // size of 10 pts. That's why, font size is multiplied by 2 here.
+    fmt::format_to(std::back_inserter(rtfBuilder), FMT_COMPILE("\\fs{}"), std::to_string(2 * fontHeightPoints));
 
-                if (attr.IsCrossedOut())
-                {
-                    contentBuilder += "\\strike";
-                }
+    // Set the background color for the page. But the standard way (\cbN) to do
+    // this isn't supported in Word. However, the following control words sequence
+    // works in Word (and other RTF editors also) for applying the text background
+    // color. See: Spec 1.9.1, Pg. 23.
+    fmt::format_to(std::back_inserter(rtfBuilder), FMT_COMPILE("\\chshdng0\\chcbpat{}"), backgroundColorIndex);
 
-                switch (ulStyle)
-                {
-                case UnderlineStyle::NoUnderline:
-                    break;
-                case UnderlineStyle::DoublyUnderlined:
-                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\uldb\\ulc{}"), ulIdx);
-                    break;
-                case UnderlineStyle::CurlyUnderlined:
-                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\ulwave\\ulc{}"), ulIdx);
-                    break;
-                case UnderlineStyle::DottedUnderlined:
-                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\uld\\ulc{}"), ulIdx);
-                    break;
-                case UnderlineStyle::DashedUnderlined:
-                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\uldash\\ulc{}"), ulIdx);
-                    break;
-                case UnderlineStyle::SinglyUnderlined:
-                default:
-                    fmt::format_to(std::back_inserter(contentBuilder), FMT_COMPILE("\\ul\\ulc{}"), ulIdx);
-                    break;
-                }
+    for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+    {
+        const auto& row = GetRowByOffset(iRow);
+        const auto [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
+        const auto rowBegU16 = gsl::narrow_cast<uint16_t>(rowBeg);
+        const auto rowEndU16 = gsl::narrow_cast<uint16_t>(rowEnd);
+        const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
 
-                // RTF commands and the text data must be separated by a space.
-                // Otherwise, if the text begins with a space then that space will
-                // be interpreted as part of the last command, and will be lost.
-                contentBuilder += " ";
+        auto x = rowBegU16;
+        for (const auto& [attrId, length] : runs)
+        {
+            const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
 
-                const auto unescapedText = row.GetText(x, nextX); // including character at nextX
-                _AppendRTFText(contentBuilder, unescapedText);
+            rtfBuilder += til::at(runStarts, attrId);
 
-                contentBuilder += "}"; // close RTF group
+            const auto unescapedText = row.GetText(x, nextX); // including character at nextX
+            _AppendRTFText(rtfBuilder, unescapedText);
 
-                // advance to next run of text
-                x = nextX;
-            }
+            rtfBuilder += "}"; // close RTF group
 
-            // never add line break to the last row.
-            if (addLineBreak && iRow < req.end.y)
-            {
-                contentBuilder += "\\line";
-            }
+            // advance to next run of text
+            x = nextX;
         }
 
-        // add color table to the final RTF
-        rtfBuilder += colorTableBuilder + "}";
-
-        // add the text content to the final RTF
-        rtfBuilder += contentBuilder + "}";
+        // never add line break to the last row.
+        if (addLineBreak && iRow < req.end.y)
+        {
+            rtfBuilder += "\\line";
+        }
 
-        return rtfBuilder;
+        flushChunk(rtfBuilder, sink);
     }
-    catch (...)
+
+    // end rtf
+    rtfBuilder += "}";
+
+    flushChunk(rtfBuilder, sink, true);
+}
+
+void TextBuffer::_AppendHTMLText(std::string& contentBuilder, std::string& scratch, const std::wstring_view& text)
+{
+    THROW_IF_FAILED(til::u16u8(text, scratch));
+    for (const auto c : scratch)
     {
-        LOG_HR(wil::ResultFromCaughtException());
-        return {};
+        switch (c)
+        {
+        case '<':
+            contentBuilder += "&lt;";
+            break;
+        case '>':
+            contentBuilder += "&gt;";
+            break;
+        case '&':
+            contentBuilder += "&amp;";
+            break;
+        default:
+            contentBuilder += c;
+        }
     }
 }
 
@@ -2554,7 +3063,6 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
 
     const auto oldHeight = std::max(lastRowWithText, oldCursorPos.y) + 1;
     const auto newHeight = newBuffer.GetSize().Height();
-    const auto newWidthU16 = gsl::narrow_cast<uint16_t>(newWidth);
 
     // Copy oldBuffer into newBuffer until oldBuffer has been fully consumed.
     for (; oldY < oldHeight && newY < newYLimit; ++oldY)
@@ -2579,7 +3087,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
             // See the comment marked with "REFLOW_RESET".
             if (newY >= newHeight)
             {
-                newRow.Reset(newBuffer._initialAttributes);
+                newRow.Reset(newBuffer._initialAttributesId);
             }
 
             newRow.CopyFrom(oldRow);
@@ -2646,7 +3154,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
                 {
                     break;
                 }
-                newBuffer.GetMutableRowByOffset(newY).Reset(newBuffer._initialAttributes);
+                newBuffer.GetMutableRowByOffset(newY).Reset(newBuffer._initialAttributesId);
             }
 
             auto& newRow = newBuffer.GetMutableRowByOffset(newY);
@@ -2660,11 +3168,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
             };
             newRow.CopyTextFrom(state);
 
-            const auto& oldAttr = oldRow.Attributes();
-            auto& newAttr = newRow.Attributes();
-            const auto attributes = oldAttr.slice(gsl::narrow_cast<uint16_t>(oldX), oldAttr.size());
-            newAttr.replace(gsl::narrow_cast<uint16_t>(newX), newAttr.size(), attributes);
-            newAttr.resize_trailing_extent(newWidthU16);
+            newRow.CopyAttributesFrom(oldRow, oldX, newX);
 
             if (oldY == oldCursorPos.y && oldCursorPos.x >= oldX)
             {
@@ -2711,9 +3215,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
     {
         auto& oldRow = oldBuffer.GetRowByOffset(oldY);
         auto& newRow = newBuffer.GetMutableRowByOffset(newY);
-        auto& newAttr = newRow.Attributes();
-        newAttr = oldRow.Attributes();
-        newAttr.resize_trailing_extent(newWidthU16);
+        newRow.CopyAttributesFrom(oldRow);
     }
 
     // Since we didn't use IncrementCircularBuffer() we need to compute the proper
@@ -2738,16 +3240,18 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
     newCursor.SetPosition(newCursorPos);
 
     newBuffer._marks = oldBuffer._marks;
+    newBuffer._marksOrigin = oldBuffer._marksOrigin;
+    newBuffer._currentPromptMark = oldBuffer._currentPromptMark;
     newBuffer._trimMarksOutsideBuffer();
 }
 
 // Method Description:
 // - Adds or updates a hyperlink in our hyperlink table
 // Arguments:
-// - The hyperlink URI, the hyperlink id (could be new or old)
+// - The hyperlink URI, the hyperlink id (as returned by GetHyperlinkId)
 void TextBuffer::AddHyperlinkToMap(std::wstring_view uri, uint16_t id)
 {
-    _hyperlinkMap[id] = uri;
+    _hyperlinks.SetUri(id, uri);
 }
 
 // Method Description:
@@ -2755,10 +3259,10 @@ void TextBuffer::AddHyperlinkToMap(std::wstring_view uri, uint16_t id)
 // Arguments:
 // - The hyperlink ID
 // Return Value:
-// - The URI
+// - The URI or an empty string if the ID is unknown
 std::wstring TextBuffer::GetHyperlinkUriFromId(uint16_t id) const
 {
-    return _hyperlinkMap.at(id);
+    return std::wstring{ _hyperlinks.GetUri(id) };
 }
 
 // Method description:
@@ -2766,34 +3270,26 @@ std::wstring TextBuffer::GetHyperlinkUriFromId(uint16_t id) const
 // Arguments:
 // - The user-defined id
 // Return value:
-// - The internal hyperlink ID
+// - The internal hyperlink ID or 0 if all IDs are in use
 uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
 {
-    uint16_t numericId = 0;
-    if (id.empty())
+    // Pruning here ensures that the IDs of hyperlinks that never make it into the buffer get recycled eventually.
+    // (Otherwise that only happens when the buffer scrolls.) It also frees up IDs if we ran out of them.
+    if (_hyperlinkUnreferenced.size() >= 1024)
     {
-        // no custom id specified, return our internal count
-        numericId = _currentHyperlinkId;
-        ++_currentHyperlinkId;
+        _PruneHyperlinks();
     }
-    else
+
+    auto numericId = _hyperlinks.Intern(uri, id);
+    if (numericId == 0)
     {
-        // assign _currentHyperlinkId if the custom id does not already exist
-        std::wstring newId{ id };
-        // hash the URL and add it to the custom ID - GH#7698
-        newId += L"%" + std::to_wstring(til::hash(uri));
-        const auto result = _hyperlinkCustomIdMap.emplace(newId, _currentHyperlinkId);
-        if (result.second)
-        {
-            // the custom id did not already exist
-            ++_currentHyperlinkId;
-        }
-        numericId = (*(result.first)).second;
+        _PruneHyperlinks();
+        numericId = _hyperlinks.Intern(uri, id);
     }
-    // _currentHyperlinkId could overflow, make sure its not 0
-    if (_currentHyperlinkId == 0)
+
+    if (numericId != 0)
     {
-        ++_currentHyperlinkId;
+        _hyperlinkUnreferenced.emplace_back(numericId);
     }
     return numericId;
 }
@@ -2805,15 +3301,7 @@ uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
 // - The ID of the hyperlink to be removed
 void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
 {
-    _hyperlinkMap.erase(id);
-    for (const auto& customIdPair : _hyperlinkCustomIdMap)
-    {
-        if (customIdPair.second == id)
-        {
-            _hyperlinkCustomIdMap.erase(customIdPair.first);
-            break;
-        }
-    }
+    _hyperlinks.Erase(id);
 }
 
 // Method Description:
@@ -2825,26 +3313,18 @@ void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
 // - The custom ID if there was one, empty string otherwise
 std::wstring TextBuffer::GetCustomIdFromId(uint16_t id) const
 {
-    for (auto customIdPair : _hyperlinkCustomIdMap)
-    {
-        if (customIdPair.second == id)
-        {
-            return customIdPair.first;
-        }
-    }
-    return {};
+    return std::wstring{ _hyperlinks.GetCustomId(id) };
 }
 
 // Method Description:
-// - Copies the hyperlink/customID maps of the old buffer into this one,
-//   also copies currentHyperlinkId
+// - Copies the hyperlink/customID maps of the old buffer into this one
+//   and counts the references to them in this buffer
 // Arguments:
 // - The other buffer
 void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 {
-    _hyperlinkMap = other._hyperlinkMap;
-    _hyperlinkCustomIdMap = other._hyperlinkCustomIdMap;
-    _currentHyperlinkId = other._currentHyperlinkId;
+    _hyperlinks = other._hyperlinks;
+    _recountHyperlinks();
 }
 
 // Searches through the entire (committed) text buffer for `needle` and returns the coordinates in absolute coordinates.
@@ -2888,9 +3368,71 @@ std::vector<til::point_span> TextBuffer::SearchText(const std::wstring_view& nee
     return results;
 }
 
-const std::vector<ScrollMark>& TextBuffer::GetMarks() const noexcept
+bool TextBuffer::HasMarks() const noexcept
+{
+    return !_marks.empty();
+}
+
+// Returns all marks in buffer coordinates, sorted by their start. See MarkView.
+TextBuffer::MarkView TextBuffer::GetMarks() const noexcept
 {
-    return _marks;
+    return MarkView{ std::ranges::ref_view{ _marks }, MarkToBuffer{ _marksOrigin } };
+}
+
+// Returns the mark of the current prompt, if any. This isn't necessarily the last mark,
+// as marks added by the UI are sorted in by their position.
+std::optional<ScrollMark> TextBuffer::GetCurrentPromptMark() const noexcept
+{
+    if (_currentPromptMark == SIZE_MAX)
+    {
+        return std::nullopt;
+    }
+    return _markToRelative(til::at(_marks, _currentPromptMark));
+}
+
+// Returns the marks that start between the rows `top` & `bottom`, inclusive, sorted by their start.
+std::vector<ScrollMark> TextBuffer::GetMarksInRange(const til::CoordType top, const til::CoordType bottom) const
+{
+    const auto beg = std::partition_point(_marks.begin(), _marks.end(), [&](const ScrollMark& m) {
+        return m.start.y - _marksOrigin < top;
+    });
+    const auto end = std::partition_point(beg, _marks.end(), [&](const ScrollMark& m) {
+        return m.start.y - _marksOrigin <= bottom;
+    });
+
+    std::vector<ScrollMark> marks;
+    marks.reserve(gsl::narrow_cast<size_t>(end - beg));
+    for (auto it = beg; it != end; ++it)
+    {
+        marks.emplace_back(_markToRelative(*it));
+    }
+    return marks;
+}
+
+// Returns the bottom-most mark that starts above the row `y`, if any.
+std::optional<ScrollMark> TextBuffer::GetPreviousMark(const til::CoordType y) const
+{
+    const auto it = std::partition_point(_marks.begin(), _marks.end(), [&](const ScrollMark& m) {
+        return m.start.y - _marksOrigin < y;
+    });
+    if (it == _marks.begin())
+    {
+        return std::nullopt;
+    }
+    return _markToRelative(*(it - 1));
+}
+
+// Returns the top-most mark that starts below the row `y`, if any.
+std::optional<ScrollMark> TextBuffer::GetNextMark(const til::CoordType y) const
+{
+    const auto it = std::partition_point(_marks.begin(), _marks.end(), [&](const ScrollMark& m) {
+        return m.start.y - _marksOrigin <= y;
+    });
+    if (it == _marks.end())
+    {
+        return std::nullopt;
+    }
+    return _markToRelative(*it);
 }
 
 // Remove all marks between `start` & `end`, inclusive.
@@ -2898,83 +3440,190 @@ void TextBuffer::ClearMarksInRange(
     const til::point start,
     const til::point end)
 {
-    auto inRange = [&start, &end](const ScrollMark& m) {
-        return (m.start >= start && m.start <= end) ||
-               (m.end >= start && m.end <= end);
+    const auto absStart = _markPointToAbsolute(start);
+    const auto absEnd = _markPointToAbsolute(end);
+    auto inRange = [&absStart, &absEnd](const ScrollMark& m) {
+        return (m.start >= absStart && m.start <= absEnd) ||
+               (m.end >= absStart && m.end <= absEnd);
     };
 
-    _marks.erase(std::remove_if(_marks.begin(),
-                                _marks.end(),
-                                inRange),
-                 _marks.end());
+    // Marks that start after `end` can't be in range. Neither can marks that end before `start`, which includes
+    // all marks that start more than _marksMaxHeight rows above it. That leaves a short range of marks to filter.
+    const til::point reach{ 0, gsl::narrow_cast<til::CoordType>(std::max<int64_t>(int64_t{ absStart.y } - _marksMaxHeight, til::CoordTypeMin)) };
+    const auto firstIt = std::partition_point(_marks.begin(), _marks.end(), [&](const ScrollMark& m) {
+        return m.start < reach;
+    });
+    const auto lastIt = std::partition_point(firstIt, _marks.end(), [&](const ScrollMark& m) {
+        return m.start <= absEnd;
+    });
+    const auto first = gsl::narrow_cast<size_t>(firstIt - _marks.begin());
+    const auto last = gsl::narrow_cast<size_t>(lastIt - _marks.begin());
+
+    auto currentPromptMark = _currentPromptMark;
+    if (currentPromptMark != SIZE_MAX && currentPromptMark >= first && currentPromptMark < last)
+    {
+        const auto promptIt = firstIt + (currentPromptMark - first);
+        currentPromptMark = inRange(*promptIt) ? SIZE_MAX : currentPromptMark - gsl::narrow_cast<size_t>(std::count_if(firstIt, promptIt, inRange));
+    }
+
+    const auto keptEnd = std::remove_if(firstIt, lastIt, inRange);
+    const auto removed = gsl::narrow_cast<size_t>(lastIt - keptEnd);
+    _marks.erase(keptEnd, lastIt);
+
+    if (currentPromptMark != SIZE_MAX && currentPromptMark >= last)
+    {
+        currentPromptMark -= removed;
+    }
+
+    // If the current prompt got cleared, fall back to the last mark, like we always used to.
+    _currentPromptMark = (currentPromptMark != SIZE_MAX || _marks.empty()) ? currentPromptMark : _marks.size() - 1;
 }
 void TextBuffer::ClearAllMarks() noexcept
 {
     _marks.clear();
+    _marksOrigin = 0;
+    _marksMaxHeight = 0;
+    _currentPromptMark = SIZE_MAX;
 }
 
 // Adjust all the marks in the y-direction by `delta`. Positive values move the
 // marks down (the positive y direction). Negative values move up. This will
-// trim marks that are no longer have a start in the bounds of the buffer
+// trim marks that are no longer have a start in the bounds of the buffer.
+// This is O(1) apart from the trimmed marks, since it only moves the origin of the stored coordinates.
 void TextBuffer::ScrollMarks(const int delta)
 {
-    for (auto& mark : _marks)
-    {
-        mark.start.y += delta;
+    _marksOrigin -= delta;
 
-        // If the mark had sub-regions, then move those pointers too
-        if (mark.commandEnd.has_value())
-        {
-            (*mark.commandEnd).y += delta;
-        }
-        if (mark.outputEnd.has_value())
+    // _marksOrigin changes with every line that scrolls out of the buffer and would eventually overflow.
+    // Rebasing the stored coordinates once every billion lines or so is the cheap alternative to 64-bit points.
+    static constexpr til::CoordType rebaseThreshold = 1 << 30;
+    if (_marksOrigin > rebaseThreshold || _marksOrigin < -rebaseThreshold)
+    {
+        for (auto& m : _marks)
         {
-            (*mark.outputEnd).y += delta;
+            m = _markToRelative(m);
         }
+        _marksOrigin = 0;
     }
+
     _trimMarksOutsideBuffer();
 }
 
 // Method Description:
 // - Add a mark to our list of marks, and treat it as the active "prompt". For
 //   the sake of shell integration, we need to know which mark represents the
-//   current prompt/command/output. Internally, we'll always treat the _last_
-//   mark in the list as the current prompt.
+//   current prompt/command/output. We keep track of the last mark added with
+//   this method and treat it as the current prompt.
 // Arguments:
 // - m: the mark to add.
 void TextBuffer::StartPromptMark(const ScrollMark& m)
 {
-    _marks.push_back(m);
+    _currentPromptMark = _insertMark(m);
 }
 // Method Description:
 // - Add a mark to our list of marks. Don't treat this as the active prompt.
 //   This should be used for marks created by the UI or from other user input.
-//   By inserting at the start of the list, we can separate out marks that were
-//   generated by client programs vs ones created by the user.
 // Arguments:
 // - m: the mark to add.
 void TextBuffer::AddMark(const ScrollMark& m)
 {
-    _marks.insert(_marks.begin(), m);
+    const auto index = _insertMark(m);
+    if (_currentPromptMark == SIZE_MAX)
+    {
+        _currentPromptMark = index;
+    }
+}
+
+ScrollMark TextBuffer::MarkToBuffer::operator()(const ScrollMark& m) const noexcept
+{
+    auto rel = m;
+    rel.start.y -= origin;
+    rel.end.y -= origin;
+    if (rel.commandEnd)
+    {
+        rel.commandEnd->y -= origin;
+    }
+    if (rel.outputEnd)
+    {
+        rel.outputEnd->y -= origin;
+    }
+    return rel;
 }
 
-void TextBuffer::_trimMarksOutsideBuffer()
+ScrollMark TextBuffer::_markToRelative(const ScrollMark& m) const noexcept
 {
-    const til::CoordType height = _height;
-    std::erase_if(_marks, [height](const auto& m) {
-        return (m.start.y < 0) || (m.start.y >= height);
+    return MarkToBuffer{ _marksOrigin }(m);
+}
+
+til::point TextBuffer::_markPointToAbsolute(til::point pos) const noexcept
+{
+    // The callers may pass arbitrary rows, like the height of the buffer, so this clamps instead of overflowing.
+    pos.y = gsl::narrow_cast<til::CoordType>(std::clamp<int64_t>(int64_t{ pos.y } + _marksOrigin, til::CoordTypeMin, til::CoordTypeMax));
+    return pos;
+}
+
+// Inserts the given mark (in buffer coordinates) at its sorted position and returns its index.
+size_t TextBuffer::_insertMark(const ScrollMark& m)
+{
+    auto abs = m;
+    abs.start = _markPointToAbsolute(m.start);
+    abs.end = _markPointToAbsolute(m.end);
+    if (abs.commandEnd)
+    {
+        abs.commandEnd = _markPointToAbsolute(*m.commandEnd);
+    }
+    if (abs.outputEnd)
+    {
+        abs.outputEnd = _markPointToAbsolute(*m.outputEnd);
+    }
+
+    _marksMaxHeight = std::max(_marksMaxHeight, abs.end.y - abs.start.y);
+
+    // Marks are almost always added at the bottom of the buffer, in which case this is an append.
+    const auto it = std::partition_point(_marks.begin(), _marks.end(), [&](const ScrollMark& other) {
+        return other.start <= abs.start;
     });
+    const auto index = gsl::narrow_cast<size_t>(it - _marks.begin());
+    _marks.insert(it, std::move(abs));
+
+    if (_currentPromptMark != SIZE_MAX && _currentPromptMark >= index)
+    {
+        _currentPromptMark++;
+    }
+    return index;
+}
+
+void TextBuffer::_trimMarksOutsideBuffer() noexcept
+{
+    // The marks are sorted by their start, so the ones outside the buffer are at either end.
+    while (!_marks.empty() && _marks.front().start.y - _marksOrigin < 0)
+    {
+        _marks.pop_front();
+        _currentPromptMark = _currentPromptMark == 0 ? SIZE_MAX : _currentPromptMark - 1;
+    }
+    while (!_marks.empty() && _marks.back().start.y - _marksOrigin >= _height)
+    {
+        _marks.pop_back();
+        if (_currentPromptMark == _marks.size())
+        {
+            _currentPromptMark = SIZE_MAX;
+        }
+    }
+    if (_currentPromptMark == SIZE_MAX && !_marks.empty())
+    {
+        _currentPromptMark = _marks.size() - 1;
+    }
 }
 
 std::wstring_view TextBuffer::CurrentCommand() const
 {
-    if (_marks.size() == 0)
+    if (_marks.empty())
     {
         return L"";
     }
 
-    const auto& curr{ _marks.back() };
-    const auto& start{ curr.end };
+    const auto& curr{ til::at(_marks, _currentPromptMark) };
+    const til::point start{ curr.end.x, curr.end.y - _marksOrigin };
     const auto& end{ GetCursor().GetPosition() };
 
     const auto line = start.y;
@@ -2988,8 +3637,9 @@ void TextBuffer::SetCurrentPromptEnd(const til::point pos) noexcept
     {
         return;
     }
-    auto& curr{ _marks.back() };
-    curr.end = pos;
+    auto& curr{ til::at(_marks, _currentPromptMark) };
+    curr.end = _markPointToAbsolute(pos);
+    _marksMaxHeight = std::max(_marksMaxHeight, curr.end.y - curr.start.y);
 }
 void TextBuffer::SetCurrentCommandEnd(const til::point pos) noexcept
 {
@@ -2997,8 +3647,8 @@ void TextBuffer::SetCurrentCommandEnd(const til::point pos) noexcept
     {
         return;
     }
-    auto& curr{ _marks.back() };
-    curr.commandEnd = pos;
+    auto& curr{ til::at(_marks, _currentPromptMark) };
+    curr.commandEnd = _markPointToAbsolute(pos);
 }
 void TextBuffer::SetCurrentOutputEnd(const til::point pos, ::MarkCategory category) noexcept
 {
@@ -3006,7 +3656,7 @@ void TextBuffer::SetCurrentOutputEnd(const til::point pos, ::MarkCategory catego
     {
         return;
     }
-    auto& curr{ _marks.back() };
-    curr.outputEnd = pos;
+    auto& curr{ til::at(_marks, _currentPromptMark) };
+    curr.outputEnd = _markPointToAbsolute(pos);
     curr.category = category;
 }
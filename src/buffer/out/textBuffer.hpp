@@ -49,11 +49,15 @@ filling in the last row, and updating the screen.
 
 #pragma once
 
+#include <ranges>
 #include <vector>
 
 #include "cursor.h"
+#include "HyperlinkTable.hpp"
 #include "Row.hpp"
+#include "RowArena.hpp"
 #include "TextAttribute.hpp"
+#include "WordIndex.hpp"
 #include "../types/inc/Viewport.hpp"
 
 #include "../buffer/out/textBufferCellIterator.hpp"
@@ -170,6 +174,8 @@ public:
     const Cursor& GetCursor() const noexcept;
 
     uint64_t GetLastMutationId() const noexcept;
+    uint64_t GetRowGeneration(til::CoordType y) const;
+    std::vector<til::CoordType> GetRowsChangedSince(uint64_t generation) const;
     const til::CoordType GetFirstRowIndex() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
@@ -198,6 +204,8 @@ public:
 
     void ResizeTraditional(const til::size newSize);
 
+    std::shared_ptr<const TextBuffer> Snapshot() const;
+
     void SetAsActiveBuffer(const bool isActiveBuffer) noexcept;
     bool IsActiveBuffer() const noexcept;
 
@@ -303,21 +311,41 @@ public:
         }
     };
 
+    using AttributeColorsCallback = std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)>;
+    // The Serialize*() functions pass their output to these in chunks of a few dozen KB.
+    using PlainTextSink = std::function<void(std::wstring_view)>;
+    using FormattedTextSink = std::function<void(std::string_view)>;
+
     std::wstring GetPlainText(const CopyRequest& req) const;
+    void SerializePlainText(const CopyRequest& req, const PlainTextSink& sink) const;
 
     std::string GenHTML(const CopyRequest& req,
                         const int fontHeightPoints,
                         const std::wstring_view fontFaceName,
                         const COLORREF backgroundColor,
                         const bool isIntenseBold,
-                        std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept;
+                        const AttributeColorsCallback& GetAttributeColors) const noexcept;
+    void SerializeHTML(const CopyRequest& req,
+                       const int fontHeightPoints,
+                       const std::wstring_view fontFaceName,
+                       const COLORREF backgroundColor,
+                       const bool isIntenseBold,
+                       const AttributeColorsCallback& GetAttributeColors,
+                       const FormattedTextSink& sink) const;
 
     std::string GenRTF(const CopyRequest& req,
                        const int fontHeightPoints,
                        const std::wstring_view fontFaceName,
                        const COLORREF backgroundColor,
                        const bool isIntenseBold,
-                       std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept;
+                       const AttributeColorsCallback& GetAttributeColors) const noexcept;
+    void SerializeRTF(const CopyRequest& req,
+                      const int fontHeightPoints,
+                      const std::wstring_view fontFaceName,
+                      const COLORREF backgroundColor,
+                      const bool isIntenseBold,
+                      const AttributeColorsCallback& GetAttributeColors,
+                      const FormattedTextSink& sink) const;
 
     struct PositionInformation
     {
@@ -330,7 +358,22 @@ public:
     std::vector<til::point_span> SearchText(const std::wstring_view& needle, bool caseInsensitive) const;
     std::vector<til::point_span> SearchText(const std::wstring_view& needle, bool caseInsensitive, til::CoordType rowBeg, til::CoordType rowEnd) const;
 
-    const std::vector<ScrollMark>& GetMarks() const noexcept;
+    // Translates marks from how they're stored (relative to _marksOrigin) to buffer coordinates.
+    struct MarkToBuffer
+    {
+        til::CoordType origin = 0;
+        ScrollMark operator()(const ScrollMark& m) const noexcept;
+    };
+    // A lazily translated view of all marks. Just like iterators into a std::deque,
+    // it's invalidated by anything that adds, removes or scrolls marks.
+    using MarkView = std::ranges::transform_view<std::ranges::ref_view<const std::deque<ScrollMark>>, MarkToBuffer>;
+
+    bool HasMarks() const noexcept;
+    MarkView GetMarks() const noexcept;
+    std::optional<ScrollMark> GetCurrentPromptMark() const noexcept;
+    std::vector<ScrollMark> GetMarksInRange(const til::CoordType top, const til::CoordType bottom) const;
+    std::optional<ScrollMark> GetPreviousMark(const til::CoordType y) const;
+    std::optional<ScrollMark> GetNextMark(const til::CoordType y) const;
     void ClearMarksInRange(const til::point start, const til::point end);
     void ClearAllMarks() noexcept;
     void ScrollMarks(const int delta);
@@ -350,6 +393,10 @@ private:
     ROW& _getRowByOffsetDirect(size_t offset);
     ROW& _getRow(til::CoordType y) const;
     til::CoordType _estimateOffsetOfLastCommittedRow() const noexcept;
+    size_t _getRowOffset(const ROW& row) const noexcept;
+    void _touchRow(size_t offset);
+    void _touchAllRows() noexcept;
+    void _compactAttributeTable();
 
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
     til::point _GetPreviousFromCursor() const;
@@ -359,21 +406,45 @@ private:
     void _PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     void _ExpandTextRow(til::inclusive_rect& selectionRow) const;
     DelimiterClass _GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const;
+    til::point _FindNextDelimiterClass(const til::point pos, const til::point end, const std::wstring_view wordDelimiters, const DelimiterClass cls, const bool match) const;
+    std::optional<til::point> _FindPreviousDelimiterClass(const til::point pos, const std::wstring_view wordDelimiters, const DelimiterClass cls, const bool match) const;
     til::point _GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
     til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
     til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
-    void _PruneHyperlinks();
-    void _trimMarksOutsideBuffer();
+    void _releaseRowHyperlinks(const ROW& row);
+    void _addRowHyperlinks(const ROW& row) noexcept;
+    void _PruneHyperlinks() noexcept;
+    void _recountHyperlinks() noexcept;
+    ScrollMark _markToRelative(const ScrollMark& m) const noexcept;
+    til::point _markPointToAbsolute(til::point pos) const noexcept;
+    size_t _insertMark(const ScrollMark& m);
+    void _trimMarksOutsideBuffer() noexcept;
     std::tuple<til::CoordType, til::CoordType, bool> _RowCopyHelper(const CopyRequest& req, const til::CoordType iRow, const ROW& row) const;
 
+    static void _AppendHTMLText(std::string& contentBuilder, std::string& scratch, const std::wstring_view& text);
     static void _AppendRTFText(std::string& contentBuilder, const std::wstring_view& text);
 
     Microsoft::Console::Render::Renderer& _renderer;
 
-    std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
-    std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
-    uint16_t _currentHyperlinkId = 1;
+    // The reference counts in _hyperlinks only include ROWs that aren't listed in _hyperlinkDirtyRows.
+    // GetMutableRowByOffset() can't know how the caller modifies a ROW and so it releases the references of each ROW
+    // it hands out and lists it as dirty. _PruneHyperlinks() then counts the references of all dirty ROWs again,
+    // which makes the cost of pruning proportional to the number of modified ROWs instead of the size of the buffer.
+    HyperlinkTable _hyperlinks;
+    // Indexed by the offset of a ROW in _buffer (see _getRowByOffsetDirect()). 1 if it's listed in _hyperlinkDirtyRows.
+    std::vector<uint8_t> _hyperlinkRowIsDirty;
+    std::vector<uint32_t> _hyperlinkDirtyRows;
+    // IDs whose reference count may be 0, to be checked (and erased) by _PruneHyperlinks().
+    std::vector<uint16_t> _hyperlinkUnreferenced;
+
+    // Caches the DelimiterClass of each cell for word navigation. It's filled lazily by const member functions, hence
+    // mutable, and GetMutableRowByOffset() invalidates the ROWs it hands out, just like it does for _hyperlinks.
+    mutable WordIndex _wordIndex;
+
+    // Maps the TextAttributeIds stored in our ROWs to TextAttributes. ROWs hold a pointer to it,
+    // which is why it's heap allocated: ResizeTraditional() can then steal it from its temporary TextBuffer.
+    std::unique_ptr<TextAttributeTable> _attributeTable;
 
     // This block describes the state of the underlying virtual memory buffer that holds all ROWs, text and attributes.
     // Initially memory is only allocated with MEM_RESERVE to reduce the private working set of conhost.
@@ -387,8 +458,9 @@ private:
     //   ...
     // Padding may exist for alignment purposes.
     //
-    // The base (start) address of the memory arena.
-    wil::unique_virtualalloc_ptr<std::byte> _buffer;
+    // The memory arena. It's borrowed from RowArenaPool and may have been used by another TextBuffer
+    // before, in which case its memory is possibly committed already, but never contains valid ROWs.
+    RowArena _buffer;
     // The past-the-end pointer of the memory arena.
     std::byte* _bufferEnd = nullptr;
     // The range between _buffer (inclusive) and _commitWatermark (exclusive) is the range of
@@ -418,6 +490,8 @@ private:
     // Before TextBuffer was made to use virtual memory it initialized the entire memory arena with the initial
     // attributes right away. To ensure it continues to work the way it used to, this stores these initial attributes.
     TextAttribute _initialAttributes;
+    // The ID of _initialAttributes in _attributeTable.
+    TextAttributeId _initialAttributesId = 0;
     // ROW ---------------+--+--+
     // (padding)          |  |  v _bufferOffsetChars
     // ROW::_charsBuffer  |  |
@@ -436,8 +510,34 @@ private:
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
     uint64_t _lastMutationId = 0;
 
+    // The generation of a ROW is the _lastMutationId at which it was last handed out by GetMutableRowByOffset().
+    // _rowGenerations is indexed by the offset of a ROW in _buffer (see _getRowByOffsetDirect()) and additionally
+    // forms a doubly linked list sorted by generation, ending in the most recently modified ROW at
+    // _rowGenerationsTail. GetRowsChangedSince() walks it backwards and so its cost is proportional to the number
+    // of changed ROWs. Changes that replace all ROWs at once only update _allRowsGeneration.
+    struct RowGeneration
+    {
+        static constexpr uint32_t None = UINT32_MAX;
+
+        uint64_t generation = 0;
+        uint32_t prev = None;
+        uint32_t next = None;
+    };
+    std::vector<RowGeneration> _rowGenerations;
+    uint32_t _rowGenerationsTail = RowGeneration::None;
+    uint64_t _allRowsGeneration = 0;
+
     Cursor _cursor;
-    std::vector<ScrollMark> _marks;
+    // The marks are sorted by their start position and stored in absolute coordinates:
+    // Row y of the buffer is stored as y + _marksOrigin. This allows ScrollMarks() to only update
+    // _marksOrigin and to pop the marks that scrolled out of the buffer off either end.
+    std::deque<ScrollMark> _marks;
+    til::CoordType _marksOrigin = 0;
+    // The largest number of rows between the start and end of any mark since the last ClearAllMarks().
+    // It bounds how far above a given row the marks that end in that row can start.
+    til::CoordType _marksMaxHeight = 0;
+    // The index of the mark in _marks that represents the current prompt, or SIZE_MAX if there are no marks.
+    size_t _currentPromptMark = SIZE_MAX;
     bool _isActiveBuffer = false;
 
 #ifdef UNIT_TESTING
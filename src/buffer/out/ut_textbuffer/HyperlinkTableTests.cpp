@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../HyperlinkTable.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace std::string_view_literals;
+
+class HyperlinkTableTests
+{
+    TEST_CLASS(HyperlinkTableTests);
+
+    TEST_METHOD(TestInterning);
+    TEST_METHOD(TestRefCounting);
+    TEST_METHOD(TestRecycling);
+    TEST_METHOD(TestExhaustion);
+};
+
+void HyperlinkTableTests::TestInterning()
+{
+    HyperlinkTable table;
+    VERIFY_IS_TRUE(table.empty());
+
+    Log::Comment(L"Hyperlinks without a custom ID always get a new ID.");
+    const auto a = table.Intern(L"test.url", {});
+    const auto b = table.Intern(L"test.url", {});
+    VERIFY_ARE_NOT_EQUAL(uint16_t{ 0 }, a);
+    VERIFY_ARE_NOT_EQUAL(a, b);
+    VERIFY_ARE_EQUAL(L"test.url"sv, table.GetUri(a));
+    VERIFY_ARE_EQUAL(L""sv, table.GetCustomId(a));
+
+    Log::Comment(L"Hyperlinks with a custom ID share their ID, but only if the URI matches as well.");
+    const auto c = table.Intern(L"test.url", L"myId");
+    VERIFY_ARE_EQUAL(c, table.Intern(L"test.url", L"myId"));
+    VERIFY_ARE_NOT_EQUAL(c, table.Intern(L"other.url", L"myId"));
+    VERIFY_ARE_EQUAL(L"myId%"sv, table.GetCustomId(c).substr(0, 5));
+    VERIFY_ARE_EQUAL(4u, table.size());
+
+    table.SetUri(a, L"changed.url");
+    VERIFY_ARE_EQUAL(L"changed.url"sv, table.GetUri(a));
+    VERIFY_ARE_EQUAL(L"test.url"sv, table.GetUri(b));
+
+    Log::Comment(L"Unknown IDs yield empty strings.");
+    VERIFY_IS_FALSE(table.Contains(0));
+    VERIFY_IS_FALSE(table.Contains(1234));
+    VERIFY_ARE_EQUAL(L""sv, table.GetUri(1234));
+}
+
+void HyperlinkTableTests::TestRefCounting()
+{
+    HyperlinkTable table;
+    const auto id = table.Intern(L"test.url", L"myId");
+    VERIFY_ARE_EQUAL(0u, table.GetRefCount(id));
+
+    table.AddRef(id);
+    table.AddRef(id);
+    VERIFY_ARE_EQUAL(2u, table.GetRefCount(id));
+    VERIFY_IS_FALSE(table.Release(id));
+    VERIFY_IS_TRUE(table.Release(id));
+    VERIFY_IS_TRUE(table.Contains(id));
+
+    const auto other = table.Intern(L"other.url", {});
+    table.AddRef(other);
+
+    Log::Comment(L"EraseUnreferenced() erases hyperlinks without references, except for the one it's asked to keep.");
+    table.EraseUnreferenced(0);
+    VERIFY_IS_FALSE(table.Contains(id));
+    VERIFY_IS_TRUE(table.Contains(other));
+    VERIFY_ARE_EQUAL(1u, table.size());
+
+    Log::Comment(L"Erasing the custom ID allows it to be assigned to a new ID.");
+    VERIFY_ARE_NOT_EQUAL(uint16_t{ 0 }, table.Intern(L"test.url", L"myId"));
+    VERIFY_ARE_EQUAL(2u, table.size());
+
+    table.ClearRefs();
+    table.EraseUnreferenced(other);
+    VERIFY_ARE_EQUAL(1u, table.size());
+    VERIFY_IS_TRUE(table.Contains(other));
+}
+
+void HyperlinkTableTests::TestRecycling()
+{
+    HyperlinkTable table;
+    const auto a = table.Intern(L"a", {});
+    const auto b = table.Intern(L"b", {});
+    const auto c = table.Intern(L"c", {});
+
+    Log::Comment(L"Erased IDs aren't handed out again right away...");
+    table.Erase(b);
+    table.Erase(a);
+    const auto d = table.Intern(L"d", {});
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<uint16_t>(c + 1), d);
+
+    Log::Comment(L"...but once more than ReuseDelay IDs are unused, the one that has been unused the longest first.");
+    std::vector<uint16_t> ids;
+    for (size_t i = 0; i < HyperlinkTable::ReuseDelay; ++i)
+    {
+        ids.emplace_back(table.Intern(L"x", {}));
+    }
+    for (const auto id : ids)
+    {
+        table.Erase(id);
+    }
+    VERIFY_ARE_EQUAL(b, table.Intern(L"e", {}));
+    VERIFY_ARE_EQUAL(a, table.Intern(L"f", {}));
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<uint16_t>(d + HyperlinkTable::ReuseDelay + 1), table.Intern(L"g", {}));
+    VERIFY_ARE_EQUAL(L"e"sv, table.GetUri(b));
+    VERIFY_ARE_EQUAL(L"f"sv, table.GetUri(a));
+    VERIFY_ARE_EQUAL(L"c"sv, table.GetUri(c));
+
+    Log::Comment(L"Churning through many more hyperlinks than there are IDs must keep the URIs intact.");
+    auto mismatches = 0;
+    for (auto i = 0; i < 200000; ++i)
+    {
+        const auto uri = std::to_wstring(i);
+        const auto id = table.Intern(uri, {});
+        mismatches += id == 0 || table.GetUri(id) != uri;
+        table.Erase(id);
+    }
+    VERIFY_ARE_EQUAL(0, mismatches);
+    VERIFY_ARE_EQUAL(L"c"sv, table.GetUri(c));
+    VERIFY_ARE_EQUAL(5u, table.size());
+}
+
+void HyperlinkTableTests::TestExhaustion()
+{
+    HyperlinkTable table;
+    auto failures = 0;
+    for (size_t i = 0; i < HyperlinkTable::MaxSize; ++i)
+    {
+        failures += table.Intern(L"test.url", {}) == 0;
+    }
+    VERIFY_ARE_EQUAL(0, failures);
+    VERIFY_ARE_EQUAL(HyperlinkTable::MaxSize, table.size());
+
+    Log::Comment(L"Once all IDs are in use, 0 is returned, until an ID gets erased.");
+    VERIFY_ARE_EQUAL(uint16_t{ 0 }, table.Intern(L"test.url", {}));
+    table.Erase(1234);
+    VERIFY_ARE_EQUAL(uint16_t{ 1234 }, table.Intern(L"test.url", {}));
+}
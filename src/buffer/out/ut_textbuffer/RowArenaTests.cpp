@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../RowArena.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RowArenaTests
+{
+    TEST_CLASS(RowArenaTests);
+
+    TEST_METHOD(TestReuse);
+    TEST_METHOD(TestSizeSelection);
+    TEST_METHOD(TestLimits);
+};
+
+void RowArenaTests::TestReuse()
+{
+    RowArenaPool pool;
+
+    auto arena = pool.Acquire(64 * 1024);
+    VERIFY_IS_TRUE(static_cast<bool>(arena));
+    VERIFY_ARE_EQUAL(0u, arena.committed());
+    const auto base = arena.get();
+
+    arena.Commit(10000);
+    arena.get()[9999] = std::byte{ 42 };
+    VERIFY_ARE_EQUAL(10000u, pool.GetCommittedBytes());
+
+    Log::Comment(L"Committing less than what's already committed does nothing.");
+    arena.Commit(5000);
+    VERIFY_ARE_EQUAL(10000u, arena.committed());
+
+    Log::Comment(L"Returned arenas stay committed.");
+    arena.reset();
+    VERIFY_IS_FALSE(static_cast<bool>(arena));
+    VERIFY_ARE_EQUAL(1u, pool.GetIdleCount());
+    VERIFY_ARE_EQUAL(10000u, pool.GetIdleBytes());
+    VERIFY_ARE_EQUAL(10000u, pool.GetCommittedBytes());
+
+    Log::Comment(L"The next request of a similar size adopts the arena, including its committed memory.");
+    auto other = pool.Acquire(60 * 1024);
+    VERIFY_IS_TRUE(base == other.get());
+    VERIFY_ARE_EQUAL(10000u, other.committed());
+    VERIFY_ARE_EQUAL(0u, pool.GetIdleCount());
+    VERIFY_ARE_EQUAL(10000u, pool.GetCommittedBytes());
+
+    other.Decommit();
+    VERIFY_ARE_EQUAL(0u, pool.GetCommittedBytes());
+}
+
+void RowArenaTests::TestSizeSelection()
+{
+    RowArenaPool pool;
+
+    auto large = pool.Acquire(1024 * 1024);
+    auto small = pool.Acquire(64 * 1024);
+    large.Commit(1024 * 1024);
+    const auto largeBase = large.get();
+    const auto smallBase = small.get();
+    large.reset();
+    small.reset();
+
+    Log::Comment(L"The smallest arena that fits is used...");
+    auto a = pool.Acquire(32 * 1024);
+    VERIFY_IS_TRUE(smallBase == a.get());
+
+    Log::Comment(L"...but not if it's more than twice as large as needed.");
+    auto b = pool.Acquire(64 * 1024);
+    VERIFY_IS_TRUE(largeBase != b.get());
+
+    Log::Comment(L"Adopted arenas don't keep more committed memory than requested.");
+    auto c = pool.Acquire(600 * 1024);
+    VERIFY_IS_TRUE(largeBase == c.get());
+    VERIFY_ARE_EQUAL(600u * 1024, c.committed());
+}
+
+void RowArenaTests::TestLimits()
+{
+    RowArenaPool pool;
+
+    auto a = pool.Acquire(64 * 1024);
+    auto b = pool.Acquire(64 * 1024);
+    auto live = pool.Acquire(64 * 1024);
+    a.Commit(8192);
+    b.Commit(8192);
+    live.Commit(8192);
+    a.reset();
+    b.reset();
+    VERIFY_ARE_EQUAL(2u, pool.GetIdleCount());
+
+    Log::Comment(L"Exceeding the commit limit releases the least recently returned arenas first.");
+    pool.SetCommitLimit(2 * 8192);
+    VERIFY_ARE_EQUAL(1u, pool.GetIdleCount());
+    VERIFY_ARE_EQUAL(2u * 8192, pool.GetCommittedBytes());
+
+    Log::Comment(L"Arenas in use are never trimmed.");
+    pool.SetCommitLimit(0);
+    VERIFY_ARE_EQUAL(0u, pool.GetIdleCount());
+    VERIFY_ARE_EQUAL(8192u, live.committed());
+    VERIFY_ARE_EQUAL(8192u, pool.GetCommittedBytes());
+
+    Log::Comment(L"The idle limit applies to idle arenas only.");
+    pool.SetCommitLimit(SIZE_MAX);
+    pool.SetIdleLimit(4096);
+    live.reset();
+    VERIFY_ARE_EQUAL(0u, pool.GetIdleBytes());
+
+    Log::Comment(L"The number of idle arenas is limited as well.");
+    std::vector<RowArena> arenas;
+    for (size_t i = 0; i < RowArenaPool::MaxIdleArenas + 4; ++i)
+    {
+        arenas.emplace_back(pool.Acquire(4096));
+    }
+    arenas.clear();
+    VERIFY_ARE_EQUAL(RowArenaPool::MaxIdleArenas, pool.GetIdleCount());
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../TextAttributeTable.hpp"
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextAttributeTableTests
+{
+    TEST_CLASS(TextAttributeTableTests);
+
+    TEST_METHOD(TestInterning);
+    TEST_METHOD(TestReset);
+    TEST_METHOD(TestCompact);
+    TEST_METHOD(TestCompactionThreshold);
+    TEST_METHOD(TestManyDistinctAttributes);
+};
+
+void TextAttributeTableTests::TestInterning()
+{
+    const TextAttribute initial{};
+    TextAttributeTable table{ initial };
+
+    VERIFY_ARE_EQUAL(1u, table.size());
+    VERIFY_ARE_EQUAL(TextAttributeId{ 0 }, table.Intern(initial));
+
+    const auto makeAttr = [](const BYTE red) {
+        TextAttribute attr;
+        attr.SetForeground(RGB(red, 0, 0));
+        return attr;
+    };
+
+    Log::Comment(L"Intern 256 unique attributes, which forces the table to rehash a few times.");
+    std::vector<TextAttributeId> ids;
+    for (auto red = 0; red < 256; ++red)
+    {
+        ids.emplace_back(table.Intern(makeAttr(gsl::narrow_cast<BYTE>(red))));
+    }
+    VERIFY_ARE_EQUAL(257u, table.size());
+
+    Log::Comment(L"Interning them again must yield the same IDs without growing the table.");
+    for (auto red = 0; red < 256; ++red)
+    {
+        const auto attr = makeAttr(gsl::narrow_cast<BYTE>(red));
+        const auto id = ids.at(red);
+        VERIFY_ARE_EQUAL(id, table.Intern(attr));
+        VERIFY_ARE_EQUAL(attr, table.Get(id));
+    }
+    VERIFY_ARE_EQUAL(257u, table.size());
+}
+
+void TextAttributeTableTests::TestReset()
+{
+    TextAttributeTable table{ TextAttribute{} };
+    table.Intern(TextAttribute{ FOREGROUND_RED });
+    table.Intern(TextAttribute{ FOREGROUND_GREEN });
+    VERIFY_ARE_EQUAL(3u, table.size());
+
+    const TextAttribute initial{ BACKGROUND_BLUE };
+    table.Reset(initial);
+    VERIFY_ARE_EQUAL(1u, table.size());
+    VERIFY_ARE_EQUAL(initial, table.Get(0));
+    VERIFY_ARE_EQUAL(TextAttributeId{ 0 }, table.Intern(initial));
+    VERIFY_ARE_EQUAL(TextAttributeId{ 1 }, table.Intern(TextAttribute{ FOREGROUND_GREEN }));
+}
+
+void TextAttributeTableTests::TestCompact()
+{
+    TextAttributeTable table{ TextAttribute{} };
+    table.Intern(TextAttribute{ FOREGROUND_RED });
+    table.Intern(TextAttribute{ FOREGROUND_GREEN });
+    const auto blue = table.Intern(TextAttribute{ FOREGROUND_BLUE });
+
+    std::vector<uint8_t> used(table.size());
+    used.at(0) = 1;
+    used.at(blue) = 1;
+
+    const auto remap = table.Compact(used);
+    VERIFY_ARE_EQUAL(2u, table.size());
+    VERIFY_ARE_EQUAL(TextAttributeId{ 0 }, remap.at(0));
+    VERIFY_ARE_EQUAL(TextAttribute{}, table.Get(remap.at(0)));
+    VERIFY_ARE_EQUAL(TextAttribute{ FOREGROUND_BLUE }, table.Get(remap.at(blue)));
+
+    Log::Comment(L"Dropped attributes can be interned again and retained ones keep their new ID.");
+    VERIFY_ARE_EQUAL(remap.at(blue), table.Intern(TextAttribute{ FOREGROUND_BLUE }));
+    VERIFY_ARE_EQUAL(TextAttributeId{ 2 }, table.Intern(TextAttribute{ FOREGROUND_RED }));
+    VERIFY_ARE_EQUAL(TextAttributeId{ 3 }, table.Intern(TextAttribute{ FOREGROUND_GREEN }));
+}
+
+void TextAttributeTableTests::TestCompactionThreshold()
+{
+    TextAttributeTable table{ TextAttribute{} };
+
+    Log::Comment(L"Fill the table up to the threshold with attributes that all remain in use.");
+    for (DWORD i = 1; i < TextAttributeTable::CompactionThreshold; ++i)
+    {
+        table.Intern(TextAttribute{ i, 0, 0 });
+    }
+    VERIFY_IS_TRUE(table.NeedsCompaction());
+
+    const std::vector<uint8_t> used(table.size(), 1);
+    table.Compact(used);
+    VERIFY_ARE_EQUAL(TextAttributeTable::CompactionThreshold, table.size());
+
+    Log::Comment(L"A compaction that retains everything must not cause another one right away.");
+    VERIFY_IS_FALSE(table.NeedsCompaction());
+    for (DWORD i = 0; i < TextAttributeTable::CompactionThreshold - 1; ++i)
+    {
+        table.Intern(TextAttribute{ 0, i, 0 });
+    }
+    VERIFY_IS_FALSE(table.NeedsCompaction());
+    table.Intern(TextAttribute{ 0, 0, 1 });
+    VERIFY_IS_TRUE(table.NeedsCompaction());
+}
+
+void TextAttributeTableTests::TestManyDistinctAttributes()
+{
+    // 256 * 300 = 76800 cells, each with a distinct foreground color.
+    static constexpr til::CoordType width = 256;
+    static constexpr til::CoordType height = 300;
+    const auto colorAt = [](const til::CoordType x, const til::CoordType y) {
+        TextAttribute attr;
+        attr.SetForeground(RGB(x, y & 0xff, y >> 8));
+        return attr;
+    };
+
+    DummyRenderer renderer;
+    TextBuffer buffer{ til::size{ width, height }, TextAttribute{}, 0, false, renderer };
+
+    Log::Comment(L"Writing more than 65535 distinct live attributes must neither fail nor lose any of them.");
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        auto& row = buffer.GetMutableRowByOffset(y);
+        for (til::CoordType x = 0; x < width; ++x)
+        {
+            row.ReplaceAttributes(x, x + 1, colorAt(x, y));
+        }
+    }
+
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        const auto& row = buffer.GetRowByOffset(y);
+        for (til::CoordType x = 0; x < width; ++x)
+        {
+            VERIFY_ARE_EQUAL(colorAt(x, y), row.GetAttrByColumn(x));
+        }
+    }
+}
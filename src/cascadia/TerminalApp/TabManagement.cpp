@@ -335,6 +335,8 @@ namespace winrt::TerminalApp::implementation
         // files by default.
         static constexpr COMDLG_FILTERSPEC supportedFileTypes[] = {
             { L"Text Files (*.txt)", L"*.txt" },
+            { L"HTML Files (*.html)", L"*.html;*.htm" },
+            { L"Rich Text Files (*.rtf)", L"*.rtf" },
             { L"All Files (*.*)", L"*.*" }
         };
         // An arbitrary GUID to associate with all instances of this
@@ -383,8 +385,8 @@ namespace winrt::TerminalApp::implementation
 
                 if (!path.empty())
                 {
-                    const auto buffer = control.ReadEntireBuffer();
-                    CascadiaSettings::ExportFile(path, buffer);
+                    // The file extension picks the format. See ControlCore::ExportBuffer.
+                    co_await control.ExportBuffer(path);
                 }
             }
         }
@@ -1880,12 +1880,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // approach, but it's good enough to bring value to 90% of use cases.
             const auto cursorPos{ _terminal->GetCursorPosition() };
 
-            // Does the current buffer line have a mark on it?
-            const auto& marks{ _terminal->GetScrollMarks() };
-            if (!marks.empty())
+            // Is there a prompt we can move the cursor in?
+            if (const auto prompt{ _terminal->GetCurrentPromptMark() })
             {
-                const auto& last{ marks.back() };
-                const auto [start, end] = last.GetExtent();
+                const auto [start, end] = prompt->GetExtent();
                 const auto lastNonSpace = _terminal->GetTextBuffer().GetLastNonSpaceCharacter();
 
                 // If the user clicked off to the right side of the prompt, we
@@ -2079,6 +2077,79 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return hstring{ str };
     }
 
+    // Method Description:
+    // - Writes the entire buffer to the given file, as HTML or RTF if the file has
+    //   an .htm/.html or .rtf extension respectively, and as plain UTF-8 text otherwise.
+    // - The buffer is written in chunks on a background thread, so that exporting
+    //   a huge scrollback neither blocks the UI nor needs to fit into memory twice.
+    //   The export works on a snapshot of the buffer and so the terminal lock is
+    //   only held for as long as it takes to copy the buffer.
+    // - An existing file is only replaced once the export has been written completely.
+    Windows::Foundation::IAsyncAction ControlCore::ExportBuffer(const hstring path)
+    {
+        const auto strongThis{ get_strong() };
+
+        co_await winrt::resume_background();
+
+        const std::wstring_view pathView{ path };
+        auto format = ::Microsoft::Terminal::Core::Terminal::TextExportFormat::PlainText;
+        if (til::ends_with_insensitive_ascii(pathView, L".html") || til::ends_with_insensitive_ascii(pathView, L".htm"))
+        {
+            format = ::Microsoft::Terminal::Core::Terminal::TextExportFormat::Html;
+        }
+        else if (til::ends_with_insensitive_ascii(pathView, L".rtf"))
+        {
+            format = ::Microsoft::Terminal::Core::Terminal::TextExportFormat::Rtf;
+        }
+
+        const auto exporter = [&]() {
+            const auto lock = _terminal->LockForReading();
+            return _terminal->PrepareExport(format);
+        }();
+
+        // The export is written to a temporary file next to the destination, which then replaces it.
+        // This way a failed or partial export doesn't destroy an existing file. Like WriteUTF8FileAtomic,
+        // symbolic links are resolved first, so that we replace their target and not the link itself.
+        std::filesystem::path finalPath{ std::wstring_view{ path } };
+        if (std::error_code ec; std::filesystem::is_symlink(finalPath, ec))
+        {
+            if (auto resolved = std::filesystem::canonical(finalPath, ec); !ec)
+            {
+                finalPath = std::move(resolved);
+            }
+        }
+        auto tmpPath = finalPath;
+        tmpPath += L".tmp";
+
+        wil::unique_hfile file{ CreateFileW(tmpPath.c_str(),
+                                            GENERIC_WRITE,
+                                            FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                            nullptr,
+                                            CREATE_ALWAYS,
+                                            FILE_ATTRIBUTE_NORMAL,
+                                            nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        auto deleteTmp = wil::scope_exit([&]() noexcept {
+            file.reset();
+            DeleteFileW(tmpPath.c_str());
+        });
+
+        exporter([&](const std::string_view chunk) {
+            const auto size = gsl::narrow<DWORD>(chunk.size());
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), chunk.data(), size, &written, nullptr));
+            if (written != size)
+            {
+                THROW_WIN32_MSG(ERROR_WRITE_FAULT, "failed to write whole file");
+            }
+        });
+
+        file.reset();
+        THROW_IF_WIN32_BOOL_FALSE(MoveFileExW(tmpPath.c_str(), finalPath.c_str(), MOVEFILE_REPLACE_EXISTING));
+        deleteTmp.release();
+    }
+
     // Get all of our recent commands. This will only really work if the user has enabled shell integration.
     Control::CommandHistoryContext ControlCore::CommandHistory() const
     {
@@ -2383,67 +2454,40 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         const auto lock = _terminal->LockForWriting();
         const auto currentOffset = ScrollOffset();
-        const auto& marks{ _terminal->GetScrollMarks() };
+        const auto& textBuffer = _terminal->GetTextBuffer();
 
+        // The marks are sorted by their start, which allows the buffer to find each of these with a binary search.
         std::optional<::ScrollMark> tgt;
 
         switch (direction)
         {
         case ScrollToMarkDirection::Last:
         {
-            int highest = currentOffset;
-            for (const auto& mark : marks)
+            tgt = textBuffer.GetPreviousMark(til::CoordTypeMax);
+            if (tgt.has_value() && tgt->start.y <= currentOffset)
             {
-                const auto newY = mark.start.y;
-                if (newY > highest)
-                {
-                    tgt = mark;
-                    highest = newY;
-                }
+                tgt.reset();
             }
             break;
         }
         case ScrollToMarkDirection::First:
         {
-            int lowest = currentOffset;
-            for (const auto& mark : marks)
+            tgt = textBuffer.GetNextMark(til::CoordTypeMin);
+            if (tgt.has_value() && tgt->start.y >= currentOffset)
             {
-                const auto newY = mark.start.y;
-                if (newY < lowest)
-                {
-                    tgt = mark;
-                    lowest = newY;
-                }
+                tgt.reset();
             }
             break;
         }
         case ScrollToMarkDirection::Next:
         {
-            int minDistance = INT_MAX;
-            for (const auto& mark : marks)
-            {
-                const auto delta = mark.start.y - currentOffset;
-                if (delta > 0 && delta < minDistance)
-                {
-                    tgt = mark;
-                    minDistance = delta;
-                }
-            }
+            tgt = textBuffer.GetNextMark(currentOffset);
             break;
         }
         case ScrollToMarkDirection::Previous:
         default:
         {
-            int minDistance = INT_MAX;
-            for (const auto& mark : marks)
-            {
-                const auto delta = currentOffset - mark.start.y;
-                if (delta > 0 && delta < minDistance)
-                {
-                    tgt = mark;
-                    minDistance = delta;
-                }
-            }
+            tgt = textBuffer.GetPreviousMark(currentOffset);
             break;
         }
         }
@@ -3442,6 +3442,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         return _core.ReadEntireBuffer();
     }
+    Windows::Foundation::IAsyncAction TermControl::ExportBuffer(const hstring& path)
+    {
+        return _core.ExportBuffer(path);
+    }
     Control::CommandHistoryContext TermControl::CommandHistory() const
     {
         return _core.CommandHistory();
@@ -1323,6 +1323,50 @@ TextBuffer& Terminal::_activeBuffer() const noexcept
     return _inAltBuffer() ? *_altBuffer : *_mainBuffer;
 }
 
+// Invalidates only those rows of the visible viewport that look different from what was
+// last rendered for previousBuffer, which is assumed to have been visible at the origin.
+// This avoids a full redraw when switching back from the alt buffer.
+void Terminal::_triggerRedrawOfChangedRows(const TextBuffer& previousBuffer)
+{
+    auto& buffer = _activeBuffer();
+    const auto viewport = _GetVisibleViewport();
+    const auto top = viewport.Top();
+    const auto width = viewport.Width();
+    const auto height = viewport.Height();
+
+    if (previousBuffer.GetSize().Dimensions() != viewport.Dimensions() || top >= height)
+    {
+        buffer.TriggerRedrawAll();
+        return;
+    }
+
+    const auto invalidate = [&](const til::CoordType beg, const til::CoordType end) {
+        if (beg < end)
+        {
+            buffer.TriggerRedraw(Viewport::FromExclusive({ 0, top + beg, width, top + end }));
+        }
+    };
+
+    // The renderer will scroll its previous frame up by `top` rows to follow the viewport.
+    // Viewport row y thus shows what used to be row y + top, and nothing for the last `top` rows.
+    const auto rows = height - top;
+    auto dirtyBeg = rows;
+    for (til::CoordType y = 0; y < rows; ++y)
+    {
+        if (buffer.GetRowByOffset(top + y).IsContentEqual(previousBuffer.GetRowByOffset(top + y)))
+        {
+            invalidate(dirtyBeg, y);
+            dirtyBeg = rows;
+        }
+        else if (dirtyBeg == rows)
+        {
+            dirtyBeg = y;
+        }
+    }
+    // This covers both, any trailing dirty rows, as well as the rows the renderer had nothing to scroll into.
+    invalidate(dirtyBeg, height);
+}
+
 void Terminal::_updateUrlDetection()
 {
     if (_detectURLs)
@@ -1495,15 +1539,19 @@ void Terminal::ClearAllMarks()
     _NotifyScrollEvent();
 }
 
-const std::vector<ScrollMark>& Terminal::GetScrollMarks() const noexcept
+TextBuffer::MarkView Terminal::GetScrollMarks() const noexcept
 {
     // TODO: GH#11000 - when the marks are stored per-buffer, get rid of this.
     // We want to return _no_ marks when we're in the alt buffer, to effectively
-    // hide them. We need to return a reference, so we can't just ctor an empty
-    // list here just for when we're in the alt buffer.
+    // hide them.
     return _activeBuffer().GetMarks();
 }
 
+std::optional<ScrollMark> Terminal::GetCurrentPromptMark() const noexcept
+{
+    return _activeBuffer().GetCurrentPromptMark();
+}
+
 til::color Terminal::GetColorForMark(const ScrollMark& mark) const
 {
     if (mark.color.has_value())
@@ -117,7 +117,8 @@ public:
     RenderSettings& GetRenderSettings() noexcept;
     const RenderSettings& GetRenderSettings() const noexcept;
 
-    const std::vector<ScrollMark>& GetScrollMarks() const noexcept;
+    TextBuffer::MarkView GetScrollMarks() const noexcept;
+    std::optional<ScrollMark> GetCurrentPromptMark() const noexcept;
     void AddMark(const ScrollMark& mark,
                  const til::point& start,
                  const til::point& end,
@@ -319,6 +320,16 @@ public:
     const SelectionEndpoint SelectionEndpointTarget() const noexcept;
 
     TextCopyData RetrieveSelectedTextFromBuffer(const bool singleLine, const bool html = false, const bool rtf = false) const;
+
+    enum class TextExportFormat
+    {
+        PlainText,
+        Html,
+        Rtf,
+    };
+
+    using TextExporter = std::function<void(const TextBuffer::FormattedTextSink&)>;
+    TextExporter PrepareExport(const TextExportFormat format) const;
 #pragma endregion
 
 #ifndef NDEBUG
@@ -468,6 +479,7 @@ private:
 
     bool _inAltBuffer() const noexcept;
     TextBuffer& _activeBuffer() const noexcept;
+    void _triggerRedrawOfChangedRows(const TextBuffer& previousBuffer);
     void _updateUrlDetection();
     interval_tree::IntervalTree<til::point, size_t> _getPatterns(til::CoordType beg, til::CoordType end) const;
 
@@ -206,7 +206,7 @@ void Terminal::UseAlternateScreenBuffer(const TextAttribute& attrs)
 
     ClearSelection();
 
-    // Create a new alt buffer
+    // Create a new alt buffer. It adopts the memory of the previous one from the RowArenaPool.
     _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
                                               attrs,
                                               cursorSize,
@@ -262,7 +262,8 @@ void Terminal::UseMainScreenBuffer()
 
     _mainBuffer->SetAsActiveBuffer(true);
 
-    if (_deferredResize.has_value())
+    const auto resized = _deferredResize.has_value();
+    if (resized)
     {
         LOG_IF_FAILED(UserResize(_deferredResize.value()));
         _deferredResize = std::nullopt;
@@ -297,7 +298,14 @@ void Terminal::UseMainScreenBuffer()
     _NotifyScrollEvent();
 
     // redraw the screen
-    _activeBuffer().TriggerRedrawAll();
+    if (resized)
+    {
+        _activeBuffer().TriggerRedrawAll();
+    }
+    else
+    {
+        _triggerRedrawOfChangedRows(*altBuffer);
+    }
 }
 
 // NOTE: This is the version of AddMark that comes from VT
@@ -334,7 +342,7 @@ void Terminal::MarkCommandStart()
     const til::point cursorPos{ _activeBuffer().GetCursor().GetPosition() };
 
     if ((_currentPromptState == PromptState::Prompt) &&
-        (_activeBuffer().GetMarks().size() > 0))
+        _activeBuffer().HasMarks())
     {
         // We were in the right state, and there's a previous mark to work
         // with.
@@ -369,7 +377,7 @@ void Terminal::MarkOutputStart()
     const til::point cursorPos{ _activeBuffer().GetCursor().GetPosition() };
 
     if ((_currentPromptState == PromptState::Command) &&
-        (_activeBuffer().GetMarks().size() > 0))
+        _activeBuffer().HasMarks())
     {
         // We were in the right state, and there's a previous mark to work
         // with.
@@ -411,7 +419,7 @@ void Terminal::MarkCommandFinish(std::optional<unsigned int> error)
     }
 
     if ((_currentPromptState == PromptState::Output) &&
-        (_activeBuffer().GetMarks().size() > 0))
+        _activeBuffer().HasMarks())
     {
         // We were in the right state, and there's a previous mark to work
         // with.
@@ -497,8 +505,7 @@ void Terminal::NotifyBufferRotation(const int delta)
     // manually erase our pattern intervals since the locations have changed now
     _patternIntervalTree = {};
 
-    auto& marks{ _activeBuffer().GetMarks() };
-    const auto hasScrollMarks = marks.size() > 0;
+    const auto hasScrollMarks = _activeBuffer().HasMarks();
     if (hasScrollMarks)
     {
         _activeBuffer().ScrollMarks(-delta);
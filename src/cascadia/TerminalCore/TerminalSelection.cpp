@@ -916,6 +916,64 @@ Terminal::TextCopyData Terminal::RetrieveSelectedTextFromBuffer(const bool singl
     return data;
 }
 
+// Method Description:
+// - Takes a snapshot of the buffer together with the colors and font needed to
+//   serialize it. The returned function can be called without holding the lock,
+//   so that exporting a huge buffer doesn't stall the output of the terminal.
+// Arguments:
+// - format: the format of the document
+// Return Value:
+// - A function that serializes the entire buffer up to its last line of text
+//   and passes it to the given sink in chunks of UTF-8.
+Terminal::TextExporter Terminal::PrepareExport(const TextExportFormat format) const
+{
+    _assertLocked();
+
+    return [format,
+            snapshot = _activeBuffer().Snapshot(),
+            renderSettings = _renderSettings,
+            fontSizePt = _fontInfo.GetUnscaledSize().height, // already in points
+            fontName = _fontInfo.GetFaceName()](const TextBuffer::FormattedTextSink& sink) {
+        const auto GetAttributeColors = [&](const auto& attr) {
+            const auto [fg, bg] = renderSettings.GetAttributeColors(attr);
+            const auto ul = renderSettings.GetAttributeUnderlineColor(attr);
+            return std::tuple{ fg, bg, ul };
+        };
+
+        const auto& textBuffer = *snapshot;
+        const til::point end{ textBuffer.GetSize().RightInclusive(), textBuffer.GetLastNonSpaceCharacter().y };
+        const TextBuffer::CopyRequest req{ textBuffer, {}, end, false, true, true, false };
+
+        const auto bgColor = renderSettings.GetAttributeColors({}).second;
+        const auto isIntenseBold = renderSettings.GetRenderMode(::Microsoft::Console::Render::RenderSettings::Mode::IntenseIsBold);
+
+        switch (format)
+        {
+        case TextExportFormat::Html:
+            textBuffer.SerializeHTML(req, fontSizePt, fontName, bgColor, isIntenseBold, GetAttributeColors, sink);
+            break;
+        case TextExportFormat::Rtf:
+            textBuffer.SerializeRTF(req, fontSizePt, fontName, bgColor, isIntenseBold, GetAttributeColors, sink);
+            break;
+        case TextExportFormat::PlainText:
+        default:
+        {
+            std::string utf8;
+            textBuffer.SerializePlainText(req, [&](const std::wstring_view chunk) {
+                THROW_IF_FAILED(til::u16u8(chunk, utf8));
+                sink(utf8);
+            });
+            // Like every other line, the last one ends in a line break, unless it wrapped.
+            if (!textBuffer.GetRowByOffset(end.y).WasWrapForced())
+            {
+                sink("\r\n");
+            }
+            break;
+        }
+        }
+    };
+}
+
 // Method Description:
 // - convert viewport position to the corresponding location on the buffer
 // Arguments:
@@ -368,6 +368,17 @@ namespace ControlUnitTests
         Log::Comment(L"Check the buffer contents");
         VERIFY_ARE_EQUAL(L"This is some text\r\nwith varying amounts\r\nof whitespace\r\n",
                          core->ReadEntireBuffer());
+
+        Log::Comment(L"Exporting the buffer as plain text yields the same contents");
+        std::string exported;
+        {
+            const auto lock = core->_terminal->LockForReading();
+            const auto exporter = core->_terminal->PrepareExport(::Microsoft::Terminal::Core::Terminal::TextExportFormat::PlainText);
+            exporter([&](const std::string_view chunk) {
+                exported.append(chunk);
+            });
+        }
+        VERIFY_ARE_EQUAL(L"This is some text\r\nwith varying amounts\r\nof whitespace\r\n", til::u8u16(exported));
     }
     void _writePrompt(const winrt::com_ptr<MockConnection>& conn, const auto& path)
     {
@@ -26,9 +26,21 @@ namespace
             return _triggerScrollDelta;
         }
 
+        const std::vector<til::rect>& InvalidatedRects() const
+        {
+            return _invalidatedRects;
+        }
+
+        bool InvalidatedAll() const
+        {
+            return _invalidatedAll;
+        }
+
         void Reset()
         {
             _triggerScrollDelta.reset();
+            _invalidatedRects.clear();
+            _invalidatedAll = false;
         }
 
         HRESULT StartPaint() noexcept { return S_OK; }
@@ -36,7 +48,11 @@ namespace
         HRESULT Present() noexcept { return S_OK; }
         HRESULT PrepareForTeardown(_Out_ bool* /*pForcePaint*/) noexcept { return S_OK; }
         HRESULT ScrollFrame() noexcept { return S_OK; }
-        HRESULT Invalidate(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
+        HRESULT Invalidate(const til::rect* psrRegion) noexcept
+        {
+            _invalidatedRects.emplace_back(*psrRegion);
+            return S_OK;
+        }
         HRESULT InvalidateCursor(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
         HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept { return S_OK; }
         HRESULT InvalidateSelection(const std::vector<til::rect>& /*rectangles*/) noexcept { return S_OK; }
@@ -45,7 +61,11 @@ namespace
             _triggerScrollDelta = *pcoordDelta;
             return S_OK;
         }
-        HRESULT InvalidateAll() noexcept { return S_OK; }
+        HRESULT InvalidateAll() noexcept
+        {
+            _invalidatedAll = true;
+            return S_OK;
+        }
         HRESULT InvalidateCircling(_Out_ bool* /*pForcePaint*/) noexcept { return S_OK; }
         HRESULT PaintBackground() noexcept { return S_OK; }
         HRESULT PaintBufferLine(std::span<const Cluster> /*clusters*/, til::point /*coord*/, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept { return S_OK; }
@@ -67,6 +87,8 @@ namespace
 
     private:
         std::optional<til::point> _triggerScrollDelta;
+        std::vector<til::rect> _invalidatedRects;
+        bool _invalidatedAll = false;
     };
 
     struct ScrollBarNotification
@@ -97,6 +119,7 @@ class TerminalCoreUnitTests::ScrollTest final
     TEST_CLASS(ScrollTest);
 
     TEST_METHOD(TestNotifyScrolling);
+    TEST_METHOD(TestAltBufferPartialRedraw);
 
     TEST_METHOD_SETUP(MethodSetup)
     {
@@ -125,6 +148,8 @@ class TerminalCoreUnitTests::ScrollTest final
     }
 
 private:
+    std::vector<bool> _GetInvalidatedRows() const;
+
     std::unique_ptr<Terminal> _term;
     std::unique_ptr<MockScrollRenderEngine> _renderEngine;
     std::unique_ptr<DummyRenderer> _renderer;
@@ -237,3 +262,93 @@ void ScrollTest::TestNotifyScrolling()
         }
     }
 }
+
+// Returns for each row of the viewport whether the render engine was asked to redraw any part of it.
+std::vector<bool> ScrollTest::_GetInvalidatedRows() const
+{
+    std::vector<bool> rows(TerminalViewHeight);
+    for (const auto& rect : _renderEngine->InvalidatedRects())
+    {
+        for (auto y = std::max(0, rect.top); y < std::min(TerminalViewHeight, rect.bottom); ++y)
+        {
+            rows.at(y) = true;
+        }
+    }
+    return rows;
+}
+
+void ScrollTest::TestAltBufferPartialRedraw()
+{
+    auto& termSm = *_term->_stateMachine;
+
+    Log::Comment(L"Only the rows that differ between the alt buffer and the main buffer get redrawn.");
+    {
+        termSm.ProcessString(L"A\r\nB\r\nC");
+        termSm.ProcessString(L"\x1b[?1049h");
+        // Row 0 matches the main buffer, row 1 and 2 are blank, and row 5 only has text in the alt buffer.
+        termSm.ProcessString(L"\x1b[1;1HA\x1b[6;1HX");
+
+        _renderEngine->Reset();
+        termSm.ProcessString(L"\x1b[?1049l");
+
+        VERIFY_IS_FALSE(_renderEngine->InvalidatedAll());
+        const auto rows = _GetInvalidatedRows();
+        for (til::CoordType y = 0; y < TerminalViewHeight; ++y)
+        {
+            const auto expected = y == 1 || y == 2 || y == 5;
+            VERIFY_ARE_EQUAL(expected, rows.at(y), fmt::format(L"row {}", y).c_str());
+        }
+    }
+
+    Log::Comment(L"The rows the renderer scrolls into view are always redrawn.");
+    {
+        // This moves the viewport of the main buffer down to row 9, while the alt buffer's viewport is at row 0.
+        for (auto y = 2; y < 40; ++y)
+        {
+            termSm.ProcessString(L"X\r\n");
+        }
+        const auto top = _term->GetViewport().Top();
+        VERIFY_ARE_EQUAL(9, top);
+
+        termSm.ProcessString(L"\x1b[?1049h");
+        // The alt buffer gets the same contents as the main buffer in rows 9 to 31.
+        for (auto y = top; y < TerminalViewHeight; ++y)
+        {
+            termSm.ProcessString(fmt::format(L"\x1b[{};1HX", y + 1));
+        }
+
+        _renderEngine->Reset();
+        termSm.ProcessString(L"\x1b[?1049l");
+
+        VERIFY_IS_FALSE(_renderEngine->InvalidatedAll());
+        const auto rows = _GetInvalidatedRows();
+        for (til::CoordType y = 0; y < TerminalViewHeight; ++y)
+        {
+            const auto expected = y >= TerminalViewHeight - top;
+            VERIFY_ARE_EQUAL(expected, rows.at(y), fmt::format(L"row {}", y).c_str());
+        }
+    }
+
+    Log::Comment(L"If the viewport scrolled by a full page or more, everything gets redrawn.");
+    {
+        for (auto y = 0; y < TerminalViewHeight; ++y)
+        {
+            termSm.ProcessString(L"X\r\n");
+        }
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(_term->GetViewport().Top(), TerminalViewHeight);
+
+        termSm.ProcessString(L"\x1b[?1049h");
+        _renderEngine->Reset();
+        termSm.ProcessString(L"\x1b[?1049l");
+        VERIFY_IS_TRUE(_renderEngine->InvalidatedAll());
+    }
+
+    Log::Comment(L"A resize while in the alt buffer redraws everything as well.");
+    {
+        termSm.ProcessString(L"\x1b[?1049h");
+        VERIFY_SUCCEEDED(_term->UserResize({ TerminalViewWidth, TerminalViewHeight - 2 }));
+        _renderEngine->Reset();
+        termSm.ProcessString(L"\x1b[?1049l");
+        VERIFY_IS_TRUE(_renderEngine->InvalidatedAll());
+    }
+}
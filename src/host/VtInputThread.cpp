@@ -34,6 +34,7 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     THROW_HR_IF(E_HANDLE, _hFile.get() == INVALID_HANDLE_VALUE);
 
     auto dispatch = std::make_unique<InteractDispatch>();
+    _pDispatch = dispatch.get();
 
     auto engine = std::make_unique<InputStateMachineEngine>(std::move(dispatch), inheritCursor);
 
@@ -105,7 +106,17 @@ bool VtInputThread::DoReadInput()
         LockConsole();
         const auto unlock = wil::scope_exit([&] { UnlockConsole(); });
 
-        _pInputStateMachine->ProcessString(_wstr);
+        try
+        {
+            _pInputStateMachine->ProcessString(_wstr);
+        }
+        CATCH_LOG();
+
+        // The dispatch accumulates all the input events we parse and writes them to the
+        // input buffer in one go. This needs to happen while we're still holding the lock,
+        // and even if parsing failed halfway through, so that no input gets lost.
+        // It isn't done in a scope_exit, as writing to the input buffer can throw.
+        _pDispatch->FlushInput();
     }
     CATCH_LOG();
 
@@ -16,6 +16,11 @@ Author(s):
 
 #include "../terminal/parser/StateMachine.hpp"
 
+namespace Microsoft::Console::VirtualTerminal
+{
+    class InteractDispatch;
+}
+
 namespace Microsoft::Console
 {
     class VtInputThread
@@ -38,6 +43,8 @@ namespace Microsoft::Console
         std::function<void(bool)> _pfnSetLookingForDSR;
 
         std::unique_ptr<Microsoft::Console::VirtualTerminal::StateMachine> _pInputStateMachine;
+        // Owned by _pInputStateMachine's engine.
+        Microsoft::Console::VirtualTerminal::InteractDispatch* _pDispatch = nullptr;
         til::u8state _u8State;
         std::wstring _wstr;
     };
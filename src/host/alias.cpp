@@ -19,9 +19,13 @@
 
 using Microsoft::Console::Interactivity::ServiceLocator;
 
+// Both are transparent, so that the maps can be searched with a std::wstring_view
+// without constructing a std::wstring first, which matters for s_MatchAndCopyAlias().
 struct case_insensitive_hash
 {
-    std::size_t operator()(const std::wstring& key) const
+    using is_transparent = void;
+
+    std::size_t operator()(const std::wstring_view& key) const noexcept
     {
         til::hasher h;
         for (const auto& ch : key)
@@ -34,15 +38,19 @@ struct case_insensitive_hash
 
 struct case_insensitive_equality
 {
-    bool operator()(const std::wstring& lhs, const std::wstring& rhs) const
+    using is_transparent = void;
+
+    bool operator()(const std::wstring_view& lhs, const std::wstring_view& rhs) const noexcept
     {
-        return 0 == _wcsicmp(lhs.data(), rhs.data());
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const wchar_t a, const wchar_t b) {
+            return ::towlower(a) == ::towlower(b);
+        });
     }
 };
 
 std::unordered_map<std::wstring,
                    std::unordered_map<std::wstring,
-                                      std::wstring,
+                                      Alias::CompiledTarget,
                                       case_insensitive_hash,
                                       case_insensitive_equality>,
                    case_insensitive_hash,
@@ -108,13 +116,13 @@ std::unordered_map<std::wstring,
             auto exeData = g_aliasData.find(exeNameString);
             if (exeData != g_aliasData.end())
             {
-                g_aliasData[exeNameString].erase(sourceString);
+                exeData->second.erase(sourceString);
             }
         }
         else
         {
             // Map will auto-create each level as necessary
-            g_aliasData[exeNameString][sourceString] = targetString;
+            g_aliasData[exeNameString][sourceString] = Alias::s_CompileTarget(targetString);
         }
     }
     CATCH_RETURN();
@@ -149,17 +157,14 @@ std::unordered_map<std::wstring,
         til::at(*target, 0) = UNICODE_NULL;
     }
 
-    std::wstring exeNameString(exeName);
-    std::wstring sourceString(source);
-
     // For compatibility, return ERROR_GEN_FAILURE for any result where the alias can't be found.
     // We use .find for the iterators then dereference to search without creating entries.
-    const auto exeIter = g_aliasData.find(exeNameString);
+    const auto exeIter = g_aliasData.find(exeName);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), exeIter == g_aliasData.end());
-    const auto exeData = exeIter->second;
-    const auto sourceIter = exeData.find(sourceString);
+    const auto& exeData = exeIter->second;
+    const auto sourceIter = exeData.find(source);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), sourceIter == exeData.end());
-    const auto targetString = sourceIter->second;
+    const auto& targetString = sourceIter->second.target;
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), targetString.size() == 0);
 
     // TargetLength is a byte count, convert to characters.
@@ -315,8 +320,6 @@ static std::wstring aliasesSeparator(L"=");
 
     try
     {
-        const std::wstring exeNameString(exeName);
-
         size_t cchNeeded = 0;
 
         // Each of the aliases will be made up of the source, a separator, the target, then a null character.
@@ -330,21 +333,22 @@ static std::wstring aliasesSeparator(L"=");
         }
 
         // Find without creating.
-        auto exeIter = g_aliasData.find(exeNameString);
+        const auto exeIter = g_aliasData.find(exeName);
         if (exeIter != g_aliasData.end())
         {
-            auto list = exeIter->second;
-            for (auto& pair : list)
+            for (const auto& pair : exeIter->second)
             {
+                const auto& target = pair.second.target;
+
                 // Alias stores lengths in bytes.
                 auto cchSource = pair.first.size();
-                auto cchTarget = pair.second.size();
+                auto cchTarget = target.size();
 
                 // If we're counting how much multibyte space will be needed, trial convert the source and target strings before we add.
                 if (!countInUnicode)
                 {
                     cchSource = GetALengthFromW(codepage, pair.first);
-                    cchTarget = GetALengthFromW(codepage, pair.second);
+                    cchTarget = GetALengthFromW(codepage, target);
                 }
 
                 // Accumulate all sizes to the final string count.
@@ -451,8 +455,6 @@ void Alias::s_ClearCmdExeAliases()
         til::at(*aliasBuffer, 0) = UNICODE_NULL;
     }
 
-    std::wstring exeNameString(exeName);
-
     auto AliasesBufferPtrW = aliasBuffer.has_value() ? aliasBuffer->data() : nullptr;
     size_t cchTotalLength = 0; // accumulate the characters we need/have copied as we walk the list
 
@@ -461,15 +463,16 @@ void Alias::s_ClearCmdExeAliases()
     const size_t cchNull = 1;
 
     // Find without creating.
-    auto exeIter = g_aliasData.find(exeNameString);
+    const auto exeIter = g_aliasData.find(exeName);
     if (exeIter != g_aliasData.end())
     {
-        auto list = exeIter->second;
-        for (auto& pair : list)
+        for (const auto& pair : exeIter->second)
         {
+            const auto& target = pair.second.target;
+
             // Alias stores lengths in bytes.
             const auto cchSource = pair.first.size();
-            const auto cchTarget = pair.second.size();
+            const auto cchTarget = target.size();
 
             // Add up how many characters we will need for the full alias data.
             size_t cchNeeded = 0;
@@ -499,7 +502,7 @@ void Alias::s_ClearCmdExeAliases()
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, aliasesSeparator.size(), &cchAliasBufferRemaining));
                 AliasesBufferPtrW += aliasesSeparator.size();
 
-                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, pair.second.data(), cchTarget));
+                RETURN_IF_FAILED(StringCchCopyNW(AliasesBufferPtrW, cchAliasBufferRemaining, target.data(), cchTarget));
                 RETURN_IF_FAILED(SizeTSub(cchAliasBufferRemaining, cchTarget, &cchAliasBufferRemaining));
                 AliasesBufferPtrW += cchTarget;
 
@@ -818,32 +821,31 @@ void Alias::s_ClearCmdExeAliases()
 }
 
 // Routine Description:
-// - Tokenizes a string into a collection using space as a separator
+// - Tokenizes a string using space as a separator
+// - Only the first 10 tokens are returned, which are the alias and the arguments $1-$9 can refer to.
+//   Missing tokens are empty, which has the same effect as the empty tokens between two consecutive spaces.
 // Arguments:
 // - str - String to tokenize
 // Return Value:
-// - Collection of tokenized strings
-std::deque<std::wstring> Alias::s_Tokenize(const std::wstring_view str)
+// - The tokens, referring to the given string.
+std::array<std::wstring_view, 10> Alias::s_Tokenize(const std::wstring_view str)
 {
-    std::deque<std::wstring> result;
+    std::array<std::wstring_view, 10> result;
 
     size_t prevIndex = 0;
-    auto spaceIndex = str.find(L' ');
-    while (std::wstring_view::npos != spaceIndex)
+    for (auto& token : result)
     {
-        const auto length = spaceIndex - prevIndex;
-
-        result.emplace_back(str.substr(prevIndex, length));
+        const auto spaceIndex = str.find(L' ', prevIndex);
+        token = str.substr(prevIndex, spaceIndex - prevIndex);
 
-        spaceIndex++;
-        prevIndex = spaceIndex;
+        if (std::wstring_view::npos == spaceIndex)
+        {
+            break;
+        }
 
-        spaceIndex = str.find(L' ', spaceIndex);
+        prevIndex = spaceIndex + 1;
     }
 
-    // Place the final one into the set.
-    result.emplace_back(str.substr(prevIndex));
-
     return result;
 }
 
@@ -854,74 +856,15 @@ std::deque<std::wstring> Alias::s_Tokenize(const std::wstring_view str)
 // - str - String to split into just args
 // Return Value:
 // - Only the arguments part of the string or empty if there are no arguments.
-std::wstring Alias::s_GetArgString(const std::wstring_view str)
+std::wstring_view Alias::s_GetArgString(const std::wstring_view str)
 {
-    std::wstring result;
-    auto firstSpace = str.find_first_of(L' ');
+    const auto firstSpace = str.find_first_of(L' ');
     if (std::wstring_view::npos != firstSpace)
     {
-        firstSpace++;
-        if (firstSpace < str.size())
-        {
-            result = str.substr(firstSpace);
-        }
-    }
-
-    return result;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a numbered arg replacement macro
-//   and replaces it with the counted argument if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - tokens - Tokens of the original command string. 0 is alias. 1-N are arguments.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::deque<std::wstring>& tokens)
-{
-    if (ch >= L'1' && ch <= L'9')
-    {
-        // Numerical macros substitute that numbered argument
-        const size_t index = ch - L'0';
-
-        if (index < tokens.size() && index > 0)
-        {
-            appendToStr.append(tokens[index]);
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a wildcard arg replacement macro
-//   and replaces it with the entire argument string if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - fullArgString - All of the arguments as one big string.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::wstring fullArgString)
-{
-    if (L'*' == ch)
-    {
-        // Wildcard substitutes all arguments
-        appendToStr.append(fullArgString);
-        return true;
+        return str.substr(firstSpace + 1);
     }
 
-    return false;
+    return {};
 }
 
 // Routine Description:
@@ -1024,58 +967,62 @@ void Alias::s_AppendCrLf(std::wstring& appendToStr,
 }
 
 // Routine Description:
-// - Searches through the given string for macros and replaces them
-//   with the matching action
+// - Parses an alias target into runs of text and references to arguments, which s_MatchAndCopyAlias() concatenates.
+// - The target may contain substitution macros indicated by $. $1-$9 and $* depend on the command line the alias
+//   is used with, while $L, $G, $B and $T always result in the same text and are substituted right away.
 // Arguments:
-// - str - On input, the string to search. On output, the string is replaced.
-// - tokens - The tokenized command line input. 0 is the alias, 1-N are arguments.
-// - fullArgString - Shorthand to 1-N argument string in case of wildcard match.
+// - target - The target of the alias, as given to AddConsoleAlias.
 // Return Value:
-// - The number of commands in the final string (line feeds, CRLFs)
-size_t Alias::s_ReplaceMacros(std::wstring& str,
-                              const std::deque<std::wstring>& tokens,
-                              const std::wstring& fullArgString)
+// - The compiled target.
+Alias::CompiledTarget Alias::s_CompileTarget(const std::wstring_view target)
 {
+    CompiledTarget compiled;
+    compiled.target = target;
+
+    auto& text = compiled.text;
+    size_t textBegin = 0;
     size_t lineCount = 0;
-    std::wstring finalText;
 
-    // The target text may contain substitution macros indicated by $.
-    // Walk through and substitute them as appropriate.
-    for (auto ch = str.cbegin(); ch < str.cend(); ch++)
+    // Turns the text that was appended since the last op into an op of its own.
+    const auto flushText = [&]() {
+        if (text.size() > textBegin)
+        {
+            compiled.ops.push_back({ 0, gsl::narrow<uint32_t>(textBegin), gsl::narrow<uint32_t>(text.size() - textBegin) });
+            textBegin = text.size();
+        }
+    };
+    const auto pushArgument = [&](const uint16_t argument) {
+        flushText();
+        compiled.ops.push_back({ argument, 0, 0 });
+    };
+
+    for (auto ch = target.cbegin(); ch < target.cend(); ch++)
     {
         if (L'$' == *ch)
         {
             // Attempt to read ahead by one character.
             const auto chNext = ch + 1;
 
-            if (chNext < str.cend())
+            if (chNext < target.cend())
             {
-                auto isProcessed = s_TryReplaceNumberedArgMacro(*chNext, finalText, tokens);
-                if (!isProcessed)
+                if (*chNext >= L'1' && *chNext <= L'9')
                 {
-                    isProcessed = s_TryReplaceWildcardArgMacro(*chNext, finalText, fullArgString);
+                    // Numerical macros substitute that numbered argument
+                    pushArgument(gsl::narrow_cast<uint16_t>(*chNext - L'0'));
                 }
-                if (!isProcessed)
+                else if (L'*' == *chNext)
                 {
-                    isProcessed = s_TryReplaceInputRedirMacro(*chNext, finalText);
+                    // Wildcard substitutes all arguments
+                    pushArgument(CompiledTarget::AllArguments);
                 }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceOutputRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplacePipeRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceNextCommandMacro(*chNext, finalText, lineCount);
-                }
-                if (!isProcessed)
+                else if (!s_TryReplaceInputRedirMacro(*chNext, text) &&
+                         !s_TryReplaceOutputRedirMacro(*chNext, text) &&
+                         !s_TryReplacePipeRedirMacro(*chNext, text) &&
+                         !s_TryReplaceNextCommandMacro(*chNext, text, lineCount))
                 {
                     // If nothing matches, just push these two characters in.
-                    finalText.push_back(*ch);
-                    finalText.push_back(*chNext);
+                    text.push_back(*ch);
+                    text.push_back(*chNext);
                 }
 
                 // Since we read ahead and used that character,
@@ -1085,22 +1032,22 @@ size_t Alias::s_ReplaceMacros(std::wstring& str,
             else
             {
                 // If no read-ahead, just push this character and be done.
-                finalText.push_back(*ch);
+                text.push_back(*ch);
             }
         }
         else
         {
             // If it didn't match the macro specifier $, push the character.
-            finalText.push_back(*ch);
+            text.push_back(*ch);
         }
     }
 
     // We always terminate with a CRLF to symbolize end of command.
-    s_AppendCrLf(finalText, lineCount);
+    s_AppendCrLf(text, lineCount);
+    flushText();
 
-    // Give back the final text and count.
-    str.swap(finalText);
-    return lineCount;
+    compiled.lineCount = lineCount;
+    return compiled;
 }
 
 // Routine Description:
@@ -1116,40 +1063,33 @@ size_t Alias::s_ReplaceMacros(std::wstring& str,
 std::wstring Alias::s_MatchAndCopyAlias(std::wstring_view sourceText, const std::wstring& exeName, size_t& lineCount)
 {
     // Check if we have an EXE in the list that matches the request first.
-    auto exeIter = g_aliasData.find(exeName);
+    const auto exeIter = g_aliasData.find(exeName);
     if (exeIter == g_aliasData.end())
     {
         // We found no data for this exe. Give back an empty string.
         return std::wstring();
     }
 
-    auto exeList = exeIter->second;
+    const auto& exeList = exeIter->second;
     if (exeList.size() == 0)
     {
         // If there's no match, give back an empty string.
         return std::wstring();
     }
 
-    // Tokenize the text by spaces
+    // Tokenize the text by spaces. The first token is the alias.
     const auto tokens = s_Tokenize(sourceText);
 
-    // If there are no tokens, return an empty string
-    if (tokens.size() == 0)
-    {
-        return std::wstring();
-    }
-
     // Find alias. If there isn't one, return an empty string
-    const auto alias = tokens.front();
-    const auto aliasIter = exeList.find(alias);
+    const auto aliasIter = exeList.find(tokens[0]);
     if (aliasIter == exeList.end())
     {
         // We found no alias pair with this name. Give back an empty string.
         return std::wstring();
     }
 
-    const auto& target = aliasIter->second;
-    if (target.size() == 0)
+    const auto& compiled = aliasIter->second;
+    if (compiled.target.size() == 0)
     {
         return std::wstring();
     }
@@ -1157,10 +1097,33 @@ std::wstring Alias::s_MatchAndCopyAlias(std::wstring_view sourceText, const std:
     // Get the string of all parameters as a shorthand for $* later.
     const auto allParams = s_GetArgString(sourceText);
 
+    const auto resolve = [&](const CompiledTarget::Op& op) {
+        switch (op.argument)
+        {
+        case 0:
+            return std::wstring_view{ compiled.text }.substr(op.offset, op.length);
+        case CompiledTarget::AllArguments:
+            return allParams;
+        default:
+            return til::at(tokens, op.argument);
+        }
+    };
+
     // The final text will be the target but with macros replaced.
-    auto finalText = target;
-    lineCount = s_ReplaceMacros(finalText, tokens, allParams);
+    size_t length = 0;
+    for (const auto& op : compiled.ops)
+    {
+        length += resolve(op).size();
+    }
+
+    std::wstring finalText;
+    finalText.reserve(length);
+    for (const auto& op : compiled.ops)
+    {
+        finalText.append(resolve(op));
+    }
 
+    lineCount = compiled.lineCount;
     return finalText;
 }
 
@@ -1169,7 +1132,7 @@ void Alias::s_TestAddAlias(std::wstring& exe,
                            std::wstring& alias,
                            std::wstring& target)
 {
-    g_aliasData[exe][alias] = target;
+    g_aliasData[exe][alias] = s_CompileTarget(target);
 }
 
 void Alias::s_TestClearAliases()
@@ -14,23 +14,38 @@ Abstract:
 class Alias
 {
 public:
+    // An alias target, parsed once when the alias is defined, so that expanding it
+    // for each line of cooked read input is a simple concatenation of strings.
+    struct CompiledTarget
+    {
+        // Each op appends either text[offset, offset + length) or an argument of the command line.
+        struct Op
+        {
+            // 0 for text, 1-9 for the numbered arguments $1-$9 and AllArguments for $*.
+            uint16_t argument = 0;
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        static constexpr uint16_t AllArguments = 10;
+
+        // The target as it was defined, which is what GetConsoleAlias() and GetConsoleAliases() return.
+        std::wstring target;
+        // The literal parts of the target with the $L, $G, $B and $T macros replaced, including the trailing CRLF.
+        std::wstring text;
+        std::vector<Op> ops;
+        size_t lineCount = 0;
+    };
+
     static void s_ClearCmdExeAliases();
 
     static std::wstring s_MatchAndCopyAlias(std::wstring_view sourceText, const std::wstring& exeName, size_t& lineCount);
 
-private:
-    static std::deque<std::wstring> s_Tokenize(const std::wstring_view str);
-    static std::wstring s_GetArgString(const std::wstring_view str);
-    static size_t s_ReplaceMacros(std::wstring& str,
-                                  const std::deque<std::wstring>& tokens,
-                                  const std::wstring& fullArgString);
+    static CompiledTarget s_CompileTarget(const std::wstring_view target);
 
-    static bool s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::deque<std::wstring>& tokens);
-    static bool s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::wstring fullArgString);
+private:
+    static std::array<std::wstring_view, 10> s_Tokenize(const std::wstring_view str);
+    static std::wstring_view s_GetArgString(const std::wstring_view str);
 
     static bool s_TryReplaceInputRedirMacro(const wchar_t ch,
                                             std::wstring& appendToStr);
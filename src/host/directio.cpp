@@ -463,6 +463,135 @@ CATCH_RETURN();
     return result;
 }
 
+static_assert(sizeof(CHAR_INFO) == 4 && offsetof(CHAR_INFO, Attributes) == 2);
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+// Routine Description:
+// - Interleaves the given characters with the given attributes into CHAR_INFOs.
+static void _PackCharInfos(const wchar_t* chars, const WORD attributes, CHAR_INFO* target, size_t count) noexcept
+{
+#if defined(TIL_SSE_INTRINSICS)
+    const auto attr = _mm_set1_epi16(static_cast<short>(attributes));
+    for (; count >= 8; count -= 8, chars += 8, target += 8)
+    {
+        const auto ch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 0), _mm_unpacklo_epi16(ch, attr));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4), _mm_unpackhi_epi16(ch, attr));
+    }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    uint16x8x2_t v;
+    v.val[1] = vdupq_n_u16(attributes);
+    for (; count >= 8; count -= 8, chars += 8, target += 8)
+    {
+        v.val[0] = vld1q_u16(reinterpret_cast<const uint16_t*>(chars));
+        vst2q_u16(reinterpret_cast<uint16_t*>(target), v);
+    }
+#endif
+
+    for (; count; --count, ++chars, ++target)
+    {
+        target->Char.UnicodeChar = *chars;
+        target->Attributes = attributes;
+    }
+}
+
+// Routine Description:
+// - Splits the given CHAR_INFOs into their characters and attributes.
+// Return Value:
+// - All attributes OR'd together, which allows the caller to check for DBCS flags.
+static WORD _UnpackCharInfos(const CHAR_INFO* source, wchar_t* chars, WORD* attributes, size_t count) noexcept
+{
+    WORD flags = 0;
+
+#if defined(TIL_SSE_INTRINSICS)
+    auto flagsVec = _mm_setzero_si128();
+    for (; count >= 8; count -= 8, source += 8, chars += 8, attributes += 8)
+    {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 0));
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4));
+        // Sign-extending each 16-bit half into 32 bits makes the signed saturation of _mm_packs_epi32 lossless.
+        const auto ch = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16), _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+        const auto attr = _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(chars), ch);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(attributes), attr);
+        flagsVec = _mm_or_si128(flagsVec, attr);
+    }
+    flagsVec = _mm_or_si128(flagsVec, _mm_srli_si128(flagsVec, 8));
+    flagsVec = _mm_or_si128(flagsVec, _mm_srli_si128(flagsVec, 4));
+    flagsVec = _mm_or_si128(flagsVec, _mm_srli_si128(flagsVec, 2));
+    flags = static_cast<WORD>(_mm_cvtsi128_si32(flagsVec));
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    auto flagsVec = vdupq_n_u16(0);
+    for (; count >= 8; count -= 8, source += 8, chars += 8, attributes += 8)
+    {
+        const auto v = vld2q_u16(reinterpret_cast<const uint16_t*>(source));
+        vst1q_u16(reinterpret_cast<uint16_t*>(chars), v.val[0]);
+        vst1q_u16(attributes, v.val[1]);
+        flagsVec = vorrq_u16(flagsVec, v.val[1]);
+    }
+    uint16_t lanes[8];
+    vst1q_u16(&lanes[0], flagsVec);
+    for (const auto lane : lanes)
+    {
+        flags |= lane;
+    }
+#endif
+
+    for (; count; --count, ++source, ++chars, ++attributes)
+    {
+        *chars = source->Char.UnicodeChar;
+        *attributes = source->Attributes;
+        flags |= source->Attributes;
+    }
+
+    return flags;
+}
+
+#pragma warning(pop)
+
+// Routine Description:
+// - Fast path for _ReadConsoleOutputWImplHelper. If the given part of a row consists of narrow,
+//   single-character glyphs only, it's converted into CHAR_INFOs directly from the row's text and
+//   attribute runs, instead of going through a TextBufferCellIterator cell by cell.
+// Return Value:
+// - false if the row contains wide or multi-character glyphs in that range. Nothing is written in that case.
+static bool _ReadSingleWidthCells(const ROW& row, const til::CoordType columnBegin, std::span<CHAR_INFO> target)
+{
+    const auto columnEnd = columnBegin + gsl::narrow_cast<til::CoordType>(target.size());
+    if (!row.IsSingleWidth(columnBegin, columnEnd))
+    {
+        return false;
+    }
+
+    const auto text = row.GetText(columnBegin, columnEnd);
+    const auto& table = row.AttributeTable();
+    til::CoordType runBegin = 0;
+
+    for (const auto& run : row.Attributes().runs())
+    {
+        const auto runEnd = runBegin + run.length;
+        const auto beg = std::max(runBegin, columnBegin);
+        const auto end = std::min(runEnd, columnEnd);
+        if (beg < end)
+        {
+            const auto offset = gsl::narrow_cast<size_t>(beg - columnBegin);
+            // This is what CONSOLE_INFORMATION::AsCharInfo() does for a single-width glyph.
+            const auto attributes = table.Get(run.value).GetLegacyAttributes();
+            _PackCharInfos(text.data() + offset, attributes, target.data() + offset, gsl::narrow_cast<size_t>(end - beg));
+        }
+        if (runEnd >= columnEnd)
+        {
+            break;
+        }
+        runBegin = runEnd;
+    }
+
+    return true;
+}
+
 [[nodiscard]] static HRESULT _ReadConsoleOutputWImplHelper(const SCREEN_INFORMATION& context,
                                                            std::span<CHAR_INFO> targetBuffer,
                                                            const Microsoft::Console::Types::Viewport& requestRectangle,
@@ -507,41 +636,31 @@ CATCH_RETURN();
 
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
+        const auto clippedSize = clippedRequestRectangle.Dimensions();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        til::point targetPos;
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Walk through every row of the clipped request and copy it into the corresponding
+        // part of the target. Cells of the target outside the clipped request are skipped.
+        // The user's buffer may be smaller than the request, so we must stop at its end.
+        for (til::CoordType y = 0; y < clippedSize.height; ++y)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            const auto targetOffset = gsl::narrow_cast<size_t>((targetPoint.y + y) * targetSize.width + targetPoint.x);
+            if (targetOffset >= targetBuffer.size())
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                ++sourceIter;
+                break;
             }
 
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            ++targetIter;
+            const auto target = targetBuffer.subspan(targetOffset, std::min<size_t>(clippedSize.width, targetBuffer.size() - targetOffset));
+            const til::point source{ sourcePoint.x, sourcePoint.y + y };
 
-            // Increment the target
-            targetPos.x++;
-            if (targetPos.x >= targetSize.width)
+            if (!_ReadSingleWidthCells(storageBuffer.GetRowByOffset(source.y), source.x, target))
             {
-                targetPos.x = 0;
-                targetPos.y++;
+                // Get an iterator to the beginning of this row of the request inside the screen buffer.
+                auto sourceIter = storageBuffer.GetCellDataAt(source, clippedRequestRectangle);
+                for (auto& cell : target)
+                {
+                    cell = gci.AsCharInfo(*sourceIter);
+                    ++sourceIter;
+                }
             }
         }
 
@@ -667,9 +786,15 @@ CATCH_RETURN();
         }
 
         const auto writeRectangle = Viewport::FromInclusive(writeRegion);
+        const auto writeWidth = gsl::narrow_cast<size_t>(writeRectangle.Width());
 
+        auto& textBuffer = storageBuffer.GetTextBuffer();
         auto target = writeRectangle.Origin();
 
+        // Scratch space for splitting CHAR_INFOs up into the text and attributes that ROW stores.
+        const auto chars = std::make_unique_for_overwrite<wchar_t[]>(writeWidth);
+        const auto attributes = std::make_unique_for_overwrite<WORD[]>(writeWidth);
+
         // For every row in the request, create a view into the clamped portion of just the one line to write.
         // This allows us to restrict the width of the call without allocating/copying any memory by just making
         // a smaller view over the existing big blob of data from the original call.
@@ -681,7 +806,17 @@ CATCH_RETURN();
             const auto totalOffset = rowOffset + colOffset;
 
             // Now we make a subspan starting from that offset for as much of the original request as would fit
-            const auto subspan = buffer.subspan(totalOffset, writeRectangle.Width());
+            const auto subspan = buffer.subspan(totalOffset, writeWidth);
+
+            // Without DBCS flags, every CHAR_INFO is exactly 1 character that occupies exactly 1 column
+            // (see ROW::WriteCells). Such rows can be written in bulk instead of cell by cell.
+            const auto flags = _UnpackCharInfos(subspan.data(), chars.get(), attributes.get(), writeWidth);
+            if (WI_AreAllFlagsClear(flags, COMMON_LVB_LEADING_BYTE | COMMON_LVB_TRAILING_BYTE))
+            {
+                auto& row = textBuffer.GetMutableRowByOffset(target.y);
+                row.ReplaceLegacyCells(target.x, { chars.get(), writeWidth }, { attributes.get(), writeWidth });
+                continue;
+            }
 
             // Convert to a CHAR_INFO view to fit into the iterator
             const auto charInfos = std::span<const CHAR_INFO>(subspan.data(), subspan.size());
@@ -691,6 +826,9 @@ CATCH_RETURN();
             storageBuffer.Write(it, target);
         }
 
+        // The rows written via ROW::ReplaceLegacyCells() still need to be redrawn.
+        textBuffer.TriggerRedraw(writeRectangle);
+
         // Since we've managed to write part of the request, return the clamped part that we actually used.
         writtenRectangle = writeRectangle;
 
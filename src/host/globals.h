@@ -24,6 +24,7 @@ Revision History:
 
 #include "../propslib/DelegationConfig.hpp"
 #include "../renderer/base/Renderer.hpp"
+#include "../server/ApiMetrics.h"
 #include "../server/DeviceComm.h"
 #include "../server/ConDrvDeviceComm.h"
 
@@ -46,6 +47,7 @@ public:
     CONSOLE_INFORMATION& getConsoleInformation();
 
     IDeviceComm* pDeviceComm{ nullptr };
+    ApiMetrics apiMetrics;
 
     wil::unique_event_nothrow hInputEvent;
 
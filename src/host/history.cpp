@@ -55,6 +55,11 @@ void CommandHistory::s_Free(const HANDLE processHandle)
     const auto History = CommandHistory::s_Find(processHandle);
     if (History)
     {
+        if (ServiceLocator::LocateGlobals().getConsoleInformation().GetPersistHistory())
+        {
+            History->_SavePersisted();
+        }
+
         WI_ClearFlag(History->Flags, CLE_ALLOCATED);
         History->_processHandle = nullptr;
     }
@@ -86,6 +91,67 @@ void CommandHistory::_Reset()
     WI_SetFlag(Flags, CLE_RESET);
 }
 
+// Routine Description:
+// - Returns the path the history of the given application is persisted at.
+// Return Value:
+// - The path or an empty string if the name can't be used as a file name. The name comes from the client.
+std::wstring CommandHistory::_PersistedPath(const std::wstring_view appName)
+{
+    if (appName.empty() || appName == L"." || appName == L".." || appName.find_first_of(L"\\/:*?\"<>|") != std::wstring_view::npos)
+    {
+        return {};
+    }
+
+    auto path = wil::ExpandEnvironmentStringsW<std::wstring>(L"%LOCALAPPDATA%\\Microsoft\\Console\\History\\");
+    path.append(appName);
+    path.append(L".bin");
+    return path;
+}
+
+// Routine Description:
+// - Replaces the commands with the ones the last process with the same name left behind, if any.
+void CommandHistory::_LoadPersisted()
+try
+{
+    const auto path = _PersistedPath(_appName);
+    if (path.empty())
+    {
+        return;
+    }
+
+    const auto hr = _commands.Load(path.c_str());
+    if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || hr == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND))
+    {
+        return;
+    }
+    LOG_IF_FAILED(hr);
+
+    // The history size may have been lowered since the file was written.
+    while (GetNumberOfCommands() > std::max(0, _maxCommands))
+    {
+        _commands.PopFront();
+    }
+    _Reset();
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Saves the commands, so that the next process with the same name can continue where this one left off.
+void CommandHistory::_SavePersisted() const
+try
+{
+    const auto path = _PersistedPath(_appName);
+    if (path.empty())
+    {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path{ path }.parent_path(), ec);
+    LOG_IF_FAILED(_commands.Save(path.c_str()));
+}
+CATCH_LOG()
+
 [[nodiscard]] HRESULT CommandHistory::Add(const std::wstring_view newCommand,
                                           const bool suppressDuplicates)
 {
@@ -99,49 +165,33 @@ void CommandHistory::_Reset()
 
     try
     {
-        if (_commands.size() == 0 ||
-            _commands.back().size() != newCommand.size() ||
-            !std::equal(_commands.back().cbegin(),
-                        _commands.back().cbegin() + newCommand.size(),
-                        newCommand.cbegin(),
-                        newCommand.cend()))
+        if (_commands.empty() || _commands.Back() != newCommand)
         {
-            std::wstring reuse{};
+            // newCommand may point into _commands (e.g. if it came from GetNth()), which Remove() would invalidate.
+            const std::wstring command{ newCommand };
 
             if (suppressDuplicates)
             {
                 Index index;
-                if (FindMatchingCommand(newCommand, LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch))
+                if (FindMatchingCommand(command, LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch))
                 {
-                    reuse = Remove(index);
+                    Remove(index);
                 }
             }
 
             // find free record.  if all records are used, free the lru one.
             if (GetNumberOfCommands() == _maxCommands)
             {
-                _commands.erase(_commands.cbegin());
+                _commands.PopFront();
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
             }
 
             // add newCommand to array
-            if (!reuse.empty())
-            {
-                _commands.emplace_back(reuse);
-            }
-            else
-            {
-                _commands.emplace_back(newCommand);
-            }
+            _commands.PushBack(command);
 
-            if (LastDisplayed == -1 ||
-                _commands.at(LastDisplayed).size() != newCommand.size() ||
-                !std::equal(_commands.at(LastDisplayed).cbegin(),
-                            _commands.at(LastDisplayed).cbegin() + newCommand.size(),
-                            newCommand.cbegin(),
-                            newCommand.cend()))
+            if (LastDisplayed == -1 || GetNth(LastDisplayed) != command)
             {
                 _Reset();
             }
@@ -157,16 +207,11 @@ std::wstring_view CommandHistory::GetNth(Index index) const
 {
     if (index >= 0 && index < GetNumberOfCommands())
     {
-        return _commands.at(index);
+        return _commands.At(gsl::narrow_cast<size_t>(index));
     }
     return {};
 }
 
-const std::vector<std::wstring>& CommandHistory::GetCommands() const noexcept
-{
-    return _commands;
-}
-
 std::wstring_view CommandHistory::Retrieve(const SearchDirection searchDirection)
 {
     if (searchDirection == SearchDirection::Previous)
@@ -200,7 +245,7 @@ std::wstring_view CommandHistory::RetrieveNth(Index index)
     }
 
     LastDisplayed = std::clamp(index, 0, GetNumberOfCommands() - 1);
-    return _commands.at(LastDisplayed);
+    return _commands.At(gsl::narrow_cast<size_t>(LastDisplayed));
 }
 
 std::wstring_view CommandHistory::GetLastCommand() const
@@ -210,7 +255,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 
 void CommandHistory::Empty()
 {
-    _commands.clear();
+    _commands.Clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -243,7 +288,7 @@ void CommandHistory::Realloc(const Index commands)
         return;
     }
 
-    _commands.resize(std::min(_commands.size(), gsl::narrow_cast<size_t>(std::max(0, commands))));
+    _commands.Truncate(gsl::narrow_cast<size_t>(std::max(0, commands)));
 
     WI_SetFlag(Flags, CLE_RESET);
     LastDisplayed = GetNumberOfCommands() - 1;
@@ -323,7 +368,13 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         History.LastDisplayed = -1;
         History._maxCommands = gsl::narrow<Index>(gci.GetHistoryBufferSize());
         History._processHandle = processHandle;
-        return &s_historyLists.emplace_front(History);
+
+        auto& history = s_historyLists.emplace_front(History);
+        if (gci.GetPersistHistory())
+        {
+            history._LoadPersisted();
+        }
+        return &history;
     }
 
     // If we have no candidate already and we need one,
@@ -348,9 +399,14 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
     {
         if (!SameApp)
         {
-            BestCandidate->_commands.clear();
+            BestCandidate->_commands.Clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
+
+            if (gci.GetPersistHistory())
+            {
+                BestCandidate->_LoadPersisted();
+            }
         }
 
         BestCandidate->_processHandle = processHandle;
@@ -412,8 +468,8 @@ std::wstring CommandHistory::Remove(const Index iDel)
         return {};
     }
 
-    const auto str = std::move(_commands.at(iDel));
-    _commands.erase(_commands.begin() + iDel);
+    std::wstring str{ _commands.At(gsl::narrow_cast<size_t>(iDel)) };
+    _commands.Erase(gsl::narrow_cast<size_t>(iDel));
 
     if (LastDisplayed == iDel)
     {
@@ -427,6 +483,22 @@ std::wstring CommandHistory::Remove(const Index iDel)
     return str;
 }
 
+// Routine Description:
+// - Finds all commands that contain the given text. Used to filter the command list popup (F7).
+// Return Value:
+// - The indices of the matching commands, oldest first.
+std::vector<CommandHistory::Index> CommandHistory::FindSubstring(const std::wstring_view needle) const
+{
+    const auto indices = _commands.FindSubstring(needle);
+    std::vector<Index> result;
+    result.reserve(indices.size());
+    for (const auto index : indices)
+    {
+        result.emplace_back(gsl::narrow_cast<Index>(index));
+    }
+    return result;
+}
+
 // Routine Description:
 // - this routine finds the most recent command that starts with the letters already in the current command.  it returns the array index (no mod needed).
 [[nodiscard]] bool CommandHistory::FindMatchingCommand(const std::wstring_view givenCommand,
@@ -436,7 +508,7 @@ std::wstring CommandHistory::Remove(const Index iDel)
 {
     indexFound = startingIndex;
 
-    if (_commands.size() == 0)
+    if (_commands.empty())
     {
         return false;
     }
@@ -457,18 +529,12 @@ std::wstring CommandHistory::Remove(const Index iDel)
 
     try
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        // An indexFound of -1 wraps around to npos, which FindPrefix() treats as "not found".
+        const auto index = _commands.FindPrefix(givenCommand, gsl::narrow_cast<size_t>(indexFound), WI_IsFlagSet(options, MatchOptions::ExactMatch));
+        if (index != HistoryStore::npos)
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
-            {
-                if (til::starts_with(storedCommand, givenCommand))
-                {
-                    return true;
-                }
-            }
-
-            _Prev(indexFound);
+            indexFound = gsl::narrow_cast<Index>(index);
+            return true;
         }
     }
     CATCH_LOG();
@@ -495,7 +561,7 @@ void CommandHistory::Swap(const Index indexA, const Index indexB)
         indexA >= 0 && indexA < num &&
         indexB >= 0 && indexB < num)
     {
-        std::swap(_commands.at(indexA), _commands.at(indexB));
+        _commands.Swap(gsl::narrow_cast<size_t>(indexA), gsl::narrow_cast<size_t>(indexB));
     }
 }
 
@@ -618,8 +684,9 @@ HRESULT GetConsoleCommandHistoryLengthImplHelper(const std::wstring_view exeName
         // Every command history item is made of a string length followed by 1 null character.
         const size_t cchNull = 1;
 
-        for (const auto& command : pCommandHistory->GetCommands())
+        for (CommandHistory::Index i = 0, count = pCommandHistory->GetNumberOfCommands(); i < count; ++i)
         {
+            const auto command = pCommandHistory->GetNth(i);
             auto cchCommand = command.size();
 
             // If we're counting how much multibyte space will be needed, trial convert the command string before we add.
@@ -724,8 +791,9 @@ HRESULT GetConsoleCommandHistoryWImplHelper(const std::wstring_view exeName,
 
         const size_t cchNull = 1;
 
-        for (const auto& command : CommandHistory->GetCommands())
+        for (CommandHistory::Index i = 0, count = CommandHistory->GetNumberOfCommands(); i < count; ++i)
         {
+            const auto command = CommandHistory->GetNth(i);
             const auto cchCommand = command.size();
 
             size_t cchNeeded;
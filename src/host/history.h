@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "historyStore.h"
+
 class CommandHistory
 {
 public:
@@ -38,6 +40,7 @@ public:
                              const Index startingIndex,
                              Index& indexFound,
                              const MatchOptions options);
+    std::vector<Index> FindSubstring(const std::wstring_view needle) const;
     bool IsAppNameMatch(const std::wstring_view other) const;
 
     [[nodiscard]] HRESULT Add(const std::wstring_view command,
@@ -48,7 +51,6 @@ public:
 
     Index GetNumberOfCommands() const;
     std::wstring_view GetNth(Index index) const;
-    const std::vector<std::wstring>& GetCommands() const noexcept;
 
     void Realloc(Index commands);
     void Empty();
@@ -65,6 +67,10 @@ public:
 private:
     void _Reset();
 
+    static std::wstring _PersistedPath(const std::wstring_view appName);
+    void _LoadPersisted();
+    void _SavePersisted() const;
+
     // _Next and _Prev go to the next and prev command
     // _Inc  and _Dec go to the next and prev slots
     // Don't get the two confused - it matters when the cmd history is not full!
@@ -73,9 +79,8 @@ private:
     void _Dec(Index& ind) const;
     void _Inc(Index& ind) const;
 
-    // NOTE: In conhost v1 this used to be a circular buffer because removal at the
-    // start is a very common operation. It seems this was lost in the C++ refactor.
-    std::vector<std::wstring> _commands;
+    // Like in conhost v1, removing the oldest command is O(1), as it's a very common operation.
+    HistoryStore _commands;
     Index _maxCommands = 0;
 
     std::wstring _appName;
@@ -0,0 +1,798 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "historyStore.h"
+
+#include <til/hash.h>
+
+// The serialized form of a HistoryStore is this header, followed by the length of each unique string (uint32_t),
+// followed by the index of each entry's string (uint32_t), followed by the text of all unique strings (wchar_t).
+struct SerializedHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stringCount;
+    uint32_t entryCount;
+    uint32_t textLength;
+};
+
+static constexpr uint32_t serializedMagic = 0x54534948; // "HIST"
+static constexpr uint32_t serializedVersion = 1;
+// A history is a few KiB at most. Anything much larger than this is most likely not a history file.
+static constexpr uint64_t serializedMaxSize = 64 * 1024 * 1024;
+
+size_t HistoryStore::size() const noexcept
+{
+    return _entries.size();
+}
+
+bool HistoryStore::empty() const noexcept
+{
+    return _entries.empty();
+}
+
+// Returns the command at the given index or an empty string if the index is out of range.
+// The returned string is null-terminated and stays valid until the next modification.
+std::wstring_view HistoryStore::At(const size_t index) const noexcept
+{
+    return index < _entries.size() ? _text(_entries[index]) : std::wstring_view{};
+}
+
+std::wstring_view HistoryStore::Back() const noexcept
+{
+    return _entries.empty() ? std::wstring_view{} : _text(_entries.back());
+}
+
+// Appends a command. If the same text is already stored, only its reference count is increased.
+void HistoryStore::PushBack(const std::wstring_view command)
+{
+    if (_entries.size() >= UINT32_MAX - _frontPosition)
+    {
+        _rebasePositions();
+    }
+
+    const auto id = _intern(command);
+    const auto position = gsl::narrow_cast<uint32_t>(_frontPosition + _entries.size());
+
+    try
+    {
+        _insertPosition(id, position);
+        try
+        {
+            _entries.push_back(id);
+        }
+        catch (...)
+        {
+            _erasePosition(id, position);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        _release(id);
+        throw;
+    }
+
+    // Released strings leave holes in the arena. Once they make up the majority of it, we copy the live strings
+    // into a fresh arena. This is only done here (and not in _release()) so that removals don't invalidate
+    // the string_views callers may still be holding on to.
+    if (_arenaGarbage > 1024 && _arenaGarbage > _arena.size() / 2)
+    {
+        try
+        {
+            _compactArena();
+        }
+        CATCH_LOG();
+    }
+}
+
+void HistoryStore::PopFront() noexcept
+{
+    if (!_entries.empty())
+    {
+        const auto id = _entries.front();
+        _erasePosition(id, _frontPosition);
+        _entries.pop_front();
+        _frontPosition++;
+        _release(id);
+    }
+}
+
+void HistoryStore::Erase(const size_t index) noexcept
+{
+    const auto count = _entries.size();
+    if (index >= count)
+    {
+        return;
+    }
+
+    const auto it = _entries.begin() + index;
+    const auto id = *it;
+    _erasePosition(id, gsl::narrow_cast<uint32_t>(_frontPosition + index));
+
+    // Close the gap from whichever side has fewer entries to renumber.
+    // Moving each entry by one into the gap doesn't change the order of any string's positions.
+    if (index < count / 2)
+    {
+        for (auto i = index; i > 0; --i)
+        {
+            const auto position = gsl::narrow_cast<uint32_t>(_frontPosition + i - 1);
+            _movePosition(_entries[i - 1], position, position + 1);
+        }
+        _frontPosition++;
+    }
+    else
+    {
+        for (auto i = index + 1; i < count; ++i)
+        {
+            const auto position = gsl::narrow_cast<uint32_t>(_frontPosition + i);
+            _movePosition(_entries[i], position, position - 1);
+        }
+    }
+
+    _entries.erase(it, it + 1);
+    _release(id);
+}
+
+// Removes the newest entries until at most count entries remain.
+void HistoryStore::Truncate(const size_t count) noexcept
+{
+    while (_entries.size() > count)
+    {
+        const auto id = _entries.back();
+        _erasePosition(id, gsl::narrow_cast<uint32_t>(_frontPosition + _entries.size() - 1));
+        _entries.erase(_entries.end() - 1, _entries.end());
+        _release(id);
+    }
+}
+
+void HistoryStore::Swap(const size_t indexA, const size_t indexB) noexcept
+{
+    if (indexA < _entries.size() && indexB < _entries.size() && _entries[indexA] != _entries[indexB])
+    {
+        const auto positionA = gsl::narrow_cast<uint32_t>(_frontPosition + indexA);
+        const auto positionB = gsl::narrow_cast<uint32_t>(_frontPosition + indexB);
+        _movePosition(_entries[indexA], positionA, positionB);
+        _movePosition(_entries[indexB], positionB, positionA);
+        std::swap(_entries[indexA], _entries[indexB]);
+    }
+}
+
+// Removes all commands, but retains the allocations for reuse.
+void HistoryStore::Clear() noexcept
+{
+    _entries.clear();
+    _frontPosition = 0;
+    _positions.clear();
+    _strings.clear();
+    _freeHead = EmptySlot;
+    _arena.clear();
+    _arenaGarbage = 0;
+    std::fill(_slots.begin(), _slots.end(), EmptySlot);
+    _sorted.clear();
+    _trigrams.clear();
+}
+
+// Routine Description:
+// - Finds the newest command that starts with the given prefix, searching backwards
+//   from startingIndex and wrapping around to the newest entry once the oldest one was checked.
+// Arguments:
+// - prefix - The text to search for.
+// - startingIndex - The index of the first entry to check.
+// - exact - If true, the command must be equal to the prefix.
+// Return Value:
+// - The index of the entry or npos if none matched.
+size_t HistoryStore::FindPrefix(const std::wstring_view prefix, const size_t startingIndex, const bool exact) const noexcept
+{
+    if (startingIndex >= _entries.size())
+    {
+        return npos;
+    }
+
+    if (exact)
+    {
+        const auto id = til::at(_slots, _findSlot(prefix));
+        return id == EmptySlot ? npos : _findNewest({ &id, 1 }, startingIndex);
+    }
+
+    const auto beg = std::lower_bound(_sorted.begin(), _sorted.end(), prefix, [&](const StringId id, const std::wstring_view text) {
+        return _text(id) < text;
+    });
+    const auto end = std::partition_point(beg, _sorted.end(), [&](const StringId id) {
+        return til::starts_with(_text(id), prefix);
+    });
+
+    return _findNewest({ beg, end }, startingIndex);
+}
+
+// Routine Description:
+// - Finds all commands that contain the given text.
+// Arguments:
+// - needle - The text to search for. An empty needle matches all commands.
+// Return Value:
+// - The indices of the matching entries in ascending (chronological) order.
+std::vector<size_t> HistoryStore::FindSubstring(const std::wstring_view needle) const
+{
+    std::vector<StringId> ids;
+
+    if (needle.size() < 3)
+    {
+        // Too short for the trigram index. There are at most as many unique strings as entries, so this is still cheap.
+        for (const auto id : _sorted)
+        {
+            if (_text(id).find(needle) != std::wstring_view::npos)
+            {
+                ids.emplace_back(id);
+            }
+        }
+    }
+    else
+    {
+        // Every string that contains the needle also contains all of its trigrams.
+        // The rarest trigram gives us the fewest candidates to verify.
+        const std::vector<StringId>* candidates = nullptr;
+        for (size_t i = 0; i + 3 <= needle.size(); ++i)
+        {
+            const auto it = _trigrams.find(_trigramKey(needle, i));
+            if (it == _trigrams.end())
+            {
+                return {};
+            }
+            if (!candidates || it->second.size() < candidates->size())
+            {
+                candidates = &it->second;
+            }
+        }
+
+        for (const auto id : *candidates)
+        {
+            if (_text(id).find(needle) != std::wstring_view::npos)
+            {
+                ids.emplace_back(id);
+            }
+        }
+    }
+
+    // Each matching string knows the positions of its entries, so we only visit the entries that match.
+    std::vector<size_t> indices;
+    for (const auto id : ids)
+    {
+        const auto [beg, end] = _positionsOf(id);
+        for (auto it = beg; it != end; ++it)
+        {
+            indices.emplace_back(gsl::narrow_cast<uint32_t>(*it) - _frontPosition);
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+// Returns the history in a compact binary form, suitable for persisting it to disk. See SerializedHeader.
+std::vector<uint8_t> HistoryStore::Serialize() const
+{
+    // Number the unique strings densely in the order of their first use.
+    std::vector<StringId> remap(_strings.size(), EmptySlot);
+    std::vector<StringId> order;
+    size_t textLength = 0;
+
+    for (const auto id : _entries)
+    {
+        auto& index = til::at(remap, id);
+        if (index == EmptySlot)
+        {
+            index = gsl::narrow_cast<StringId>(order.size());
+            order.emplace_back(id);
+            textLength += til::at(_strings, id).length;
+        }
+    }
+
+    const SerializedHeader header{
+        .magic = serializedMagic,
+        .version = serializedVersion,
+        .stringCount = gsl::narrow<uint32_t>(order.size()),
+        .entryCount = gsl::narrow<uint32_t>(_entries.size()),
+        .textLength = gsl::narrow<uint32_t>(textLength),
+    };
+
+    std::vector<uint8_t> data;
+    data.reserve(sizeof(header) + (order.size() + _entries.size()) * sizeof(uint32_t) + textLength * sizeof(wchar_t));
+
+    const auto write = [&](const void* ptr, const size_t bytes) {
+        const auto beg = static_cast<const uint8_t*>(ptr);
+        data.insert(data.end(), beg, beg + bytes);
+    };
+
+    write(&header, sizeof(header));
+    for (const auto id : order)
+    {
+        write(&til::at(_strings, id).length, sizeof(uint32_t));
+    }
+    for (const auto id : _entries)
+    {
+        write(&til::at(remap, id), sizeof(uint32_t));
+    }
+    for (const auto id : order)
+    {
+        const auto text = _text(id);
+        write(text.data(), text.size() * sizeof(wchar_t));
+    }
+
+    return data;
+}
+
+// Replaces the contents of this history with the one produced by Serialize().
+// Throws HRESULT_FROM_WIN32(ERROR_INVALID_DATA) if the data is malformed, in which case the history remains unchanged.
+void HistoryStore::Deserialize(const std::span<const uint8_t> data)
+{
+    static constexpr auto invalid = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+    size_t pos = 0;
+    const auto read = [&](void* ptr, const size_t bytes) {
+        THROW_HR_IF(invalid, bytes > data.size() - pos);
+        if (bytes)
+        {
+            memcpy(ptr, data.data() + pos, bytes);
+        }
+        pos += bytes;
+    };
+
+    SerializedHeader header{};
+    read(&header, sizeof(header));
+    THROW_HR_IF(invalid, header.magic != serializedMagic || header.version != serializedVersion);
+    // Validate the counts before we allocate anything based on them.
+    const auto expectedSize = (uint64_t{ header.stringCount } + header.entryCount) * sizeof(uint32_t) + uint64_t{ header.textLength } * sizeof(wchar_t);
+    THROW_HR_IF(invalid, expectedSize != data.size() - pos);
+
+    std::vector<uint32_t> lengths(header.stringCount);
+    std::vector<uint32_t> indices(header.entryCount);
+    std::wstring text(header.textLength, L'\0');
+    read(lengths.data(), lengths.size() * sizeof(uint32_t));
+    read(indices.data(), indices.size() * sizeof(uint32_t));
+    read(text.data(), text.size() * sizeof(wchar_t));
+
+    std::vector<std::wstring_view> strings;
+    strings.reserve(lengths.size());
+    size_t offset = 0;
+    for (const auto length : lengths)
+    {
+        THROW_HR_IF(invalid, length > text.size() - offset);
+        strings.emplace_back(text.data() + offset, length);
+        offset += length;
+    }
+    THROW_HR_IF(invalid, offset != text.size());
+
+    HistoryStore store;
+    for (const auto index : indices)
+    {
+        THROW_HR_IF(invalid, index >= strings.size());
+        store.PushBack(til::at(strings, index));
+    }
+
+    *this = std::move(store);
+}
+
+// Routine Description:
+// - Writes the history to the given file, replacing it if it already exists.
+// - The data is written to a temporary file next to it first, so that a failed write doesn't destroy an existing history.
+// Return Value:
+// - S_OK or a suitable HRESULT on failure.
+[[nodiscard]] HRESULT HistoryStore::Save(const wchar_t* path) const noexcept
+try
+{
+    const auto data = Serialize();
+    const auto tmpPath = std::wstring{ path } + L".tmp";
+
+    {
+        const wil::unique_hfile file{ CreateFileW(tmpPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        RETURN_LAST_ERROR_IF(!file);
+
+        auto deleteTmp = wil::scope_exit([&]() noexcept {
+            DeleteFileW(tmpPath.c_str());
+        });
+
+        const auto size = gsl::narrow<DWORD>(data.size());
+        DWORD written = 0;
+        RETURN_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), data.data(), size, &written, nullptr));
+        RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_WRITE_FAULT), written != size);
+
+        deleteTmp.release();
+    }
+
+    if (!MoveFileExW(tmpPath.c_str(), path, MOVEFILE_REPLACE_EXISTING))
+    {
+        const auto hr = HRESULT_FROM_WIN32(GetLastError());
+        DeleteFileW(tmpPath.c_str());
+        return hr;
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Replaces the history with the contents of a file written by Save().
+// Return Value:
+// - S_OK or a suitable HRESULT on failure, in which case the history remains unchanged.
+[[nodiscard]] HRESULT HistoryStore::Load(const wchar_t* path) noexcept
+try
+{
+    const wil::unique_hfile file{ CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    RETURN_LAST_ERROR_IF(!file);
+
+    LARGE_INTEGER size{};
+    RETURN_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &size));
+    RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE), gsl::narrow_cast<uint64_t>(size.QuadPart) > serializedMaxSize);
+
+    std::vector<uint8_t> data(gsl::narrow_cast<size_t>(size.QuadPart));
+    DWORD read = 0;
+    RETURN_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), data.data(), gsl::narrow<DWORD>(data.size()), &read, nullptr));
+    data.resize(read);
+
+    Deserialize(data);
+    return S_OK;
+}
+CATCH_RETURN()
+
+std::wstring_view HistoryStore::_text(const StringId id) const noexcept
+{
+    const auto& str = til::at(_strings, id);
+    return { _arena.data() + str.offset, str.length };
+}
+
+// Returns the ID for the given text with its reference count incremented, adding it to the store if necessary.
+HistoryStore::StringId HistoryStore::_intern(const std::wstring_view text)
+{
+    if (_slots.empty())
+    {
+        _rehash(16);
+    }
+
+    const auto slot = _findSlot(text);
+    auto id = til::at(_slots, slot);
+
+    if (id != EmptySlot)
+    {
+        til::at(_strings, id).refs++;
+        return id;
+    }
+
+    THROW_HR_IF(E_OUTOFMEMORY, _arena.size() + text.size() >= UINT32_MAX);
+
+    if (_freeHead == EmptySlot)
+    {
+        THROW_HR_IF(E_OUTOFMEMORY, _strings.size() >= EmptySlot);
+        _strings.emplace_back(String{ EmptySlot, 0, 0 });
+        _freeHead = gsl::narrow_cast<StringId>(_strings.size() - 1);
+    }
+
+    // text may point into _arena (for instance if a caller re-adds the result of At()),
+    // which std::wstring::append() handles correctly even if it needs to reallocate.
+    const auto offset = _arena.size();
+    try
+    {
+        _arena.append(text);
+        _arena.push_back(L'\0');
+    }
+    catch (...)
+    {
+        _arena.resize(offset);
+        throw;
+    }
+
+    id = _freeHead;
+    auto& str = til::at(_strings, id);
+    _freeHead = str.offset;
+    str = { gsl::narrow_cast<uint32_t>(offset), gsl::narrow_cast<uint32_t>(text.size()), 1 };
+
+    auto cleanup = wil::scope_exit([&]() noexcept {
+        _unindex(id);
+        _arena.resize(offset);
+        til::at(_strings, id) = { _freeHead, 0, 0 };
+        _freeHead = id;
+    });
+
+    const auto newText = _text(id);
+    const auto it = std::lower_bound(_sorted.begin(), _sorted.end(), newText, [&](const StringId other, const std::wstring_view needle) {
+        return _text(other) < needle;
+    });
+    _sorted.insert(it, id);
+
+    // Keep the load factor at or below 50%, because linear probing degrades quickly past that.
+    if (_sorted.size() * 2 > _slots.size())
+    {
+        _rehash(_slots.size() * 2);
+    }
+    else
+    {
+        til::at(_slots, slot) = id;
+    }
+
+    _indexTrigrams(id);
+
+    cleanup.release();
+    return id;
+}
+
+// Decrements the reference count of the given ID and removes its text from all indices once it's unused.
+void HistoryStore::_release(const StringId id) noexcept
+{
+    auto& str = til::at(_strings, id);
+    if (--str.refs != 0)
+    {
+        return;
+    }
+
+    _unindex(id);
+    _arenaGarbage += str.length + 1;
+    str = { _freeHead, 0, 0 };
+    _freeHead = id;
+}
+
+// Removes the given ID from the hash table, _sorted and _trigrams. It's fine if some of them don't contain it,
+// which allows _intern() to use this to roll back a partial insertion.
+void HistoryStore::_unindex(const StringId id) noexcept
+{
+    _eraseSlot(id);
+
+    const auto text = _text(id);
+    const auto beg = std::lower_bound(_sorted.begin(), _sorted.end(), text, [&](const StringId other, const std::wstring_view needle) {
+        return _text(other) < needle;
+    });
+    if (beg != _sorted.end() && *beg == id)
+    {
+        _sorted.erase(beg);
+    }
+
+    _unindexTrigrams(id);
+}
+
+// Copies all live strings into a new arena, dropping the text of released strings.
+void HistoryStore::_compactArena()
+{
+    std::wstring arena;
+    arena.reserve(_arena.size() - _arenaGarbage);
+
+    // With the capacity reserved, nothing below can throw and leave the offsets half updated.
+    for (auto& str : _strings)
+    {
+        if (str.refs)
+        {
+            const auto offset = arena.size();
+            arena.append(_arena, str.offset, str.length + 1);
+            str.offset = gsl::narrow_cast<uint32_t>(offset);
+        }
+    }
+
+    _arena = std::move(arena);
+    _arenaGarbage = 0;
+}
+
+// Returns the index of the slot that either holds the ID for the given text or is empty.
+size_t HistoryStore::_findSlot(const std::wstring_view text) const noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto slot = til::hash(text) & mask;
+
+    for (;;)
+    {
+        const auto id = til::at(_slots, slot);
+        if (id == EmptySlot || _text(id) == text)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void HistoryStore::_rehash(const size_t slotCount)
+{
+    _slots.assign(slotCount, EmptySlot);
+
+    for (size_t id = 0; id < _strings.size(); ++id)
+    {
+        if (til::at(_strings, id).refs)
+        {
+            _insertSlot(gsl::narrow_cast<StringId>(id));
+        }
+    }
+}
+
+void HistoryStore::_insertSlot(const StringId id) noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto slot = til::hash(_text(id)) & mask;
+
+    while (til::at(_slots, slot) != EmptySlot)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    til::at(_slots, slot) = id;
+}
+
+// Removes the given ID from the hash table using backward shift deletion, which unlike
+// tombstones doesn't slowly fill up the table as commands come and go.
+void HistoryStore::_eraseSlot(const StringId id) noexcept
+{
+    const auto mask = _slots.size() - 1;
+    auto slot = til::hash(_text(id)) & mask;
+
+    for (;;)
+    {
+        const auto current = til::at(_slots, slot);
+        if (current == id)
+        {
+            break;
+        }
+        if (current == EmptySlot)
+        {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    auto hole = slot;
+    for (;;)
+    {
+        slot = (slot + 1) & mask;
+        const auto next = til::at(_slots, slot);
+        if (next == EmptySlot)
+        {
+            break;
+        }
+
+        // The entry may only move into the hole if the hole lies on its probe sequence,
+        // which is the case if its home slot is at least as far from it as the hole is.
+        const auto home = til::hash(_text(next)) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            til::at(_slots, hole) = next;
+            hole = slot;
+        }
+    }
+
+    til::at(_slots, hole) = EmptySlot;
+}
+
+uint64_t HistoryStore::_trigramKey(const std::wstring_view text, const size_t offset) noexcept
+{
+    return uint64_t{ til::at(text, offset) } << 32 | uint64_t{ til::at(text, offset + 1) } << 16 | til::at(text, offset + 2);
+}
+
+void HistoryStore::_indexTrigrams(const StringId id)
+{
+    const auto text = _text(id);
+
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+    {
+        auto& ids = _trigrams[_trigramKey(text, i)];
+        const auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it == ids.end() || *it != id)
+        {
+            ids.insert(it, id);
+        }
+    }
+}
+
+void HistoryStore::_unindexTrigrams(const StringId id) noexcept
+{
+    const auto text = _text(id);
+
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+    {
+        const auto entry = _trigrams.find(_trigramKey(text, i));
+        if (entry == _trigrams.end())
+        {
+            continue;
+        }
+
+        auto& ids = entry->second;
+        const auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id)
+        {
+            ids.erase(it);
+        }
+        if (ids.empty())
+        {
+            _trigrams.erase(entry);
+        }
+    }
+}
+
+// Sorting these keys sorts by string ID first and by position second.
+uint64_t HistoryStore::_positionKey(const StringId id, const uint32_t position) noexcept
+{
+    return uint64_t{ id } << 32 | position;
+}
+
+// Returns the range of _positions that belongs to the given string.
+std::pair<std::vector<uint64_t>::const_iterator, std::vector<uint64_t>::const_iterator> HistoryStore::_positionsOf(const StringId id) const noexcept
+{
+    // id is never EmptySlot and so id + 1 can't overflow.
+    const auto beg = std::lower_bound(_positions.begin(), _positions.end(), _positionKey(id, 0));
+    const auto end = std::lower_bound(beg, _positions.end(), _positionKey(id + 1, 0));
+    return { beg, end };
+}
+
+void HistoryStore::_insertPosition(const StringId id, const uint32_t position)
+{
+    const auto key = _positionKey(id, position);
+    _positions.insert(std::lower_bound(_positions.begin(), _positions.end(), key), key);
+}
+
+void HistoryStore::_erasePosition(const StringId id, const uint32_t position) noexcept
+{
+    const auto it = std::lower_bound(_positions.begin(), _positions.end(), _positionKey(id, position));
+    assert(it != _positions.end() && *it == _positionKey(id, position));
+    _positions.erase(it);
+}
+
+// Replaces the position `from` of the given string with `to`, keeping _positions sorted.
+// Only the range of the given string is affected, as the string ID is the most significant part of the key.
+void HistoryStore::_movePosition(const StringId id, const uint32_t from, const uint32_t to) noexcept
+{
+    const auto it = std::lower_bound(_positions.begin(), _positions.end(), _positionKey(id, from));
+    *it = _positionKey(id, to);
+
+    if (to > from)
+    {
+        std::rotate(it, it + 1, std::lower_bound(it + 1, _positions.end(), *it));
+    }
+    else
+    {
+        const auto dst = std::lower_bound(_positions.begin(), it, *it);
+        std::rotate(dst, it, it + 1);
+    }
+}
+
+// Positions are 32-bit and only ever grow, as dropping the oldest command increments _frontPosition.
+// Once they're about to overflow, this renumbers them so that _entries.front() is at position 0 again.
+// All positions are at least _frontPosition, so this doesn't change their order.
+void HistoryStore::_rebasePositions() noexcept
+{
+    for (auto& key : _positions)
+    {
+        key -= _frontPosition;
+    }
+    _frontPosition = 0;
+}
+
+// Returns the index of the first entry, searching backwards from startingIndex and wrapping around,
+// that refers to any of the given strings, or npos if there's none. This costs O(log n) per string,
+// independent of how many entries there are in total.
+size_t HistoryStore::_findNewest(const std::span<const StringId> ids, const size_t startingIndex) const noexcept
+{
+    const auto start = gsl::narrow_cast<uint32_t>(_frontPosition + startingIndex);
+    auto found = false;
+    uint32_t best = 0;
+    // The newest entry past the starting index, in case we need to wrap around.
+    auto foundWrapped = false;
+    uint32_t bestWrapped = 0;
+
+    for (const auto id : ids)
+    {
+        const auto [beg, end] = _positionsOf(id);
+        const auto it = std::upper_bound(beg, end, _positionKey(id, start));
+
+        if (it != beg && (!found || gsl::narrow_cast<uint32_t>(*(it - 1)) > best))
+        {
+            found = true;
+            best = gsl::narrow_cast<uint32_t>(*(it - 1));
+        }
+        if (it != end && (!foundWrapped || gsl::narrow_cast<uint32_t>(*(end - 1)) > bestWrapped))
+        {
+            foundWrapped = true;
+            bestWrapped = gsl::narrow_cast<uint32_t>(*(end - 1));
+        }
+    }
+
+    if (found)
+    {
+        return best - _frontPosition;
+    }
+    if (foundWrapped)
+    {
+        return bestWrapped - _frontPosition;
+    }
+    return npos;
+}
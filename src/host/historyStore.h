@@ -0,0 +1,112 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- historyStore.h
+
+Abstract:
+- The storage behind CommandHistory: An ordered list of commands, which may contain duplicates.
+- Each unique command is stored only once in a shared string arena and the list itself is a ring of 32-bit IDs.
+  This makes indexing and the removal of the oldest command O(1) and means that a history full of
+  "dir" and "cd .." costs a few bytes per entry instead of a std::wstring each.
+- The unique commands are additionally indexed for prefix searches (F8) and substring searches (the F7 popup),
+  and the positions each of them occurs at are tracked, so that a search only visits the matching entries
+  instead of comparing against every entry.
+- Serialize() and Deserialize() convert the history to and from a compact binary form for persisting it.
+--*/
+
+#pragma once
+
+#include <til/ring.h>
+
+class HistoryStore
+{
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    std::wstring_view At(size_t index) const noexcept;
+    std::wstring_view Back() const noexcept;
+
+    void PushBack(std::wstring_view command);
+    void PopFront() noexcept;
+    void Erase(size_t index) noexcept;
+    void Truncate(size_t count) noexcept;
+    void Swap(size_t indexA, size_t indexB) noexcept;
+    void Clear() noexcept;
+
+    size_t FindPrefix(std::wstring_view prefix, size_t startingIndex, bool exact) const noexcept;
+    std::vector<size_t> FindSubstring(std::wstring_view needle) const;
+
+    std::vector<uint8_t> Serialize() const;
+    void Deserialize(std::span<const uint8_t> data);
+    [[nodiscard]] HRESULT Save(const wchar_t* path) const noexcept;
+    [[nodiscard]] HRESULT Load(const wchar_t* path) noexcept;
+
+private:
+    using StringId = uint32_t;
+
+    // Marks empty hash slots as well as the end of the free list and so it can't be a valid ID.
+    static constexpr StringId EmptySlot = UINT32_MAX;
+
+    struct String
+    {
+        // Offset and length of the text in _arena. Each text is followed by a null terminator,
+        // which allows callers to pass the result of At().data() to C APIs.
+        // For unused IDs the offset is the next ID in the free list instead.
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        // The number of entries in _entries that refer to this string. 0 if the ID is unused.
+        uint32_t refs = 0;
+    };
+
+    std::wstring_view _text(StringId id) const noexcept;
+    StringId _intern(std::wstring_view text);
+    void _release(StringId id) noexcept;
+    void _unindex(StringId id) noexcept;
+    void _compactArena();
+
+    size_t _findSlot(std::wstring_view text) const noexcept;
+    void _rehash(size_t slotCount);
+    void _insertSlot(StringId id) noexcept;
+    void _eraseSlot(StringId id) noexcept;
+
+    static uint64_t _trigramKey(std::wstring_view text, size_t offset) noexcept;
+    void _indexTrigrams(StringId id);
+    void _unindexTrigrams(StringId id) noexcept;
+
+    static uint64_t _positionKey(StringId id, uint32_t position) noexcept;
+    std::pair<std::vector<uint64_t>::const_iterator, std::vector<uint64_t>::const_iterator> _positionsOf(StringId id) const noexcept;
+    void _insertPosition(StringId id, uint32_t position);
+    void _erasePosition(StringId id, uint32_t position) noexcept;
+    void _movePosition(StringId id, uint32_t from, uint32_t to) noexcept;
+    void _rebasePositions() noexcept;
+    size_t _findNewest(std::span<const StringId> ids, size_t startingIndex) const noexcept;
+
+    // The commands in chronological order as IDs into _strings.
+    til::ring<StringId> _entries;
+    // The position of _entries.front(). The entry at index i has the position _frontPosition + i.
+    // Counting positions this way means that dropping the oldest command doesn't require updating all _positions.
+    uint32_t _frontPosition = 0;
+    // The string ID and position of every entry, packed by _positionKey() and sorted. The positions of
+    // the entries referring to a string thus form a contiguous, ascending range in here. This costs
+    // 8 bytes per entry in a single allocation, instead of a separate vector for each unique string.
+    std::vector<uint64_t> _positions;
+    // _strings[id] describes the unique string with the given ID. Unused IDs form a linked list starting at _freeHead.
+    std::vector<String> _strings;
+    StringId _freeHead = EmptySlot;
+    std::wstring _arena;
+    // The number of characters in _arena that belong to released strings.
+    size_t _arenaGarbage = 0;
+    // An open addressing hash table (linear probing) mapping from text to its ID.
+    // Its size is always a power of 2 and at most half full.
+    std::vector<StringId> _slots;
+    // All used IDs sorted by their text. The strings starting with a given prefix form a contiguous range in here,
+    // which is the same information a prefix trie would give us, but at a fraction of the memory.
+    std::vector<StringId> _sorted;
+    // Maps from each 3-character sequence to the sorted IDs of the strings that contain it.
+    std::unordered_map<uint64_t, std::vector<StringId>> _trigrams;
+};
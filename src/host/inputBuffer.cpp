@@ -211,10 +211,7 @@ void InputBuffer::Cache(bool isUnicode, InputEventQueue& source, size_t expected
 
     if (source.size() > expectedSourceSize)
     {
-        _cachedInputEvents.insert(
-            _cachedInputEvents.end(),
-            std::make_move_iterator(source.begin() + expectedSourceSize),
-            std::make_move_iterator(source.end()));
+        _cachedInputEvents.append_range(std::span<const INPUT_RECORD>{ source }.subspan(expectedSourceSize));
         source.resize(expectedSourceSize);
     }
 }
@@ -235,7 +232,7 @@ void InputBuffer::_switchReadingModeSlowPath(ReadingMode mode)
     _cachedTextW = std::wstring{};
     _cachedTextReaderW = {};
 
-    _cachedInputEvents = std::deque<INPUT_RECORD>{};
+    _cachedInputEvents = til::ring<INPUT_RECORD>{};
 
     _readingMode = mode;
 }
@@ -503,7 +500,7 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<INPUT_RECORD> existingStorage;
+        til::ring<INPUT_RECORD> existingStorage;
         existingStorage.swap(_storage);
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
@@ -517,10 +514,7 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(unusedWaitStatus));
 
-        for (const auto& event : existingStorage)
-        {
-            _storage.push_back(event);
-        }
+        _storage.append_range(existingStorage);
 
         // We need to set the wait event if there were 0 events in the
         // input queue when we started.
@@ -715,6 +709,9 @@ void InputBuffer::_WriteBuffer(const std::span<const INPUT_RECORD>& inEvents, _O
     const auto initialInEventsSize = inEvents.size();
     const auto vtInputMode = IsInVirtualTerminalInputMode();
 
+    // Grow the storage at most once per write.
+    _storage.reserve(_storage.size() + inEvents.size());
+
     for (const auto& inEvent : inEvents)
     {
         if (inEvent.EventType == KEY_EVENT && inEvent.Event.KeyEvent.bKeyDown)
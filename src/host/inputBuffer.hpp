@@ -10,7 +10,7 @@
 #include "../server/ObjectHeader.h"
 #include "../terminal/input/terminalInput.hpp"
 
-#include <deque>
+#include <til/ring.h>
 
 namespace Microsoft::Console::Render
 {
@@ -78,10 +78,12 @@ private:
     std::string_view _cachedTextReaderA;
     std::wstring _cachedTextW;
     std::wstring_view _cachedTextReaderW;
-    std::deque<INPUT_RECORD> _cachedInputEvents;
+    til::ring<INPUT_RECORD> _cachedInputEvents;
     ReadingMode _readingMode = ReadingMode::StringA;
 
-    std::deque<INPUT_RECORD> _storage;
+    // A ring instead of a std::deque, because it's filled and drained in bulk, which for a
+    // std::deque would mean constantly allocating and freeing blocks while holding the console lock.
+    til::ring<INPUT_RECORD> _storage;
     INPUT_RECORD _writePartialByteSequence{};
     bool _writePartialByteSequenceAvailable = false;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
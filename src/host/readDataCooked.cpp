@@ -42,6 +42,7 @@ void COOKED_READ_DATA::BufferState::Replace(size_t offset, size_t remove, const
     _buffer.replace(offset, remove, input, count);
     _cursor = offset + count;
     _dirtyBeg = std::min(_dirtyBeg, offset);
+    _invalidateCheckpoints(offset);
 }
 
 void COOKED_READ_DATA::BufferState::Replace(const std::wstring_view& str)
@@ -49,6 +50,7 @@ void COOKED_READ_DATA::BufferState::Replace(const std::wstring_view& str)
     _buffer.assign(str);
     _cursor = _buffer.size();
     _dirtyBeg = 0;
+    _checkpoints.clear();
 }
 
 size_t COOKED_READ_DATA::BufferState::GetCursorPosition() const noexcept
@@ -72,6 +74,8 @@ bool COOKED_READ_DATA::BufferState::IsClean() const noexcept
 void COOKED_READ_DATA::BufferState::MarkEverythingDirty() noexcept
 {
     _dirtyBeg = 0;
+    // This is called when the text buffer got resized, which changes where lines wrap.
+    _checkpoints.clear();
 }
 
 void COOKED_READ_DATA::BufferState::MarkAsClean() noexcept
@@ -79,24 +83,35 @@ void COOKED_READ_DATA::BufferState::MarkAsClean() noexcept
     _dirtyBeg = npos;
 }
 
-std::wstring_view COOKED_READ_DATA::BufferState::GetUnmodifiedTextBeforeCursor() const noexcept
+// Returns the closest checkpoint at or in front of the given offset.
+// If there's none, it returns the start of the prompt, which is an implicit checkpoint at distance 0.
+COOKED_READ_DATA::BufferState::Checkpoint COOKED_READ_DATA::BufferState::FindCheckpoint(size_t offset) const noexcept
 {
-    return _slice(0, std::min(_dirtyBeg, _cursor));
+    const auto it = std::upper_bound(_checkpoints.begin(), _checkpoints.end(), offset, [](const size_t off, const Checkpoint& cp) {
+        return off < cp.offset;
+    });
+    return it == _checkpoints.begin() ? Checkpoint{} : *(it - 1);
 }
 
-std::wstring_view COOKED_READ_DATA::BufferState::GetUnmodifiedTextAfterCursor() const noexcept
+// Checkpoints must be added in ascending offset order. To keep the list short,
+// the checkpoint is ignored if it's closer than CheckpointInterval to the previous one.
+void COOKED_READ_DATA::BufferState::AddCheckpoint(size_t offset, ptrdiff_t distance)
 {
-    return _slice(_cursor, _dirtyBeg);
+    const auto last = _checkpoints.empty() ? 0 : _checkpoints.back().offset;
+    if (offset > last && offset - last >= CheckpointInterval)
+    {
+        _checkpoints.push_back({ offset, distance });
+    }
 }
 
-std::wstring_view COOKED_READ_DATA::BufferState::GetModifiedTextBeforeCursor() const noexcept
+std::wstring_view COOKED_READ_DATA::BufferState::GetUnmodifiedTextBeforeCursor() const noexcept
 {
-    return _slice(_dirtyBeg, _cursor);
+    return _slice(0, std::min(_dirtyBeg, _cursor));
 }
 
-std::wstring_view COOKED_READ_DATA::BufferState::GetModifiedTextAfterCursor() const noexcept
+std::wstring_view COOKED_READ_DATA::BufferState::GetUnmodifiedTextAfterCursor() const noexcept
 {
-    return _slice(std::max(_dirtyBeg, _cursor), npos);
+    return _slice(_cursor, _dirtyBeg);
 }
 
 std::wstring_view COOKED_READ_DATA::BufferState::_slice(size_t from, size_t to) const noexcept
@@ -106,6 +121,17 @@ std::wstring_view COOKED_READ_DATA::BufferState::_slice(size_t from, size_t to)
     return std::wstring_view{ _buffer.data() + from, to - from };
 }
 
+// Removes all checkpoints that may be affected by a modification at the given offset.
+// A checkpoint right at the offset is removed as well, because the modification
+// could for instance be a combining mark that changes the width of the preceding grapheme.
+void COOKED_READ_DATA::BufferState::_invalidateCheckpoints(size_t offset) noexcept
+{
+    const auto it = std::lower_bound(_checkpoints.begin(), _checkpoints.end(), offset, [](const Checkpoint& cp, const size_t off) {
+        return cp.offset < off;
+    });
+    _checkpoints.erase(it, _checkpoints.end());
+}
+
 // Routine Description:
 // - Constructs cooked read data class to hold context across key presses while a user is modifying their 'input line'.
 // Arguments:
@@ -803,6 +829,11 @@ void COOKED_READ_DATA::_transitionState(State state) noexcept
 // time complexity of _readCharInputLoop() from O(n^2) (n(n+1)/2 redraws) into O(n).
 // Pasting text would quickly turn into "accidentally quadratic" meme material otherwise.
 //
+// Similarly, the unmodified text in front of _buffer._dirtyBeg isn't measured from the start of the prompt, but
+// rather from the closest checkpoint that the previous call recorded. Otherwise, typing at the end of a very long
+// line would get slower with every keystroke. What remains is redrawing the text after the modification,
+// which is unavoidable, because it moves on screen.
+//
 // NOTE: Don't call _flushBuffer() after appending newlines to the buffer! See _handlePostCharInputLoop for more information.
 void COOKED_READ_DATA::_flushBuffer()
 {
@@ -820,32 +851,26 @@ void COOKED_READ_DATA::_flushBuffer()
     //   and this split prevents us from announcing text that hasn't actually changed
     //   to accessibility tools via MSAA (or UIA, but UIA is robust against this anyways).
     //
-    // This results in 2*2 = 4 writes of which always at least one of the middle two is empty,
+    // This results in 2 measurements followed by 2 writes of which always at least one of the middle two is empty,
     // depending on whether _buffer._cursor > _buffer._dirtyBeg or _buffer._cursor < _buffer._dirtyBeg.
-    // slice() returns an empty string-view when `from` index is greater than the `to` index.
 
-    ptrdiff_t distanceBeforeCursor = 0;
+    const auto unmodifiedBeforeCursor = _buffer.GetUnmodifiedTextBeforeCursor().size();
+    const auto unmodifiedEnd = unmodifiedBeforeCursor + _buffer.GetUnmodifiedTextAfterCursor().size();
+    const auto modifiedBeg = std::max(unmodifiedEnd, _buffer.GetCursorPosition());
+
+    auto distanceBeforeCursor = _measureTo(unmodifiedBeforeCursor);
     ptrdiff_t distanceAfterCursor = 0;
+    if (unmodifiedEnd != unmodifiedBeforeCursor)
     {
-        // _distanceCursor might be larger than the entire viewport (= a really long input line).
-        // _offsetCursorPosition() with such an offset will end up clamping the cursor position to (0,0).
-        // To make this implementation behave a little bit more consistent in this case without
-        // writing a more thorough and complex readline implementation, we pass _measureChars()
-        // the relative "distance" to the current actual cursor position. That way _measureChars()
-        // can still figure out what the logical cursor position is, when it handles tabs, etc.
-        auto dirtyBegDistance = -_distanceCursor;
-
-        distanceBeforeCursor = _measureChars(_buffer.GetUnmodifiedTextBeforeCursor(), dirtyBegDistance);
-        dirtyBegDistance += distanceBeforeCursor;
-        distanceAfterCursor = _measureChars(_buffer.GetUnmodifiedTextAfterCursor(), dirtyBegDistance);
-        dirtyBegDistance += distanceAfterCursor;
-
-        _offsetCursorPosition(dirtyBegDistance);
+        distanceAfterCursor = _measureTo(unmodifiedEnd) - distanceBeforeCursor;
     }
 
+    _offsetCursorPosition(distanceBeforeCursor + distanceAfterCursor - _distanceCursor);
+
     // Now we can finally write the parts of _buffer that have actually changed (or moved).
-    distanceBeforeCursor += _writeChars(_buffer.GetModifiedTextBeforeCursor());
-    distanceAfterCursor += _writeChars(_buffer.GetModifiedTextAfterCursor());
+    // [unmodifiedEnd, modifiedBeg) is the modified text before the cursor and is empty if the cursor is within the unmodified text.
+    distanceBeforeCursor += _writeRange(unmodifiedEnd, modifiedBeg, distanceBeforeCursor + distanceAfterCursor);
+    distanceAfterCursor += _writeRange(modifiedBeg, _buffer.Get().size(), distanceBeforeCursor + distanceAfterCursor);
 
     const auto distanceEnd = distanceBeforeCursor + distanceAfterCursor;
     const auto eraseDistance = std::max<ptrdiff_t>(0, _distanceEnd - distanceEnd);
@@ -885,6 +910,49 @@ void COOKED_READ_DATA::_erase(ptrdiff_t distance) const
     } while (remaining != 0);
 }
 
+// Returns the distance in columns between the start of the prompt and the given offset into _buffer.
+// The text in front of the offset must not have been modified since the last _flushBuffer(),
+// because the measurement starts at the closest checkpoint that was recorded while drawing it.
+ptrdiff_t COOKED_READ_DATA::_measureTo(const size_t offset) const
+{
+    const auto checkpoint = _buffer.FindCheckpoint(offset);
+    const std::wstring_view text{ _buffer.Get() };
+
+    // _distanceCursor might be larger than the entire viewport (= a really long input line).
+    // _offsetCursorPosition() with such an offset will end up clamping the cursor position to (0,0).
+    // To make this implementation behave a little bit more consistent in this case without
+    // writing a more thorough and complex readline implementation, we pass _measureChars()
+    // the relative "distance" to the current actual cursor position. That way _measureChars()
+    // can still figure out what the logical cursor position is, when it handles tabs, etc.
+    const auto cursorOffset = checkpoint.distance - _distanceCursor;
+    return checkpoint.distance + _measureChars(text.substr(checkpoint.offset, offset - checkpoint.offset), cursorOffset);
+}
+
+// Writes _buffer[beg, end) and returns the number of cells it took up. `distance` is the distance between
+// the start of the prompt and `beg`. The text is written in chunks of CheckpointInterval characters,
+// so that a checkpoint can be recorded after each of them for use by _measureTo().
+ptrdiff_t COOKED_READ_DATA::_writeRange(size_t beg, const size_t end, const ptrdiff_t distance)
+{
+    const std::wstring_view text{ _buffer.Get() };
+    ptrdiff_t written = 0;
+
+    while (beg < end)
+    {
+        auto next = end;
+        if (end - beg > CheckpointInterval)
+        {
+            // Don't split up graphemes between two writes.
+            next = TextBuffer::GraphemeNext(text, TextBuffer::GraphemePrev(text, beg + CheckpointInterval));
+        }
+
+        written += _writeChars(text.substr(beg, next - beg));
+        beg = next;
+        _buffer.AddCheckpoint(beg, distance + written);
+    }
+
+    return written;
+}
+
 // A helper to calculate the number of cells `text` would take up if it were written.
 // `cursorOffset` allows the caller to specify a "logical" cursor position relative to the actual cursor position.
 // This allows the function to track in which column it currently is, which is needed to implement tabs for instance.
@@ -1113,13 +1181,12 @@ try
         break;
     case PopupKind::CommandList:
     {
-        const auto& commands = _history->GetCommands();
         const auto commandCount = _history->GetNumberOfCommands();
 
         size_t maxStringLength = 0;
-        for (const auto& c : commands)
+        for (CommandHistory::Index i = 0; i < commandCount; ++i)
         {
-            maxStringLength = std::max(maxStringLength, c.size());
+            maxStringLength = std::max(maxStringLength, _history->GetNth(i).size());
         }
 
         // Account for the "123: " prefix each line gets.
@@ -1401,12 +1468,34 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
 
     if (wch == UNICODE_CARRIAGERETURN)
     {
-        _buffer.Replace(_history->RetrieveNth(cl.selected));
+        _buffer.Replace(_history->RetrieveNth(_popupCommandListIndex(popup, cl.selected)));
         _popupsDone();
         _handleChar(UNICODE_CARRIAGERETURN, modifiers);
         return;
     }
 
+    // Typing filters the list down to the commands containing the typed text.
+    if (wch == UNICODE_BACKSPACE)
+    {
+        if (popup.filter.empty())
+        {
+            return;
+        }
+        auto filter = popup.filter;
+        filter.pop_back();
+        _popupCommandListSetFilter(popup, std::move(filter));
+        _popupDrawCommandList(popup);
+        return;
+    }
+    if (wch >= L' ')
+    {
+        if (_popupCommandListSetFilter(popup, popup.filter + wch))
+        {
+            _popupDrawCommandList(popup);
+        }
+        return;
+    }
+
     switch (vkey)
     {
     case VK_ESCAPE:
@@ -1416,22 +1505,36 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
         _popupPush(PopupKind::CommandNumber);
         return;
     case VK_DELETE:
-        _history->Remove(cl.selected);
+    {
+        const auto index = _popupCommandListIndex(popup, cl.selected);
+        _history->Remove(index);
         if (_history->GetNumberOfCommands() <= 0)
         {
             _popupsDone();
             return;
         }
+        if (!popup.filter.empty())
+        {
+            // The indices after the removed command have shifted. Just like without a filter the selected row stays the same.
+            popup.matches = _history->FindSubstring(popup.filter);
+            if (popup.matches.empty())
+            {
+                popup.filter.clear();
+                cl.selected = index;
+            }
+        }
         break;
+    }
     case VK_LEFT:
     case VK_RIGHT:
-        _buffer.Replace(_history->RetrieveNth(cl.selected));
+        _buffer.Replace(_history->RetrieveNth(_popupCommandListIndex(popup, cl.selected)));
         _popupsDone();
         return;
     case VK_UP:
         if (WI_IsFlagSet(modifiers, SHIFT_PRESSED))
         {
-            _history->Swap(cl.selected, cl.selected - 1);
+            // Both commands contain the filter, so swapping them doesn't change popup.matches.
+            _history->Swap(_popupCommandListIndex(popup, cl.selected), _popupCommandListIndex(popup, cl.selected - 1));
         }
         // _popupDrawCommandList() clamps all values to valid ranges in `cl`.
         cl.selected--;
@@ -1439,7 +1542,7 @@ void COOKED_READ_DATA::_popupHandleCommandListInput(Popup& popup, const wchar_t
     case VK_DOWN:
         if (WI_IsFlagSet(modifiers, SHIFT_PRESSED))
         {
-            _history->Swap(cl.selected, cl.selected + 1);
+            _history->Swap(_popupCommandListIndex(popup, cl.selected), _popupCommandListIndex(popup, cl.selected + 1));
         }
         // _popupDrawCommandList() clamps all values to valid ranges in `cl`.
         cl.selected++;
@@ -1482,9 +1585,9 @@ void COOKED_READ_DATA::_popupDrawCommandList(Popup& popup) const
     assert(popup.kind == PopupKind::CommandList);
 
     auto& cl = popup.commandList;
-    const auto max = _history->GetNumberOfCommands();
+    const auto max = _popupCommandListCount(popup);
     const auto width = popup.contentRect.narrow_width<size_t>();
-    const auto height = std::min(popup.contentRect.height(), _history->GetNumberOfCommands());
+    const auto height = std::min(popup.contentRect.height(), max);
     const auto dirtyHeight = std::max(height, cl.dirtyHeight);
 
     {
@@ -1519,9 +1622,10 @@ void COOKED_READ_DATA::_popupDrawCommandList(Popup& popup) const
     for (til::CoordType off = 0; off < dirtyHeight; ++off)
     {
         const auto y = popup.contentRect.top + off;
-        const auto historyIndex = cl.top + off;
+        const auto row = cl.top + off;
+        const auto historyIndex = _popupCommandListIndex(popup, row);
         const auto str = _history->GetNth(historyIndex);
-        const auto& attr = historyIndex == cl.selected ? attrInverted : attrRegular;
+        const auto& attr = row == cl.selected ? attrInverted : attrRegular;
 
         buffer.clear();
         if (!str.empty())
@@ -1536,5 +1640,65 @@ void COOKED_READ_DATA::_popupDrawCommandList(Popup& popup) const
         _screenInfo.GetTextBuffer().Write(y, attr, state);
     }
 
+    // The filter is shown in place of the bottom border.
+    buffer.assign(popup.filter);
+    buffer.append(width, L'─');
+    state.text = buffer;
+    _screenInfo.GetTextBuffer().Write(popup.contentRect.bottom, attrRegular, state);
+
     cl.dirtyHeight = height;
 }
+
+// Filters the command list down to the commands containing the given text. An empty filter lists all commands.
+// Returns false and leaves the popup unchanged if no command contains the text.
+bool COOKED_READ_DATA::_popupCommandListSetFilter(Popup& popup, std::wstring filter) const
+{
+    auto& cl = popup.commandList;
+    const auto selected = _popupCommandListIndex(popup, cl.selected);
+
+    std::vector<CommandHistory::Index> matches;
+    if (!filter.empty())
+    {
+        matches = _history->FindSubstring(filter);
+        if (matches.empty())
+        {
+            return false;
+        }
+    }
+
+    popup.filter = std::move(filter);
+    popup.matches = std::move(matches);
+
+    // Keep the selection on the same command, or if it got filtered out, on the closest older one.
+    if (popup.filter.empty())
+    {
+        cl.selected = selected;
+    }
+    else
+    {
+        const auto it = std::upper_bound(popup.matches.begin(), popup.matches.end(), selected);
+        cl.selected = std::max(0, gsl::narrow_cast<CommandHistory::Index>(it - popup.matches.begin()) - 1);
+    }
+    return true;
+}
+
+// Returns the number of rows in the command list popup.
+CommandHistory::Index COOKED_READ_DATA::_popupCommandListCount(const Popup& popup) const noexcept
+{
+    return popup.filter.empty() ? _history->GetNumberOfCommands() : gsl::narrow_cast<CommandHistory::Index>(popup.matches.size());
+}
+
+// Returns the command history index of the given row in the command list popup, or -1 if there's no such row.
+// Without a filter the rows map 1:1 to the command history. Otherwise they map to popup.matches.
+CommandHistory::Index COOKED_READ_DATA::_popupCommandListIndex(const Popup& popup, const CommandHistory::Index row) const noexcept
+{
+    if (popup.filter.empty())
+    {
+        return row;
+    }
+    if (row < 0 || gsl::narrow_cast<size_t>(row) >= popup.matches.size())
+    {
+        return -1;
+    }
+    return til::at(popup.matches, gsl::narrow_cast<size_t>(row));
+}
@@ -41,6 +41,9 @@ public:
 private:
     static constexpr uint8_t CommandNumberMaxInputLength = 5;
     static constexpr size_t npos = static_cast<size_t>(-1);
+    // The maximum number of characters between two checkpoints (see BufferState::Checkpoint).
+    // This bounds how much text _flushBuffer() has to measure per keystroke, independent of the line length.
+    static constexpr size_t CheckpointInterval = 256;
 
     enum class State : uint8_t
     {
@@ -53,6 +56,14 @@ private:
     // underlying _buffer is being modified by COOKED_READ_DATA.
     struct BufferState
     {
+        // Records that the text in front of `offset` took up `distance` columns when it was last drawn.
+        // Checkpoints are invalidated as soon as the text in front of them changes.
+        struct Checkpoint
+        {
+            size_t offset = 0;
+            ptrdiff_t distance = 0;
+        };
+
         const std::wstring& Get() const noexcept;
         std::wstring Extract() noexcept
         {
@@ -68,17 +79,21 @@ private:
         void MarkEverythingDirty() noexcept;
         void MarkAsClean() noexcept;
 
+        Checkpoint FindCheckpoint(size_t offset) const noexcept;
+        void AddCheckpoint(size_t offset, ptrdiff_t distance);
+
         std::wstring_view GetUnmodifiedTextBeforeCursor() const noexcept;
         std::wstring_view GetUnmodifiedTextAfterCursor() const noexcept;
-        std::wstring_view GetModifiedTextBeforeCursor() const noexcept;
-        std::wstring_view GetModifiedTextAfterCursor() const noexcept;
 
     private:
         std::wstring_view _slice(size_t from, size_t to) const noexcept;
+        void _invalidateCheckpoints(size_t offset) noexcept;
 
         std::wstring _buffer;
         size_t _dirtyBeg = npos;
         size_t _cursor = 0;
+        // Sorted by offset and at least CheckpointInterval characters apart.
+        std::vector<Checkpoint> _checkpoints;
     };
 
     enum class PopupKind
@@ -132,15 +147,20 @@ private:
             // Used by PopupKind::CommandList
             struct
             {
-                // Command history index of the first row we draw in the popup.
+                // The first row we draw in the popup. See _popupCommandListIndex().
                 CommandHistory::Index top;
-                // Command history index of the currently selected row.
+                // The currently selected row. See _popupCommandListIndex().
                 CommandHistory::Index selected;
                 // Tracks the part of the popup that has previously been drawn and needs to be redrawn in the next paint.
                 // This becomes relevant when the length of the history changes while the popup is open (= when deleting entries).
                 til::CoordType dirtyHeight;
             } commandList;
         };
+
+        // Used by PopupKind::CommandList: The text typed while the popup is shown and the command history
+        // indices of the commands that contain it, which are the only ones listed. Empty if there's no filter.
+        std::wstring filter;
+        std::vector<CommandHistory::Index> matches;
     };
 
     static size_t _wordPrev(const std::wstring_view& chars, size_t position);
@@ -153,6 +173,8 @@ private:
     void _transitionState(State state) noexcept;
     void _flushBuffer();
     void _erase(ptrdiff_t distance) const;
+    ptrdiff_t _measureTo(size_t offset) const;
+    ptrdiff_t _writeRange(size_t beg, size_t end, ptrdiff_t distance);
     ptrdiff_t _measureChars(const std::wstring_view& text, ptrdiff_t cursorOffset) const;
     ptrdiff_t _writeChars(const std::wstring_view& text) const;
     ptrdiff_t _writeCharsImpl(const std::wstring_view& text, bool measureOnly, ptrdiff_t cursorOffset) const;
@@ -172,6 +194,9 @@ private:
     void _popupHandleInput(wchar_t wch, uint16_t vkey, DWORD keyState);
     void _popupDrawPrompt(const Popup& popup, UINT id) const;
     void _popupDrawCommandList(Popup& popup) const;
+    bool _popupCommandListSetFilter(Popup& popup, std::wstring filter) const;
+    CommandHistory::Index _popupCommandListCount(const Popup& popup) const noexcept;
+    CommandHistory::Index _popupCommandListIndex(const Popup& popup, CommandHistory::Index row) const noexcept;
 
     SCREEN_INFORMATION& _screenInfo;
     std::span<char> _userBuffer;
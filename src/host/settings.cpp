@@ -781,3 +781,19 @@ bool Settings::GetEnableBuiltinGlyphs() const noexcept
 {
     return _fEnableBuiltinGlyphs;
 }
+
+// Whether command histories are saved when their process exits and restored for the next process with the same name.
+bool Settings::GetPersistHistory() const noexcept
+{
+    return _fPersistHistory;
+}
+
+DWORD Settings::GetRowMemoryIdleLimit() const noexcept
+{
+    return _dwRowMemoryIdleLimit;
+}
+
+DWORD Settings::GetRowMemoryCommitLimit() const noexcept
+{
+    return _dwRowMemoryCommitLimit;
+}
@@ -172,6 +172,9 @@ public:
     bool GetUseDx() const noexcept;
     bool GetCopyColor() const noexcept;
     bool GetEnableBuiltinGlyphs() const noexcept;
+    bool GetPersistHistory() const noexcept;
+    DWORD GetRowMemoryIdleLimit() const noexcept;
+    DWORD GetRowMemoryCommitLimit() const noexcept;
 
 private:
     RenderSettings _renderSettings;
@@ -216,6 +219,10 @@ private:
     bool _fUseDx;
     bool _fCopyColor;
     bool _fEnableBuiltinGlyphs = true;
+    bool _fPersistHistory = false;
+    // The limits of the RowArenaPool in MiB. MAXDWORD keeps the pool's defaults.
+    DWORD _dwRowMemoryIdleLimit = MAXDWORD;
+    DWORD _dwRowMemoryCommitLimit = MAXDWORD;
 
     // this is used for the special STARTF_USESIZE mode.
     bool _fUseWindowSizePixels;
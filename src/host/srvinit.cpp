@@ -12,6 +12,8 @@
 
 #include "ApiRoutines.h"
 
+#include "../buffer/out/RowArena.hpp"
+
 #include "../types/inc/GlyphWidth.hpp"
 
 #include "../server/DeviceHandle.h"
@@ -173,6 +175,17 @@ static bool s_IsOnDesktop()
         reg.LoadGlobalsFromRegistry();
         reg.LoadDefaultFromRegistry();
 
+        // The memory of all text buffers is pooled process-wide, which makes its limits global settings.
+        auto& rowArenaPool = RowArenaPool::Instance();
+        if (const auto idleLimit = settings.GetRowMemoryIdleLimit(); idleLimit != MAXDWORD)
+        {
+            rowArenaPool.SetIdleLimit(gsl::narrow_cast<size_t>(std::min<uint64_t>(uint64_t{ idleLimit } << 20, SIZE_MAX)));
+        }
+        if (const auto commitLimit = settings.GetRowMemoryCommitLimit(); commitLimit != MAXDWORD)
+        {
+            rowArenaPool.SetCommitLimit(gsl::narrow_cast<size_t>(std::min<uint64_t>(uint64_t{ commitLimit } << 20, SIZE_MAX)));
+        }
+
         // 2. Read specific settings
 
         // Link is expecting the flags from the process to be in already, so apply that first
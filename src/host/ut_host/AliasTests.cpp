@@ -185,72 +185,48 @@ class AliasTests
     TEST_METHOD(Tokenize)
     {
         std::wstring tokenStr(L"one two three");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(L"one");
-        tokensExpected.emplace_back(L"two");
-        tokensExpected.emplace_back(L"three");
 
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
+        const auto tokensActual = Alias::s_Tokenize(tokenStr);
 
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
-
-        for (size_t i = 0; i < tokensExpected.size(); i++)
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"one" }, tokensActual[0]);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"two" }, tokensActual[1]);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"three" }, tokensActual[2]);
+        for (size_t i = 3; i < tokensActual.size(); i++)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_IS_TRUE(tokensActual[i].empty());
         }
     }
 
     TEST_METHOD(TokenizeNothing)
     {
         std::wstring tokenStr(L"alias");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(tokenStr);
-
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
 
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
+        const auto tokensActual = Alias::s_Tokenize(tokenStr);
 
-        for (size_t i = 0; i < tokensExpected.size(); i++)
+        VERIFY_ARE_EQUAL(std::wstring_view{ tokenStr }, tokensActual[0]);
+        for (size_t i = 1; i < tokensActual.size(); i++)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_IS_TRUE(tokensActual[i].empty());
         }
     }
 
-    TEST_METHOD(GetArgString)
+    TEST_METHOD(TokenizeStopsAfterNinthArgument)
     {
-        BEGIN_TEST_METHOD_PROPERTIES()
-            TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
-                                 L"{"
-                                 L"alias arg1 arg2 arg3=arg1 arg2 arg3,"
-                                 L"aliasOnly="
-                                 L"}")
-        END_TEST_METHOD_PROPERTIES()
-
-        std::wstring target;
-        std::wstring expected;
-        _RetrieveTargetExpectedPair(target, expected);
+        std::wstring tokenStr(L"alias 1 2 3 4 5 6 7 8 9 10 11");
 
-        auto actual = Alias::s_GetArgString(target);
+        const auto tokensActual = Alias::s_Tokenize(tokenStr);
 
-        VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"alias" }, tokensActual[0]);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"9" }, tokensActual[9]);
     }
 
-    TEST_METHOD(NumberedArgMacro)
+    TEST_METHOD(GetArgString)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
             TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
                                  L"{"
-                                 L"1=one,"
-                                 L"2=two,"
-                                 L"3=three,"
-                                 L"4=four,"
-                                 L"5=five,"
-                                 L"6=six,"
-                                 L"7=seven,"
-                                 L"8=eight,"
-                                 L"9=nine,"
-                                 L"A=,"
-                                 L"0=,"
+                                 L"alias arg1 arg2 arg3=arg1 arg2 arg3,"
+                                 L"aliasOnly="
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
@@ -258,54 +234,32 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        std::deque<std::wstring> tokens;
-        tokens.emplace_back(L"alias");
-        tokens.emplace_back(L"one");
-        tokens.emplace_back(L"two");
-        tokens.emplace_back(L"three");
-        tokens.emplace_back(L"four");
-        tokens.emplace_back(L"five");
-        tokens.emplace_back(L"six");
-        tokens.emplace_back(L"seven");
-        tokens.emplace_back(L"eight");
-        tokens.emplace_back(L"nine");
-        tokens.emplace_back(L"ten");
-
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const auto returnExpected = !expected.empty();
+        const auto actual = Alias::s_GetArgString(target);
 
-        std::wstring actual;
-        const auto returnActual = Alias::s_TryReplaceNumberedArgMacro(target[0], actual, tokens);
-
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
-        VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
+        VERIFY_ARE_EQUAL(std::wstring_view{ expected }, actual);
     }
 
-    TEST_METHOD(WildcardArgMacro)
+    TEST_METHOD(CompileTarget)
     {
-        BEGIN_TEST_METHOD_PROPERTIES()
-            TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
-                                 L"{"
-                                 L"*=one two three,"
-                                 L"A=,"
-                                 L"0=,"
-                                 L"}")
-        END_TEST_METHOD_PROPERTIES()
-
-        std::wstring target;
-        std::wstring expected;
-        _RetrieveTargetExpectedPair(target, expected);
-
-        std::wstring fullArgString(L"one two three");
-
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const auto returnExpected = !expected.empty();
-
-        std::wstring actual;
-        const auto returnActual = Alias::s_TryReplaceWildcardArgMacro(target[0], actual, fullArgString);
-
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
-        VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
+        const auto compiled = Alias::s_CompileTarget(L"bar $1$goutput $*$tbaz $$");
+
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"bar $1$goutput $*$tbaz $$" }, std::wstring_view{ compiled.target });
+        Log::Comment(L"Macros with a fixed replacement are substituted into the text.");
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"bar >output \r\nbaz $$\r\n" }, std::wstring_view{ compiled.text });
+        VERIFY_ARE_EQUAL(2u, compiled.lineCount);
+
+        Log::Comment(L"Arguments split the text into separate runs.");
+        VERIFY_ARE_EQUAL(5u, compiled.ops.size());
+        VERIFY_ARE_EQUAL(0, compiled.ops[0].argument);
+        VERIFY_ARE_EQUAL(4u, compiled.ops[0].length);
+        VERIFY_ARE_EQUAL(1, compiled.ops[1].argument);
+        VERIFY_ARE_EQUAL(0, compiled.ops[2].argument);
+        VERIFY_ARE_EQUAL(4u, compiled.ops[2].offset);
+        VERIFY_ARE_EQUAL(8u, compiled.ops[2].length);
+        VERIFY_ARE_EQUAL(Alias::CompiledTarget::AllArguments, compiled.ops[3].argument);
+        VERIFY_ARE_EQUAL(0, compiled.ops[4].argument);
+        VERIFY_ARE_EQUAL(12u, compiled.ops[4].offset);
+        VERIFY_ARE_EQUAL(10u, compiled.ops[4].length);
     }
 
     TEST_METHOD(InputRedirMacro)
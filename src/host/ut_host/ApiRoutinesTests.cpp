@@ -866,4 +866,148 @@ class ApiRoutinesTests
 
         ValidateComplexScreen(si, background, fill, scrollRect, Viewport::FromInclusive(scroll), destination, clipViewport);
     }
+
+    static std::vector<CHAR_INFO> MakeCharInfos(const til::size size)
+    {
+        std::vector<CHAR_INFO> cells(size.area<size_t>());
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            auto& cell = til::at(cells, i);
+            cell.Char.UnicodeChar = static_cast<wchar_t>(L'a' + i % 26);
+            // Runs of 7 cells, so that attribute runs don't line up with the rows.
+            cell.Attributes = static_cast<WORD>(i / 7 % 0xff + 1);
+        }
+        return cells;
+    }
+
+    static void VerifyCharInfosEqual(const std::span<const CHAR_INFO> expected, const std::span<const CHAR_INFO> actual)
+    {
+        VERIFY_ARE_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const auto& e = til::at(expected, i);
+            const auto& a = til::at(actual, i);
+            if (e.Char.UnicodeChar != a.Char.UnicodeChar || e.Attributes != a.Attributes)
+            {
+                VERIFY_FAIL(NoThrowString().Format(L"cell %zu: expected U+%04X/%04x, got U+%04X/%04x", i, e.Char.UnicodeChar, e.Attributes, a.Char.UnicodeChar, a.Attributes));
+            }
+        }
+    }
+
+    TEST_METHOD(ApiWriteReadConsoleOutputW)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+        auto& textBuffer = si.GetTextBuffer();
+
+        Log::Comment(L"Cells without DBCS flags must round-trip through WriteConsoleOutputW and ReadConsoleOutputW.");
+        const auto region = Viewport::FromDimensions({ 3, 2 }, { 20, 4 });
+        auto cells = MakeCharInfos(region.Dimensions());
+        Viewport written;
+        VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, cells, region, written));
+        VERIFY_ARE_EQUAL(region.ToInclusive(), written.ToInclusive());
+
+        std::vector<CHAR_INFO> readBack(cells.size());
+        Viewport read;
+        VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, readBack, region, read));
+        VERIFY_ARE_EQUAL(region.ToInclusive(), read.ToInclusive());
+        VerifyCharInfosEqual(cells, readBack);
+
+        Log::Comment(L"A request that's clipped on the left and top must be read into the matching part of the target.");
+        const auto clipped = Viewport::FromDimensions({ -2, -1 }, { 10, 5 });
+        std::vector<CHAR_INFO> clippedBack(clipped.Dimensions().area<size_t>());
+        VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, clippedBack, clipped, read));
+        VERIFY_ARE_EQUAL(Viewport::FromDimensions({ 0, 0 }, { 8, 4 }).ToInclusive(), read.ToInclusive());
+        // The cell at 3,2 is the first one we wrote above and it's at 5,3 in the clipped target.
+        VerifyCharInfosEqual({ cells.data(), 5 }, { &til::at(clippedBack, 3 * 10 + 5), 5 });
+
+        Log::Comment(L"Overwriting half of a wide glyph must turn the other half into whitespace.");
+        const til::point wide{ 10, 3 };
+        textBuffer.GetMutableRowByOffset(wide.y).ReplaceCharacters(wide.x, 2, L"\u3042");
+        CHAR_INFO single{};
+        single.Char.UnicodeChar = L'x';
+        single.Attributes = FOREGROUND_RED;
+        VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, { &single, 1 }, Viewport::FromDimensions({ wide.x + 1, wide.y }, { 1, 1 }), written));
+        const auto& row = textBuffer.GetRowByOffset(wide.y);
+        VERIFY_ARE_EQUAL(std::wstring_view{ L" " }, row.GlyphAt(wide.x));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"x" }, row.GlyphAt(wide.x + 1));
+        VERIFY_IS_TRUE(row.DbcsAttrAt(wide.x) == DbcsAttribute::Single);
+        VERIFY_IS_TRUE(row.DbcsAttrAt(wide.x + 1) == DbcsAttribute::Single);
+        VERIFY_ARE_EQUAL(static_cast<WORD>(FOREGROUND_RED), row.GetAttrByColumn(wide.x + 1).GetLegacyAttributes());
+
+        Log::Comment(L"Rows with DBCS flags must still be written cell by cell.");
+        CHAR_INFO pair[2]{};
+        pair[0].Char.UnicodeChar = pair[1].Char.UnicodeChar = L'\u3042';
+        pair[0].Attributes = FOREGROUND_GREEN | COMMON_LVB_LEADING_BYTE;
+        pair[1].Attributes = FOREGROUND_GREEN | COMMON_LVB_TRAILING_BYTE;
+        VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, pair, Viewport::FromDimensions(wide, { 2, 1 }), written));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"\u3042" }, row.GlyphAt(wide.x));
+        VERIFY_IS_TRUE(row.DbcsAttrAt(wide.x) == DbcsAttribute::Leading);
+        VERIFY_IS_TRUE(row.DbcsAttrAt(wide.x + 1) == DbcsAttribute::Trailing);
+    }
+
+    TEST_METHOD(ApiConsoleOutputThroughput)
+    {
+        auto benchmark = false;
+        RuntimeParameters::TryGetValue(L"Benchmark", benchmark);
+        if (!benchmark)
+        {
+            Log::Comment(L"This is a benchmark. Run it with /p:Benchmark=true.");
+            Log::Result(TestResults::Skipped);
+            return;
+        }
+
+        auto iterations = 1000;
+        RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+        // The size of a large, full-screen legacy TUI that screen-scrapes itself every frame.
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->PrepareGlobalScreenBuffer(200, 60, 200, 60);
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+        const auto region = Viewport::FromDimensions({ 0, 0 }, { 200, 60 });
+        auto cells = MakeCharInfos(region.Dimensions());
+        std::vector<CHAR_INFO> readBack(cells.size());
+        Viewport unused;
+
+        const auto run = [&](const wchar_t* name, auto&& fn) {
+            const auto beg = std::chrono::high_resolution_clock::now();
+            for (auto i = 0; i < iterations; ++i)
+            {
+                fn();
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto ns = std::chrono::duration<double, std::nano>(end - beg).count() / iterations;
+            const auto cellsPerSecond = cells.size() / ns * 1e9;
+            Log::Comment(NoThrowString().Format(L"%-20s 200x60 %10.0f ns/call %8.1f Mcells/s", name, ns, cellsPerSecond / 1e6));
+        };
+
+        // The baselines are the cell-by-cell loops the two APIs used before they got their row-span fast paths.
+        run(L"Write (cell by cell)", [&]() {
+            for (til::CoordType y = 0; y < region.Height(); ++y)
+            {
+                const auto row = std::span<const CHAR_INFO>{ cells }.subspan(gsl::narrow_cast<size_t>(y * region.Width()), gsl::narrow_cast<size_t>(region.Width()));
+                si.Write(OutputCellIterator{ row }, { 0, y });
+            }
+        });
+        run(L"WriteConsoleOutputW", [&]() {
+            VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, cells, region, unused));
+        });
+        run(L"Read (cell by cell)", [&]() {
+            auto sourceIter = si.GetCellDataAt({ 0, 0 }, region);
+            for (auto& cell : readBack)
+            {
+                cell = gci.AsCharInfo(*sourceIter);
+                ++sourceIter;
+            }
+        });
+        VerifyCharInfosEqual(cells, readBack);
+        run(L"ReadConsoleOutputW", [&]() {
+            VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, readBack, region, unused));
+        });
+
+        VerifyCharInfosEqual(cells, readBack);
+    }
 };
@@ -8,6 +8,9 @@
 
 #include "../types/inc/CodepointWidthDetector.hpp"
 
+#include <til/unicode.h>
+
+using namespace WEX::Common;
 using namespace WEX::Logging;
 
 static constexpr std::wstring_view emoji = L"\xD83E\xDD22"; // U+1F922 nauseated face
@@ -86,4 +89,58 @@ class CodepointWidthDetectorTests
         widthDetector.NotifyFontChanged();
         VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
     }
+
+    TEST_METHOD(GetWidthsMatchesGetWidth)
+    {
+        CodepointWidthDetector widthDetector;
+
+        // Every codepoint once, interleaved with runs of ASCII so that the vectorized fast-path gets to run as well.
+        // The unpaired surrogates in the middle are measured individually, just like GetWidth() would.
+        std::wstring text;
+        for (char32_t cp = 0x20; cp < 0x110000; ++cp)
+        {
+            if (cp < 0x10000)
+            {
+                text.push_back(static_cast<wchar_t>(cp));
+            }
+            else
+            {
+                text.push_back(static_cast<wchar_t>(0xD7C0 + (cp >> 10)));
+                text.push_back(static_cast<wchar_t>(0xDC00 + (cp & 0x3FF)));
+            }
+            if ((cp & 0xff) == 0)
+            {
+                text.append(L"0123456789abcdef");
+            }
+        }
+
+        std::vector<uint8_t> widths(text.size());
+        const auto columns = widthDetector.GetWidths(text, widths);
+
+        size_t expectedColumns = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            const size_t len = til::is_leading_surrogate(text[i]) && i + 1 < text.size() && til::is_trailing_surrogate(text[i + 1]) ? 2 : 1;
+            const auto expected = WI_EnumValue(widthDetector.GetWidth({ text.data() + i, len }));
+            if (widths[i] != expected || (len == 2 && widths[i + 1] != 0))
+            {
+                VERIFY_FAIL(NoThrowString().Format(L"mismatch at U+%04X", text[i]));
+            }
+            expectedColumns += expected;
+            i += len;
+        }
+
+        VERIFY_ARE_EQUAL(expectedColumns, columns);
+    }
+
+    TEST_METHOD(GetWidthsOfMixedText)
+    {
+        CodepointWidthDetector widthDetector;
+        const std::wstring_view text{ L"ab\x306A\xD83D\xDC7Ecd\x414" };
+        static constexpr std::array<uint8_t, 8> expected{ 1, 1, 2, 2, 0, 1, 1, 1 };
+        std::array<uint8_t, 8> widths{};
+
+        VERIFY_ARE_EQUAL(9u, widthDetector.GetWidths(text, widths));
+        VERIFY_IS_TRUE(widths == expected);
+    }
 };
@@ -242,6 +242,215 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(AddBeyondCapacityDropsOldest)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        for (size_t j = 0; j < _manyHistoryItems.size(); j++)
+        {
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[j], false));
+        }
+
+        VERIFY_ARE_EQUAL(s_BufferSize, history->GetNumberOfCommands());
+        const auto dropped = _manyHistoryItems.size() - s_BufferSize;
+        for (CommandHistory::Index i = 0; i < s_BufferSize; i++)
+        {
+            VERIFY_ARE_EQUAL(std::wstring_view{ _manyHistoryItems[dropped + i] }, history->GetNth(i));
+        }
+        VERIFY_ARE_EQUAL(s_BufferSize - 1, history->LastDisplayed);
+    }
+
+    TEST_METHOD(FindMatchingCommand)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+        VERIFY_SUCCEEDED(history->Add(L"dir", false));
+        VERIFY_SUCCEEDED(history->Add(L"dir /w", false));
+        VERIFY_SUCCEEDED(history->Add(L"cd ..", false));
+        VERIFY_SUCCEEDED(history->Add(L"dir /p /w", false));
+        VERIFY_SUCCEEDED(history->Add(L"git push", false));
+
+        CommandHistory::Index index;
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", 4, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(3, index);
+        Log::Comment(L"The search continues at the newest command once the oldest one was checked.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"git", 1, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(4, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", 4, index, CommandHistory::MatchOptions::JustLooking | CommandHistory::MatchOptions::ExactMatch));
+        VERIFY_ARE_EQUAL(0, index);
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"dir /x", 4, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"di", 4, index, CommandHistory::MatchOptions::JustLooking | CommandHistory::MatchOptions::ExactMatch));
+    }
+
+    TEST_METHOD(StoreDeduplicatesCommands)
+    {
+        HistoryStore store;
+        store.PushBack(L"dir");
+        store.PushBack(L"cd ..");
+        store.PushBack(L"dir");
+        VERIFY_ARE_EQUAL(3u, store.size());
+        Log::Comment(L"Identical commands share their text.");
+        VERIFY_IS_TRUE(store.At(0).data() == store.At(2).data());
+
+        store.PopFront();
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"cd .." }, store.At(0));
+        VERIFY_ARE_EQUAL(std::wstring_view{ L"dir" }, store.At(1));
+        store.Erase(1);
+        VERIFY_ARE_EQUAL(HistoryStore::npos, store.FindPrefix(L"dir", 0, false));
+        VERIFY_ARE_EQUAL(0u, store.FindPrefix(L"cd ..", 0, true));
+
+        Log::Comment(L"Text returned by At() is null-terminated.");
+        store.PushBack(L"ipconfig /all");
+        VERIFY_ARE_EQUAL(L'\0', store.At(0).data()[store.At(0).size()]);
+        VERIFY_ARE_EQUAL(L'\0', store.At(1).data()[store.At(1).size()]);
+    }
+
+    TEST_METHOD(StoreFindPrefixAfterEdits)
+    {
+        // A plain list to check the store against, as the store tracks the position of each entry separately.
+        std::vector<std::wstring> expected;
+        HistoryStore store;
+
+        const auto findAll = [&](const std::wstring_view needle) {
+            std::vector<size_t> indices;
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                if (expected[i].find(needle) != std::wstring::npos)
+                {
+                    indices.emplace_back(i);
+                }
+            }
+            return indices;
+        };
+        const auto find = [&](const std::wstring_view prefix, const size_t startingIndex) {
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                const auto index = (startingIndex + expected.size() - i) % expected.size();
+                if (til::starts_with(expected[index], prefix))
+                {
+                    return index;
+                }
+            }
+            return HistoryStore::npos;
+        };
+
+        uint32_t seed = 1;
+        const auto next = [&](const size_t max) {
+            seed = seed * 1664525 + 1013904223;
+            return (seed >> 8) % max;
+        };
+
+        for (auto step = 0; step < 2000; ++step)
+        {
+            const auto& item = til::at(_manyHistoryItems, next(_manyHistoryItems.size()));
+
+            switch (next(5))
+            {
+            case 0:
+                if (!expected.empty())
+                {
+                    expected.erase(expected.begin());
+                    store.PopFront();
+                }
+                break;
+            case 1:
+                if (!expected.empty())
+                {
+                    const auto index = next(expected.size());
+                    expected.erase(expected.begin() + index);
+                    store.Erase(index);
+                }
+                break;
+            case 2:
+                if (!expected.empty())
+                {
+                    const auto a = next(expected.size());
+                    const auto b = next(expected.size());
+                    std::swap(expected[a], expected[b]);
+                    store.Swap(a, b);
+                }
+                break;
+            default:
+                expected.emplace_back(item);
+                store.PushBack(item);
+                break;
+            }
+
+            VERIFY_ARE_EQUAL(expected.size(), store.size());
+            if (!expected.empty())
+            {
+                const auto startingIndex = next(expected.size());
+                VERIFY_ARE_EQUAL(find(L"dir", startingIndex), store.FindPrefix(L"dir", startingIndex, false));
+                VERIFY_ARE_EQUAL(find(L"ip", startingIndex), store.FindPrefix(L"ip", startingIndex, false));
+                VERIFY_ARE_EQUAL(find(item, startingIndex), store.FindPrefix(item, startingIndex, false));
+            }
+            VERIFY_IS_TRUE(findAll(L"127.0.0.1") == store.FindSubstring(L"127.0.0.1"));
+            VERIFY_IS_TRUE(findAll(L"/") == store.FindSubstring(L"/"));
+        }
+    }
+
+    TEST_METHOD(StoreFindSubstring)
+    {
+        HistoryStore store;
+        for (const auto& item : _manyHistoryItems)
+        {
+            store.PushBack(item);
+        }
+        store.PushBack(_manyHistoryItems[3]);
+
+        VERIFY_IS_TRUE((std::vector<size_t>{ 3, 7, 12 }) == store.FindSubstring(L"127.0.0.1"));
+        VERIFY_IS_TRUE((std::vector<size_t>{ 5 }) == store.FindSubstring(L"/all"));
+        Log::Comment(L"Needles shorter than the indexed trigrams work as well.");
+        VERIFY_IS_TRUE((std::vector<size_t>{ 2 }) == store.FindSubstring(L"/p"));
+        VERIFY_IS_TRUE(store.FindSubstring(L"/x").empty());
+        VERIFY_IS_TRUE(store.FindSubstring(L"pull").empty());
+
+        Log::Comment(L"Removed commands aren't found anymore and the remaining ones are found at their new index.");
+        store.Erase(7);
+        VERIFY_IS_TRUE((std::vector<size_t>{ 3, 11 }) == store.FindSubstring(L"127.0.0.1"));
+        store.PopFront();
+        VERIFY_IS_TRUE((std::vector<size_t>{ 2, 10 }) == store.FindSubstring(L"127.0.0.1"));
+        store.Erase(10);
+        store.Erase(2);
+        VERIFY_IS_TRUE(store.FindSubstring(L"127.0.0.1").empty());
+    }
+
+    TEST_METHOD(StoreSerializeRoundTrip)
+    {
+        HistoryStore store;
+        for (const auto& item : _manyHistoryItems)
+        {
+            store.PushBack(item);
+        }
+        store.PushBack(_manyHistoryItems[0]);
+
+        auto data = store.Serialize();
+
+        HistoryStore loaded;
+        loaded.Deserialize(data);
+        VERIFY_ARE_EQUAL(store.size(), loaded.size());
+        for (size_t i = 0; i < store.size(); i++)
+        {
+            VERIFY_ARE_EQUAL(store.At(i), loaded.At(i));
+        }
+        VERIFY_IS_TRUE(store.FindSubstring(L"127.0.0.1") == loaded.FindSubstring(L"127.0.0.1"));
+
+        Log::Comment(L"Malformed data is rejected and leaves the store unchanged.");
+        data.pop_back();
+        VERIFY_THROWS_SPECIFIC(loaded.Deserialize(data), wil::ResultException, [](wil::ResultException& e) { return e.GetErrorCode() == HRESULT_FROM_WIN32(ERROR_INVALID_DATA); });
+        VERIFY_ARE_EQUAL(store.size(), loaded.size());
+
+        Log::Comment(L"Save() and Load() round-trip through a file.");
+        const auto path = (std::filesystem::temp_directory_path() / L"HistoryTests.bin").wstring();
+        const auto deleteFile = wil::scope_exit([&] { DeleteFileW(path.c_str()); });
+        VERIFY_SUCCEEDED(store.Save(path.c_str()));
+        HistoryStore fromFile;
+        VERIFY_SUCCEEDED(fromFile.Load(path.c_str()));
+        VERIFY_ARE_EQUAL(store.size(), fromFile.size());
+        VERIFY_ARE_EQUAL(store.Back(), fromFile.Back());
+    }
+
 private:
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
@@ -0,0 +1,651 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "CommonState.hpp"
+
+#include "ApiRoutines.h"
+
+#include "../server/IoSorter.h"
+#include "../server/LoopbackDeviceComm.h"
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+// These tests drive the entire API server (IoSorter, ApiSorter, ApiDispatchers, ApiRoutines)
+// through LoopbackDeviceComm, the same way a client would through ConDrv.
+// The benchmarks (ReplayCallMix, CookedReadWithAliases, CookedReadTypingLongLine) only run with /p:Benchmark=true.
+// ReplayCallMix doubles as a harness for profiling the per-message overhead of the server:
+// Run it under a profiler with /p:Benchmark=true /p:Iterations=100000 for a stable picture.
+class LoopbackDeviceCommTests
+{
+    TEST_CLASS(LoopbackDeviceCommTests);
+
+    std::unique_ptr<CommonState> m_state;
+    ApiRoutines _routines;
+    LoopbackDeviceComm _comm;
+    IDeviceComm* _previousDeviceComm = nullptr;
+    ConsoleProcessHandle* _process = nullptr;
+    ULONG_PTR _output = 0;
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        m_state = std::make_unique<CommonState>();
+        m_state->PrepareGlobalFont();
+        m_state->PrepareGlobalInputBuffer();
+        m_state->PrepareGlobalScreenBuffer();
+
+        auto& globals = ServiceLocator::LocateGlobals();
+        _previousDeviceComm = std::exchange(globals.pDeviceComm, &_comm);
+
+        {
+            auto& gci = globals.getConsoleInformation();
+            gci.LockConsole();
+            auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+            VERIFY_SUCCEEDED(gci.ProcessHandleList.AllocProcessData(GetCurrentProcessId(), GetCurrentThreadId(), 0, nullptr));
+            _process = gci.ProcessHandleList.FindProcessInList(GetCurrentProcessId());
+            VERIFY_IS_NOT_NULL(_process);
+        }
+
+        const CD_CREATE_OBJECT_INFORMATION createInfo{ CD_IO_OBJECT_TYPE_CURRENT_OUTPUT, FILE_SHARE_READ | FILE_SHARE_WRITE, GENERIC_READ | GENERIC_WRITE };
+        LoopbackDeviceComm::Request create;
+        create.Descriptor.Process = _comm.PutHandle(_process);
+        create.Descriptor.Function = CONSOLE_IO_CREATE_OBJECT;
+        create.Descriptor.InputSize = sizeof(createInfo);
+        create.Input.assign(reinterpret_cast<const BYTE*>(&createInfo), reinterpret_cast<const BYTE*>(&createInfo + 1));
+
+        _comm.Submit(create);
+        _ServiceRequests();
+        _VerifyCompleted(create);
+        _output = create.IoStatus.Information;
+        VERIFY_ARE_NOT_EQUAL(0u, _output);
+
+        globals.apiMetrics.Reset();
+        globals.apiMetrics.SetEnabled(true);
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        if (_output)
+        {
+            LoopbackDeviceComm::Request close;
+            close.Descriptor.Process = _comm.PutHandle(_process);
+            close.Descriptor.Object = _output;
+            close.Descriptor.Function = CONSOLE_IO_CLOSE_OBJECT;
+            _comm.Submit(close);
+            _ServiceRequests();
+            _output = 0;
+        }
+
+        auto& globals = ServiceLocator::LocateGlobals();
+        globals.apiMetrics.SetEnabled(false);
+        if (_process)
+        {
+            auto& gci = globals.getConsoleInformation();
+            gci.LockConsole();
+            auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            gci.ProcessHandleList.FreeProcessData(_process);
+            _process = nullptr;
+        }
+        globals.pDeviceComm = _previousDeviceComm;
+
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->CleanupGlobalInputBuffer();
+        m_state->CleanupGlobalFont();
+        m_state.reset();
+        return true;
+    }
+
+    // Services all queued requests the same way ConsoleIoThread() does.
+    void _ServiceRequests()
+    {
+        CONSOLE_API_MSG receiveMsg;
+        receiveMsg._pApiRoutines = &_routines;
+        receiveMsg._pDeviceComm = &_comm;
+        PCONSOLE_API_MSG replyMsg = nullptr;
+
+        for (;;)
+        {
+            if (replyMsg != nullptr)
+            {
+                LOG_IF_FAILED(replyMsg->ReleaseMessageBuffers());
+            }
+
+            if (FAILED(_comm.ReadIo(replyMsg, &receiveMsg)))
+            {
+                break;
+            }
+
+            IoSorter::ServiceIoOperation(&receiveMsg, &replyMsg);
+        }
+    }
+
+    static bool _SkipUnlessBenchmark()
+    {
+        auto benchmark = false;
+        RuntimeParameters::TryGetValue(L"Benchmark", benchmark);
+        if (!benchmark)
+        {
+            Log::Comment(L"This is a benchmark. Run it with /p:Benchmark=true.");
+            Log::Result(TestResults::Skipped);
+        }
+        return !benchmark;
+    }
+
+    static void _VerifyCompleted(const LoopbackDeviceComm::Request& request)
+    {
+        VERIFY_IS_TRUE(request.Completed);
+        VERIFY_IS_TRUE(NT_SUCCESS(request.IoStatus.Status));
+    }
+
+    template<typename T>
+    static T _ApiMessage(const LoopbackDeviceComm::Request& request)
+    {
+        T msg;
+        memcpy(&msg, request.Output.data(), sizeof(msg));
+        return msg;
+    }
+
+    LoopbackDeviceComm::Request _SetConsoleCursorPosition(const til::point position)
+    {
+        CONSOLE_SETCURSORPOSITION_MSG msg{};
+        msg.CursorPosition = til::unwrap_coord(position);
+        return LoopbackDeviceComm::MakeApiRequest(ConsolepSetCursorPosition, _comm.PutHandle(_process), _output, &msg, sizeof(msg), {}, 0);
+    }
+
+    LoopbackDeviceComm::Request _WriteConsoleW(const std::wstring_view text)
+    {
+        CONSOLE_WRITECONSOLE_MSG msg{};
+        msg.Unicode = TRUE;
+        const std::span payload{ reinterpret_cast<const BYTE*>(text.data()), text.size() * sizeof(wchar_t) };
+        return LoopbackDeviceComm::MakeApiRequest(ConsolepWriteConsole, _comm.PutHandle(_process), _output, &msg, sizeof(msg), payload, 0);
+    }
+
+    LoopbackDeviceComm::Request _ReadConsoleOutputW(const til::inclusive_rect& region)
+    {
+        CONSOLE_READCONSOLEOUTPUT_MSG msg{};
+        msg.CharRegion = til::unwrap_small_rect(region);
+        msg.Unicode = TRUE;
+        const auto area = (region.right - region.left + 1) * (region.bottom - region.top + 1);
+        return LoopbackDeviceComm::MakeApiRequest(ConsolepReadConsoleOutput, _comm.PutHandle(_process), _output, &msg, sizeof(msg), {}, gsl::narrow<ULONG>(area * sizeof(CHAR_INFO)));
+    }
+
+    ULONG_PTR _OpenInput()
+    {
+        const CD_CREATE_OBJECT_INFORMATION createInfo{ CD_IO_OBJECT_TYPE_CURRENT_INPUT, FILE_SHARE_READ | FILE_SHARE_WRITE, GENERIC_READ | GENERIC_WRITE };
+        LoopbackDeviceComm::Request create;
+        create.Descriptor.Process = _comm.PutHandle(_process);
+        create.Descriptor.Function = CONSOLE_IO_CREATE_OBJECT;
+        create.Descriptor.InputSize = sizeof(createInfo);
+        create.Input.assign(reinterpret_cast<const BYTE*>(&createInfo), reinterpret_cast<const BYTE*>(&createInfo + 1));
+        _comm.Submit(create);
+        _ServiceRequests();
+        _VerifyCompleted(create);
+        return create.IoStatus.Information;
+    }
+
+    void _CloseObject(const ULONG_PTR object)
+    {
+        LoopbackDeviceComm::Request close;
+        close.Descriptor.Process = _comm.PutHandle(_process);
+        close.Descriptor.Object = object;
+        close.Descriptor.Function = CONSOLE_IO_CLOSE_OBJECT;
+        _comm.Submit(close);
+        _ServiceRequests();
+    }
+
+    LoopbackDeviceComm::Request _ReadConsoleW(const ULONG_PTR input, const std::wstring_view exeName, const ULONG bufferSize)
+    {
+        CONSOLE_READCONSOLE_MSG msg{};
+        msg.Unicode = TRUE;
+        msg.ExeNameLength = gsl::narrow<USHORT>(exeName.size());
+        const std::span payload{ reinterpret_cast<const BYTE*>(exeName.data()), exeName.size() * sizeof(wchar_t) };
+        return LoopbackDeviceComm::MakeApiRequest(ConsolepReadConsole, _comm.PutHandle(_process), input, &msg, sizeof(msg), payload, bufferSize);
+    }
+
+    TEST_METHOD(WriteAndReadBack)
+    {
+        auto requests = std::array{
+            _SetConsoleCursorPosition({ 0, 0 }),
+            _WriteConsoleW(L"Hello"),
+            _ReadConsoleOutputW({ 0, 0, 4, 0 }),
+        };
+
+        for (auto& request : requests)
+        {
+            _comm.Submit(request);
+        }
+        _ServiceRequests();
+        VERIFY_ARE_EQUAL(0u, _comm.PendingCount());
+
+        for (const auto& request : requests)
+        {
+            _VerifyCompleted(request);
+        }
+
+        Log::Comment(L"WriteConsoleW must reply with the number of bytes written.");
+        const auto write = _ApiMessage<CONSOLE_WRITECONSOLE_MSG>(requests[1]);
+        VERIFY_ARE_EQUAL(5 * sizeof(wchar_t), write.NumBytes);
+
+        Log::Comment(L"ReadConsoleOutputW must return the region and its contents through the output buffer.");
+        const auto read = _ApiMessage<CONSOLE_READCONSOLEOUTPUT_MSG>(requests[2]);
+        VERIFY_ARE_EQUAL(4, read.CharRegion.Right);
+        VERIFY_ARE_EQUAL(0, read.CharRegion.Bottom);
+
+        std::array<CHAR_INFO, 5> cells{};
+        memcpy(cells.data(), requests[2].Output.data() + sizeof(CONSOLE_READCONSOLEOUTPUT_MSG), sizeof(cells));
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(L"Hello"[i], til::at(cells, i).Char.UnicodeChar);
+        }
+    }
+
+    TEST_METHOD(RecordsApiLatency)
+    {
+        auto& metrics = ServiceLocator::LocateGlobals().apiMetrics;
+
+        auto requests = std::array{
+            _SetConsoleCursorPosition({ 0, 0 }),
+            _WriteConsoleW(L"a"),
+            _SetConsoleCursorPosition({ 0, 1 }),
+            _WriteConsoleW(L"b"),
+        };
+        const auto serviceAll = [&]() {
+            for (auto& request : requests)
+            {
+                _comm.Submit(request);
+            }
+            _ServiceRequests();
+            for (const auto& request : requests)
+            {
+                _VerifyCompleted(request);
+            }
+        };
+        const auto countCalls = [&](const ULONG apiNumber) {
+            const auto histogram = metrics.ApiLatency(apiNumber);
+            VERIFY_IS_NOT_NULL(histogram);
+            return std::accumulate(histogram->begin(), histogram->end(), 0u);
+        };
+
+        Log::Comment(L"Each API must have its latency recorded exactly once per call.");
+        serviceAll();
+        VERIFY_ARE_EQUAL(2u, countCalls(ConsolepSetCursorPosition));
+        VERIFY_ARE_EQUAL(2u, countCalls(ConsolepWriteConsole));
+        VERIFY_ARE_EQUAL(0u, countCalls(ConsolepReadConsoleOutput));
+
+        Log::Comment(L"Nothing must be recorded while the metrics are disabled.");
+        metrics.SetEnabled(false);
+        serviceAll();
+        metrics.SetEnabled(true);
+        VERIFY_ARE_EQUAL(2u, countCalls(ConsolepSetCursorPosition));
+        VERIFY_ARE_EQUAL(2u, countCalls(ConsolepWriteConsole));
+    }
+
+    TEST_METHOD(ReplayCallMix)
+    {
+        if (_SkipUnlessBenchmark())
+        {
+            return;
+        }
+
+        auto iterations = 1000;
+        RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto width = gci.GetActiveOutputBuffer().GetBufferSize().Width();
+        const auto height = gci.GetActiveOutputBuffer().GetBufferSize().Height();
+        const std::wstring line(gsl::narrow_cast<size_t>(width), L'x');
+
+        // The same scenarios ConsoleBench measures against a real conhost, minus the kernel transitions.
+        const auto run = [&](const wchar_t* name, auto&& makeRequests) {
+            std::vector<LoopbackDeviceComm::Request> requests;
+            for (auto i = 0; i < iterations; ++i)
+            {
+                makeRequests(requests, i % height);
+            }
+
+            for (auto& request : requests)
+            {
+                _comm.Submit(request);
+            }
+
+            const auto beg = std::chrono::high_resolution_clock::now();
+            _ServiceRequests();
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            for (const auto& request : requests)
+            {
+                _VerifyCompleted(request);
+            }
+
+            const auto ns = std::chrono::duration<double, std::nano>(end - beg).count();
+            Log::Comment(NoThrowString().Format(L"%-26s %6zu messages %10.0f ns/message", name, requests.size(), ns / requests.size()));
+        };
+        const auto logApiLatency = [&](const wchar_t* name, const ULONG apiNumber) {
+            const auto& histogram = *ServiceLocator::LocateGlobals().apiMetrics.ApiLatency(apiNumber);
+            Log::Comment(NoThrowString().Format(L"%-26s p50 < %6llu ns  p99 < %6llu ns", name, ApiMetrics::Percentile(histogram, 0.5), ApiMetrics::Percentile(histogram, 0.99)));
+        };
+
+        run(L"SetConsoleCursorPosition", [&](auto& requests, til::CoordType row) {
+            requests.emplace_back(_SetConsoleCursorPosition({ 0, row }));
+        });
+        run(L"WriteConsoleW", [&](auto& requests, til::CoordType) {
+            requests.emplace_back(_WriteConsoleW(line));
+        });
+        run(L"ReadConsoleOutputW", [&](auto& requests, til::CoordType row) {
+            requests.emplace_back(_ReadConsoleOutputW({ 0, row, width - 1, row }));
+        });
+        run(L"Mixed", [&](auto& requests, til::CoordType row) {
+            requests.emplace_back(_SetConsoleCursorPosition({ 0, row }));
+            requests.emplace_back(_WriteConsoleW(line));
+            requests.emplace_back(_ReadConsoleOutputW({ 0, row, width - 1, row }));
+        });
+
+        logApiLatency(L"SetConsoleCursorPosition", ConsolepSetCursorPosition);
+        logApiLatency(L"WriteConsoleW", ConsolepWriteConsole);
+        logApiLatency(L"ReadConsoleOutputW", ConsolepReadConsoleOutput);
+    }
+
+    // Edits the middle of a line that's several COOKED_READ_DATA::CheckpointInterval long and checks after every edit that the prompt and
+    // the cursor are drawn where laying out the entire line from scratch would put them. Tabs and wide glyphs make the
+    // width of the text depend on the column it starts in, which is what the cooked read checkpoints have to get right.
+    TEST_METHOD(CookedReadEditLongLine)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto width = textBuffer.GetSize().Width();
+
+        const auto insertMode = gci.GetInsertMode();
+        gci.SetInsertMode(true);
+        const auto restoreInsertMode = wil::scope_exit([&] { gci.SetInsertMode(insertMode); });
+
+        const auto input = _OpenInput();
+        const auto closeInput = wil::scope_exit([&] { _CloseObject(input); });
+
+        const auto origin = textBuffer.GetCursor().GetPosition();
+        VERIFY_ARE_EQUAL(0, origin.x);
+
+        auto read = _ReadConsoleW(input, L"edit.exe", 4096 * sizeof(wchar_t));
+        _comm.Submit(read);
+        _ServiceRequests();
+        VERIFY_IS_FALSE(read.Completed);
+
+        // The same edits are applied to this model of the prompt.
+        std::wstring expected;
+        size_t cursor = 0;
+        til::CoordType rowsToCheck = 0;
+
+        const auto type = [&](const std::wstring_view text) {
+            gci.LockConsole();
+            const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            gci.pInputBuffer->WriteString(text);
+        };
+        const auto press = [&](const WORD vkey, const size_t count) {
+            const std::vector<INPUT_RECORD> records(count, SynthesizeKeyEvent(true, 1, vkey, 0, 0, 0));
+            gci.LockConsole();
+            const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            gci.pInputBuffer->Write(records);
+        };
+        const auto insert = [&](const std::wstring_view text) {
+            type(text);
+            expected.insert(cursor, text);
+            cursor += text.size();
+        };
+        const auto moveTo = [&](const size_t offset) {
+            press(VK_HOME, 1);
+            press(VK_RIGHT, offset);
+            cursor = offset;
+        };
+        const auto verify = [&](const wchar_t* what) {
+            Log::Comment(what);
+
+            // Lays out the model like WriteCharsLegacy() does: Tabs advance to the next multiple of 8 columns and
+            // wide glyphs that don't fit into the remaining column get padded with whitespace and wrap.
+            // The only wide glyphs in this test are the CJK ones.
+            std::vector<std::wstring> rows(1);
+            til::point cursorPos;
+            til::CoordType col = 0;
+            const auto put = [&](const wchar_t ch, const til::CoordType columns) {
+                rows.back().push_back(ch);
+                col += columns;
+                if (col == width)
+                {
+                    rows.emplace_back();
+                    col = 0;
+                }
+            };
+            for (size_t i = 0; i <= expected.size(); ++i)
+            {
+                if (i == cursor)
+                {
+                    cursorPos = { col, origin.y + gsl::narrow_cast<til::CoordType>(rows.size()) - 1 };
+                }
+                if (i == expected.size())
+                {
+                    break;
+                }
+
+                const auto ch = expected[i];
+                if (ch == L'\t')
+                {
+                    for (auto n = 8 - col % 8; n > 0; --n)
+                    {
+                        put(L' ', 1);
+                    }
+                }
+                else if (ch >= 0x3000)
+                {
+                    if (col == width - 1)
+                    {
+                        put(L' ', 1);
+                    }
+                    put(ch, 2);
+                }
+                else
+                {
+                    put(ch, 1);
+                }
+            }
+
+            // Rows that the prompt occupied before it got shorter must be empty.
+            rowsToCheck = std::max(rowsToCheck, gsl::narrow_cast<til::CoordType>(rows.size()));
+            rows.resize(gsl::narrow_cast<size_t>(rowsToCheck));
+
+            const auto trim = [](const std::wstring_view text) {
+                return text.substr(0, text.find_last_not_of(L' ') + 1);
+            };
+            for (til::CoordType y = 0; y < rowsToCheck; ++y)
+            {
+                const auto& row = til::at(rows, gsl::narrow_cast<size_t>(y));
+                VERIFY_ARE_EQUAL(trim(row), trim(textBuffer.GetRowByOffset(origin.y + y).GetText()));
+            }
+            VERIFY_ARE_EQUAL(cursorPos, textBuffer.GetCursor().GetPosition());
+        };
+
+        // Mirrors COOKED_READ_DATA::CheckpointInterval.
+        static constexpr size_t CheckpointInterval = 256;
+
+        // Each repetition starts at a different column, so that the tabs and wide glyphs end up in all kinds of places.
+        static constexpr std::wstring_view segment{ L"abc\tde\u3042fg\u4e00\u4e01hi\tjklmn " };
+        std::wstring line;
+        while (line.size() < 6 * CheckpointInterval)
+        {
+            line.append(segment);
+        }
+
+        insert(line);
+        verify(L"Typing the entire line at once");
+
+        moveTo(0);
+        verify(L"Moving to the start");
+
+        moveTo(3 * CheckpointInterval + 5);
+        verify(L"Moving past a couple of checkpoints");
+
+        insert(L"X\t\u3042Y");
+        verify(L"Inserting in the middle");
+
+        press(VK_DELETE, 5);
+        expected.erase(cursor, 5);
+        verify(L"Deleting after the cursor");
+
+        type(L"\b\b\b");
+        expected.erase(cursor - 3, 3);
+        cursor -= 3;
+        verify(L"Deleting before the cursor");
+
+        moveTo(CheckpointInterval - 1);
+        insert(L"\t\t");
+        verify(L"Inserting right before the first checkpoint");
+
+        moveTo(2 * CheckpointInterval);
+        press(VK_DELETE, CheckpointInterval + 3);
+        expected.erase(cursor, CheckpointInterval + 3);
+        verify(L"Deleting an entire checkpoint interval");
+
+        press(VK_END, 1);
+        cursor = expected.size();
+        insert(L"\u3042end");
+        verify(L"Appending at the end");
+
+        type(L"\r");
+        _ServiceRequests();
+        _VerifyCompleted(read);
+        const auto result = _ApiMessage<CONSOLE_READCONSOLE_MSG>(read);
+        VERIFY_ARE_EQUAL((expected.size() + 2) * sizeof(wchar_t), result.NumBytes);
+        const std::wstring_view actual{ reinterpret_cast<const wchar_t*>(read.Output.data() + sizeof(CONSOLE_READCONSOLE_MSG)), expected.size() };
+        VERIFY_ARE_EQUAL(std::wstring_view{ expected }, actual);
+    }
+
+    // Measures how many lines per second a cooked read with doskey aliases can process,
+    // which is what scripts piping commands into cmd.exe are bound by.
+    TEST_METHOD(CookedReadWithAliases)
+    {
+        if (_SkipUnlessBenchmark())
+        {
+            return;
+        }
+
+        auto iterations = 1000;
+        RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+        static constexpr size_t aliasCount = 500;
+        const std::wstring_view exeName{ L"bench.exe" };
+
+        for (size_t i = 0; i < aliasCount; ++i)
+        {
+            VERIFY_SUCCEEDED(_routines.AddConsoleAliasWImpl(fmt::format(FMT_COMPILE(L"alias{}"), i), L"echo $1 $2$Gnul", exeName));
+        }
+        const auto removeAliases = wil::scope_exit([&] {
+            for (size_t i = 0; i < aliasCount; ++i)
+            {
+                LOG_IF_FAILED(_routines.AddConsoleAliasWImpl(fmt::format(FMT_COMPILE(L"alias{}"), i), {}, exeName));
+            }
+        });
+
+        const auto input = _OpenInput();
+        const auto closeInput = wil::scope_exit([&] { _CloseObject(input); });
+
+        // Every line must already be in the input buffer. Otherwise a read would turn into a wait.
+        std::wstring lines;
+        std::vector<LoopbackDeviceComm::Request> requests;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            fmt::format_to(std::back_inserter(lines), FMT_COMPILE(L"alias{} one two\r"), gsl::narrow_cast<size_t>(i) % aliasCount);
+            requests.emplace_back(_ReadConsoleW(input, exeName, 256 * sizeof(wchar_t)));
+        }
+        ServiceLocator::LocateGlobals().getConsoleInformation().pInputBuffer->WriteString(lines);
+
+        for (auto& request : requests)
+        {
+            _comm.Submit(request);
+        }
+
+        const auto beg = std::chrono::high_resolution_clock::now();
+        _ServiceRequests();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        for (const auto& request : requests)
+        {
+            _VerifyCompleted(request);
+        }
+
+        Log::Comment(L"Each read must return the expanded alias.");
+        const std::wstring_view expected{ L"echo one two>nul\r\n" };
+        const auto read = _ApiMessage<CONSOLE_READCONSOLE_MSG>(requests.front());
+        VERIFY_ARE_EQUAL(expected.size() * sizeof(wchar_t), read.NumBytes);
+        const std::wstring_view actual{ reinterpret_cast<const wchar_t*>(requests.front().Output.data() + sizeof(CONSOLE_READCONSOLE_MSG)), expected.size() };
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        const auto seconds = std::chrono::duration<double>(end - beg).count();
+        Log::Comment(NoThrowString().Format(L"%d lines with %zu aliases: %.0f lines/s", iterations, aliasCount, iterations / seconds));
+    }
+
+    // Measures how fast a cooked read echoes keystrokes that arrive one at a time at the end of an ever longer line.
+    // The cost per keystroke should be independent of the length of the line.
+    TEST_METHOD(CookedReadTypingLongLine)
+    {
+        if (_SkipUnlessBenchmark())
+        {
+            return;
+        }
+
+        auto iterations = 16384;
+        RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto input = _OpenInput();
+        const auto closeInput = wil::scope_exit([&] { _CloseObject(input); });
+
+        // The input buffer is empty, so this read turns into a wait that's serviced by every WriteString() below.
+        const auto bufferSize = gsl::narrow<ULONG>((iterations + 2) * sizeof(wchar_t));
+        auto read = _ReadConsoleW(input, L"bench.exe", bufferSize);
+        _comm.Submit(read);
+        _ServiceRequests();
+        VERIFY_IS_FALSE(read.Completed);
+
+        const auto type = [&](const std::wstring_view text) {
+            gci.LockConsole();
+            const auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+            gci.pInputBuffer->WriteString(text);
+        };
+
+        // Tabs make the measurement depend on the column, which is what checkpoints need to get right.
+        static constexpr std::wstring_view alphabet{ L"abc\tdefghijklmnopqrstuvwxyz " };
+        std::vector<double> timings;
+        const auto beg = std::chrono::high_resolution_clock::now();
+        auto sliceBeg = beg;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            type(alphabet.substr(gsl::narrow_cast<size_t>(i) % alphabet.size(), 1));
+
+            if ((i + 1) % 4096 == 0)
+            {
+                const auto now = std::chrono::high_resolution_clock::now();
+                timings.emplace_back(std::chrono::duration<double, std::micro>(now - sliceBeg).count() / 4096);
+                sliceBeg = now;
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        type(L"\r");
+        _ServiceRequests();
+        _VerifyCompleted(read);
+        VERIFY_ARE_EQUAL(bufferSize, _ApiMessage<CONSOLE_READCONSOLE_MSG>(read).NumBytes);
+
+        for (size_t i = 0; i < timings.size(); ++i)
+        {
+            Log::Comment(NoThrowString().Format(L"chars %zu-%zu: %.2f us/keystroke", i * 4096, (i + 1) * 4096, timings[i]));
+        }
+        const auto seconds = std::chrono::duration<double>(end - beg).count();
+        Log::Comment(NoThrowString().Format(L"%d keystrokes: %.0f keystrokes/s", iterations, iterations / seconds));
+    }
+};
@@ -239,6 +239,8 @@ class ScreenBufferTests
     TEST_METHOD(TestAddHyperlink);
     TEST_METHOD(TestAddHyperlinkCustomId);
     TEST_METHOD(TestAddHyperlinkCustomIdDifferentUri);
+    TEST_METHOD(TestRestoreHyperlinkAfterPrune);
+    TEST_METHOD(TestPopHyperlinkAfterPrune);
 
     TEST_METHOD(UpdateVirtualBottomWhenCursorMovesBelowIt);
     TEST_METHOD(UpdateVirtualBottomWithSetConsoleCursorPosition);
@@ -7171,6 +7173,94 @@ void ScreenBufferTests::TestAddHyperlinkCustomIdDifferentUri()
     VERIFY_ARE_NOT_EQUAL(oldAttributes.GetHyperlinkId(), tbi.GetCurrentAttributes().GetHyperlinkId());
 }
 
+void ScreenBufferTests::TestRestoreHyperlinkAfterPrune()
+{
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tbi = si.GetTextBuffer();
+    auto& stateMachine = si.GetStateMachine();
+
+    const auto saveWithHyperlinkAndPrune = [&]() {
+        // Write a hyperlink, save the cursor state (DECSC) and end the hyperlink.
+        stateMachine.ProcessString(L"\x1b[H\x1b]8;;test.url\x1b\\Hello\x1b" L"7");
+        const auto savedId = tbi.GetCurrentAttributes().GetHyperlinkId();
+        stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+
+        // Erase the only text with the hyperlink and let the buffer prune it.
+        stateMachine.ProcessString(L"\x1b[2K");
+        tbi.IncrementCircularBuffer();
+        VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(savedId), L"");
+        return savedId;
+    };
+
+    Log::Comment(L"Restoring a pruned hyperlink (DECRC) brings back its URI.");
+    saveWithHyperlinkAndPrune();
+    stateMachine.ProcessString(L"\x1b" L"8");
+    VERIFY_IS_TRUE(tbi.GetCurrentAttributes().IsHyperlink());
+    VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(tbi.GetCurrentAttributes().GetHyperlinkId()), L"test.url");
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+
+    Log::Comment(L"The same is true if the ID got reused for another hyperlink in the meantime.");
+    const auto savedId = saveWithHyperlinkAndPrune();
+    for (size_t i = 0; i < 4 * HyperlinkTable::ReuseDelay; ++i)
+    {
+        stateMachine.ProcessString(L"\x1b]8;;other" + std::to_wstring(i) + L"\x1b\\");
+    }
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+    VERIFY_ARE_NOT_EQUAL(tbi.GetHyperlinkUriFromId(savedId), L"test.url");
+    stateMachine.ProcessString(L"\x1b" L"8");
+    VERIFY_IS_TRUE(tbi.GetCurrentAttributes().IsHyperlink());
+    VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(tbi.GetCurrentAttributes().GetHyperlinkId()), L"test.url");
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+}
+
+void ScreenBufferTests::TestPopHyperlinkAfterPrune()
+{
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tbi = si.GetTextBuffer();
+    auto& stateMachine = si.GetStateMachine();
+
+    const auto pushWithHyperlinkAndPrune = [&]() {
+        // Write a hyperlink, push the attributes (XTPUSHSGR) and end the hyperlink.
+        stateMachine.ProcessString(L"\x1b[H\x1b]8;;test.url\x1b\\Hello\x1b[#{");
+        const auto savedId = tbi.GetCurrentAttributes().GetHyperlinkId();
+        stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+
+        // Erase the only text with the hyperlink and let the buffer prune it.
+        stateMachine.ProcessString(L"\x1b[2K");
+        tbi.IncrementCircularBuffer();
+        VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(savedId), L"");
+        return savedId;
+    };
+
+    Log::Comment(L"Popping a pruned hyperlink (XTPOPSGR) brings back its URI.");
+    pushWithHyperlinkAndPrune();
+    stateMachine.ProcessString(L"\x1b[#}");
+    VERIFY_IS_TRUE(tbi.GetCurrentAttributes().IsHyperlink());
+    VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(tbi.GetCurrentAttributes().GetHyperlinkId()), L"test.url");
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+
+    Log::Comment(L"The same is true if the ID got reused for another hyperlink in the meantime.");
+    const auto savedId = pushWithHyperlinkAndPrune();
+    for (size_t i = 0; i < 4 * HyperlinkTable::ReuseDelay; ++i)
+    {
+        stateMachine.ProcessString(L"\x1b]8;;other" + std::to_wstring(i) + L"\x1b\\");
+    }
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+    VERIFY_ARE_NOT_EQUAL(tbi.GetHyperlinkUriFromId(savedId), L"test.url");
+    stateMachine.ProcessString(L"\x1b[#}");
+    VERIFY_IS_TRUE(tbi.GetCurrentAttributes().IsHyperlink());
+    VERIFY_ARE_EQUAL(tbi.GetHyperlinkUriFromId(tbi.GetCurrentAttributes().GetHyperlinkId()), L"test.url");
+    stateMachine.ProcessString(L"\x1b]8;;\x1b\\");
+
+    Log::Comment(L"Popping only some of the attributes keeps the current hyperlink.");
+    stateMachine.ProcessString(L"\x1b]8;;test.url\x1b\\\x1b[1#{\x1b]8;;\x1b\\\x1b[#}");
+    VERIFY_IS_FALSE(tbi.GetCurrentAttributes().IsHyperlink());
+}
+
 void ScreenBufferTests::UpdateVirtualBottomWhenCursorMovesBelowIt()
 {
     auto& g = ServiceLocator::LocateGlobals();
@@ -25,6 +25,7 @@ using namespace Microsoft::Console::VirtualTerminal;
 using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
+using namespace std::string_view_literals;
 
 class TextBufferTests
 {
@@ -91,6 +92,7 @@ class TextBufferTests
     TEST_METHOD(TestBoundaryMeasuresFullString);
     TEST_METHOD(TestBoundaryMeasuresRegularString);
     TEST_METHOD(TestBoundaryMeasuresFloatingString);
+    TEST_METHOD(TestBoundaryMeasuresAfterOverwrite);
 
     TEST_METHOD(TestCopyProperties);
 
@@ -148,19 +150,28 @@ class TextBufferTests
     TEST_METHOD(TestBurrito);
     TEST_METHOD(TestOverwriteChars);
     TEST_METHOD(TestRowReplaceText);
+    TEST_METHOD(TestRowReplaceTextLongCluster);
+    TEST_METHOD(TestFitTextIntoColumns);
 
     TEST_METHOD(TestAppendRTFText);
 
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
     TEST_METHOD(GetWordBoundaries);
     TEST_METHOD(MoveByWord);
+    TEST_METHOD(WordIndexIsInvalidated);
     TEST_METHOD(GetGlyphBoundaries);
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetPlainText);
+    TEST_METHOD(SerializeInChunks);
+    TEST_METHOD(SnapshotIsFrozen);
+    TEST_METHOD(RowGenerations);
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkTrimOverwritten);
+
+    TEST_METHOD(ScrollMarksKeepsMarksSorted);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -359,6 +370,42 @@ void TextBufferTests::TestBoundaryMeasuresFloatingString()
     DoBoundaryTest(pwszOffsets, 14, csBufferWidth, 5, 9);
 }
 
+void TextBufferTests::TestBoundaryMeasuresAfterOverwrite()
+{
+    auto& textBuffer = GetTbi();
+    auto& row = textBuffer.GetMutableRowByOffset(0);
+    row.Reset(TextAttribute{});
+    VERIFY_IS_FALSE(row.ContainsText());
+    VERIFY_ARE_EQUAL(0, row.MeasureRight());
+
+    Log::Comment(L"Writing text in front of existing text must not shrink the measurement.");
+    row.ReplaceCharacters(40, 1, L"X");
+    row.ReplaceCharacters(10, 1, L"Y");
+    VERIFY_ARE_EQUAL(10, row.MeasureLeft());
+    VERIFY_ARE_EQUAL(41, row.MeasureRight());
+
+    Log::Comment(L"Combining characters in front of the text shift it in the underlying string, but not in columns.");
+    row.ReplaceCharacters(0, 1, L"e\x0301");
+    VERIFY_ARE_EQUAL(0, row.MeasureLeft());
+    VERIFY_ARE_EQUAL(41, row.MeasureRight());
+
+    Log::Comment(L"Overwriting the last text with whitespace has to find the text before it.");
+    row.ClearCell(40);
+    VERIFY_ARE_EQUAL(11, row.MeasureRight());
+
+    Log::Comment(L"Overwriting half of a wide glyph pads the other half with whitespace.");
+    row.ReplaceCharacters(15, 2, L"\x732B");
+    VERIFY_ARE_EQUAL(17, row.MeasureRight());
+    row.ClearCell(15);
+    VERIFY_ARE_EQUAL(11, row.MeasureRight());
+
+    row.ClearCell(10);
+    row.ClearCell(0);
+    VERIFY_IS_FALSE(row.ContainsText());
+    VERIFY_ARE_EQUAL(0, row.MeasureRight());
+    VERIFY_ARE_EQUAL(GetBufferWidth(), row.MeasureLeft());
+}
+
 void TextBufferTests::TestCopyProperties()
 {
     auto& otherTbi = GetTbi();
@@ -2012,6 +2059,7 @@ void TextBufferTests::TestRowReplaceText()
     auto& row = buffer.GetMutableRowByOffset(0);
 
 #define complex L"\U0001F41B"
+#define family L"\U0001F468\u200D\U0001F469\u200D\U0001F467"
 
     struct Test
     {
@@ -2063,6 +2111,24 @@ void TextBufferTests::TestRowReplaceText()
             { L"", 4, 0, 5 },
             L" efg c" complex L"ab",
         },
+        Test{
+            L"Combining marks are part of the preceding cell",
+            { L"e\u0301x", 0, til::CoordTypeMax },
+            { L"", 2, 0, 2 },
+            L"e\u0301xfg c" complex L"ab",
+        },
+        Test{
+            L"Emoji ZWJ sequences occupy a single wide cell",
+            { family, 2, til::CoordTypeMax },
+            { L"", 4, 2, 4 },
+            L"e\u0301x" family L" c" complex L"ab",
+        },
+        Test{
+            L"Combining marks following ASCII in the last column",
+            { L"abe\u0301", 7, til::CoordTypeMax },
+            { L"", 10, 6, 10 },
+            L"e\u0301x" family L" c abe\u0301",
+        },
     };
 
     for (const auto& t : tests)
@@ -2081,9 +2147,90 @@ void TextBufferTests::TestRowReplaceText()
         VERIFY_ARE_EQUAL(t.expectedRow, row.GetText());
     }
 
+#undef family
 #undef complex
 }
 
+void TextBufferTests::TestRowReplaceTextLongCluster()
+{
+    static constexpr til::CoordType width = 80;
+    static constexpr auto maxLength = ROW::MaxClusterLength;
+
+    const til::size bufferSize{ width, 1 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    auto& row = buffer.GetMutableRowByOffset(0);
+
+    Log::Comment(L"A grapheme cluster far longer than a row can hold gets split after every MaxClusterLength code units.");
+    std::wstring text{ L"a" };
+    text.append(40000, L'\u0301');
+
+    RowWriteState state{
+        .text = text,
+        .columnLimit = til::CoordTypeMax,
+    };
+    row.ReplaceText(state);
+
+    VERIFY_ARE_EQUAL(width, state.columnEnd);
+    VERIFY_ARE_EQUAL(text.size() - width * maxLength, state.text.size());
+    VERIFY_ARE_EQUAL(width * maxLength, row.GetText().size());
+    VERIFY_ARE_EQUAL(std::wstring_view{ text }.substr(0, maxLength), row.GlyphAt(0));
+    VERIFY_ARE_EQUAL(std::wstring_view{ text }.substr(maxLength, maxLength), row.GlyphAt(1));
+    VERIFY_ARE_EQUAL(std::wstring_view{ text }.substr(0, maxLength), row.GetText(0, 1));
+
+    Log::Comment(L"FitTextIntoColumns() measures the same split.");
+    til::CoordType columns = 0;
+    VERIFY_ARE_EQUAL(width * maxLength, TextBuffer::FitTextIntoColumns(text, width, columns));
+    VERIFY_ARE_EQUAL(width, columns);
+
+    Log::Comment(L"Surrogate pairs are never split.");
+    text = L"a";
+    text.append(maxLength - 2, L'\u0301');
+    text.append(L"\U0001F3FB");
+    state = RowWriteState{
+        .text = text,
+        .columnLimit = til::CoordTypeMax,
+    };
+    row.ReplaceText(state);
+    VERIFY_ARE_EQUAL(std::wstring_view{ text }.substr(0, maxLength - 1), row.GlyphAt(0));
+    VERIFY_ARE_EQUAL(std::wstring_view{ L"\U0001F3FB" }, row.GlyphAt(1));
+}
+
+void TextBufferTests::TestFitTextIntoColumns()
+{
+#define family L"\U0001F468\u200D\U0001F469\u200D\U0001F467"
+
+    struct Test
+    {
+        std::wstring_view text;
+        til::CoordType columnLimit = 0;
+        size_t expectedLength = 0;
+        til::CoordType expectedColumns = 0;
+    };
+
+    static constexpr std::array tests{
+        Test{ L"abc", 10, 3, 3 },
+        Test{ L"abc", 2, 2, 2 },
+        // The combining mark belongs to the "e" and thus fits, even though the ASCII prefix alone fills all columns.
+        Test{ L"abe\u0301", 3, 4, 3 },
+        Test{ L"abe\u0301z", 3, 4, 3 },
+        // The ZWJ sequence is a single 2 column wide grapheme, which either fits entirely or not at all.
+        Test{ L"a" family, 3, 9, 3 },
+        Test{ L"a" family, 2, 1, 2 },
+    };
+
+    for (const auto& t : tests)
+    {
+        til::CoordType columns = 0;
+        const auto length = TextBuffer::FitTextIntoColumns(t.text, t.columnLimit, columns);
+        VERIFY_ARE_EQUAL(t.expectedLength, length);
+        VERIFY_ARE_EQUAL(t.expectedColumns, columns);
+    }
+
+#undef family
+}
+
 void TextBufferTests::TestAppendRTFText()
 {
     {
@@ -2416,6 +2563,33 @@ void TextBufferTests::MoveByWord()
     }
 }
 
+void TextBufferTests::WordIndexIsInvalidated()
+{
+    til::size bufferSize{ 200, 10 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // A word that spans several 64-column blocks of the index.
+    WriteLinesToBuffer({ std::wstring(150, L'x') + L" tail" }, *_buffer);
+
+    VERIFY_ARE_EQUAL((til::point{ 149, 0 }), _buffer->GetWordEnd({ 0, 0 }, L" ", false));
+    VERIFY_ARE_EQUAL((til::point{ 0, 0 }), _buffer->GetWordStart({ 149, 0 }, L" ", false));
+    VERIFY_ARE_EQUAL((til::point{ 151, 0 }), _buffer->GetWordEnd({ 0, 0 }, L" ", true));
+
+    Log::Comment(L"Modifying a row must invalidate its cached delimiter classes.");
+    auto& row = _buffer->GetMutableRowByOffset(0);
+    row.ReplaceCharacters(70, 1, L" ");
+    row.ReplaceCharacters(100, 1, L"-");
+    VERIFY_ARE_EQUAL((til::point{ 69, 0 }), _buffer->GetWordEnd({ 0, 0 }, L" ", false));
+    VERIFY_ARE_EQUAL((til::point{ 71, 0 }), _buffer->GetWordStart({ 149, 0 }, L" ", false));
+    VERIFY_ARE_EQUAL((til::point{ 149, 0 }), _buffer->GetWordEnd({ 71, 0 }, L" ", false));
+
+    Log::Comment(L"Changing the delimiters must reclassify all rows.");
+    VERIFY_ARE_EQUAL((til::point{ 99, 0 }), _buffer->GetWordEnd({ 71, 0 }, L" -", false));
+    VERIFY_ARE_EQUAL((til::point{ 101, 0 }), _buffer->GetWordStart({ 149, 0 }, L" -", false));
+}
+
 void TextBufferTests::GetGlyphBoundaries()
 {
     struct ExpectedResult
@@ -2774,6 +2948,145 @@ void TextBufferTests::GetPlainText()
 
 // This tests that when we increment the circular buffer, obsolete hyperlink references
 // are removed from the hyperlink map
+void TextBufferTests::SerializeInChunks()
+{
+    const til::size bufferSize{ 100, 2000 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // Fill the buffer with a few hundred KB of text and runs of various colors.
+    std::vector<std::wstring> bufferText;
+    for (auto i = 0; i < bufferSize.height; ++i)
+    {
+        bufferText.emplace_back(fmt::format(L"{:<97}<&>", i));
+    }
+    WriteLinesToBuffer(bufferText, *_buffer);
+    for (auto i = 0; i < bufferSize.height; i += 3)
+    {
+        _buffer->GetMutableRowByOffset(i).SetAttrToEnd(i % 50, TextAttribute{ gsl::narrow_cast<WORD>(i % 16) });
+    }
+
+    const auto req = TextBuffer::CopyRequest{ *_buffer, { 0, 0 }, { bufferSize.width - 1, bufferSize.height - 1 }, false, true, true, false };
+    const auto GetAttributeColors = [](const TextAttribute& attr) {
+        const auto fg = attr.GetForeground().GetIndex();
+        return std::tuple<COLORREF, COLORREF, COLORREF>{ RGB(fg, 0, 0), RGB(0, 0, 0), RGB(0, fg, 0) };
+    };
+
+    Log::Comment(L"Streamed output must be split into multiple chunks and match the output of the regular functions.");
+    {
+        std::wstring text;
+        size_t chunks = 0;
+        _buffer->SerializePlainText(req, [&](const std::wstring_view chunk) {
+            text.append(chunk);
+            chunks++;
+        });
+        VERIFY_IS_GREATER_THAN(chunks, 1u);
+        VERIFY_ARE_EQUAL(_buffer->GetPlainText(req), text);
+    }
+    {
+        std::string html;
+        size_t chunks = 0;
+        _buffer->SerializeHTML(req, 12, L"Consolas", RGB(0, 0, 0), false, GetAttributeColors, [&](const std::string_view chunk) {
+            html.append(chunk);
+            chunks++;
+        });
+        VERIFY_IS_GREATER_THAN(chunks, 1u);
+        // GenHTML() additionally prepends the CF_HTML header.
+        const auto clipboardHtml = _buffer->GenHTML(req, 12, L"Consolas", RGB(0, 0, 0), false, GetAttributeColors);
+        VERIFY_IS_TRUE(clipboardHtml.ends_with(html));
+        VERIFY_IS_TRUE(html.find("&lt;&amp;&gt;") != std::string::npos);
+    }
+    {
+        std::string rtf;
+        size_t chunks = 0;
+        _buffer->SerializeRTF(req, 12, L"Consolas", RGB(0, 0, 0), false, GetAttributeColors, [&](const std::string_view chunk) {
+            rtf.append(chunk);
+            chunks++;
+        });
+        VERIFY_IS_GREATER_THAN(chunks, 1u);
+        VERIFY_ARE_EQUAL(_buffer->GenRTF(req, 12, L"Consolas", RGB(0, 0, 0), false, GetAttributeColors), rtf);
+    }
+}
+
+void TextBufferTests::SnapshotIsFrozen()
+{
+    const til::size bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // Rotate the buffer once, so that the rows don't start at the beginning of the underlying storage.
+    WriteLinesToBuffer({ L"AAAAA", L"BBBBB", L"CCCCC" }, *_buffer);
+    _buffer->IncrementCircularBuffer();
+
+    const auto id = _buffer->GetHyperlinkId(L"test.url", {});
+    TextAttribute linkAttr{ 0x1f };
+    linkAttr.SetHyperlinkId(id);
+    _buffer->GetMutableRowByOffset(1).SetAttrToEnd(2, linkAttr);
+    _buffer->AddHyperlinkToMap(L"test.url", id);
+    _buffer->GetCursor().SetPosition({ 3, 1 });
+
+    // This cluster doesn't fit into the row's part of the arena and spills onto the heap.
+    const auto cluster = L"e" + std::wstring(15, L'\u0301');
+    _buffer->GetMutableRowByOffset(2).ReplaceCharacters(0, 1, cluster);
+
+    const auto snapshot = _buffer->Snapshot();
+    VERIFY_ARE_EQUAL(_buffer->GetLastMutationId(), snapshot->GetLastMutationId());
+
+    Log::Comment(L"Modifying the buffer must not affect the snapshot.");
+    _buffer->GetMutableRowByOffset(0).Reset(attr);
+    _buffer->GetMutableRowByOffset(2).Reset(attr);
+    _buffer->IncrementCircularBuffer();
+
+    VERIFY_ARE_EQUAL(L"BBBBB     "sv, snapshot->GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L"CCCCC     "sv, snapshot->GetRowByOffset(1).GetText());
+    VERIFY_IS_TRUE(snapshot->GetRowByOffset(2).GetText() == cluster + L"         ");
+    VERIFY_ARE_EQUAL(L"          "sv, snapshot->GetRowByOffset(4).GetText());
+    VERIFY_ARE_EQUAL(linkAttr, snapshot->GetRowByOffset(1).GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(std::wstring{ L"test.url" }, snapshot->GetHyperlinkUriFromId(id));
+    VERIFY_ARE_EQUAL(til::point(3, 1), snapshot->GetCursor().GetPosition());
+    VERIFY_ARE_NOT_EQUAL(_buffer->GetLastMutationId(), snapshot->GetLastMutationId());
+}
+
+void TextBufferTests::RowGenerations()
+{
+    til::size bufferSize{ 10, 5 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    const auto initial = _buffer->GetLastMutationId();
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowsChangedSince(initial).size());
+
+    _buffer->GetMutableRowByOffset(3).ReplaceCharacters(0, 1, L"A");
+    _buffer->GetMutableRowByOffset(1).ReplaceCharacters(0, 1, L"B");
+    VERIFY_IS_TRUE((_buffer->GetRowsChangedSince(initial) == std::vector<til::CoordType>{ 1, 3 }));
+
+    const auto afterFirstWrite = _buffer->GetLastMutationId();
+    _buffer->GetMutableRowByOffset(3).ReplaceCharacters(1, 1, L"C");
+    VERIFY_IS_TRUE((_buffer->GetRowsChangedSince(afterFirstWrite) == std::vector<til::CoordType>{ 3 }));
+    VERIFY_IS_LESS_THAN_OR_EQUAL(_buffer->GetRowGeneration(1), afterFirstWrite);
+    VERIFY_IS_GREATER_THAN(_buffer->GetRowGeneration(3), afterFirstWrite);
+    VERIFY_IS_LESS_THAN_OR_EQUAL(_buffer->GetRowGeneration(0), initial);
+
+    Log::Comment(L"Scrolling shifts the changed rows along with the contents.");
+    const auto beforeScroll = _buffer->GetLastMutationId();
+    _buffer->IncrementCircularBuffer(attr);
+    VERIFY_IS_TRUE((_buffer->GetRowsChangedSince(beforeScroll) == std::vector<til::CoordType>{ 4 }));
+    VERIFY_IS_TRUE((_buffer->GetRowsChangedSince(afterFirstWrite) == std::vector<til::CoordType>{ 2, 4 }));
+
+    Log::Comment(L"Snapshots share the generations of their buffer.");
+    const auto snapshot = _buffer->Snapshot();
+    VERIFY_IS_TRUE(_buffer->GetRowsChangedSince(initial) == snapshot->GetRowsChangedSince(initial));
+
+    Log::Comment(L"Reset() changes all rows.");
+    const auto beforeReset = _buffer->GetLastMutationId();
+    _buffer->Reset();
+    VERIFY_IS_TRUE((_buffer->GetRowsChangedSince(beforeReset) == std::vector<til::CoordType>{ 0, 1, 2, 3, 4 }));
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowsChangedSince(_buffer->GetLastMutationId()).size());
+}
+
 void TextBufferTests::HyperlinkTrim()
 {
     // Set up a text buffer for us
@@ -2805,17 +3118,18 @@ void TextBufferTests::HyperlinkTrim()
     // Increment the circular buffer
     _buffer->IncrementCircularBuffer();
 
-    const auto finalCustomId = fmt::format(L"{}%{}", customId, til::hash(url));
     const auto finalOtherCustomId = fmt::format(L"{}%{}", otherCustomId, til::hash(otherUrl));
 
     // The hyperlink reference that was only in the first row should be deleted from the map
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.find(id), _buffer->_hyperlinkMap.end());
+    VERIFY_IS_FALSE(_buffer->_hyperlinks.Contains(id));
     // Since there was a custom id, that should be deleted as well
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap.find(finalCustomId), _buffer->_hyperlinkCustomIdMap.end());
+    VERIFY_IS_TRUE(_buffer->GetCustomIdFromId(id).empty());
+    VERIFY_ARE_EQUAL(1u, _buffer->_hyperlinks.size());
 
     // The other hyperlink reference should not be deleted
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap[otherId], otherUrl);
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalOtherCustomId], otherId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(otherId), otherUrl);
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(otherId), finalOtherCustomId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkId(otherUrl, otherCustomId), otherId);
 }
 
 // This tests that when we increment the circular buffer, non-obsolete hyperlink references
@@ -2850,5 +3164,125 @@ void TextBufferTests::NoHyperlinkTrim()
 
     // The hyperlink reference should not be deleted from the map since it is still present in the buffer
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(id), finalCustomId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkId(url, customId), id);
+}
+
+// This tests that hyperlinks which got overwritten anywhere in the buffer are
+// removed from the hyperlink map the next time the circular buffer is incremented
+void TextBufferTests::HyperlinkTrimOverwritten()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+    static constexpr std::wstring_view otherUrl{ L"other.url" };
+
+    // Write two hyperlinks into the middle of the buffer
+    const auto id = _buffer->GetHyperlinkId(url, {});
+    TextAttribute newAttr{ 0x7f };
+    newAttr.SetHyperlinkId(id);
+    _buffer->GetMutableRowByOffset(3).SetAttrToEnd(10, newAttr);
+    _buffer->AddHyperlinkToMap(url, id);
+
+    const auto otherId = _buffer->GetHyperlinkId(otherUrl, {});
+    newAttr.SetHyperlinkId(otherId);
+    _buffer->GetMutableRowByOffset(4).SetAttrToEnd(10, newAttr);
+    _buffer->AddHyperlinkToMap(otherUrl, otherId);
+
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(otherId), otherUrl);
+
+    // Overwrite the first hyperlink (which is now in row 2) with regular text
+    _buffer->GetMutableRowByOffset(2).SetAttrToEnd(0, attr);
+
+    // Neither hyperlink is in the first row, but the overwritten one must be deleted anyway
+    _buffer->IncrementCircularBuffer();
+    VERIFY_IS_FALSE(_buffer->_hyperlinks.Contains(id));
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(otherId), otherUrl);
+
+    // The current attributes keep their hyperlink alive, even if it isn't in the buffer yet
+    const auto currentId = _buffer->GetHyperlinkId(url, {});
+    auto currentAttr = _buffer->GetCurrentAttributes();
+    currentAttr.SetHyperlinkId(currentId);
+    _buffer->SetCurrentAttributes(currentAttr);
+    _buffer->AddHyperlinkToMap(url, currentId);
+
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(currentId), url);
+}
+
+void TextBufferTests::ScrollMarksKeepsMarksSorted()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    ScrollMark prompt;
+    prompt.category = MarkCategory::Prompt;
+    prompt.start = prompt.end = { 0, 2 };
+    _buffer->StartPromptMark(prompt);
+    prompt.start = prompt.end = { 0, 6 };
+    _buffer->StartPromptMark(prompt);
+
+    Log::Comment(L"Marks from the UI are sorted in, but don't become the current prompt.");
+    ScrollMark user;
+    user.start = user.end = { 0, 4 };
+    _buffer->AddMark(user);
+    _buffer->SetCurrentPromptEnd({ 5, 6 });
+    _buffer->SetCurrentCommandEnd({ 10, 6 });
+
+    auto marks = _buffer->GetMarks();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL(2, marks[0].start.y);
+    VERIFY_ARE_EQUAL(4, marks[1].start.y);
+    VERIFY_ARE_EQUAL(til::point(5, 6), marks[2].end);
+    VERIFY_ARE_EQUAL(til::point(10, 6), *marks[2].commandEnd);
+
+    Log::Comment(L"Scrolling moves all points of a mark and trims the ones that leave the buffer.");
+    _buffer->ScrollMarks(-3);
+    marks = _buffer->GetMarks();
+    VERIFY_ARE_EQUAL(2u, marks.size());
+    VERIFY_ARE_EQUAL(1, marks[0].start.y);
+    VERIFY_ARE_EQUAL(til::point(5, 3), marks[1].end);
+    VERIFY_ARE_EQUAL(til::point(10, 3), *marks[1].commandEnd);
+
+    Log::Comment(L"Queries only return the marks starting in the given rows.");
+    VERIFY_ARE_EQUAL(1u, _buffer->GetMarksInRange(2, 9).size());
+    VERIFY_ARE_EQUAL(1, _buffer->GetPreviousMark(3)->start.y);
+    VERIFY_ARE_EQUAL(3, _buffer->GetNextMark(1)->start.y);
+    VERIFY_IS_FALSE(_buffer->GetNextMark(3).has_value());
+    VERIFY_IS_FALSE(_buffer->GetPreviousMark(1).has_value());
+
+    Log::Comment(L"Clearing the current prompt falls back to the last remaining mark.");
+    _buffer->ClearMarksInRange({ 0, 3 }, { 79, 3 });
+    _buffer->SetCurrentOutputEnd({ 7, 1 }, MarkCategory::Success);
+    marks = _buffer->GetMarks();
+    VERIFY_ARE_EQUAL(1u, marks.size());
+    VERIFY_ARE_EQUAL(til::point(7, 1), *marks[0].outputEnd);
+
+    Log::Comment(L"The current prompt isn't necessarily the last mark.");
+    prompt.start = prompt.end = { 0, 5 };
+    _buffer->StartPromptMark(prompt);
+    user.start = user.end = { 0, 8 };
+    _buffer->AddMark(user);
+    VERIFY_ARE_EQUAL(8, _buffer->GetMarks().back().start.y);
+    VERIFY_ARE_EQUAL(5, _buffer->GetCurrentPromptMark()->start.y);
+
+    Log::Comment(L"Marks that start above the cleared range but end in it are cleared as well.");
+    user.start = { 0, 0 };
+    user.end = { 0, 7 };
+    _buffer->AddMark(user);
+    _buffer->ClearMarksInRange({ 0, 7 }, { 79, 7 });
+    marks = _buffer->GetMarks();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL(1, marks[0].start.y);
+    VERIFY_ARE_EQUAL(5, _buffer->GetCurrentPromptMark()->start.y);
+
+    _buffer->ScrollMarks(10);
+    VERIFY_IS_FALSE(_buffer->HasMarks());
 }
@@ -6,7 +6,11 @@
 #include "../../inc/consoletaeftemplates.hpp"
 #include "../../types/inc/Viewport.hpp"
 
+#include "CommonState.hpp"
+
 #include "../VtIo.hpp"
+#include "../VtInputThread.hpp"
+#include "../../interactivity/inc/EventSynthesis.hpp"
 #include "../../interactivity/inc/ServiceLocator.hpp"
 #include "../../renderer/base/Renderer.hpp"
 #include "../../renderer/vt/Xterm256Engine.hpp"
@@ -35,6 +39,8 @@ class Microsoft::Console::VirtualTerminal::VtIoTests
     TEST_METHOD(RendererDtorAndThread);
 
     TEST_METHOD(BasicAnonymousPipeOpeningWithSignalChannelTest);
+
+    TEST_METHOD(VtInputThreadPasteTest);
 };
 
 using namespace Microsoft::Console;
@@ -455,3 +461,71 @@ void VtIoTests::BasicAnonymousPipeOpeningWithSignalChannelTest()
     VERIFY_IS_TRUE(vtio.IsUsingVt());
     VERIFY_ARE_NOT_EQUAL(nullptr, vtio._pPtySignalInputThread);
 }
+
+void VtIoTests::VtInputThreadPasteTest()
+{
+    Log::Comment(L"Feed a large paste through the VtInputThread and ensure it arrives in the input buffer unchanged.");
+
+    CommonState state;
+    state.PrepareGlobalInputBuffer();
+    const auto cleanupInputBuffer = wil::scope_exit([&]() {
+        state.CleanupGlobalInputBuffer();
+    });
+
+    // A benchmark run pastes about 1 MB and logs how long that took. Otherwise a paste
+    // that spans a couple of reads from the pipe is enough to check the contents.
+    auto benchmark = false;
+    RuntimeParameters::TryGetValue(L"Benchmark", benchmark);
+    const auto repetitions = benchmark ? 8 * 1024 : 256;
+
+    static constexpr std::string_view payload{ "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. " };
+    std::string paste;
+    for (auto i = 0; i < repetitions; ++i)
+    {
+        paste.append(payload);
+    }
+
+    wil::unique_hfile readSide;
+    wil::unique_hfile writeSide;
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(readSide.addressof(), writeSide.addressof(), nullptr, gsl::narrow<DWORD>(paste.size())));
+
+    DWORD written = 0;
+    VERIFY_WIN32_BOOL_SUCCEEDED(WriteFile(writeSide.get(), paste.data(), gsl::narrow<DWORD>(paste.size()), &written, nullptr));
+    VERIFY_ARE_EQUAL(paste.size(), static_cast<size_t>(written));
+    writeSide.reset();
+
+    VtInputThread inputThread{ std::move(readSide), false };
+
+    const auto beg = std::chrono::steady_clock::now();
+    while (inputThread.DoReadInput())
+    {
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    if (benchmark)
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - beg).count();
+        Log::Comment(NoThrowString().Format(L"Processed %zu bytes in %lldus", paste.size(), elapsed));
+    }
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    InputEventQueue expected;
+    for (const auto ch : paste)
+    {
+        Microsoft::Console::Interactivity::CharToKeyEvents(ch, gci.OutputCP, expected);
+    }
+
+    InputEventQueue actual;
+    VERIFY_NT_SUCCESS(gci.pInputBuffer->Read(actual, expected.size() + 1, false, false, true, false));
+    VERIFY_ARE_EQUAL(expected.size(), actual.size());
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        const auto& e = expected[i].Event.KeyEvent;
+        const auto& a = actual[i].Event.KeyEvent;
+        if (memcmp(&e, &a, sizeof(e)) != 0)
+        {
+            VERIFY_FAIL(NoThrowString().Format(L"Mismatch at event %zu", i));
+        }
+    }
+}
@@ -0,0 +1,403 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <bit>
+
+#pragma warning(push)
+// Functions like front()/back()/operator[]() are explicitly unchecked, just like the std::deque equivalents.
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+// ring::_data is indexed by masking the position with the capacity, which the checker can't see through.
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+
+namespace til
+{
+    // A FIFO queue of trivially copyable elements, similar to std::deque.
+    // Unlike std::deque, the elements are stored in a single, growable allocation whose capacity
+    // is always a power of 2. This turns indexing into a simple mask, avoids the per-block
+    // allocations std::deque makes while it's being filled and drained, and allows bulk
+    // insertions and removals to be implemented with a couple of std::copy_n calls.
+    // Once a ring that grew past shrink_threshold is emptied, it releases its allocation.
+    template<typename T>
+    class ring
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "ring copies its elements with std::copy_n and never destroys them");
+
+        template<bool IsConst>
+        class iterator_impl
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<IsConst, const T*, T*>;
+            using reference = std::conditional_t<IsConst, const T&, T&>;
+            using ring_pointer = std::conditional_t<IsConst, const ring*, ring*>;
+
+            iterator_impl() = default;
+
+            iterator_impl(ring_pointer ring, size_t index) noexcept :
+                _ring{ ring },
+                _index{ index }
+            {
+            }
+
+            operator iterator_impl<true>() const noexcept
+                requires(!IsConst)
+            {
+                return { _ring, _index };
+            }
+
+            [[nodiscard]] reference operator*() const noexcept
+            {
+                return (*_ring)[_index];
+            }
+
+            [[nodiscard]] pointer operator->() const noexcept
+            {
+                return &operator*();
+            }
+
+            [[nodiscard]] reference operator[](const difference_type offset) const noexcept
+            {
+                return *(*this + offset);
+            }
+
+            iterator_impl& operator++() noexcept
+            {
+                ++_index;
+                return *this;
+            }
+
+            iterator_impl operator++(int) noexcept
+            {
+                auto tmp = *this;
+                ++_index;
+                return tmp;
+            }
+
+            iterator_impl& operator--() noexcept
+            {
+                --_index;
+                return *this;
+            }
+
+            iterator_impl operator--(int) noexcept
+            {
+                auto tmp = *this;
+                --_index;
+                return tmp;
+            }
+
+            iterator_impl& operator+=(const difference_type offset) noexcept
+            {
+                _index += offset;
+                return *this;
+            }
+
+            iterator_impl& operator-=(const difference_type offset) noexcept
+            {
+                _index -= offset;
+                return *this;
+            }
+
+            [[nodiscard]] iterator_impl operator+(const difference_type offset) const noexcept
+            {
+                auto tmp = *this;
+                return tmp += offset;
+            }
+
+            [[nodiscard]] friend iterator_impl operator+(const difference_type offset, iterator_impl it) noexcept
+            {
+                return it += offset;
+            }
+
+            [[nodiscard]] iterator_impl operator-(const difference_type offset) const noexcept
+            {
+                auto tmp = *this;
+                return tmp -= offset;
+            }
+
+            [[nodiscard]] difference_type operator-(const iterator_impl& right) const noexcept
+            {
+                return static_cast<difference_type>(_index - right._index);
+            }
+
+            [[nodiscard]] bool operator==(const iterator_impl& right) const noexcept
+            {
+                return _index == right._index;
+            }
+
+            [[nodiscard]] auto operator<=>(const iterator_impl& right) const noexcept
+            {
+                return _index <=> right._index;
+            }
+
+        private:
+            friend class ring;
+
+            ring_pointer _ring = nullptr;
+            // The logical index, relative to the front of the ring.
+            size_t _index = 0;
+        };
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+
+        // A large paste may grow the ring to millions of elements. Keeping such an allocation around
+        // for the rest of the ring's lifetime isn't worth it, while smaller ones are cheap to reuse.
+        static constexpr size_type shrink_threshold = 4096;
+
+        ring() = default;
+
+        ring(const ring& other) :
+            ring()
+        {
+            append_range(other);
+        }
+
+        ring& operator=(const ring& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                append_range(other);
+            }
+            return *this;
+        }
+
+        ring(ring&& other) noexcept :
+            _data{ std::move(other._data) },
+            _capacity{ std::exchange(other._capacity, 0) },
+            _head{ std::exchange(other._head, 0) },
+            _size{ std::exchange(other._size, 0) }
+        {
+        }
+
+        ring& operator=(ring&& other) noexcept
+        {
+            ring tmp{ std::move(other) };
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(ring& other) noexcept
+        {
+            std::swap(_data, other._data);
+            std::swap(_capacity, other._capacity);
+            std::swap(_head, other._head);
+            std::swap(_size, other._size);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        [[nodiscard]] size_type capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        [[nodiscard]] reference operator[](const size_type index) noexcept
+        {
+            return _data[(_head + index) & (_capacity - 1)];
+        }
+
+        [[nodiscard]] const_reference operator[](const size_type index) const noexcept
+        {
+            return _data[(_head + index) & (_capacity - 1)];
+        }
+
+        [[nodiscard]] reference front() noexcept
+        {
+            return operator[](0);
+        }
+
+        [[nodiscard]] const_reference front() const noexcept
+        {
+            return operator[](0);
+        }
+
+        [[nodiscard]] reference back() noexcept
+        {
+            return operator[](_size - 1);
+        }
+
+        [[nodiscard]] const_reference back() const noexcept
+        {
+            return operator[](_size - 1);
+        }
+
+        [[nodiscard]] iterator begin() noexcept
+        {
+            return { this, 0 };
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept
+        {
+            return { this, 0 };
+        }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        [[nodiscard]] iterator end() noexcept
+        {
+            return { this, _size };
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept
+        {
+            return { this, _size };
+        }
+
+        [[nodiscard]] const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Removes all elements. The allocation is retained for reuse, unless its capacity exceeds shrink_threshold.
+        void clear() noexcept
+        {
+            _head = 0;
+            _size = 0;
+            _shrink_if_empty();
+        }
+
+        void reserve(const size_type capacity)
+        {
+            if (capacity > _capacity)
+            {
+                _grow(capacity);
+            }
+        }
+
+        void push_back(const T& value)
+        {
+            if (_size == _capacity)
+            {
+                _grow(_size + 1);
+            }
+            operator[](_size) = value;
+            ++_size;
+        }
+
+        // Appends all elements in the given range, which must not be part of this ring.
+        template<typename Range>
+        void append_range(const Range& range)
+        {
+            const auto count = static_cast<size_type>(std::size(range));
+            reserve(_size + count);
+
+            auto it = std::begin(range);
+            for (size_type i = 0; i < count; ++i, ++it)
+            {
+                operator[](_size + i) = *it;
+            }
+            _size += count;
+        }
+
+        // Appends the elements of another ring with one append_range() call for each of its two contiguous halves.
+        // The other ring must not be this ring.
+        void append_range(const ring& other)
+        {
+            const auto first = std::min(other._size, other._capacity - other._head);
+            reserve(_size + other._size);
+            append_range(std::span<const T>{ other._data.get() + other._head, first });
+            append_range(std::span<const T>{ other._data.get(), other._size - first });
+        }
+
+        // Appends the given elements with (at most) 2 copies, one up to the end of the allocation and one after wrapping around.
+        void append_range(const std::span<const T>& values)
+        {
+            reserve(_size + values.size());
+
+            const auto mask = _capacity - 1;
+            const auto tail = (_head + _size) & mask;
+            const auto first = std::min(values.size(), _capacity - tail);
+            std::copy_n(values.data(), first, _data.get() + tail);
+            std::copy_n(values.data() + first, values.size() - first, _data.get());
+            _size += values.size();
+        }
+
+        void pop_front() noexcept
+        {
+            _head = (_head + 1) & (_capacity - 1);
+            --_size;
+            _shrink_if_empty();
+        }
+
+        // Removing elements from the front or back of the ring is O(1). Removing them
+        // from the middle requires the elements after the removed range to be moved.
+        iterator erase(const const_iterator first, const const_iterator last) noexcept
+        {
+            const auto beg = first._index;
+            const auto count = last._index - beg;
+
+            if (beg == 0)
+            {
+                _head = (_head + count) & (_capacity - 1);
+            }
+            else
+            {
+                for (auto i = beg; i + count < _size; ++i)
+                {
+                    operator[](i) = operator[](i + count);
+                }
+            }
+
+            _size -= count;
+            _shrink_if_empty();
+            return { this, beg };
+        }
+
+    private:
+        void _shrink_if_empty() noexcept
+        {
+            if (_size == 0 && _capacity > shrink_threshold)
+            {
+                _data.reset();
+                _capacity = 0;
+                _head = 0;
+            }
+        }
+
+        void _grow(const size_type minimumCapacity)
+        {
+            // Growing by at least 2x ensures that push_back() is amortized O(1).
+            const auto capacity = std::bit_ceil(std::max<size_type>({ minimumCapacity, _capacity * 2, 16 }));
+            auto data = std::make_unique_for_overwrite<T[]>(capacity);
+
+            // Unwrap the elements, so that the front ends up at index 0.
+            const auto first = std::min(_size, _capacity - _head);
+            std::copy_n(_data.get() + _head, first, data.get());
+            std::copy_n(_data.get(), _size - first, data.get() + first);
+
+            _data = std::move(data);
+            _capacity = capacity;
+            _head = 0;
+        }
+
+        std::unique_ptr<T[]> _data;
+        size_type _capacity = 0;
+        size_type _head = 0;
+        size_type _size = 0;
+    };
+}
+
+#pragma warning(pop)
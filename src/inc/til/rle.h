@@ -288,6 +288,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         return !(lhs == rhs);
     }
 
+    // A single edit for basic_rle::replace_sorted(): Replace the range [start, end) with value.
+    template<typename T, typename S>
+    struct rle_edit
+    {
+        S start{};
+        S end{};
+        T value{};
+    };
+
     template<typename T, typename S = std::size_t, typename Container = std::vector<rle_pair<T, S>>>
     class basic_rle
     {
@@ -305,6 +314,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
         using rle_type = rle_pair<value_type, size_type>;
+        using edit_type = rle_edit<value_type, size_type>;
         using container = Container;
 
         // We don't check anywhere whether a size_type value is negative.
@@ -493,6 +503,96 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             _replace_unchecked(start_index, end_index, replacements._runs);
         }
 
+        // Applies all edits in a single pass over the existing runs, coalescing adjacent runs with equal values.
+        // This is equivalent to calling replace() for each edit in order, but costs O(runs + edits) in total,
+        // instead of a search and a shift of the trailing runs per edit. Use it for many small edits per vector.
+        // The edits must be sorted by their start index and must not overlap.
+        // An end index larger than size() is set to size(). The vector is left unchanged if an exception is thrown.
+        void replace_sorted(const std::span<const edit_type> edits)
+        {
+            if (edits.empty())
+            {
+                return;
+            }
+
+            // ROW::WriteCells() mostly writes a single color, which replace() handles in place.
+            if (edits.size() == 1)
+            {
+                const auto& edit = edits.front();
+                const auto start = std::min(edit.start, _total_length);
+                const auto end = std::min(edit.end, _total_length);
+                if (start > end)
+                {
+                    throw std::out_of_range("edits must be sorted and must not overlap");
+                }
+                if (start != end)
+                {
+                    replace(start, end, edit.value);
+                }
+                return;
+            }
+
+            // The new runs are built on the stack and copied back afterwards, which avoids
+            // a heap allocation per call as long as they fit and _runs has enough capacity.
+            // Each edit adds at most 1 run and splits at most 1 existing run.
+            til::small_vector<rle_type, 64> runs;
+            runs.reserve(_runs.size() + 2 * edits.size());
+            auto it = _runs.begin();
+            // The position up to which runs have been built and the offset of that position within *it.
+            size_type pos = 0;
+            size_type offset = 0;
+
+            const auto append = [&](const value_type& value, const size_type length) {
+                if (!length)
+                {
+                    return;
+                }
+                if (!runs.empty() && runs.back().value == value)
+                {
+                    runs.back().length += length;
+                }
+                else
+                {
+                    runs.emplace_back(value, length);
+                }
+            };
+            const auto advance = [&](const size_type target, const bool copy) {
+                while (pos < target)
+                {
+                    const auto length = std::min<size_type>(it->length - offset, target - pos);
+                    if (copy)
+                    {
+                        append(it->value, length);
+                    }
+                    pos += length;
+                    offset += length;
+                    if (offset == it->length)
+                    {
+                        ++it;
+                        offset = 0;
+                    }
+                }
+            };
+
+            for (const auto& edit : edits)
+            {
+                const auto start = std::min(edit.start, _total_length);
+                const auto end = std::min(edit.end, _total_length);
+                if (start < pos || start > end)
+                {
+                    throw std::out_of_range("edits must be sorted and must not overlap");
+                }
+
+                advance(start, true);
+                append(edit.value, gsl::narrow_cast<size_type>(end - start));
+                advance(end, false);
+            }
+
+            advance(_total_length, true);
+            _runs.resize(runs.size());
+            std::copy(runs.begin(), runs.end(), _runs.begin());
+        }
+
         // Replaces every instance of old_value in this vector with new_value.
         void replace_values(const value_type& old_value, const value_type& new_value)
         {
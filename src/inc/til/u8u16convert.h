@@ -12,8 +12,11 @@ Abstract:
 Tests have been made in order to investigate whether or not own algorithms
 could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
-Based on the results the decision was made to keep using the platform
-functions MultiByteToWideChar and WideCharToMultiByte.
+Back then the decision was made to keep using the platform functions
+MultiByteToWideChar and WideCharToMultiByte. Since then, the conversion
+functions below have been replaced with vectorized ones (see details::),
+which convert runs of ASCII 32 bytes at a time and validate everything else
+the same way the platform functions do. U8U16Test compares both approaches.
 
 Author(s):
 - Steffen Illhardt (german-one), Leonard Hecker (lhecker) 2020-2021
@@ -23,6 +26,218 @@ Author(s):
 
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26429 26481 26490) // use not_null, pointer arithmetic, reinterpret_cast
+        // Routine Description:
+        // - Converts UTF-8 to UTF-16. Invalid sequences are replaced with U+FFFD, one per "maximal subpart"
+        //   as recommended by the Unicode standard (chapter 3.9), which is what MultiByteToWideChar does as well.
+        // Arguments:
+        // - in, len - UTF-8 string to be converted
+        // - out - destination buffer, which needs to have room for at least `len` UTF-16 code units
+        // Return Value:
+        // - the number of UTF-16 code units written to out
+        inline size_t utf8_to_utf16(const char* const in, const size_t len, wchar_t* const out) noexcept
+        {
+            auto src = reinterpret_cast<const uint8_t*>(in);
+            const auto end = src + len;
+            auto dst = out;
+
+            while (src != end)
+            {
+                // ASCII fast-path: Widen 32 bytes per iteration.
+#if defined(TIL_SSE_INTRINSICS)
+                for (const auto zero = _mm_setzero_si128(); end - src >= 32; src += 32, dst += 32)
+                {
+                    const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+                    if (_mm_movemask_epi8(_mm_or_si128(a, b)))
+                    {
+                        break;
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi8(a, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(a, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpacklo_epi8(b, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 24), _mm_unpackhi_epi8(b, zero));
+                }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+                for (; end - src >= 32; src += 32, dst += 32)
+                {
+                    const auto a = vld1q_u8(src);
+                    const auto b = vld1q_u8(src + 16);
+                    const auto high = vreinterpretq_u64_u8(vandq_u8(vorrq_u8(a, b), vdupq_n_u8(0x80)));
+                    if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1))
+                    {
+                        break;
+                    }
+                    const auto d = reinterpret_cast<uint16_t*>(dst);
+                    vst1q_u16(d + 0, vmovl_u8(vget_low_u8(a)));
+                    vst1q_u16(d + 8, vmovl_u8(vget_high_u8(a)));
+                    vst1q_u16(d + 16, vmovl_u8(vget_low_u8(b)));
+                    vst1q_u16(d + 24, vmovl_u8(vget_high_u8(b)));
+                }
+#endif
+
+                // The scalar path handles the next 32 bytes (or a few more to finish the last sequence),
+                // before we try the fast-path again. This is the only place that handles non-ASCII.
+                for (const auto scalarEnd = end - src > 32 ? src + 32 : end; src < scalarEnd;)
+                {
+                    const auto b0 = *src++;
+                    if (b0 < 0x80)
+                    {
+                        *dst++ = b0;
+                        continue;
+                    }
+
+                    // The valid range of the second byte depends on the lead byte, to
+                    // exclude overlong encodings, surrogates and codepoints past U+10FFFF.
+                    char32_t cp;
+                    size_t trail;
+                    uint8_t lo = 0x80;
+                    uint8_t hi = 0xBF;
+
+                    if (b0 >= 0xC2 && b0 <= 0xDF)
+                    {
+                        cp = b0 & 0x1F;
+                        trail = 1;
+                    }
+                    else if (b0 >= 0xE0 && b0 <= 0xEF)
+                    {
+                        cp = b0 & 0x0F;
+                        trail = 2;
+                        lo = b0 == 0xE0 ? 0xA0 : 0x80;
+                        hi = b0 == 0xED ? 0x9F : 0xBF;
+                    }
+                    else if (b0 >= 0xF0 && b0 <= 0xF4)
+                    {
+                        cp = b0 & 0x07;
+                        trail = 3;
+                        lo = b0 == 0xF0 ? 0x90 : 0x80;
+                        hi = b0 == 0xF4 ? 0x8F : 0xBF;
+                    }
+                    else
+                    {
+                        *dst++ = 0xFFFD;
+                        continue;
+                    }
+
+                    for (; trail && src != end && *src >= lo && *src <= hi; --trail)
+                    {
+                        cp = (cp << 6) | (*src++ & 0x3F);
+                        lo = 0x80;
+                        hi = 0xBF;
+                    }
+
+                    if (trail)
+                    {
+                        // The lead byte and all valid trail bytes so far are the maximal subpart.
+                        // The offending byte is processed again as the start of the next sequence.
+                        *dst++ = 0xFFFD;
+                    }
+                    else if (cp >= 0x10000)
+                    {
+                        cp -= 0x10000;
+                        *dst++ = static_cast<wchar_t>(0xD800 | (cp >> 10));
+                        *dst++ = static_cast<wchar_t>(0xDC00 | (cp & 0x3FF));
+                    }
+                    else
+                    {
+                        *dst++ = static_cast<wchar_t>(cp);
+                    }
+                }
+            }
+
+            return static_cast<size_t>(dst - out);
+        }
+
+        // Routine Description:
+        // - Converts UTF-16 to UTF-8. Unpaired surrogates are replaced with U+FFFD, just like WideCharToMultiByte does.
+        // Arguments:
+        // - in, len - UTF-16 string to be converted
+        // - out - destination buffer, which needs to have room for at least `len * 3` UTF-8 code units
+        // Return Value:
+        // - the number of UTF-8 code units written to out
+        inline size_t utf16_to_utf8(const wchar_t* const in, const size_t len, char* const out) noexcept
+        {
+            auto src = in;
+            const auto end = src + len;
+            auto dst = reinterpret_cast<uint8_t*>(out);
+
+            while (src != end)
+            {
+                // ASCII fast-path: Narrow 16 code units (32 bytes) per iteration.
+#if defined(TIL_SSE_INTRINSICS)
+                for (const auto mask = _mm_set1_epi16(static_cast<short>(0xff80)); end - src >= 16; src += 16, dst += 16)
+                {
+                    const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+                    const auto nonAscii = _mm_and_si128(_mm_or_si128(a, b), mask);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) != 0xffff)
+                    {
+                        break;
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(a, b));
+                }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+                for (; end - src >= 16; src += 16, dst += 16)
+                {
+                    const auto s = reinterpret_cast<const uint16_t*>(src);
+                    const auto a = vld1q_u16(s);
+                    const auto b = vld1q_u16(s + 8);
+                    const auto high = vreinterpretq_u64_u16(vandq_u16(vorrq_u16(a, b), vdupq_n_u16(0xff80)));
+                    if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1))
+                    {
+                        break;
+                    }
+                    vst1q_u8(dst, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+                }
+#endif
+
+                // The scalar path handles the next 16 code units (or 1 more to finish
+                // a surrogate pair), before we try the fast-path again.
+                for (const auto scalarEnd = end - src > 16 ? src + 16 : end; src < scalarEnd;)
+                {
+                    char32_t cp = *src++;
+
+                    if (cp < 0x80)
+                    {
+                        *dst++ = static_cast<uint8_t>(cp);
+                        continue;
+                    }
+
+                    if (cp < 0x800)
+                    {
+                        *dst++ = static_cast<uint8_t>(0xC0 | (cp >> 6));
+                        *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                        continue;
+                    }
+
+                    if (cp >= 0xD800 && cp <= 0xDFFF)
+                    {
+                        if (cp <= 0xDBFF && src != end && *src >= 0xDC00 && *src <= 0xDFFF)
+                        {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (*src++ - 0xDC00);
+                            *dst++ = static_cast<uint8_t>(0xF0 | (cp >> 18));
+                            *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3F));
+                            *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+                            *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                            continue;
+                        }
+                        cp = 0xFFFD;
+                    }
+
+                    *dst++ = static_cast<uint8_t>(0xE0 | (cp >> 12));
+                    *dst++ = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+                    *dst++ = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+                }
+            }
+
+            return static_cast<size_t>(dst - reinterpret_cast<uint8_t*>(out));
+        }
+#pragma warning(pop)
+    }
+
     // state structure for maintenance of UTF-8 partials
     struct u8state
     {
@@ -56,7 +271,6 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     // - S_OK          - the conversion succeeded
     // - E_OUTOFMEMORY - the function failed to allocate memory for the resulting string
     // - E_ABORT       - the resulting string length would exceed the upper boundary of an int and thus, the conversion was aborted before the conversion has been completed
-    // - E_UNEXPECTED  - the underlying conversion function failed
     // - HRESULT value converted from a caught exception
     template<class outT>
     [[nodiscard]] HRESULT u8u16(const std::string_view& in, outT& out) noexcept
@@ -69,11 +283,11 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             int lengthRequired{};
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
-            out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(CP_UTF8, 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            out.resize(in.length());
+            const auto lengthOut = details::utf8_to_utf16(in.data(), in.length(), out.data());
+            out.resize(lengthOut);
 
-            return lengthOut == 0 ? E_UNEXPECTED : S_OK;
+            return S_OK;
         }
         CATCH_RETURN();
     }
@@ -90,7 +304,6 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     // - S_OK          - the conversion succeeded
     // - E_OUTOFMEMORY - the function failed to allocate memory for the resulting string
     // - E_ABORT       - the resulting string length would exceed the upper boundary of an int and thus, the conversion was aborted before the conversion has been completed
-    // - E_UNEXPECTED  - the underlying conversion function failed
     // - HRESULT value converted from a caught exception
     template<class outT>
     [[nodiscard]] HRESULT u8u16(const std::string_view& in, outT& out, u8state& state) noexcept
@@ -120,10 +333,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     return S_OK;
                 }
 
-                len16 = MultiByteToWideChar(CP_UTF8, 0UL, &state.partials[0], gsl::narrow_cast<int>(state.have), out.data(), capa16);
-                RETURN_HR_IF(E_UNEXPECTED, !len16);
+                len16 = gsl::narrow_cast<int>(details::utf8_to_utf16(&state.partials[0], state.have, out.data()));
 
-                capa16 -= len16;
                 len8 -= copyable;
                 cursor8 += copyable;
                 // state.want is already zero at this point
@@ -158,10 +369,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             if (len8)
             {
-                const auto convLen{ MultiByteToWideChar(CP_UTF8, 0UL, cursor8, len8, out.data() + len16, capa16) };
-                RETURN_HR_IF(E_UNEXPECTED, !convLen);
-
-                len16 += convLen;
+                len16 += gsl::narrow_cast<int>(details::utf8_to_utf16(cursor8, gsl::narrow_cast<size_t>(len8), out.data() + len16));
             }
 
             out.resize(gsl::narrow_cast<size_t>(len16));
@@ -180,7 +388,6 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     // - S_OK          - the conversion succeeded
     // - E_OUTOFMEMORY - the function failed to allocate memory for the resulting string
     // - E_ABORT       - the resulting string length would exceed the upper boundary of an int and thus, the conversion was aborted before the conversion has been completed
-    // - E_UNEXPECTED  - the underlying conversion function failed
     // - HRESULT value converted from a caught exception
     template<class outT>
     [[nodiscard]] HRESULT u16u8(const std::wstring_view& in, outT& out) noexcept
@@ -196,11 +403,11 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Code Points >U+FFFF: 2 UTF-16 code units --> 4 UTF-8 code units.
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
-            out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(CP_UTF8, 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+            out.resize(gsl::narrow_cast<size_t>(lengthRequired));
+            const auto lengthOut = details::utf16_to_utf8(in.data(), in.length(), out.data());
+            out.resize(lengthOut);
 
-            return lengthOut == 0 ? E_UNEXPECTED : S_OK;
+            return S_OK;
         }
         CATCH_RETURN();
     }
@@ -217,7 +424,6 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     // - S_OK          - the conversion succeeded without any change of the represented code points
     // - E_OUTOFMEMORY - the function failed to allocate memory for the resulting string
     // - E_ABORT       - the resulting string length would exceed the upper boundary of an int and thus, the conversion was aborted before the conversion has been completed
-    // - E_UNEXPECTED  - the underlying conversion function failed
     // - HRESULT value converted from a caught exception
     template<class outT>
     [[nodiscard]] HRESULT u16u8(const std::wstring_view& in, outT& out, u16state& state) noexcept
@@ -238,11 +444,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             if (state.partials[0])
             {
                 state.partials[1] = *cursor16;
-                len8 = WideCharToMultiByte(CP_UTF8, 0UL, &state.partials[0], 2, out.data(), capa8, nullptr, nullptr);
-                RETURN_HR_IF(E_UNEXPECTED, !len8);
+                len8 = gsl::narrow_cast<int>(details::utf16_to_utf8(&state.partials[0], 2, out.data()));
 
                 state.reset();
-                capa8 -= len8;
                 --len16;
                 ++cursor16;
             }
@@ -259,10 +463,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             if (len16)
             {
-                const auto convLen{ WideCharToMultiByte(CP_UTF8, 0UL, cursor16, len16, out.data() + len8, capa8, nullptr, nullptr) };
-                RETURN_HR_IF(E_UNEXPECTED, !convLen);
-
-                len8 += convLen;
+                len8 += gsl::narrow_cast<int>(details::utf16_to_utf8(cursor16, gsl::narrow_cast<size_t>(len16), out.data() + len8));
             }
 
             out.resize(gsl::narrow_cast<size_t>(len8));
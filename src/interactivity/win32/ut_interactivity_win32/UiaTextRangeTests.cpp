@@ -335,6 +335,23 @@ class UiaTextRangeTests
         }
     };
 
+    // Makes every row alternate between 4 regular and 4 italic cells,
+    // so that attribute queries have to cross many attribute runs.
+    void _writeItalicRuns()
+    {
+        TextAttribute italicAttr;
+        italicAttr.SetItalic(true);
+        const auto width = _pTextBuffer->GetSize().Width();
+        for (auto y = 0; y < _pTextBuffer->TotalRowCount(); ++y)
+        {
+            auto& row = _pTextBuffer->GetMutableRowByOffset(y);
+            for (auto x = 4; x < width; x += 8)
+            {
+                row.ReplaceAttributes(x, std::min(x + 4, width), italicAttr);
+            }
+        }
+    }
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         auto& gci = Microsoft::Console::Interactivity::ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -1807,6 +1824,145 @@ class UiaTextRangeTests
         }
     }
 
+    TEST_METHOD(AttributeQueryRuns)
+    {
+        // FindAttribute and GetAttributeValue walk the attribute runs of each row instead of each cell.
+        // This test checks that they still honor the run boundaries.
+        _writeItalicRuns();
+
+        VARIANT italic{};
+        italic.vt = VT_BOOL;
+        italic.boolVal = true;
+
+        Microsoft::WRL::ComPtr<UiaTextRange> utr;
+        THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider, til::point{ 0, 1 }, til::point{ 10, 1 }));
+        {
+            Log::Comment(L"FindAttribute finds the italic run in the middle of the range in both directions");
+            Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_IsItalicAttributeId, italic, false, result.GetAddressOf()));
+            const auto resultUtr{ static_cast<UiaTextRange*>(result.Get()) };
+            VERIFY_ARE_EQUAL((til::point{ 4, 1 }), resultUtr->_start);
+            VERIFY_ARE_EQUAL((til::point{ 8, 1 }), resultUtr->_end);
+
+            Microsoft::WRL::ComPtr<ITextRangeProvider> resultBackwards;
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_IsItalicAttributeId, italic, true, resultBackwards.GetAddressOf()));
+            BOOL isEqual;
+            THROW_IF_FAILED(result->Compare(resultBackwards.Get(), &isEqual));
+            VERIFY_IS_TRUE(isEqual);
+        }
+
+        Microsoft::WRL::ComPtr<IUnknown> mixedVal;
+        THROW_IF_FAILED(UiaGetReservedMixedAttributeValue(&mixedVal));
+        {
+            Log::Comment(L"GetAttributeValue checks every cell of the range, up to and including the last one");
+            Microsoft::WRL::ComPtr<UiaTextRange> run;
+            THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&run, _pUiaData, &_dummyProvider, til::point{ 4, 1 }, til::point{ 8, 1 }));
+            VARIANT result;
+            VERIFY_SUCCEEDED(run->GetAttributeValue(UIA_IsItalicAttributeId, &result));
+            VERIFY_ARE_EQUAL(VT_BOOL, result.vt);
+            VERIFY_IS_TRUE(result.boolVal);
+
+            Microsoft::WRL::ComPtr<UiaTextRange> runAndOneMore;
+            THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&runAndOneMore, _pUiaData, &_dummyProvider, til::point{ 4, 1 }, til::point{ 9, 1 }));
+            VERIFY_SUCCEEDED(runAndOneMore->GetAttributeValue(UIA_IsItalicAttributeId, &result));
+            VERIFY_ARE_EQUAL(VT_UNKNOWN, result.vt);
+            VERIFY_ARE_EQUAL(mixedVal.Get(), result.punkVal);
+        }
+
+        THROW_IF_FAILED(utr->ExpandToEnclosingUnit(TextUnit_Document));
+        {
+            Log::Comment(L"GetAttributeValue reports mixed values for the document");
+            VARIANT result;
+            VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_IsItalicAttributeId, &result));
+            VERIFY_ARE_EQUAL(VT_UNKNOWN, result.vt);
+            VERIFY_ARE_EQUAL(mixedVal.Get(), result.punkVal);
+        }
+        {
+            Log::Comment(L"Attributes that no cell has are neither found nor mixed");
+            VARIANT crossedOut{};
+            crossedOut.vt = VT_I4;
+            crossedOut.lVal = TextDecorationLineStyle_Single;
+
+            Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_StrikethroughStyleAttributeId, crossedOut, false, result.GetAddressOf()));
+            VERIFY_IS_NULL(result.Get());
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_StrikethroughStyleAttributeId, crossedOut, true, result.GetAddressOf()));
+            VERIFY_IS_NULL(result.Get());
+
+            VARIANT value;
+            VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_StrikethroughStyleAttributeId, &value));
+            VERIFY_ARE_EQUAL(VT_I4, value.vt);
+            VERIFY_ARE_EQUAL(TextDecorationLineStyle_None, value.lVal);
+        }
+    }
+
+    TEST_METHOD(AttributeQueryThroughput)
+    {
+        auto iterations = 100;
+        RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+        _writeItalicRuns();
+
+        Microsoft::WRL::ComPtr<UiaTextRange> utr;
+        THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider));
+        THROW_IF_FAILED(utr->ExpandToEnclosingUnit(TextUnit_Document));
+
+        // Nothing is crossed out, so all queries have to look at the entire document.
+        VARIANT crossedOut{};
+        crossedOut.vt = VT_I4;
+        crossedOut.lVal = TextDecorationLineStyle_Single;
+
+        const auto bufferSize = _pTextBuffer->GetSize();
+        const auto inclusiveEnd = utr->_getInclusiveEnd();
+
+        const auto run = [&](const wchar_t* name, auto&& fn) {
+            const auto beg = std::chrono::high_resolution_clock::now();
+            for (auto i = 0; i < iterations; ++i)
+            {
+                fn();
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+
+            const auto us = std::chrono::duration<double, std::micro>(end - beg).count() / iterations;
+            Log::Comment(NoThrowString().Format(L"%-36s %10.1f us/call", name, us));
+        };
+
+        // The baselines are the cell-by-cell loops the two queries used before they walked attribute runs.
+        run(L"FindAttribute (cell by cell)", [&]() {
+            auto found = false;
+            for (auto iter = _pTextBuffer->GetCellDataAt(utr->_start, bufferSize); iter && !found; ++iter)
+            {
+                found = utr->_verifyAttr(UIA_StrikethroughStyleAttributeId, crossedOut, iter->TextAttr()).value();
+                if (iter.Pos() == inclusiveEnd)
+                {
+                    break;
+                }
+            }
+            VERIFY_IS_FALSE(found);
+        });
+        run(L"FindAttribute", [&]() {
+            Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+            VERIFY_SUCCEEDED(utr->FindAttribute(UIA_StrikethroughStyleAttributeId, crossedOut, false, result.GetAddressOf()));
+            VERIFY_IS_NULL(result.Get());
+        });
+        run(L"GetAttributeValue (cell by cell)", [&]() {
+            VARIANT value;
+            VariantInit(&value);
+            VERIFY_IS_TRUE(utr->_initializeAttrQuery(UIA_StrikethroughStyleAttributeId, &value, _pTextBuffer->GetCellDataAt(utr->_start)->TextAttr()));
+            auto mixed = false;
+            for (auto iter = _pTextBuffer->GetCellDataAt(utr->_start, bufferSize); iter && iter.Pos() != inclusiveEnd && !mixed; ++iter)
+            {
+                mixed = !utr->_verifyAttr(UIA_StrikethroughStyleAttributeId, value, iter->TextAttr()).value();
+            }
+            VERIFY_IS_FALSE(mixed);
+        });
+        run(L"GetAttributeValue", [&]() {
+            VARIANT value;
+            VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_StrikethroughStyleAttributeId, &value));
+            VERIFY_ARE_EQUAL(VT_I4, value.vt);
+        });
+    }
+
     TEST_METHOD(BlockRange)
     {
         // This test replicates GH#7960.
@@ -65,6 +65,7 @@ const RegistrySerialization::_RegPropertyMap RegistrySerialization::s_PropertyMa
 #if TIL_FEATURE_CONHOSTATLASENGINE_ENABLED
     { _RegPropertyType::Boolean,        L"EnableBuiltinGlyphs",                         SET_FIELD_AND_SIZE(_fEnableBuiltinGlyphs)        },
 #endif
+    { _RegPropertyType::Boolean,        L"PersistHistory",                              SET_FIELD_AND_SIZE(_fPersistHistory)             },
 
     // Special cases that are handled manually in Registry::LoadFromRegistry:
     // - CONSOLE_REGISTRY_WINDOWPOS
@@ -82,7 +83,9 @@ const RegistrySerialization::_RegPropertyMap RegistrySerialization::s_GlobalProp
 {
     //+---------------------------------+-----------------------------------------------+-----------------------------------------------+
     //| Property type                   | Property Name                                 | Corresponding Settings field                  |
-    { _RegPropertyType::Dword,          CONSOLE_REGISTRY_VIRTTERM_LEVEL,                SET_FIELD_AND_SIZE(_dwVirtTermLevel), }
+    { _RegPropertyType::Dword,          CONSOLE_REGISTRY_VIRTTERM_LEVEL,                SET_FIELD_AND_SIZE(_dwVirtTermLevel), },
+    { _RegPropertyType::Dword,          L"RowMemoryIdleLimit",                          SET_FIELD_AND_SIZE(_dwRowMemoryIdleLimit), },
+    { _RegPropertyType::Dword,          L"RowMemoryCommitLimit",                        SET_FIELD_AND_SIZE(_dwRowMemoryCommitLimit), },
 };
 const size_t RegistrySerialization::s_GlobalPropMappingsSize = ARRAYSIZE(s_GlobalPropMappings);
 
@@ -188,11 +188,45 @@ void Renderer::NotifyPaintFrame() noexcept
     // If we're running in the unittests, we might not have a render thread.
     if (_pThread)
     {
+        if (_paintNotificationsDeferred.load())
+        {
+            _paintNotificationPending.store(true);
+
+            // If ResumePaintNotifications() ran in between the two lines above,
+            // it might have missed our store, so we need to check again.
+            if (_paintNotificationsDeferred.load() || !_paintNotificationPending.exchange(false))
+            {
+                return;
+            }
+        }
+
         // The thread will provide throttling for us.
         _pThread->NotifyPaint();
     }
 }
 
+// Routine Description:
+// - Holds back calls to NotifyPaintFrame() until ResumePaintNotifications() is called.
+// - The IO thread uses this while it services an API message under the console lock.
+//   The render thread can't paint until the lock is released anyway, so waking it up
+//   for every single invalidation would only cost us a SetEvent() and a context switch each.
+void Renderer::DeferPaintNotifications() noexcept
+{
+    _paintNotificationsDeferred.store(true);
+}
+
+// Routine Description:
+// - Ends DeferPaintNotifications() and notifies the render thread if a frame was requested in the meantime.
+void Renderer::ResumePaintNotifications() noexcept
+{
+    _paintNotificationsDeferred.store(false);
+
+    if (_paintNotificationPending.exchange(false))
+    {
+        NotifyPaintFrame();
+    }
+}
+
 // Routine Description:
 // - Called when the system has requested we redraw a portion of the console.
 // Arguments:
@@ -47,6 +47,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT PaintFrame();
 
         void NotifyPaintFrame() noexcept;
+        void DeferPaintNotifications() noexcept;
+        void ResumePaintNotifications() noexcept;
         void TriggerSystemRedraw(const til::rect* const prcDirtyClient);
         void TriggerRedraw(const Microsoft::Console::Types::Viewport& region);
         void TriggerRedraw(const til::point* const pcoord);
@@ -134,6 +136,8 @@ namespace Microsoft::Console::Render
         std::function<void()> _pfnRendererEnteredErrorState;
         bool _destructing = false;
         bool _forceUpdateViewport = false;
+        std::atomic<bool> _paintNotificationsDeferred{ false };
+        std::atomic<bool> _paintNotificationPending{ false };
 
 #ifdef UNIT_TESTING
         friend class ConptyOutputTests;
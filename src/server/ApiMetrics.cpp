@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "ApiMetrics.h"
+
+#include <bit>
+
+bool ApiMetrics::IsEnabled() const noexcept
+{
+    return _enabled;
+}
+
+void ApiMetrics::SetEnabled(const bool enabled) noexcept
+{
+    _enabled = enabled;
+}
+
+// Routine Description:
+// - Records how long it took to service a single API message.
+// Arguments:
+// - apiNumber - The API number as found in CONSOLE_MSG_HEADER. Unknown APIs are ignored.
+// - latency - The time it took to service the message.
+void ApiMetrics::RecordApiCall(const ULONG apiNumber, const std::chrono::nanoseconds latency) noexcept
+{
+    size_t layer, api;
+    if (_decode(apiNumber, layer, api))
+    {
+        _record(til::at(til::at(_apiLatencies, layer), api), gsl::narrow_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(0, latency.count())));
+    }
+}
+
+// Routine Description:
+// - Returns the latency histogram for the given API number or nullptr if it's not a valid API number.
+const ApiMetrics::Histogram* ApiMetrics::ApiLatency(const ULONG apiNumber) const noexcept
+{
+    size_t layer, api;
+    if (!_decode(apiNumber, layer, api))
+    {
+        return nullptr;
+    }
+    return &til::at(til::at(_apiLatencies, layer), api);
+}
+
+void ApiMetrics::Reset() noexcept
+{
+    _apiLatencies = {};
+}
+
+// Routine Description:
+// - Returns the (exclusive) upper bound of the range of values counted by the given bucket.
+uint64_t ApiMetrics::BucketUpperBound(const size_t bucket) noexcept
+{
+    return uint64_t{ 1 } << bucket;
+}
+
+// Routine Description:
+// - Returns an estimate for the given percentile (0 to 1) of the histogram,
+//   which is the upper bound of the bucket that contains the percentile.
+// - Returns 0 if the histogram is empty.
+uint64_t ApiMetrics::Percentile(const Histogram& histogram, const double percentile) noexcept
+{
+    uint64_t total = 0;
+    for (const auto count : histogram)
+    {
+        total += count;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * total + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < histogram.size(); ++i)
+    {
+        seen += til::at(histogram, i);
+        if (seen >= target)
+        {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(histogram.size() - 1);
+}
+
+void ApiMetrics::_record(Histogram& histogram, const uint64_t value) noexcept
+{
+    const auto bucket = std::min<size_t>(std::bit_width(value), BucketCount - 1);
+    auto& count = til::at(histogram, bucket);
+    // Saturate instead of wrapping around in long-running sessions.
+    if (count != UINT32_MAX)
+    {
+        ++count;
+    }
+}
+
+// Decodes the API number the same way ApiSorter::ConsoleDispatchRequest does.
+bool ApiMetrics::_decode(const ULONG apiNumber, size_t& layer, size_t& api) noexcept
+{
+    layer = (apiNumber >> 24) - 1;
+    api = apiNumber & 0xffffff;
+    return layer < LayerCount && api < MaxApisPerLayer;
+}
@@ -0,0 +1,46 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ApiMetrics.h
+
+Abstract:
+- Histograms of how long each API takes to be serviced by the IO thread. Timing every call
+  isn't free, so they're only collected after SetEnabled(true) has been called, for instance
+  from a debugger. Inspect them with a debugger or via Globals::apiMetrics (see LoopbackDeviceCommTests).
+--*/
+
+#pragma once
+
+class ApiMetrics
+{
+public:
+    // Bucket 0 counts zeros and bucket i > 0 counts values in the range [2^(i-1), 2^i).
+    // The last bucket additionally counts all values that exceed its range.
+    static constexpr size_t BucketCount = 32;
+    // The number of API layers and APIs per layer (see ConsoleApiLayerTable) we can track.
+    static constexpr size_t LayerCount = 3;
+    static constexpr size_t MaxApisPerLayer = 64;
+
+    using Histogram = std::array<uint32_t, BucketCount>;
+
+    bool IsEnabled() const noexcept;
+    void SetEnabled(bool enabled) noexcept;
+
+    void RecordApiCall(ULONG apiNumber, std::chrono::nanoseconds latency) noexcept;
+
+    const Histogram* ApiLatency(ULONG apiNumber) const noexcept;
+    void Reset() noexcept;
+
+    static uint64_t BucketUpperBound(size_t bucket) noexcept;
+    static uint64_t Percentile(const Histogram& histogram, double percentile) noexcept;
+
+private:
+    static void _record(Histogram& histogram, uint64_t value) noexcept;
+    static bool _decode(ULONG apiNumber, size_t& layer, size_t& api) noexcept;
+
+    bool _enabled = false;
+    // Indexed by [layer][api], the same way ApiSorter indexes ConsoleApiLayerTable. Latencies are in ns.
+    std::array<std::array<Histogram, MaxApisPerLayer>, LayerCount> _apiLatencies{};
+};
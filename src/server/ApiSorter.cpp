@@ -7,7 +7,11 @@
 
 #include "ApiDispatchers.h"
 
+#include "../host/globals.h"
 #include "../host/tracing.hpp"
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using Microsoft::Console::Interactivity::ServiceLocator;
 
 #define CONSOLE_API_STRUCT(Routine, Struct, TraceName) \
     {                                                  \
@@ -132,6 +136,11 @@ const CONSOLE_API_LAYER_DESCRIPTOR ConsoleApiLayerTable[] = {
     { ConsoleApiLayer3, RTL_NUMBER_OF(ConsoleApiLayer3) },
 };
 
+static_assert(RTL_NUMBER_OF(ConsoleApiLayerTable) <= ApiMetrics::LayerCount);
+static_assert(RTL_NUMBER_OF(ConsoleApiLayer1) <= ApiMetrics::MaxApisPerLayer);
+static_assert(RTL_NUMBER_OF(ConsoleApiLayer2) <= ApiMetrics::MaxApisPerLayer);
+static_assert(RTL_NUMBER_OF(ConsoleApiLayer3) <= ApiMetrics::MaxApisPerLayer);
+
 // Routine Description:
 // - This routine validates a user IO and dispatches it to the appropriate worker routine.
 // Arguments:
@@ -173,6 +182,14 @@ PCONSOLE_API_MSG ApiSorter::ConsoleDispatchRequest(_Inout_ PCONSOLE_API_MSG Mess
     // such known code -- STATUS_BUFFER_TOO_SMALL. There's a conlibk dependency on this being returned from the console
     // alias API.
     NTSTATUS Status = S_OK;
+    if (auto& metrics = ServiceLocator::LocateGlobals().apiMetrics; metrics.IsEnabled()) [[unlikely]]
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Status = (*Descriptor->Routine)(Message, &ReplyPending);
+        const auto latency = std::chrono::steady_clock::now() - start;
+        metrics.RecordApiCall(Message->msgHeader.ApiNumber, latency);
+    }
+    else
     {
         Status = (*Descriptor->Routine)(Message, &ReplyPending);
     }
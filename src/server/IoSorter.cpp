@@ -15,6 +15,10 @@
 #include "../host/getset.h"
 #include "../host/stream.h"
 
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using Microsoft::Console::Interactivity::ServiceLocator;
+
 void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
                                   _Out_ CONSOLE_API_MSG** ReplyMsg)
 {
@@ -30,8 +34,23 @@ void IoSorter::ServiceIoOperation(_In_ CONSOLE_API_MSG* const pMsg,
     switch (pMsg->Descriptor.Function)
     {
     case CONSOLE_IO_USER_DEFINED:
+    {
+        // An API call may invalidate the screen many times over (for instance a WriteConsole
+        // that scrolls), but the render thread only needs to be woken up once at the end.
+        const auto renderer = ServiceLocator::LocateGlobals().pRender;
+        if (renderer)
+        {
+            renderer->DeferPaintNotifications();
+        }
+        const auto resume = wil::scope_exit([&]() noexcept {
+            if (renderer)
+            {
+                renderer->ResumePaintNotifications();
+            }
+        });
         *ReplyMsg = IoDispatchers::ConsoleDispatchRequest(pMsg);
         break;
+    }
 
     case CONSOLE_IO_CONNECT:
         *ReplyMsg = IoDispatchers::ConsoleHandleConnectionRequest(pMsg);
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "LoopbackDeviceComm.h"
+
+#include "ApiMessage.h"
+
+// The part of CONSOLE_API_MSG after the descriptor, which ConDrv fills with the start of the input buffer during ReadIo.
+static constexpr size_t packetOffset = offsetof(CONSOLE_API_MSG, Descriptor) + sizeof(CD_IO_DESCRIPTOR);
+static constexpr size_t packetSize = sizeof(CONSOLE_API_MSG) - packetOffset;
+
+// Routine Description:
+// - Builds a CONSOLE_IO_USER_DEFINED request the same way the client side in kernelbase does for API calls.
+// Arguments:
+// - apiNumber - The API to call (one of the ConsolepXXX values in conmsgl1.h, conmsgl2.h and conmsgl3.h).
+// - process - The process handle as returned by PutHandle().
+// - object - The object handle as returned by CONSOLE_IO_CREATE_OBJECT, or 0 if the API doesn't need one.
+// - apiMsg - The API message (e.g. CONSOLE_WRITECONSOLE_MSG).
+// - apiMsgSize - The size of the API message in bytes.
+// - inputPayload - Any additional input data, like the text for WriteConsole.
+// - outputPayloadSize - The amount of additional output data the API may return, like the CHAR_INFOs for ReadConsoleOutput.
+// Return Value:
+// - The request, ready to be passed to Submit().
+LoopbackDeviceComm::Request LoopbackDeviceComm::MakeApiRequest(const ULONG apiNumber,
+                                                               const ULONG_PTR process,
+                                                               const ULONG_PTR object,
+                                                               _In_reads_bytes_(apiMsgSize) const void* const apiMsg,
+                                                               const ULONG apiMsgSize,
+                                                               const std::span<const BYTE> inputPayload,
+                                                               const ULONG outputPayloadSize)
+{
+    const CONSOLE_MSG_HEADER header{ apiNumber, apiMsgSize };
+    const auto apiMsgBytes = static_cast<const BYTE*>(apiMsg);
+
+    Request request;
+    request.Descriptor.Process = process;
+    request.Descriptor.Object = object;
+    request.Descriptor.Function = CONSOLE_IO_USER_DEFINED;
+
+    request.Input.reserve(sizeof(header) + apiMsgSize + inputPayload.size());
+    request.Input.insert(request.Input.end(), reinterpret_cast<const BYTE*>(&header), reinterpret_cast<const BYTE*>(&header + 1));
+    request.Input.insert(request.Input.end(), apiMsgBytes, apiMsgBytes + apiMsgSize);
+    request.Input.insert(request.Input.end(), inputPayload.begin(), inputPayload.end());
+
+    request.Output.resize(apiMsgSize + outputPayloadSize);
+
+    request.Descriptor.InputSize = gsl::narrow<ULONG>(request.Input.size());
+    request.Descriptor.OutputSize = gsl::narrow<ULONG>(request.Output.size());
+    return request;
+}
+
+// Routine Description:
+// - Queues a request for the server to retrieve with ReadIo().
+// - The request must stay alive and in place until it has been completed.
+// Arguments:
+// - request - The request to queue. Its identifier and completion status will be reset.
+void LoopbackDeviceComm::Submit(Request& request)
+{
+    request.Descriptor.Identifier = { ++_nextIdentifier, 0 };
+    request.IoStatus = {};
+    request.Completed = false;
+    _pending.emplace_back(&request);
+}
+
+// Routine Description:
+// - Returns the number of requests that haven't been retrieved by ReadIo() yet.
+size_t LoopbackDeviceComm::PendingCount() const noexcept
+{
+    return _pending.size();
+}
+
+// Routine Description:
+// - There's no driver to inform about the input event, so this does nothing.
+[[nodiscard]] HRESULT LoopbackDeviceComm::SetServerInformation(_In_ CD_IO_SERVER_INFORMATION* const /*pServerInfo*/) const
+{
+    return S_OK;
+}
+
+// Routine Description:
+// - Completes the previous request (if any) and retrieves the next queued one, just like IOCTL_CONDRV_READ_IO.
+// - Unlike ConDrv this doesn't block if no request is queued and instead returns an error,
+//   which allows a harness to run the usual ConsoleIoThread loop until all requests have been serviced.
+// Arguments:
+// - pReplyMsg - Optional completion from the previous request.
+// - pMessage - Receives the next request.
+// Return Value:
+// - HRESULT S_OK, or HRESULT_FROM_WIN32(ERROR_NO_MORE_ITEMS) if no requests are queued.
+[[nodiscard]] HRESULT LoopbackDeviceComm::ReadIo(_In_opt_ PCONSOLE_API_MSG const pReplyMsg,
+                                                 _Out_ CONSOLE_API_MSG* const pMessage) const
+{
+    if (pReplyMsg)
+    {
+        RETURN_IF_FAILED(CompleteIo(&pReplyMsg->Complete));
+    }
+
+    if (_pending.empty())
+    {
+        return HRESULT_FROM_WIN32(ERROR_NO_MORE_ITEMS);
+    }
+
+    const auto request = _pending.front();
+    _pending.pop_front();
+    _inflight.emplace_back(request);
+
+    // ConDrv writes the descriptor followed by as much of the input buffer as fits into the message.
+    // The rest of the input is retrieved on demand via ReadInput().
+    const auto packet = reinterpret_cast<BYTE*>(pMessage) + packetOffset;
+    const auto copied = std::min(packetSize, request->Input.size());
+    pMessage->Descriptor = request->Descriptor;
+    memcpy(packet, request->Input.data(), copied);
+    memset(packet + copied, 0, packetSize - copied);
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Marks a request as completed and writes the API message (if any) back into the request's output buffer.
+// Arguments:
+// - pCompletion - The completion for an inflight request.
+// Return Value:
+// - HRESULT S_OK or E_INVALIDARG if the request is unknown or the write exceeds its output buffer.
+[[nodiscard]] HRESULT LoopbackDeviceComm::CompleteIo(_In_ CD_IO_COMPLETE* const pCompletion) const
+{
+    const auto request = _FindInflight(pCompletion->Identifier);
+    RETURN_HR_IF_NULL(E_INVALIDARG, request);
+
+    if (pCompletion->Write.Data)
+    {
+        const auto end = size_t{ pCompletion->Write.Offset } + pCompletion->Write.Size;
+        RETURN_HR_IF(E_INVALIDARG, end > request->Output.size());
+        memcpy(request->Output.data() + pCompletion->Write.Offset, pCompletion->Write.Data, pCompletion->Write.Size);
+    }
+
+    request->IoStatus = pCompletion->IoStatus;
+    request->Completed = true;
+    std::erase(_inflight, request);
+    return S_OK;
+}
+
+// Routine Description:
+// - Copies a part of an inflight request's input buffer, just like IOCTL_CONDRV_READ_INPUT.
+[[nodiscard]] HRESULT LoopbackDeviceComm::ReadInput(_In_ CD_IO_OPERATION* const pIoOperation) const
+{
+    const auto request = _FindInflight(pIoOperation->Identifier);
+    RETURN_HR_IF_NULL(E_INVALIDARG, request);
+
+    const auto end = size_t{ pIoOperation->Buffer.Offset } + pIoOperation->Buffer.Size;
+    RETURN_HR_IF(E_INVALIDARG, end > request->Input.size());
+    memcpy(pIoOperation->Buffer.Data, request->Input.data() + pIoOperation->Buffer.Offset, pIoOperation->Buffer.Size);
+    return S_OK;
+}
+
+// Routine Description:
+// - Copies data into a part of an inflight request's output buffer, just like IOCTL_CONDRV_WRITE_OUTPUT.
+[[nodiscard]] HRESULT LoopbackDeviceComm::WriteOutput(_In_ CD_IO_OPERATION* const pIoOperation) const
+{
+    const auto request = _FindInflight(pIoOperation->Identifier);
+    RETURN_HR_IF_NULL(E_INVALIDARG, request);
+
+    const auto end = size_t{ pIoOperation->Buffer.Offset } + pIoOperation->Buffer.Size;
+    RETURN_HR_IF(E_INVALIDARG, end > request->Output.size());
+    memcpy(request->Output.data() + pIoOperation->Buffer.Offset, pIoOperation->Buffer.Data, pIoOperation->Buffer.Size);
+    return S_OK;
+}
+
+// Routine Description:
+// - There's no driver to grant UIAccess through, so this does nothing.
+[[nodiscard]] HRESULT LoopbackDeviceComm::AllowUIAccess() const
+{
+    return S_OK;
+}
+
+// Routine Description:
+// - Implements IDeviceComm handle exchange the same way as ConDrvDeviceComm,
+//   by passing the pointer value through as the handle value.
+[[nodiscard]] ULONG_PTR LoopbackDeviceComm::PutHandle(const void* handle)
+{
+    return reinterpret_cast<ULONG_PTR>(handle);
+}
+
+// Routine Description:
+// - The opposite of PutHandle.
+[[nodiscard]] void* LoopbackDeviceComm::GetHandle(ULONG_PTR handleId) const
+{
+    return reinterpret_cast<void*>(handleId);
+}
+
+// Routine Description:
+// - There's no server handle that could be handed off to another console host.
+[[nodiscard]] HRESULT LoopbackDeviceComm::GetServerHandle(_Out_ HANDLE* pHandle) const
+{
+    *pHandle = nullptr;
+    return E_NOTIMPL;
+}
+
+LoopbackDeviceComm::Request* LoopbackDeviceComm::_FindInflight(const LUID& identifier) const noexcept
+{
+    for (const auto request : _inflight)
+    {
+        if (request->Descriptor.Identifier.LowPart == identifier.LowPart && request->Descriptor.Identifier.HighPart == identifier.HighPart)
+        {
+            return request;
+        }
+    }
+    return nullptr;
+}
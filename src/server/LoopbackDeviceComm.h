@@ -0,0 +1,73 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- LoopbackDeviceComm.h
+
+Abstract:
+- An in-process IDeviceComm implementation that serves requests synthesized by the caller instead of a ConDrv server handle.
+- This allows the API server (IoSorter, ApiSorter, ApiDispatchers and everything below them) to be driven at full speed
+  without a real client process, the driver, or any kernel transitions, which makes it suitable for benchmarks and profiling.
+--*/
+
+#pragma once
+
+#include "DeviceComm.h"
+
+#include <deque>
+
+class LoopbackDeviceComm : public IDeviceComm
+{
+public:
+    // A request as a client would have sent it to ConDrv, along with the client's buffers.
+    struct Request
+    {
+        CD_IO_DESCRIPTOR Descriptor{};
+        // The client's input buffer. For API messages (CONSOLE_IO_USER_DEFINED) this is
+        // the CONSOLE_MSG_HEADER, followed by the API message, followed by the payload.
+        std::vector<BYTE> Input;
+        // The client's output buffer. For API messages this is the API message followed by the payload.
+        std::vector<BYTE> Output;
+        // Set once the server completed the request.
+        IO_STATUS_BLOCK IoStatus{};
+        bool Completed = false;
+    };
+
+    static Request MakeApiRequest(const ULONG apiNumber,
+                                  const ULONG_PTR process,
+                                  const ULONG_PTR object,
+                                  _In_reads_bytes_(apiMsgSize) const void* const apiMsg,
+                                  const ULONG apiMsgSize,
+                                  const std::span<const BYTE> inputPayload,
+                                  const ULONG outputPayloadSize);
+
+    void Submit(Request& request);
+    size_t PendingCount() const noexcept;
+
+    [[nodiscard]] HRESULT SetServerInformation(_In_ CD_IO_SERVER_INFORMATION* const pServerInfo) const override;
+    [[nodiscard]] HRESULT ReadIo(_In_opt_ PCONSOLE_API_MSG const pReplyMsg,
+                                 _Out_ CONSOLE_API_MSG* const pMessage) const override;
+    [[nodiscard]] HRESULT CompleteIo(_In_ CD_IO_COMPLETE* const pCompletion) const override;
+
+    [[nodiscard]] HRESULT ReadInput(_In_ CD_IO_OPERATION* const pIoOperation) const override;
+    [[nodiscard]] HRESULT WriteOutput(_In_ CD_IO_OPERATION* const pIoOperation) const override;
+
+    [[nodiscard]] HRESULT AllowUIAccess() const override;
+
+    [[nodiscard]] ULONG_PTR PutHandle(const void*) override;
+    [[nodiscard]] void* GetHandle(ULONG_PTR) const override;
+
+    [[nodiscard]] HRESULT GetServerHandle(_Out_ HANDLE* pHandle) const override;
+
+private:
+    Request* _FindInflight(const LUID& identifier) const noexcept;
+
+    // The IDeviceComm interface is const, because ConDrvDeviceComm is stateless.
+    // We need to track our requests though, which is what these are for.
+    mutable std::deque<Request*> _pending;
+    // Requests that were handed out by ReadIo() but haven't been completed yet. This is usually just 1 or 2
+    // requests (or a few more if the server has pending waits), so a linear search is the fastest lookup.
+    mutable std::vector<Request*> _inflight;
+    DWORD _nextIdentifier = 0;
+};
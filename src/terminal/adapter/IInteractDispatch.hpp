@@ -43,6 +43,6 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool IsVtInputEnabled() const = 0;
 
-        virtual bool FocusChanged(const bool focused) const = 0;
+        virtual bool FocusChanged(const bool focused) = 0;
     };
 }
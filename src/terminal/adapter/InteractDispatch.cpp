@@ -29,7 +29,7 @@ InteractDispatch::InteractDispatch() :
 
 // Method Description:
 // - Writes a collection of input to the host. The new input is appended to the
-//      end of the input buffer.
+//      end of the input buffer once FlushInput() is called.
 //  If Ctrl+C is written with this function, it will not trigger a Ctrl-C
 //      interrupt in the client, but instead write a Ctrl+C to the input buffer
 //      to be read by the client.
@@ -39,8 +39,17 @@ InteractDispatch::InteractDispatch() :
 // - True.
 bool InteractDispatch::WriteInput(const std::span<const INPUT_RECORD>& inputEvents)
 {
-    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-    gci.GetActiveInputBuffer()->Write(inputEvents);
+    // The input buffer only coalesces events (e.g. consecutive mouse moves)
+    // if they're written one at a time. Writing those directly retains that.
+    if (inputEvents.size() == 1)
+    {
+        _FlushPendingInput();
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        gci.GetActiveInputBuffer()->Write(inputEvents);
+        return true;
+    }
+
+    _pendingInput.insert(_pendingInput.end(), inputEvents.begin(), inputEvents.end());
     return true;
 }
 
@@ -53,6 +62,8 @@ bool InteractDispatch::WriteInput(const std::span<const INPUT_RECORD>& inputEven
 // - event: The key to send to the host.
 bool InteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
 {
+    // The input that preceded the key must reach the input buffer before the key does.
+    _FlushPendingInput();
     HandleGenericKeyEvent(event, false);
     return true;
 }
@@ -68,18 +79,76 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
     if (!string.empty())
     {
         const auto codepage = _api.GetConsoleOutputCP();
-        InputEventQueue keyEvents;
+
+        // Most characters turn into a key down and up event.
+        _pendingInput.reserve(_pendingInput.size() + string.size() * 2);
 
         for (const auto& wch : string)
         {
-            CharToKeyEvents(wch, codepage, keyEvents);
-        }
+            // Plain text (and pasted text in particular) consists mostly of ASCII. The key events for
+            // those characters are cached, which turns the VkKeyScanW() and MapVirtualKeyW() calls
+            // that CharToKeyEvents() makes for each character into a simple copy.
+            if (wch < _asciiKeyEvents.size())
+            {
+                auto& cached = til::at(_asciiKeyEvents, wch);
+                if (cached.size)
+                {
+                    _pendingInput.insert(_pendingInput.end(), cached.events.begin(), cached.events.begin() + cached.size);
+                    continue;
+                }
+
+                const auto offset = _pendingInput.size();
+                CharToKeyEvents(wch, codepage, _pendingInput);
+
+                // Characters that aren't on the keyboard layout are typed via Alt+Numpad,
+                // which takes more events than we cache. Those are rare enough to not matter.
+                const auto size = _pendingInput.size() - offset;
+                if (size <= cached.events.size())
+                {
+                    std::copy_n(_pendingInput.begin() + offset, size, cached.events.begin());
+                    cached.size = gsl::narrow_cast<uint8_t>(size);
+                }
+                continue;
+            }
 
-        WriteInput(keyEvents);
+            CharToKeyEvents(wch, codepage, _pendingInput);
+        }
     }
     return true;
 }
 
+// Method Description:
+// - Writes all input that was queued up by WriteInput() and WriteString()
+//   to the input buffer. Doing so in a single Write() call, instead of one
+//   call per key, means that a paste only wakes up waiting readers once.
+//   VtInputThread calls this once it's done processing a chunk of input.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InteractDispatch::FlushInput()
+{
+    _FlushPendingInput();
+
+    // The keyboard layout or codepage may have changed before the next chunk of input arrives.
+    for (auto& cached : _asciiKeyEvents)
+    {
+        cached.size = 0;
+    }
+}
+
+void InteractDispatch::_FlushPendingInput()
+{
+    if (!_pendingInput.empty())
+    {
+        // clear() retains the capacity, so that subsequent reads don't need to allocate.
+        // If the write fails, the input is dropped instead of being written again with the next batch.
+        const auto clear = wil::scope_exit([&]() noexcept { _pendingInput.clear(); });
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        gci.GetActiveInputBuffer()->Write(_pendingInput);
+    }
+}
+
 //Method Description:
 // Window Manipulation - Performs a variety of actions relating to the window,
 //      such as moving the window position, resizing the window, querying
@@ -170,8 +239,11 @@ bool InteractDispatch::IsVtInputEnabled() const
 // - focused: if the terminal is now focused
 // Return Value:
 // - true always.
-bool InteractDispatch::FocusChanged(const bool focused) const
+bool InteractDispatch::FocusChanged(const bool focused)
 {
+    // The focus event must be ordered after any input that preceded it.
+    _FlushPendingInput();
+
     auto& g = ServiceLocator::LocateGlobals();
     auto& gci = g.getConsoleInformation();
 
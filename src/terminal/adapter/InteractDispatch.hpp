@@ -35,9 +35,25 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool IsVtInputEnabled() const override;
 
-        bool FocusChanged(const bool focused) const override;
+        bool FocusChanged(const bool focused) override;
+
+        void FlushInput();
 
     private:
+        // The key events for a single ASCII character. Most characters take 2 events
+        // (key down and up), but Shift and AltGr add another down/up pair around them.
+        struct AsciiKeyEvents
+        {
+            std::array<INPUT_RECORD, 4> events;
+            uint8_t size;
+        };
+
+        void _FlushPendingInput();
+
         ConhostInternalGetSet _api;
+        // Input that has been parsed but not yet written to the input buffer. See FlushInput().
+        InputEventQueue _pendingInput;
+        // Key events for the ASCII characters we've encountered since the last FlushInput(). A size of 0 means "not cached".
+        std::array<AsciiKeyEvents, 128> _asciiKeyEvents{};
     };
 }
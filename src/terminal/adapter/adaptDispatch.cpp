@@ -523,6 +523,7 @@ bool AdaptDispatch::CursorSaveState()
     savedCursorState.IsDelayedEOLWrap = textBuffer.GetCursor().IsDelayedEOLWrap();
     savedCursorState.IsOriginModeRelative = _modes.test(Mode::Origin);
     savedCursorState.Attributes = attributes;
+    savedCursorState.HyperlinkUri = textBuffer.GetHyperlinkUriFromId(attributes.GetHyperlinkId());
     savedCursorState.TermOutput = _termOutput;
 
     return true;
@@ -553,7 +554,12 @@ bool AdaptDispatch::CursorRestoreState()
     }
 
     // Restore text attributes.
-    _api.SetTextAttributes(savedCursorState.Attributes);
+    auto attributes = savedCursorState.Attributes;
+    if (attributes.IsHyperlink())
+    {
+        _RevalidateHyperlink(attributes, savedCursorState.HyperlinkUri);
+    }
+    _api.SetTextAttributes(attributes);
 
     // Restore designated character sets.
     _termOutput.RestoreFrom(savedCursorState.TermOutput);
@@ -561,6 +567,27 @@ bool AdaptDispatch::CursorRestoreState()
     return true;
 }
 
+// Routine Description:
+// - DECSC and XTPUSHSGR save the attributes without holding a reference to their hyperlink.
+//   If the hyperlink got pruned since, its ID may have been handed out to a different URI in
+//   the meantime. In that case the saved URI needs a new ID. (It won't share the ID with the
+//   rest of the hyperlink anymore, even if it had a custom ID.)
+// Arguments:
+// - attributes - The restored attributes, whose hyperlink ID gets updated if needed.
+// - uri - The URI of the hyperlink at the time the attributes were saved.
+// Return Value:
+// - <none>
+void AdaptDispatch::_RevalidateHyperlink(TextAttribute& attributes, const std::wstring_view uri)
+{
+    auto& textBuffer = _api.GetTextBuffer();
+    if (textBuffer.GetHyperlinkUriFromId(attributes.GetHyperlinkId()) != uri)
+    {
+        const auto id = textBuffer.GetHyperlinkId(uri, {});
+        attributes.SetHyperlinkId(id);
+        textBuffer.AddHyperlinkToMap(uri, id);
+    }
+}
+
 // Routine Description:
 // - Returns the attributes that should be used when erasing the buffer. When
 //   the Erase Color mode is set, we use the default attributes, but when reset,
@@ -986,9 +1013,7 @@ void AdaptDispatch::_ChangeRectAttributes(TextBuffer& textBuffer, const til::rec
         for (auto row = changeRect.top; row < changeRect.bottom; row++)
         {
             auto& rowBuffer = textBuffer.GetMutableRowByOffset(row);
-            for (auto col = changeRect.left; col < changeRect.right; col++)
-            {
-                auto attr = rowBuffer.GetAttrByColumn(col);
+            rowBuffer.TransformAttributes(changeRect.left, changeRect.right, [&](TextAttribute attr) {
                 auto characterAttributes = attr.GetCharacterAttributes();
                 characterAttributes &= changeOps.andAttrMask;
                 characterAttributes ^= changeOps.xorAttrMask;
@@ -1005,8 +1030,8 @@ void AdaptDispatch::_ChangeRectAttributes(TextBuffer& textBuffer, const til::rec
                 {
                     attr.SetUnderlineColor(*changeOps.underlineColor);
                 }
-                rowBuffer.ReplaceAttributes(col, col + 1, attr);
-            }
+                return attr;
+            });
         }
         textBuffer.TriggerRedraw(Viewport::FromExclusive(changeRect));
         _api.NotifyAccessibilityChange(changeRect);
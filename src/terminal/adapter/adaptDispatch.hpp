@@ -192,6 +192,9 @@ namespace Microsoft::Console::VirtualTerminal
             bool IsDelayedEOLWrap = false;
             bool IsOriginModeRelative = false;
             TextAttribute Attributes = {};
+            // The URI of the hyperlink in Attributes. The saved state doesn't hold a reference
+            // to the hyperlink, so by the time it's restored the ID may have been pruned.
+            std::wstring HyperlinkUri = {};
             TerminalOutput TermOutput = {};
         };
         struct Offset
@@ -218,6 +221,7 @@ namespace Microsoft::Console::VirtualTerminal
         std::pair<int, int> _GetHorizontalMargins(const til::CoordType bufferWidth) noexcept;
         bool _CursorMovePosition(const Offset rowOffset, const Offset colOffset, const bool clampInMargins);
         void _ApplyCursorMovementFlags(Cursor& cursor) noexcept;
+        void _RevalidateHyperlink(TextAttribute& attributes, const std::wstring_view uri);
         void _FillRect(TextBuffer& textBuffer, const til::rect& fillRect, const std::wstring_view& fillChar, const TextAttribute& fillAttrs) const;
         void _SelectiveEraseRect(TextBuffer& textBuffer, const til::rect& eraseRect);
         void _ChangeRectAttributes(TextBuffer& textBuffer, const til::rect& changeRect, const ChangeOps& changeOps);
@@ -299,6 +303,24 @@ namespace Microsoft::Console::VirtualTerminal
 
         SgrStack _sgrStack;
 
+        // Colored output repeats the same handful of SGR sequences over and
+        // over again, so we remember the most recent attribute transitions.
+        // Since an SGR result only depends on the prior attributes and the
+        // parameters, cached entries never become stale.
+        static constexpr size_t SgrCacheSize = 8;
+        static constexpr size_t SgrCacheMaxParameters = 8;
+        struct SgrCacheEntry
+        {
+            TextAttribute before;
+            TextAttribute after;
+            std::array<VTInt, SgrCacheMaxParameters> parameters{};
+            size_t parameterCount = 0;
+        };
+        std::array<SgrCacheEntry, SgrCacheSize> _sgrCache;
+        size_t _sgrCacheNext = 0;
+
+        bool _LookupGraphicsRendition(const VTParameters options, TextAttribute& attr) const noexcept;
+        void _CacheGraphicsRendition(const VTParameters options, const TextAttribute& before, const TextAttribute& after) noexcept;
         void _SetUnderlineStyleHelper(const VTParameter option, TextAttribute& attr) noexcept;
         size_t _SetRgbColorsHelper(const VTParameters options,
                                    TextAttribute& attr,
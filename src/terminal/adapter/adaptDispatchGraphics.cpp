@@ -410,6 +410,76 @@ void AdaptDispatch::_ApplyGraphicsOptions(const VTParameters options,
     }
 }
 
+// Routine Description:
+// - Looks up the result of applying the given options to the given attribute
+//   in the SGR transition cache. Options with sub parameters aren't cached.
+// Arguments:
+// - options - An array of options that are about to be applied.
+// - attr - The current attribute. Will be updated with the cached result.
+// Return Value:
+// - True if a cached transition was found and applied.
+bool AdaptDispatch::_LookupGraphicsRendition(const VTParameters options, TextAttribute& attr) const noexcept
+{
+    const auto count = options.size();
+    if (count > SgrCacheMaxParameters || options.hasSubParams())
+    {
+        return false;
+    }
+
+    for (const auto& entry : _sgrCache)
+    {
+        if (entry.parameterCount != count || entry.before != attr)
+        {
+            continue;
+        }
+
+        auto matches = true;
+        for (size_t i = 0; i < count && matches; ++i)
+        {
+            matches = til::at(entry.parameters, i) == options.at(i).value();
+        }
+
+        if (matches)
+        {
+            attr = entry.after;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Routine Description:
+// - Stores the result of applying the given options in the SGR transition
+//   cache, replacing the oldest entry.
+// Arguments:
+// - options - An array of options that were applied.
+// - before - The attribute before the options were applied.
+// - after - The attribute after the options were applied.
+// Return Value:
+// - <none>
+void AdaptDispatch::_CacheGraphicsRendition(const VTParameters options, const TextAttribute& before, const TextAttribute& after) noexcept
+{
+    const auto count = options.size();
+    if (count > SgrCacheMaxParameters || options.hasSubParams())
+    {
+        return;
+    }
+
+    auto& entry = til::at(_sgrCache, _sgrCacheNext);
+    _sgrCacheNext = (_sgrCacheNext + 1) % SgrCacheSize;
+
+    entry.before = before;
+    entry.after = after;
+    entry.parameterCount = count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // We store the raw values, so that omitted parameters (-1) are kept
+        // distinct from explicit zeros, exactly like _ApplyGraphicsOptions sees them.
+        til::at(entry.parameters, i) = options.at(i).value();
+    }
+}
+
 // Routine Description:
 // - SGR - Modifies the graphical rendering options applied to the next
 //   characters written into the buffer.
@@ -422,8 +492,13 @@ void AdaptDispatch::_ApplyGraphicsOptions(const VTParameters options,
 // - True.
 bool AdaptDispatch::SetGraphicsRendition(const VTParameters options)
 {
-    auto attr = _api.GetTextBuffer().GetCurrentAttributes();
-    _ApplyGraphicsOptions(options, attr);
+    const auto& current = _api.GetTextBuffer().GetCurrentAttributes();
+    auto attr = current;
+    if (!_LookupGraphicsRendition(options, attr))
+    {
+        _ApplyGraphicsOptions(options, attr);
+        _CacheGraphicsRendition(options, current, attr);
+    }
     _api.SetTextAttributes(attr);
     return true;
 }
@@ -470,8 +545,9 @@ bool AdaptDispatch::SetCharacterProtectionAttribute(const VTParameters options)
 // - True.
 bool AdaptDispatch::PushGraphicsRendition(const VTParameters options)
 {
-    const auto& currentAttributes = _api.GetTextBuffer().GetCurrentAttributes();
-    _sgrStack.Push(currentAttributes, options);
+    const auto& textBuffer = _api.GetTextBuffer();
+    const auto& currentAttributes = textBuffer.GetCurrentAttributes();
+    _sgrStack.Push(currentAttributes, textBuffer.GetHyperlinkUriFromId(currentAttributes.GetHyperlinkId()), options);
     return true;
 }
 
@@ -485,6 +561,12 @@ bool AdaptDispatch::PushGraphicsRendition(const VTParameters options)
 bool AdaptDispatch::PopGraphicsRendition()
 {
     const auto& currentAttributes = _api.GetTextBuffer().GetCurrentAttributes();
-    _api.SetTextAttributes(_sgrStack.Pop(currentAttributes));
+    std::wstring hyperlinkUri;
+    auto attributes = _sgrStack.Pop(currentAttributes, hyperlinkUri);
+    if (!hyperlinkUri.empty())
+    {
+        _RevalidateHyperlink(attributes, hyperlinkUri);
+    }
+    _api.SetTextAttributes(attributes);
     return true;
 }
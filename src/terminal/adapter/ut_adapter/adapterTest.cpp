@@ -1192,6 +1192,56 @@ public:
         VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ std::span{ rgOptions, cOptions }, subParams, subParamRanges }));
     }
 
+    TEST_METHOD(GraphicsCachedTransitionTests)
+    {
+        Log::Comment(L"Starting test...");
+        _testGetSet->PrepData();
+
+        VTParameter rgOptions[16];
+        size_t cOptions = 3;
+        rgOptions[0] = DispatchTypes::GraphicsOptions::ForegroundExtended;
+        rgOptions[1] = DispatchTypes::GraphicsOptions::BlinkOrXterm256Index;
+        rgOptions[2] = 123;
+
+        Log::Comment(L"Apply the same sequence twice to the same attribute, to hit the cache");
+        for (auto i = 0; i < 2; ++i)
+        {
+            _testGetSet->_textBuffer->SetCurrentAttributes(TextAttribute{ 0 });
+            _testGetSet->_expectedAttribute = TextAttribute{ 0 };
+            _testGetSet->_expectedAttribute.SetIndexedForeground256(123);
+            VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+        }
+
+        Log::Comment(L"The same sequence applied to a different attribute must not reuse the cached result");
+        auto startingAttribute = TextAttribute{ 0 };
+        startingAttribute.SetIntense(true);
+        startingAttribute.SetIndexedBackground(TextColor::DARK_BLUE);
+        _testGetSet->_textBuffer->SetCurrentAttributes(startingAttribute);
+        _testGetSet->_expectedAttribute = startingAttribute;
+        _testGetSet->_expectedAttribute.SetIndexedForeground256(123);
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+
+        Log::Comment(L"Omitted parameters must not be confused with explicit zeros");
+        cOptions = 2;
+        rgOptions[0] = DispatchTypes::GraphicsOptions::Intense;
+        rgOptions[1] = 0;
+        _testGetSet->_textBuffer->SetCurrentAttributes(TextAttribute{ 0 });
+        _testGetSet->_expectedAttribute = {};
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+
+        rgOptions[1] = {};
+        _testGetSet->_textBuffer->SetCurrentAttributes(TextAttribute{ 0 });
+        _testGetSet->_expectedAttribute = {};
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+
+        rgOptions[1] = DispatchTypes::GraphicsOptions::ForegroundRed;
+        _testGetSet->_textBuffer->SetCurrentAttributes(TextAttribute{ 0 });
+        _testGetSet->_expectedAttribute = TextAttribute{ 0 };
+        _testGetSet->_expectedAttribute.SetIntense(true);
+        _testGetSet->_expectedAttribute.SetIndexedForeground(TextColor::DARK_RED);
+        VERIFY_IS_TRUE(_pDispatch->SetGraphicsRendition({ rgOptions, cOptions }));
+    }
+
     TEST_METHOD(GraphicsPushPopTests)
     {
         Log::Comment(L"Starting test...");
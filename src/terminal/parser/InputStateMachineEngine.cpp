@@ -286,12 +286,14 @@ bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view st
         // similar to TerminalInput::_SendInputSequence
         if (!string.empty())
         {
-            InputEventQueue inputEvents;
+            // _passThroughEvents is reused across calls, so that this doesn't allocate in the steady state.
+            _passThroughEvents.clear();
+            _passThroughEvents.reserve(string.size());
             for (const auto& wch : string)
             {
-                inputEvents.push_back(SynthesizeKeyEvent(true, 1, 0, 0, wch, 0));
+                _passThroughEvents.push_back(SynthesizeKeyEvent(true, 1, 0, 0, wch, 0));
             }
-            return _pDispatch->WriteInput(inputEvents);
+            return _pDispatch->WriteInput(_passThroughEvents);
         }
     }
     return ActionPrintString(string);
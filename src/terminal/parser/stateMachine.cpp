@@ -368,6 +368,72 @@ static constexpr bool _isApcIndicator(const wchar_t wch) noexcept
     return wch == L'_'; // 0x5F
 }
 
+// The character classes of the table driven CSI states. See _EventCsi.
+enum class CsiCharClass : uint8_t
+{
+    Execute,
+    Ignore,
+    Intermediate,
+    Parameter,
+    SubParameterDelimiter,
+    ParameterDelimiter,
+    PrivateMarker,
+    Final,
+};
+static constexpr size_t CsiCharClassCount = 8;
+
+// The ASCII part of the CSI character class table. It's generated out of the
+// predicates above at compile time, so that both can't diverge.
+static constexpr auto s_csiCharClasses = []() {
+    std::array<CsiCharClass, 128> classes{};
+    for (wchar_t wch = 0; wch < classes.size(); ++wch)
+    {
+        auto cls = CsiCharClass::Final;
+        if (_isC0Code(wch))
+        {
+            cls = CsiCharClass::Execute;
+        }
+        else if (_isDelete(wch))
+        {
+            cls = CsiCharClass::Ignore;
+        }
+        else if (_isIntermediate(wch))
+        {
+            cls = CsiCharClass::Intermediate;
+        }
+        else if (_isNumericParamValue(wch))
+        {
+            cls = CsiCharClass::Parameter;
+        }
+        else if (_isSubParameterDelimiter(wch))
+        {
+            cls = CsiCharClass::SubParameterDelimiter;
+        }
+        else if (_isParameterDelimiter(wch))
+        {
+            cls = CsiCharClass::ParameterDelimiter;
+        }
+        else if (_isCsiPrivateMarker(wch))
+        {
+            cls = CsiCharClass::PrivateMarker;
+        }
+        classes[wch] = cls;
+    }
+    return classes;
+}();
+
+// Routine Description:
+// - Classifies a character for the CSI transition table.
+//   Anything outside of ASCII is a final character as far as CSI is concerned.
+// Arguments:
+// - wch - Character to classify.
+// Return Value:
+// - The character's class.
+static constexpr CsiCharClass _classifyCsiChar(const wchar_t wch) noexcept
+{
+    return wch < s_csiCharClasses.size() ? til::at(s_csiCharClasses, wch) : CsiCharClass::Final;
+}
+
 #pragma warning(pop)
 
 // Routine Description:
@@ -543,6 +609,48 @@ void StateMachine::_ActionParam(const wchar_t wch)
     }
 }
 
+// Routine Description:
+// - Equivalent to calling _ActionParam for each character of a run of digits,
+//   but accumulates them into the current parameter in a tight loop.
+//   Digits are the majority of all characters in SGR heavy output.
+// Arguments:
+// - string - The string that's currently being processed.
+// - offset - The offset of the first digit of the run within string.
+// Return Value:
+// - The offset past the last digit of the run.
+size_t StateMachine::_ActionParamDigits(const std::wstring_view string, size_t offset)
+{
+    _trace.TraceOnAction(L"Param");
+
+    auto end = offset;
+    while (end < string.size() && _isNumericParamValue(til::at(string, end)))
+    {
+        ++end;
+    }
+
+    // Once we've reached the parameter limit, additional parameters are ignored.
+    if (!_parameterLimitOverflowed)
+    {
+        // If we have no parameters and we're about to add one, get the next value ready here.
+        // This happens if the CsiParam state was entered via a private marker like in "\x1b[?25h".
+        if (_parameters.empty())
+        {
+            _parameters.push_back({});
+            const auto rangeStart = gsl::narrow_cast<BYTE>(_subParameters.size());
+            _subParameterRanges.push_back({ rangeStart, rangeStart });
+        }
+
+        auto currentParameter = _parameters.back().value_or(0);
+        for (; offset < end; ++offset)
+        {
+            _AccumulateTo(til::at(string, offset), currentParameter);
+        }
+        _parameters.back() = currentParameter;
+    }
+
+    return end;
+}
+
 // Routine Description:
 // - Triggers the SubParam action to indicate that the state machine should
 //   store this character as a part of a sub-parameter to a control sequence.
@@ -1201,233 +1309,188 @@ void StateMachine::_EventEscapeIntermediate(const wchar_t wch)
 }
 
 // Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiEntry state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Store parameter data
-//   5. Store sub parameter data
-//   6. Collect Control Sequence Private markers
-//   7. Dispatch a control sequence with parameters for action
+// - Moves the state machine into one of the states a CSI transition can lead to.
+// Arguments:
+// - state - The state to enter. Must be Ground or one of the Csi* states.
+// Return Value:
+// - <none>
+void StateMachine::_EnterCsiState(const VTStates state)
+{
+    switch (state)
+    {
+    case VTStates::Ground:
+        return _EnterGround();
+    case VTStates::CsiEntry:
+        return _EnterCsiEntry();
+    case VTStates::CsiIntermediate:
+        return _EnterCsiIntermediate();
+    case VTStates::CsiIgnore:
+        return _EnterCsiIgnore();
+    case VTStates::CsiParam:
+        return _EnterCsiParam();
+    case VTStates::CsiSubParam:
+        return _EnterCsiSubParam();
+    default:
+        return;
+    }
+}
+
+// Routine Description:
+// - Processes a character event into an Action that occurs while in one of the
+//   CSI states (CsiEntry, CsiIntermediate, CsiIgnore, CsiParam, CsiSubParam).
+//   Colored output consists mostly of these sequences, so instead of walking a
+//   chain of predicates per character, we classify the character with a single
+//   table lookup and look up the action and the follow-up state in a
+//   [state][class] transition table. The transitions are:
+//   * CsiEntry:
+//     1. Execute C0 control characters
+//     2. Ignore Delete characters
+//     3. Collect Intermediate characters
+//     4. Store parameter data
+//     5. Store sub parameter data
+//     6. Collect Control Sequence Private markers
+//     7. Dispatch a control sequence with parameters for action
+//   * CsiIntermediate:
+//     1. Execute C0 control characters
+//     2. Ignore Delete characters
+//     3. Collect Intermediate characters
+//     4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+//     5. Dispatch a control sequence with parameters for action
+//   * CsiIgnore:
+//     1. Execute C0 control characters
+//     2. Ignore Delete, Intermediate and parameter characters
+//     3. Return to Ground on a final character
+//   * CsiParam:
+//     1. Execute C0 control characters
+//     2. Ignore Delete characters
+//     3. Collect Intermediate characters
+//     4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+//     5. Store parameter data
+//     6. Store sub parameter data
+//     7. Dispatch a control sequence with parameters for action
+//   * CsiSubParam:
+//     1. Execute C0 control characters
+//     2. Ignore Delete characters
+//     3. Store sub parameter data
+//     4. Store parameter data
+//     5. Collect Intermediate characters for parameter.
+//     6. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+//     7. Dispatch a control sequence with parameters for action
 // Arguments:
 // - wch - Character that triggered the event
 // Return Value:
 // - <none>
-void StateMachine::_EventCsiEntry(const wchar_t wch)
+void StateMachine::_EventCsi(const wchar_t wch)
 {
-    _trace.TraceOnEvent(L"CsiEntry");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiIntermediate();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-        _EnterCsiParam();
-    }
-    else if (_isSubParameterDelimiter(wch))
-    {
-        _ActionSubParam(wch);
-        _EnterCsiSubParam();
-    }
-    else if (_isCsiPrivateMarker(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiParam();
-    }
-    else
-    {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
-        _ExecuteCsiCompleteCallback();
-    }
-}
+    using A = CsiAction;
+    using S = VTStates;
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiIntermediate state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Dispatch a control sequence with parameters for action
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiIntermediate(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiIntermediate");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediateInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
-    else
-    {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
-        _ExecuteCsiCompleteCallback();
-    }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiIgnore state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Return to Ground
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiIgnore(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiIgnore");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediateInvalid(wch))
-    {
-        _ActionIgnore();
-    }
-    else
-    {
-        _EnterGround();
-    }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiParam state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Store parameter data
-//   6. Store sub parameter data
-//   7. Dispatch a control sequence with parameters for action
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiParam(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiParam");
-    if (_isC0Code(wch))
-    {
+    // Rows are indexed by the state relative to CsiEntry, columns by CsiCharClass:
+    //   Execute, Ignore, Intermediate, Parameter, SubParameterDelimiter, ParameterDelimiter, PrivateMarker, Final
+    static constexpr CsiTransition transitions[5][CsiCharClassCount]{
+        // CsiEntry
+        {
+            { A::Execute, S::CsiEntry },
+            { A::Ignore, S::CsiEntry },
+            { A::Collect, S::CsiIntermediate },
+            { A::Param, S::CsiParam },
+            { A::SubParam, S::CsiSubParam },
+            { A::Param, S::CsiParam },
+            { A::Collect, S::CsiParam },
+            { A::Dispatch, S::Ground },
+        },
+        // CsiIntermediate
+        {
+            { A::Execute, S::CsiIntermediate },
+            { A::Ignore, S::CsiIntermediate },
+            { A::Collect, S::CsiIntermediate },
+            { A::None, S::CsiIgnore },
+            { A::None, S::CsiIgnore },
+            { A::None, S::CsiIgnore },
+            { A::None, S::CsiIgnore },
+            { A::Dispatch, S::Ground },
+        },
+        // CsiIgnore
+        {
+            { A::Execute, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::Ignore, S::CsiIgnore },
+            { A::None, S::Ground },
+        },
+        // CsiParam
+        {
+            { A::Execute, S::CsiParam },
+            { A::Ignore, S::CsiParam },
+            { A::Collect, S::CsiIntermediate },
+            { A::Param, S::CsiParam },
+            { A::SubParam, S::CsiSubParam },
+            { A::Param, S::CsiParam },
+            { A::None, S::CsiIgnore },
+            { A::Dispatch, S::Ground },
+        },
+        // CsiSubParam
+        {
+            { A::Execute, S::CsiSubParam },
+            { A::Ignore, S::CsiSubParam },
+            { A::Collect, S::CsiIntermediate },
+            { A::SubParam, S::CsiSubParam },
+            { A::SubParam, S::CsiSubParam },
+            { A::Param, S::CsiParam },
+            { A::None, S::CsiIgnore },
+            { A::Dispatch, S::Ground },
+        },
+    };
+    static constexpr const wchar_t* eventNames[]{
+        L"CsiEntry",
+        L"CsiIntermediate",
+        L"CsiIgnore",
+        L"CsiParam",
+        L"CsiSubParam",
+    };
+    static_assert(static_cast<int>(S::CsiIntermediate) - static_cast<int>(S::CsiEntry) == 1);
+    static_assert(static_cast<int>(S::CsiIgnore) - static_cast<int>(S::CsiEntry) == 2);
+    static_assert(static_cast<int>(S::CsiParam) - static_cast<int>(S::CsiEntry) == 3);
+    static_assert(static_cast<int>(S::CsiSubParam) - static_cast<int>(S::CsiEntry) == 4);
+
+    const auto state = _state;
+    const auto row = static_cast<size_t>(state) - static_cast<size_t>(S::CsiEntry);
+    const auto& transition = til::at(til::at(transitions, row), static_cast<size_t>(_classifyCsiChar(wch)));
+
+    _trace.TraceOnEvent(til::at(eventNames, row));
+
+    switch (transition.action)
+    {
+    case A::Execute:
         _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
+        break;
+    case A::Ignore:
         _ActionIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
+        break;
+    case A::Collect:
+        _ActionCollect(wch);
+        break;
+    case A::Param:
         _ActionParam(wch);
-    }
-    else if (_isSubParameterDelimiter(wch))
-    {
+        break;
+    case A::SubParam:
         _ActionSubParam(wch);
-        _EnterCsiSubParam();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiIntermediate();
-    }
-    else if (_isParameterInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
-    else
-    {
+        break;
+    case A::Dispatch:
         _ActionCsiDispatch(wch);
         _EnterGround();
         _ExecuteCsiCompleteCallback();
+        return;
+    default:
+        break;
     }
-}
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiSubParam state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Store sub parameter data
-//   4. Store parameter data
-//   5. Collect Intermediate characters for parameter.
-//   6. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   7. Dispatch a control sequence with parameters for action
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiSubParam(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiSubParam");
-    if (_isC0Code(wch))
+    if (transition.state != state)
     {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isSubParameterDelimiter(wch))
-    {
-        _ActionSubParam(wch);
-    }
-    else if (_isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-        _EnterCsiParam();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiIntermediate();
-    }
-    else if (_isParameterInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
-    else
-    {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
-        _ExecuteCsiCompleteCallback();
+        _EnterCsiState(transition.state);
     }
 }
 
@@ -1882,15 +1945,11 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
         case VTStates::EscapeIntermediate:
             return _EventEscapeIntermediate(wch);
         case VTStates::CsiEntry:
-            return _EventCsiEntry(wch);
         case VTStates::CsiIntermediate:
-            return _EventCsiIntermediate(wch);
         case VTStates::CsiIgnore:
-            return _EventCsiIgnore(wch);
         case VTStates::CsiParam:
-            return _EventCsiParam(wch);
         case VTStates::CsiSubParam:
-            return _EventCsiSubParam(wch);
+            return _EventCsi(wch);
         case VTStates::OscParam:
             return _EventOscParam(wch);
         case VTStates::OscString:
@@ -1928,7 +1987,7 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
 //      it doesn't understand to the tty.
 //  This does not modify the state of the state machine. Callers should be in
 //      the Action*Dispatch state, and upon completion, the state's handler (eg
-//      _EventCsiParam) should move us into the ground state.
+//      _EventCsi) should move us into the ground state.
 // Arguments:
 // - <none>
 // Return Value:
@@ -2124,6 +2183,19 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         do
         {
+            // Parameter digits are accumulated in bulk, bypassing ProcessCharacter.
+            if (_state == VTStates::CsiParam && _isNumericParamValue(til::at(string, i)))
+            {
+                const auto end = _ActionParamDigits(string, i);
+                _runSize += end - i;
+                i = end;
+                if (i >= string.size())
+                {
+                    _processingLastCharacter = true;
+                    break;
+                }
+            }
+
             _runSize++;
             _processingLastCharacter = i + 1 >= string.size();
             // If we're processing characters individually, send it to the state machine.
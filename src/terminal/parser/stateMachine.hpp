@@ -91,6 +91,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionVt52EscDispatch(const wchar_t wch);
         void _ActionCollect(const wchar_t wch) noexcept;
         void _ActionParam(const wchar_t wch);
+        size_t _ActionParamDigits(const std::wstring_view string, size_t offset);
         void _ActionSubParam(const wchar_t wch);
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
@@ -127,11 +128,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventGround(const wchar_t wch);
         void _EventEscape(const wchar_t wch);
         void _EventEscapeIntermediate(const wchar_t wch);
-        void _EventCsiEntry(const wchar_t wch);
-        void _EventCsiIntermediate(const wchar_t wch);
-        void _EventCsiIgnore(const wchar_t wch);
-        void _EventCsiParam(const wchar_t wch);
-        void _EventCsiSubParam(const wchar_t wch);
+        void _EventCsi(const wchar_t wch);
         void _EventOscParam(const wchar_t wch);
         void _EventOscString(const wchar_t wch);
         void _EventOscTermination(const wchar_t wch);
@@ -176,6 +173,27 @@ namespace Microsoft::Console::VirtualTerminal
             SosPmApcString
         };
 
+        // The actions that the table driven CSI states (CsiEntry through
+        // CsiSubParam) can take in response to a character.
+        enum class CsiAction : uint8_t
+        {
+            None,
+            Execute,
+            Ignore,
+            Collect,
+            Param,
+            SubParam,
+            Dispatch,
+        };
+
+        struct CsiTransition
+        {
+            CsiAction action;
+            VTStates state;
+        };
+
+        void _EnterCsiState(const VTStates state);
+
         Microsoft::Console::VirtualTerminal::ParserTracing _trace;
 
         std::unique_ptr<IStateMachineEngine> _engine;
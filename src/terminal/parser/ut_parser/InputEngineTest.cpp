@@ -329,7 +329,7 @@ public:
 
     virtual bool IsVtInputEnabled() const override;
 
-    virtual bool FocusChanged(const bool focused) const override;
+    virtual bool FocusChanged(const bool focused) override;
 
 private:
     std::function<void(const std::span<const INPUT_RECORD>&)> _pfnWriteInputCallback;
@@ -393,7 +393,7 @@ bool TestInteractDispatch::IsVtInputEnabled() const
     return true;
 }
 
-bool TestInteractDispatch::FocusChanged(const bool /*focused*/) const
+bool TestInteractDispatch::FocusChanged(const bool /*focused*/)
 {
     return false;
 }
@@ -524,6 +524,48 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
 
+    TEST_METHOD(TestCsiParamDigitRuns)
+    {
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        Log::Comment(L"Parameter digits split across multiple strings must accumulate into the same parameter");
+        mach.ProcessString(L"\x1b[3");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessString(L"8;5;1");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessString(L"23");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessString(L"m");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        VERIFY_ARE_EQUAL(mach._parameters.size(), 3u);
+        VERIFY_ARE_EQUAL(mach._parameters.at(0), 38);
+        VERIFY_ARE_EQUAL(mach._parameters.at(1), 5);
+        VERIFY_ARE_EQUAL(mach._parameters.at(2), 123);
+
+        Log::Comment(L"Digits following a private marker start a new parameter");
+        mach.ProcessString(L"\x1b[?2");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
+        mach.ProcessString(L"5h");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        VERIFY_ARE_EQUAL(mach._parameters.size(), 1u);
+        VERIFY_ARE_EQUAL(mach._parameters.at(0), 25);
+
+        Log::Comment(L"Digit runs are clamped to MAX_PARAMETER_VALUE");
+        mach.ProcessString(L"\x1b[1;99999999999;2:3m");
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+
+        VERIFY_ARE_EQUAL(mach._parameters.size(), 3u);
+        VERIFY_ARE_EQUAL(mach._parameters.at(0), 1);
+        VERIFY_ARE_EQUAL(mach._parameters.at(1), MAX_PARAMETER_VALUE);
+        VERIFY_ARE_EQUAL(mach._parameters.at(2), 2);
+        VERIFY_ARE_EQUAL(mach._subParameters.size(), 1u);
+        VERIFY_ARE_EQUAL(mach._subParameters.at(0), 3);
+    }
+
     TEST_METHOD(TestCsiIgnore)
     {
         auto dispatch = std::make_unique<DummyDispatch>();
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <til/ring.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RingTests
+{
+    TEST_CLASS(RingTests);
+
+    // Fills the ring so that its contents wrap around the end of the allocation.
+    static til::ring<int> makeWrapped()
+    {
+        til::ring<int> ring;
+        for (auto i = 0; i < 12; ++i)
+        {
+            ring.push_back(-1);
+        }
+        for (auto i = 0; i < 12; ++i)
+        {
+            ring.pop_front();
+        }
+        // The first 4 elements are stored at the end of the allocation and the other 4 at its beginning.
+        for (auto i = 0; i < 8; ++i)
+        {
+            ring.push_back(i);
+        }
+        return ring;
+    }
+
+    static void verifyContents(const til::ring<int>& ring, std::initializer_list<int> expected)
+    {
+        VERIFY_ARE_EQUAL(expected.size(), ring.size());
+
+        auto it = ring.begin();
+        for (const auto e : expected)
+        {
+            VERIFY_ARE_EQUAL(e, *it);
+            ++it;
+        }
+        VERIFY_IS_TRUE(it == ring.end());
+    }
+
+    TEST_METHOD(PushPop)
+    {
+        til::ring<int> ring;
+        VERIFY_IS_TRUE(ring.empty());
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            ring.push_back(i);
+        }
+        VERIFY_ARE_EQUAL(100u, ring.size());
+        VERIFY_ARE_EQUAL(0, ring.front());
+        VERIFY_ARE_EQUAL(99, ring.back());
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            VERIFY_ARE_EQUAL(i, ring.front());
+            ring.pop_front();
+        }
+        VERIFY_IS_TRUE(ring.empty());
+    }
+
+    TEST_METHOD(Wraparound)
+    {
+        auto ring = makeWrapped();
+        VERIFY_ARE_EQUAL(16u, ring.capacity());
+        verifyContents(ring, { 0, 1, 2, 3, 4, 5, 6, 7 });
+
+        Log::Comment(L"Growing the ring must unwrap the existing elements in order.");
+        for (auto i = 8; i < 20; ++i)
+        {
+            ring.push_back(i);
+        }
+        VERIFY_ARE_EQUAL(32u, ring.capacity());
+        for (size_t i = 0; i < 20; ++i)
+        {
+            VERIFY_ARE_EQUAL(gsl::narrow_cast<int>(i), ring[i]);
+        }
+    }
+
+    TEST_METHOD(AppendRange)
+    {
+        auto ring = makeWrapped();
+
+        const std::array values{ 8, 9, 10, 11, 12, 13 };
+        ring.append_range(std::span<const int>{ values });
+        VERIFY_ARE_EQUAL(16u, ring.capacity());
+        verifyContents(ring, { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 });
+
+        Log::Comment(L"Appending more than the capacity must grow the ring.");
+        std::vector<int> more(100, 42);
+        ring.append_range(std::span<const int>{ more });
+        VERIFY_ARE_EQUAL(114u, ring.size());
+        VERIFY_ARE_EQUAL(13, ring[13]);
+        VERIFY_ARE_EQUAL(42, ring[14]);
+        VERIFY_ARE_EQUAL(42, ring.back());
+
+        Log::Comment(L"Appending to a ring whose free space wraps around must split the copy.");
+        auto split = makeWrapped();
+        split.erase(split.begin(), split.end());
+        for (auto i = 0; i < 8; ++i)
+        {
+            split.push_back(i);
+        }
+        split.append_range(std::span<const int>{ values });
+        VERIFY_ARE_EQUAL(16u, split.capacity());
+        verifyContents(split, { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 });
+    }
+
+    TEST_METHOD(AppendRing)
+    {
+        auto ring = makeWrapped();
+        auto other = makeWrapped();
+
+        Log::Comment(L"Both halves of a wrapped ring must be appended in order.");
+        ring.append_range(other);
+        verifyContents(ring, { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 });
+
+        Log::Comment(L"Appending an empty ring is a no-op.");
+        ring.append_range(til::ring<int>{});
+        VERIFY_ARE_EQUAL(16u, ring.size());
+    }
+
+    TEST_METHOD(ShrinkWhenEmptied)
+    {
+        til::ring<int> ring;
+        std::vector<int> values(til::ring<int>::shrink_threshold + 1, 42);
+
+        Log::Comment(L"A ring that grew past the threshold releases its allocation once it's empty.");
+        ring.append_range(std::span<const int>{ values });
+        VERIFY_IS_GREATER_THAN(ring.capacity(), til::ring<int>::shrink_threshold);
+        ring.erase(ring.begin(), ring.end() - 1);
+        VERIFY_IS_GREATER_THAN(ring.capacity(), til::ring<int>::shrink_threshold);
+        ring.pop_front();
+        VERIFY_ARE_EQUAL(0u, ring.capacity());
+
+        ring.append_range(std::span<const int>{ values });
+        ring.clear();
+        VERIFY_ARE_EQUAL(0u, ring.capacity());
+
+        Log::Comment(L"Smaller rings keep their allocation for reuse.");
+        ring.push_back(1);
+        ring.pop_front();
+        VERIFY_ARE_EQUAL(16u, ring.capacity());
+        ring.push_back(2);
+        verifyContents(ring, { 2 });
+    }
+
+    TEST_METHOD(Erase)
+    {
+        auto ring = makeWrapped();
+
+        Log::Comment(L"Erase from the front.");
+        ring.erase(ring.begin(), ring.begin() + 2);
+        verifyContents(ring, { 2, 3, 4, 5, 6, 7 });
+
+        Log::Comment(L"Erase from the back.");
+        ring.erase(ring.end() - 2, ring.end());
+        verifyContents(ring, { 2, 3, 4, 5 });
+
+        Log::Comment(L"Erase from the middle.");
+        ring.erase(ring.begin() + 1, ring.begin() + 3);
+        verifyContents(ring, { 2, 5 });
+    }
+
+    TEST_METHOD(RemoveIf)
+    {
+        auto ring = makeWrapped();
+        const auto newEnd = std::remove_if(ring.begin(), ring.end(), [](int i) { return i & 1; });
+        ring.erase(newEnd, ring.end());
+        verifyContents(ring, { 0, 2, 4, 6 });
+    }
+
+    TEST_METHOD(CopyAndMove)
+    {
+        const auto ring = makeWrapped();
+
+        auto copy = ring;
+        verifyContents(copy, { 0, 1, 2, 3, 4, 5, 6, 7 });
+
+        const auto moved = std::move(copy);
+        verifyContents(moved, { 0, 1, 2, 3, 4, 5, 6, 7 });
+        VERIFY_IS_TRUE(copy.empty());
+    }
+};
@@ -91,6 +91,7 @@ class RunLengthEncodingTests
     using value_type = rle_vector::value_type;
     using size_type = rle_vector::size_type;
     using rle_type = rle_vector::rle_type;
+    using edit_type = rle_vector::edit_type;
 
     using basic_container = std::basic_string<value_type>;
     using basic_container_view = std::basic_string_view<value_type>;
@@ -378,6 +379,62 @@ class RunLengthEncodingTests
         }
     }
 
+    TEST_METHOD(ReplaceSorted)
+    {
+        struct TestCase
+        {
+            std::string_view source;
+            std::vector<edit_type> edits;
+            std::string_view expected;
+        };
+
+        const std::array<TestCase, 7> test_cases{
+            {
+                // no edits
+                { "1|3 3|2|1 1 1|5 5", {}, "1|3 3|2|1 1 1|5 5" },
+                // empty edit
+                { "1|3 3|2|1 1 1|5 5", { { 2, 2, 7 } }, "1|3 3|2|1 1 1|5 5" },
+                // within runs
+                { "1|3 3|2|1 1 1|5 5", { { 0, 1, 6 }, { 4, 6, 7 } }, "6|3 3|2|7 7|1|5 5" },
+                // adjacent edits
+                { "1|3 3|2|1 1 1|5 5", { { 0, 2, 8 }, { 2, 4, 9 } }, "8 8|9 9|1 1 1|5 5" },
+                // join with each other and existing runs
+                { "1|3 3|2|1 1 1|5 5", { { 1, 3, 1 }, { 3, 4, 1 } }, "1 1 1 1 1 1 1|5 5" },
+                // past the end
+                { "1|3 3|2|1 1 1|5 5", { { 7, 20, 6 } }, "1|3 3|2|1 1 1|6 6" },
+                // all
+                { "1|3 3|2|1 1 1|5 5", { { 0, 9, 4 } }, "4 4 4 4 4 4 4 4 4" },
+            }
+        };
+
+        auto idx = 0;
+
+        for (const auto& test_case : test_cases)
+        {
+            rle_vector rle{ rle_encode(test_case.source) };
+            rle.replace_sorted(test_case.edits);
+
+            VERIFY_ARE_EQUAL(
+                test_case.expected,
+                rle,
+                NoThrowString().Format(
+                    L"test case: %d\nsource:    %hs\nexpected:  %hs\nactual:    %s",
+                    idx,
+                    test_case.source.data(),
+                    test_case.expected.data(),
+                    rle.to_string().c_str()));
+            ++idx;
+        }
+
+        Log::Comment(L"Unsorted or overlapping edits are rejected and leave the vector unchanged.");
+        rle_vector rle{ rle_encode("1|3 3|2|1 1 1|5 5") };
+        const std::array<edit_type, 2> unsorted{ { { 4, 6, 7 }, { 0, 1, 6 } } };
+        const std::array<edit_type, 2> overlapping{ { { 0, 3, 7 }, { 2, 4, 6 } } };
+        VERIFY_THROWS(rle.replace_sorted(unsorted), std::out_of_range);
+        VERIFY_THROWS(rle.replace_sorted(overlapping), std::out_of_range);
+        VERIFY_ARE_EQUAL("1|3 3|2|1 1 1|5 5"sv, rle);
+    }
+
     TEST_METHOD(ReplaceValues)
     {
         struct TestCase
@@ -17,6 +17,9 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestU8ToU16Invalid);
+    TEST_METHOD(TestU16ToU8Invalid);
+    TEST_METHOD(TestVectorBoundaries);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +194,57 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestU8ToU16Invalid()
+{
+    // Each maximal subpart of an ill-formed sequence is replaced with a single U+FFFD.
+    // This is the example from table 3-8 in chapter 3.9 of the Unicode standard.
+    const std::string u8String{ "\x61\xF1\x80\x80\xE1\x80\xC2\x62\x80\x63\x80\xBF\x64" };
+    const std::wstring u16StringComp{ L"a\xFFFD\xFFFD\xFFFD"
+                                      L"b\xFFFD"
+                                      L"c\xFFFD\xFFFD"
+                                      L"d" };
+
+    std::wstring u16Out{};
+    VERIFY_ARE_EQUAL(S_OK, til::u8u16(u8String, u16Out));
+    VERIFY_ARE_EQUAL(u16StringComp, u16Out);
+
+    // Overlong encodings, surrogates and code points past U+10FFFF are invalid as well.
+    VERIFY_ARE_EQUAL(S_OK, til::u8u16(std::string_view{ "\xC0\xAF\xE0\x80\xAF\xED\xA0\x80\xF4\x90\x80\x80\xFF" }, u16Out));
+    VERIFY_ARE_EQUAL(std::wstring(13, L'\xFFFD'), u16Out);
+}
+
+void Utf8Utf16ConvertTests::TestU16ToU8Invalid()
+{
+    // Unpaired surrogates are replaced with U+FFFD.
+    const std::wstring u16String{ L"a\xDC00\xD800"
+                                  L"b\xD83D\xDE00\xD800" };
+    const std::string u8StringComp{ "a\xEF\xBF\xBD\xEF\xBF\xBD"
+                                    "b\xF0\x9F\x98\x80\xEF\xBF\xBD" };
+
+    std::string u8Out{};
+    VERIFY_ARE_EQUAL(S_OK, til::u16u8(u16String, u8Out));
+    VERIFY_ARE_EQUAL(u8StringComp, u8Out);
+}
+
+void Utf8Utf16ConvertTests::TestVectorBoundaries()
+{
+    // ASCII is converted 32 bytes at a time. Place a non-ASCII character at every offset of a
+    // string that is longer than that, to ensure that we transition correctly between the paths.
+    for (size_t i = 0; i < 80; ++i)
+    {
+        std::string u8String(80, 'a');
+        u8String.replace(i, 1, "\xE2\x82\xAC"); // EURO SIGN
+
+        std::wstring u16StringComp(80, L'a');
+        u16StringComp[i] = L'\x20AC';
+
+        std::wstring u16Out{};
+        VERIFY_ARE_EQUAL(S_OK, til::u8u16(u8String, u16Out));
+        VERIFY_ARE_EQUAL(u16StringComp, u16Out);
+
+        std::string u8Out{};
+        VERIFY_ARE_EQUAL(S_OK, til::u16u8(u16StringComp, u8Out));
+        VERIFY_ARE_EQUAL(u8String, u8Out);
+    }
+}
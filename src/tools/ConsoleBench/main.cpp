@@ -21,6 +21,7 @@ struct BenchmarkContext
     std::string_view utf8_128Ki;
     std::wstring_view utf16_4Ki;
     std::wstring_view utf16_128Ki;
+    std::string_view sgr_utf8_128Ki;
 };
 
 struct Benchmark
@@ -111,6 +112,23 @@ static constexpr Benchmark s_benchmarks[]{
             }
         },
     },
+    Benchmark{
+        .title = "WriteConsoleA SGR 128Ki",
+        .exec = [](const BenchmarkContext& ctx, Measurements measurements) {
+            for (auto& d : measurements)
+            {
+                const auto beg = query_perf_counter();
+                WriteConsoleA(ctx.output, ctx.sgr_utf8_128Ki.data(), static_cast<DWORD>(ctx.sgr_utf8_128Ki.size()), nullptr, nullptr);
+                const auto end = query_perf_counter();
+                d = perf_delta(beg, end);
+
+                if (end >= ctx.time_limit)
+                {
+                    break;
+                }
+            }
+        },
+    },
     Benchmark{
         .title = "Copy to clipboard 4Ki",
         .exec = [](const BenchmarkContext& ctx, Measurements measurements) {
@@ -176,6 +194,81 @@ static constexpr Benchmark s_benchmarks[]{
                 const auto end = query_perf_counter();
                 d = perf_delta(beg, end);
 
+                if (end >= ctx.time_limit)
+                {
+                    break;
+                }
+            }
+        },
+    },
+    Benchmark{
+        .title = "WriteConsoleInputW/ReadConsoleInputW contended 4Ki",
+        .exec = [](const BenchmarkContext& ctx, Measurements measurements) {
+            // A writer thread feeds the input buffer in small chunks, similar to the VT input thread
+            // during a paste, while this thread drains it, similar to a shell reading its input.
+            struct Writer
+            {
+                HANDLE input;
+                std::span<const INPUT_RECORD> records;
+            };
+            static constexpr DWORD chunk = 64;
+
+            const auto scratch = mem::get_scratch_arena(ctx.arena);
+            const auto count = ctx.utf16_4Ki.size();
+            const auto records = scratch.arena.push_uninitialized<INPUT_RECORD>(count);
+            const auto buf = scratch.arena.push_uninitialized<INPUT_RECORD>(count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                records[i] = INPUT_RECORD{
+                    .EventType = KEY_EVENT,
+                    .Event = {
+                        .KeyEvent = {
+                            .bKeyDown = TRUE,
+                            .wRepeatCount = 1,
+                            .uChar = { .UnicodeChar = ctx.utf16_4Ki[i] },
+                        },
+                    },
+                };
+            }
+
+            Writer writer{ ctx.input, { records, count } };
+            FlushConsoleInputBuffer(ctx.input);
+
+            for (auto& d : measurements)
+            {
+                const auto beg = query_perf_counter();
+
+                const auto thread = CreateThread(
+                    nullptr,
+                    0,
+                    [](LPVOID param) -> DWORD {
+                        const auto& w = *static_cast<const Writer*>(param);
+                        for (size_t off = 0; off < w.records.size(); off += chunk)
+                        {
+                            const auto len = static_cast<DWORD>(std::min<size_t>(chunk, w.records.size() - off));
+                            DWORD written;
+                            WriteConsoleInputW(w.input, w.records.data() + off, len, &written);
+                        }
+                        return 0;
+                    },
+                    &writer,
+                    0,
+                    nullptr);
+
+                for (size_t total = 0; total < count;)
+                {
+                    DWORD read = 0;
+                    ReadConsoleInputW(ctx.input, buf, static_cast<DWORD>(count), &read);
+                    total += read;
+                }
+
+                WaitForSingleObject(thread, INFINITE);
+                CloseHandle(thread);
+
+                const auto end = query_perf_counter();
+                d = perf_delta(beg, end);
+
                 if (end >= ctx.time_limit)
                 {
                     break;
@@ -189,6 +282,11 @@ static constexpr size_t s_benchmarks_count = _countof(s_benchmarks);
 // Each of these strings is 128 columns.
 static constexpr std::string_view payload_utf8{ "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labor眠い子猫はマグロ狩りの夢を見る" };
 static constexpr std::wstring_view payload_utf16{ L"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labor眠い子猫はマグロ狩りの夢を見る" };
+// Colored output as produced by syntax highlighters, where (almost) every cell has its own SGR sequence.
+static constexpr std::string_view payload_sgr_utf8{
+    "\x1b[0;1;38;5;196mL\x1b[22;38;2;255;128;0mo\x1b[48;5;21mr\x1b[39;49me\x1b[4;31mm\x1b[24;32m \x1b[33;44mi\x1b[m"
+    "\x1b[38:2::12:34:56mp\x1b[1;7ms\x1b[22;27;95mu\x1b[3;106mm\x1b[23;49;39m \x1b[38;5;240md\x1b[38;5;250mo\x1b[0ml\r\n"
+};
 
 static bool print_warning();
 static AccumulatedResults* prepare_results(mem::Arena& arena, std::span<const wchar_t*> paths);
@@ -382,6 +480,7 @@ static std::span<Measurements> run_benchmarks_for_path(mem::Arena& arena, const
         .utf8_128Ki = mem::repeat_string(scratch.arena, payload_utf8, 128 * 1024 / 128),
         .utf16_4Ki = mem::repeat_string(scratch.arena, payload_utf16, 4 * 1024 / 128),
         .utf16_128Ki = mem::repeat_string(scratch.arena, payload_utf16, 128 * 1024 / 128),
+        .sgr_utf8_128Ki = mem::repeat_string(scratch.arena, payload_sgr_utf8, 128 * 1024 / payload_sgr_utf8.size()),
     };
 
     prepare_conhost(ctx, parent_hwnd);
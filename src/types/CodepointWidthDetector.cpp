@@ -4,6 +4,10 @@
 #include "precomp.h"
 #include "inc/CodepointWidthDetector.hpp"
 
+#include <til/unicode.h>
+
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+
 namespace
 {
     // used to store range data in CodepointWidthDetector's internal map
@@ -323,31 +327,148 @@ namespace
         UnicodeRange{ 0xf0000, 0xffffd, 1 },
         UnicodeRange{ 0x100000, 0x10fffd, 1 },
     };
+
+    // s_wideAndAmbiguousTable is turned into a two-stage lookup table at compile time, so that looking up
+    // a codepoint is O(1) instead of a binary search. Stage 1 maps each block of 64 codepoints to a leaf
+    // and uniform blocks share a leaf. A leaf holds 1 bit per codepoint for "is wide" and "is ambiguous".
+    // It only covers the BMP and SMP (all of the emoji). The few ranges above are handled by a binary search.
+    struct WidthLeaf
+    {
+        uint64_t wide = 0;
+        uint64_t ambiguous = 0;
+    };
+
+    struct WidthTrie
+    {
+        static constexpr char32_t Limit = 0x20000;
+        static constexpr size_t LeafShift = 6;
+        static constexpr size_t MaxLeaves = 128;
+        // The first 3 leaves are reserved for blocks that are entirely narrow, wide or ambiguous respectively.
+        static constexpr uint8_t NarrowLeaf = 0;
+        static constexpr uint8_t WideLeaf = 1;
+        static constexpr uint8_t AmbiguousLeaf = 2;
+
+        std::array<uint8_t, (Limit >> LeafShift)> stage1{};
+        std::array<WidthLeaf, MaxLeaves> leaves{};
+        size_t leafCount = 0;
+    };
+
+    // This walks the blocks and the sorted ranges in lockstep and skips over uncovered blocks. Only blocks that are
+    // partially covered by ranges need to be assembled bit by bit, which keeps this cheap enough for constexpr.
+    constexpr WidthTrie buildWidthTrie() noexcept
+    {
+        WidthTrie trie;
+        trie.leaves[WidthTrie::WideLeaf].wide = ~uint64_t{ 0 };
+        trie.leaves[WidthTrie::AmbiguousLeaf].ambiguous = ~uint64_t{ 0 };
+        trie.leafCount = 3;
+
+        size_t r = 0;
+        size_t block = 0;
+
+        while (block < trie.stage1.size())
+        {
+            const auto beg = static_cast<char32_t>(block << WidthTrie::LeafShift);
+            const auto end = beg + 63;
+
+            while (r < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[r].upperBound < beg)
+            {
+                ++r;
+            }
+            if (r == s_wideAndAmbiguousTable.size())
+            {
+                break;
+            }
+
+            const auto& first = s_wideAndAmbiguousTable[r];
+            if (first.lowerBound > end)
+            {
+                // stage1 is zero-initialized and so the blocks up to the next range already refer to the NarrowLeaf.
+                block = first.lowerBound >> WidthTrie::LeafShift;
+                continue;
+            }
+            if (first.lowerBound <= beg && first.upperBound >= end)
+            {
+                const auto idx = first.isAmbiguous ? WidthTrie::AmbiguousLeaf : WidthTrie::WideLeaf;
+                for (; block < trie.stage1.size() && (block << WidthTrie::LeafShift) + 63 <= first.upperBound; ++block)
+                {
+                    trie.stage1[block] = idx;
+                }
+                continue;
+            }
+
+            WidthLeaf leaf;
+            for (auto i = r; i < s_wideAndAmbiguousTable.size() && s_wideAndAmbiguousTable[i].lowerBound <= end; ++i)
+            {
+                const auto& range = s_wideAndAmbiguousTable[i];
+                const auto lo = std::max<char32_t>(range.lowerBound, beg) & 63;
+                const auto hi = std::min<char32_t>(range.upperBound, end) & 63;
+                const auto mask = (~uint64_t{ 0 } >> (63 - hi)) & (~uint64_t{ 0 } << lo);
+                (range.isAmbiguous ? leaf.ambiguous : leaf.wide) |= mask;
+            }
+
+            // Partially covered blocks are practically all unique, so they aren't deduplicated.
+            if (trie.leafCount < WidthTrie::MaxLeaves)
+            {
+                trie.leaves[trie.leafCount] = leaf;
+                trie.stage1[block] = static_cast<uint8_t>(trie.leafCount++);
+            }
+            ++block;
+        }
+
+        return trie;
+    }
+
+    static constexpr auto s_widthTrie = buildWidthTrie();
+    static_assert(s_widthTrie.leafCount < WidthTrie::MaxLeaves);
+
+    // Returns 1 for narrow, 2 for wide and 0 for ambiguous codepoints. This matches CodepointWidth.
+    uint8_t lookupWidth(const char32_t codepoint) noexcept
+    {
+        if (codepoint >= WidthTrie::Limit) [[unlikely]]
+        {
+#pragma warning(suppress : 26447) // The function is declared 'noexcept' but calls function 'lower_bound<...>()' which may throw exceptions (f.6).
+            const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
+            if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
+            {
+                return it->isAmbiguous ? 0 : 2;
+            }
+            return 1;
+        }
+
+        const auto& leaf = til::at(s_widthTrie.leaves, til::at(s_widthTrie.stage1, codepoint >> WidthTrie::LeafShift));
+        const auto bit = codepoint & 63;
+        const auto wide = (leaf.wide >> bit) & 1;
+        const auto ambiguous = (leaf.ambiguous >> bit) & 1;
+        return gsl::narrow_cast<uint8_t>((1 + wide) * (1 - ambiguous));
+    }
 }
 
 // Routine Description:
 // - returns the width type of codepoint as fast as we can by using quick lookup table and fallback cache.
 // Arguments:
-// - glyph - the utf16 encoded codepoint to search for
+// - glyph - the utf16 encoded codepoint or grapheme cluster to search for. Clusters are as wide as their first
+//   codepoint, unless they contain an emoji presentation selector (U+FE0F), which always makes them wide.
 // Return Value:
 // - the width type of the codepoint
 CodepointWidth CodepointWidthDetector::GetWidth(const std::wstring_view& glyph) noexcept
 {
-    char32_t codepoint = 0;
+    if (glyph.empty())
+    {
+        return CodepointWidth::Narrow;
+    }
+
+    char32_t codepoint = til::at(glyph, 0);
+    size_t len = 1;
+
+    if (til::is_leading_surrogate(codepoint) && glyph.size() >= 2 && til::is_trailing_surrogate(til::at(glyph, 1)))
+    {
+        codepoint = til::combine_surrogates(codepoint, til::at(glyph, 1));
+        len = 2;
+    }
 
-    switch (glyph.size())
+    if (glyph.size() > len && glyph.find(L'\xFE0F', len) != std::wstring_view::npos)
     {
-    case 1:
-        codepoint = til::at(glyph, 0);
-        break;
-    case 2:
-        codepoint = (til::at(glyph, 0) & 0x3FF) << 10;
-        codepoint |= til::at(glyph, 1) & 0x3FF;
-        codepoint += 0x10000;
-        break;
-    default:
-        codepoint = 0;
-        break;
+        return CodepointWidth::Wide;
     }
 
     if (codepoint < 0x80)
@@ -374,23 +495,83 @@ bool CodepointWidthDetector::IsWide(const std::wstring_view& glyph) noexcept
     return GetWidth(glyph) == CodepointWidth::Wide;
 }
 
-// GetWidth's slow-path for non-ASCII characters. Returns the number of columns the codepoint takes up in the terminal.
-uint8_t CodepointWidthDetector::_lookupGlyphWidth(const char32_t codepoint, const std::wstring_view& glyph) noexcept
+// Routine Description:
+// - measures an entire run of text at once, which is faster than calling GetWidth() for each codepoint.
+// Arguments:
+// - text - the utf16 encoded text to measure
+// - widths - receives the width of each codepoint in text: widths[i] is what GetWidth() returns for the
+//   codepoint starting at text[i] and 0 for the trailing half of a surrogate pair. Must be at least as large as text.
+// Return Value:
+// - the number of columns the text takes up, which is the sum of all widths
+size_t CodepointWidthDetector::GetWidths(const std::wstring_view& text, const std::span<uint8_t> widths) noexcept
 {
-#pragma warning(suppress : 26447) // The function is declared 'noexcept' but calls function 'lower_bound<...>()' which may throw exceptions (f.6).
-    const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
-    uint8_t width = 1;
+    assert(widths.size() >= text.size());
+    const auto count = std::min(text.size(), widths.size());
+    const auto data = text.data();
+    const auto out = widths.data();
+    size_t columns = 0;
+    size_t i = 0;
 
-    if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
+    while (i < count)
     {
-        width = 2;
-        if (it->isAmbiguous)
+        // ASCII fast-path: 8 chars below 0x80 at a time are 8 narrow columns.
+#if defined(TIL_SSE_INTRINSICS)
+        for (; count - i >= 8; i += 8, columns += 8)
         {
-            width = _checkFallbackViaCache(codepoint, glyph);
+            const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const auto nonAscii = _mm_and_si128(wch, _mm_set1_epi16(static_cast<short>(0xff80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) != 0xffff)
+            {
+                break;
+            }
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_set1_epi8(1));
+        }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+        for (; count - i >= 8; i += 8, columns += 8)
+        {
+            const auto wch = vld1q_u16(reinterpret_cast<const uint16_t*>(data + i));
+            const auto nonAscii = vmovn_u16(vcgeq_u16(wch, vdupq_n_u16(0x80)));
+            if (vget_lane_u64(vreinterpret_u64_u8(nonAscii), 0))
+            {
+                break;
+            }
+            vst1_u8(out + i, vdup_n_u8(1));
+        }
+#endif
+
+        // The scalar path handles the next 8 chars (or less), before we try the fast-path again.
+        for (const auto end = std::min(count, i + 8); i < end;)
+        {
+            const auto wch = data[i];
+            uint8_t width = 1;
+            size_t len = 1;
+
+            if (wch >= 0x80)
+            {
+                char32_t codepoint = wch;
+                if (til::is_leading_surrogate(wch) && i + 1 < count && til::is_trailing_surrogate(data[i + 1]))
+                {
+                    codepoint = til::combine_surrogates(wch, data[i + 1]);
+                    len = 2;
+                    out[i + 1] = 0;
+                }
+                width = _lookupGlyphWidth(codepoint, { data + i, len });
+            }
+
+            out[i] = width;
+            columns += width;
+            i += len;
         }
     }
 
-    return width;
+    return columns;
+}
+
+// GetWidth's slow-path for non-ASCII characters. Returns the number of columns the codepoint takes up in the terminal.
+uint8_t CodepointWidthDetector::_lookupGlyphWidth(const char32_t codepoint, const std::wstring_view& glyph) noexcept
+{
+    const auto width = lookupWidth(codepoint);
+    return width ? width : _checkFallbackViaCache(codepoint, glyph);
 }
 
 // Call the function specified via SetFallbackMethod() to turn CodepointWidth::Ambiguous into Narrow/Wide.
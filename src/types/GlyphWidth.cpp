@@ -25,6 +25,13 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return wch < 0x80 ? false : IsGlyphFullWidth({ &wch, 1 });
 }
 
+// Function Description:
+// - measures the width of each codepoint in the given text at once. See CodepointWidthDetector::GetWidths
+size_t GetGlyphWidths(const std::wstring_view& text, const std::span<uint8_t> widths) noexcept
+{
+    return widthDetector.GetWidths(text, widths);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
@@ -0,0 +1,750 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/GraphemeBreak.hpp"
+
+#include <til/unicode.h>
+
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26482) // Only index into arrays using constant expressions (bounds.2).
+
+using namespace Microsoft::Console;
+
+namespace
+{
+    // The Grapheme_Cluster_Break property, with the Indic_Conjunct_Break and Extended_Pictographic
+    // properties folded into it, since they're only ever relevant for Extend, ZWJ and Other codepoints.
+    // The order must match the values emitted by Generate-GraphemeBreakTableFromUCD.ps1.
+    enum class ClusterBreak : uint8_t
+    {
+        Other,
+        CR,
+        LF,
+        Control,
+        Extend, // Extend with InCB=None
+        ExtendInCB, // Extend with InCB=Extend
+        Linker, // Extend with InCB=Linker
+        ZWJ, // also InCB=Extend
+        RegionalIndicator,
+        Prepend,
+        SpacingMark,
+        L,
+        V,
+        T,
+        LV,
+        LVT,
+        ExtendedPictographic,
+        Consonant, // Other with InCB=Consonant
+    };
+
+    // Generated by Generate-GraphemeBreakTableFromUCD.ps1
+    // on 2026-10-19 from Unicode 16.0.0.
+    // A three stage lookup table for all codepoints below 0x20000:
+    //   s_stage3[s_stage2[s_stage1[cp >> 6] * 8 + (cp >> 3 & 7)] * 8 + (cp & 7)]
+    // All codepoints at or above 0x20000 are handled by lookup() below.
+    static constexpr uint8_t s_stage1[2048]{
+        0x00, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x04, 0x05, 0x03, 0x03,
+        0x03, 0x03, 0x06, 0x03, 0x03, 0x03, 0x07, 0x08, 0x09, 0x0a, 0x03, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+        0x30, 0x31, 0x32, 0x03, 0x33, 0x34, 0x35, 0x36, 0x03, 0x03, 0x03, 0x03, 0x03, 0x37, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x38, 0x39, 0x3a, 0x3b,
+        0x3c, 0x03, 0x3d, 0x03, 0x3e, 0x03, 0x03, 0x03, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+        0x47, 0x03, 0x03, 0x48, 0x03, 0x03, 0x03, 0x04, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x49, 0x4a, 0x03, 0x4b, 0x4c, 0x03, 0x4d, 0x03, 0x03, 0x03, 0x03, 0x03, 0x4e, 0x03, 0x4f, 0x50,
+        0x03, 0x03, 0x03, 0x51, 0x03, 0x03, 0x52, 0x53, 0x54, 0x55, 0x56, 0x55, 0x57, 0x58, 0x59, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x5a, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x5b, 0x5c, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x5d, 0x03, 0x5e, 0x03, 0x5f, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x60, 0x03, 0x61, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x62, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x63, 0x64, 0x65, 0x03, 0x03, 0x03, 0x03,
+        0x66, 0x03, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x03, 0x03, 0x03, 0x71,
+        0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73,
+        0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75,
+        0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+        0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72,
+        0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74,
+        0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76,
+        0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78,
+        0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73,
+        0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75,
+        0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+        0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x79, 0x7a,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x7b, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x7c, 0x03, 0x03, 0x01, 0x03, 0x03, 0x64, 0x7d,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x7e, 0x03, 0x03, 0x03, 0x7f, 0x03, 0x80, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x81, 0x03, 0x03, 0x82, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x83, 0x84, 0x03, 0x03, 0x03, 0x03, 0x85, 0x86, 0x03, 0x87, 0x88, 0x03,
+        0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x03, 0x93, 0x94, 0x95, 0x96, 0x97,
+        0x98, 0x99, 0x9a, 0x9b, 0x03, 0x03, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0x03, 0xa1, 0x03, 0x03, 0x03,
+        0xa2, 0x03, 0x03, 0x03, 0xa3, 0xa4, 0x03, 0xa5, 0xa6, 0xa7, 0xa8, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0xa9, 0x03, 0xaa, 0x03, 0xab, 0xac, 0xad, 0x03, 0x03, 0x03, 0x03, 0xae, 0xaf, 0xb0, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0xb1, 0xb2, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0xb3, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xb4, 0xb5, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0xb6, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xb7, 0xb8, 0xb9,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0xba, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xbb, 0xbc, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0xbd, 0xbe, 0x03, 0x03, 0xbf, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xc0, 0xc1, 0xc2, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0xc3, 0x03, 0xc4, 0x03, 0xb5, 0x03, 0x03, 0x03, 0x03, 0x03, 0xc5, 0xc6, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0xc6, 0x03, 0x03, 0x03, 0xc7, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0xc8, 0x03, 0xc9, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+        0x55, 0x55, 0x55, 0x55, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0x55, 0x55, 0x55, 0x55, 0x55, 0xd0,
+        0x55, 0x55, 0x55, 0x55, 0xd1, 0xd2, 0x55, 0x55, 0x55, 0xd3, 0x55, 0x55, 0x03, 0xd4, 0x03, 0xd5,
+        0xd6, 0xd7, 0xd8, 0x55, 0xd9, 0xda, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x03, 0x03, 0x03, 0x03,
+        0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0xd1,
+    };
+    static constexpr uint8_t s_stage2[1752]{
+        0x00, 0x01, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x03,
+        0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x02, 0x02,
+        0x06, 0x07, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x08, 0x05, 0x05, 0x05, 0x05, 0x09,
+        0x0a, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0b, 0x02, 0x05, 0x0c, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x06, 0x05, 0x05, 0x02, 0x02, 0x0d, 0x02, 0x02, 0x02, 0x0e, 0x0f, 0x10, 0x11, 0x02, 0x02,
+        0x02, 0x12, 0x13, 0x02, 0x02, 0x02, 0x05, 0x05, 0x05, 0x14, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x0e, 0x05, 0x0d, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x06, 0x15, 0x16,
+        0x02, 0x02, 0x0e, 0x17, 0x18, 0x19, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1a, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x1b, 0x05, 0x02, 0x02, 0x02, 0x02, 0x02, 0x1c, 0x05, 0x05, 0x1d, 0x05, 0x05, 0x05,
+        0x1e, 0x02, 0x1f, 0x20, 0x20, 0x20, 0x20, 0x21, 0x22, 0x23, 0x08, 0x20, 0x24, 0x02, 0x02, 0x20,
+        0x25, 0x02, 0x1f, 0x20, 0x20, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x24, 0x02, 0x2d, 0x2e,
+        0x2f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x30, 0x31, 0x32, 0x13, 0x02, 0x02, 0x02, 0x33, 0x02,
+        0x2f, 0x02, 0x1f, 0x20, 0x20, 0x26, 0x34, 0x35, 0x36, 0x37, 0x02, 0x02, 0x24, 0x02, 0x02, 0x38,
+        0x25, 0x02, 0x1f, 0x20, 0x20, 0x26, 0x34, 0x39, 0x29, 0x2a, 0x3a, 0x2c, 0x24, 0x02, 0x3b, 0x02,
+        0x3c, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x3d, 0x3e, 0x3f, 0x2b, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x40, 0x02, 0x1f, 0x20, 0x20, 0x26, 0x20, 0x39, 0x41, 0x42, 0x43, 0x44, 0x24, 0x02, 0x02, 0x02,
+        0x25, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x45, 0x46, 0x11, 0x43, 0x02, 0x24, 0x02, 0x47, 0x02,
+        0x48, 0x02, 0x1f, 0x20, 0x20, 0x20, 0x20, 0x49, 0x4a, 0x4b, 0x2b, 0x02, 0x24, 0x02, 0x02, 0x02,
+        0x25, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x4c, 0x4d, 0x4e, 0x02, 0x02, 0x4f, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x50, 0x14, 0x2b, 0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x50, 0x52, 0x02, 0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x07, 0x02, 0x02, 0x53, 0x54, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x08, 0x55,
+        0x56, 0x3a, 0x05, 0x08, 0x05, 0x05, 0x05, 0x52, 0x2e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x3a, 0x57, 0x58, 0x02, 0x02, 0x59, 0x5a, 0x0d, 0x02, 0x5b, 0x02,
+        0x5c, 0x16, 0x02, 0x16, 0x02, 0x02, 0x02, 0x02, 0x5d, 0x5d, 0x5d, 0x5d, 0x5d, 0x5d, 0x5d, 0x5d,
+        0x5d, 0x5d, 0x5d, 0x5d, 0x5e, 0x5e, 0x5e, 0x5e, 0x5e, 0x5e, 0x5e, 0x5e, 0x5e, 0x5f, 0x5f, 0x5f,
+        0x5f, 0x5f, 0x5f, 0x5f, 0x5f, 0x5f, 0x5f, 0x5f, 0x02, 0x02, 0x02, 0x3a, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x60, 0x02, 0x02, 0x02, 0x61, 0x02, 0x02, 0x02, 0x24, 0x02, 0x02, 0x02, 0x24, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x62, 0x63, 0x64, 0x22, 0x15, 0x16, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x65, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x43, 0x02, 0x02, 0x02, 0x02, 0x13, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x66, 0x67, 0x68, 0x69, 0x02, 0x02, 0x2b, 0x6a, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x6b, 0x51, 0x6c, 0x6d, 0x6e, 0x10, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x05, 0x05,
+        0x05, 0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x6f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x70, 0x63,
+        0x71, 0x02, 0x02, 0x02, 0x02, 0x06, 0x15, 0x02, 0x72, 0x02, 0x02, 0x02, 0x73, 0x74, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x3d, 0x75, 0x15, 0x02, 0x02, 0x02, 0x02, 0x02, 0x76, 0x77, 0x78, 0x02,
+        0x02, 0x02, 0x79, 0x05, 0x57, 0x7a, 0x7b, 0x07, 0x02, 0x7c, 0x02, 0x02, 0x02, 0x7d, 0x02, 0x7e,
+        0x02, 0x7f, 0x02, 0x02, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02, 0x05, 0x05, 0x05, 0x05, 0x0d, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x80, 0x02, 0x02, 0x7f, 0x02, 0x02, 0x81, 0x82, 0x02, 0x83, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x84, 0x02, 0x85, 0x02, 0x02, 0x02, 0x85, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x86, 0x02, 0x02, 0x02, 0x87, 0x88, 0x89, 0x80, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x84, 0x8a, 0x02, 0x85, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x8b,
+        0x8c, 0x8d, 0x8e, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d,
+        0x8f, 0x02, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8f, 0x8d, 0x90, 0x91, 0x7f, 0x85, 0x92, 0x02,
+        0x93, 0x94, 0x95, 0x02, 0x96, 0x02, 0x02, 0x02, 0x02, 0x02, 0x97, 0x02, 0x7f, 0x02, 0x85, 0x86,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x98, 0x02, 0x97, 0x02, 0x02, 0x92, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x99, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x2b, 0x07, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x2b, 0x02, 0x02, 0x02, 0x02, 0x05, 0x05, 0x05, 0x05,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x1c, 0x85, 0x91, 0x02, 0x02, 0x02, 0x9a, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x86, 0x7f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x2b, 0x79, 0x74,
+        0x02, 0x02, 0x02, 0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x07, 0x02,
+        0x9b, 0x9c, 0x02, 0x02, 0x9d, 0x9e, 0x02, 0x02, 0x9f, 0x02, 0x02, 0x02, 0x02, 0x02, 0x76, 0xa0,
+        0xa1, 0x02, 0x02, 0x02, 0x05, 0x05, 0x07, 0x2b, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x74, 0x02, 0x02,
+        0x2b, 0x05, 0xa2, 0x02, 0x5d, 0x5d, 0x5d, 0xa3, 0x1e, 0x02, 0x02, 0x02, 0x02, 0x02, 0xa4, 0xa5,
+        0x0d, 0x02, 0x02, 0x02, 0x16, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xa6, 0xa7, 0x02,
+        0x9c, 0xa8, 0x02, 0x02, 0x02, 0x02, 0x02, 0x9e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xa9, 0xaa,
+        0x13, 0x02, 0x02, 0x02, 0x02, 0xab, 0xac, 0x02, 0x02, 0x02, 0x02, 0x02, 0xad, 0xae, 0x02, 0x02,
+        0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0,
+        0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb1,
+        0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0,
+        0xb0, 0xaf, 0xb0, 0xb0, 0xb1, 0xb0, 0xb0, 0xb0, 0xb0, 0xaf, 0xb0, 0xb0, 0xb2, 0x02, 0x5e, 0x5e,
+        0xb3, 0xb4, 0x5f, 0x5f, 0x5f, 0x5f, 0x5f, 0xb5, 0x02, 0x02, 0x02, 0x2e, 0x02, 0x02, 0x02, 0x02,
+        0x05, 0x05, 0x02, 0x02, 0x05, 0x05, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0xb6,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x16, 0x02, 0x02, 0x02, 0x02, 0x0d, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x14, 0xb7, 0x70, 0x02, 0x02, 0x02, 0x02, 0x02, 0xb8,
+        0x02, 0x02, 0x02, 0x02, 0x43, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x70, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x19, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xb9, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x70, 0x0e, 0x05, 0x0d, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x60, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xba, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x05,
+        0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0xbb, 0x2b, 0x72, 0x02, 0x02, 0x02, 0x02, 0x02, 0xbc, 0xbd,
+        0x3c, 0xbe, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x14, 0x02, 0x02, 0x02, 0x2b, 0xbf, 0x52, 0x02,
+        0xc0, 0x02, 0x02, 0x02, 0x02, 0x02, 0x9c, 0x02, 0x72, 0x02, 0x02, 0x02, 0x02, 0x02, 0xc1, 0x55,
+        0xc2, 0xc3, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xc4, 0xc5, 0x2e,
+        0x13, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x2b, 0x6e, 0x14, 0x02, 0x02,
+        0x48, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xc6, 0xc7, 0xc8, 0x2b, 0x02, 0xc9, 0x52, 0x52, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xca, 0xcb, 0xcc, 0xcd, 0x02, 0x9a, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xce, 0x05, 0xcf, 0x02, 0x02, 0x2e, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xca, 0xd0, 0xd1, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x2b, 0xd2, 0xd3, 0x0d, 0x02, 0x02, 0xd4, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x6e, 0xd5, 0x0d, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0xd6, 0x05, 0x02, 0x02, 0x02, 0x02, 0xd7, 0xd8, 0x15, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0xc4, 0x05, 0xd9, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xda, 0xdb,
+        0xdc, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xdd, 0xde, 0xdf, 0x02, 0x02, 0x02,
+        0x08, 0x14, 0x02, 0x02, 0x02, 0x02, 0x06, 0xe0, 0x2b, 0x02, 0xa6, 0x69, 0x02, 0x02, 0x02, 0x02,
+        0xe1, 0xe2, 0x55, 0x07, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xe3, 0x51, 0xe4,
+        0x02, 0x02, 0x1c, 0x05, 0x05, 0xe5, 0xe6, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xe7, 0xe8,
+        0xe9, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xea, 0xeb, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0xec, 0x02, 0xed, 0x02, 0x02, 0x02, 0x02, 0x02, 0xee, 0xef,
+        0x14, 0x02, 0x02, 0x3c, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0x00,
+        0xf0, 0x05, 0x74, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x05, 0xf1, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x52, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x51, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0xf2, 0xf3, 0x02, 0x02, 0x02, 0x2b, 0xf4, 0xa0, 0xa0, 0xa0, 0xa0, 0xa0,
+        0xa0, 0x2b, 0x14, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x9e, 0x02, 0x07, 0x02,
+        0x02, 0x02, 0x02, 0x43, 0xb6, 0x02, 0x02, 0x02, 0x05, 0x05, 0x05, 0x05, 0x05, 0x74, 0x05, 0x05,
+        0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x3a, 0xf5, 0xf6, 0xf7,
+        0xf8, 0x15, 0x02, 0x02, 0x02, 0x60, 0x02, 0x02, 0x61, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x51, 0x06, 0x05, 0x05, 0x05, 0x05, 0x05, 0x52, 0x16, 0x02,
+        0x9e, 0x02, 0x02, 0x06, 0x08, 0x05, 0x02, 0x02, 0x51, 0x05, 0x05, 0xf9, 0xfa, 0x14, 0x02, 0x02,
+        0x02, 0x2b, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x2e, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x70, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x02, 0x02,
+        0x02, 0x02, 0x51, 0x02, 0x02, 0x02, 0x02, 0x02, 0x70, 0x14, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x97, 0x02, 0x02, 0x02, 0x86, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x81, 0x82, 0xfb,
+        0x02, 0x8a, 0x87, 0x89, 0x02, 0x97, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0xfc, 0xfd, 0xfd, 0xfd,
+        0x87, 0x8d, 0x02, 0x80, 0x02, 0x86, 0xfe, 0x8e, 0x02, 0x87, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d,
+        0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0xff, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8f,
+        0xfb, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x81, 0x8d, 0x02, 0x02, 0x97, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d,
+        0x02, 0x81, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x8d, 0x02, 0xfe, 0x02, 0x02, 0x02, 0x02,
+        0x02, 0x8d, 0x02, 0x02, 0x02, 0xfb, 0x8d, 0x8d, 0x02, 0x81, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8e,
+        0x8c, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d, 0x8d,
+    };
+    static constexpr uint8_t s_stage3[2048]{
+        0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x02, 0x03, 0x03, 0x01, 0x03, 0x03,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+        0x00, 0x10, 0x00, 0x00, 0x00, 0x03, 0x10, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x05,
+        0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x00, 0x05, 0x09, 0x09, 0x09, 0x09, 0x09, 0x09, 0x00, 0x00,
+        0x05, 0x05, 0x05, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x09, 0x00, 0x05,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00,
+        0x00, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x09, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+        0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x09, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x05, 0x0a, 0x05, 0x00, 0x0a, 0x0a,
+        0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x0a, 0x0a,
+        0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x11, 0x00, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x00, 0x11, 0x00, 0x00, 0x00, 0x11, 0x11,
+        0x11, 0x11, 0x00, 0x00, 0x05, 0x00, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x0a,
+        0x0a, 0x00, 0x00, 0x0a, 0x0a, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x00, 0x11, 0x11, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x05, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05,
+        0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00,
+        0x11, 0x00, 0x11, 0x11, 0x00, 0x11, 0x11, 0x11, 0x11, 0x11, 0x00, 0x00, 0x05, 0x00, 0x0a, 0x0a,
+        0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x0a, 0x00, 0x0a, 0x0a, 0x06, 0x00, 0x00,
+        0x00, 0x11, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x11, 0x11, 0x00, 0x00, 0x05, 0x00, 0x05, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a,
+        0x05, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x00, 0x0a, 0x0a, 0x0a, 0x05, 0x00, 0x00,
+        0x05, 0x0a, 0x0a, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x00, 0x05, 0x05,
+        0x05, 0x00, 0x05, 0x05, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00,
+        0x11, 0x11, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0a, 0x05,
+        0x05, 0x0a, 0x05, 0x0a, 0x0a, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x05, 0x05, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x11, 0x05, 0x05, 0x00, 0x05, 0x0a,
+        0x0a, 0x05, 0x05, 0x05, 0x05, 0x00, 0x0a, 0x0a, 0x0a, 0x00, 0x0a, 0x0a, 0x0a, 0x06, 0x09, 0x00,
+        0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x00, 0x05, 0x00,
+        0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x00, 0x00, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x05, 0x00, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x05,
+        0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x00, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a,
+        0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x05, 0x00, 0x0a, 0x05, 0x05, 0x00, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d,
+        0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a,
+        0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x03, 0x05,
+        0x05, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x0a, 0x0a, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00,
+        0x05, 0x0a, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x05, 0x0a,
+        0x05, 0x00, 0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x0a,
+        0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00,
+        0x05, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x05, 0x0a, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x0a,
+        0x00, 0x00, 0x00, 0x03, 0x04, 0x07, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x00,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x10, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,
+        0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10,
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x10,
+        0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10,
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+        0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00,
+        0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x05, 0x05, 0x0a,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x00, 0x00,
+        0x05, 0x05, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x0a, 0x0a,
+        0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x00, 0x00, 0x05, 0x00, 0x05, 0x05, 0x05, 0x00, 0x00, 0x05,
+        0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x0a, 0x05, 0x05, 0x0a, 0x0a,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x05, 0x0a, 0x0a,
+        0x05, 0x0a, 0x0a, 0x00, 0x0a, 0x05, 0x00, 0x00, 0x0e, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
+        0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0e, 0x0f, 0x0f, 0x0f,
+        0x0f, 0x0f, 0x0f, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x0c, 0x00,
+        0x00, 0x00, 0x00, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x0d, 0x00, 0x00, 0x00, 0x00,
+        0x03, 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x00, 0x05, 0x05, 0x00,
+        0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00,
+        0x0a, 0x05, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00,
+        0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x09, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x05, 0x05, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x05, 0x05,
+        0x05, 0x00, 0x09, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x0a, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05,
+        0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x05, 0x0a, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x0a,
+        0x0a, 0x00, 0x00, 0x0a, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x00, 0x00, 0x05, 0x05,
+        0x05, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x05, 0x00, 0x00, 0x05, 0x00, 0x05,
+        0x05, 0x05, 0x0a, 0x00, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x09, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x0a, 0x05, 0x00,
+        0x05, 0x0a, 0x05, 0x0a, 0x0a, 0x05, 0x0a, 0x05, 0x05, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00,
+        0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x0a, 0x05,
+        0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x05, 0x0a, 0x05,
+        0x00, 0x00, 0x00, 0x05, 0x0a, 0x05, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x05,
+        0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x05, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x00, 0x0a, 0x0a, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x09,
+        0x0a, 0x09, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05,
+        0x00, 0x00, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+        0x05, 0x0a, 0x09, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x09, 0x09, 0x09,
+        0x09, 0x09, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+        0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x0a, 0x05, 0x00, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x0a, 0x05, 0x05, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00,
+        0x00, 0x00, 0x05, 0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x09, 0x05,
+        0x00, 0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x00, 0x05, 0x05, 0x00, 0x0a, 0x0a, 0x05, 0x0a, 0x05,
+        0x00, 0x00, 0x00, 0x05, 0x05, 0x0a, 0x0a, 0x00, 0x05, 0x05, 0x09, 0x0a, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x0a, 0x0a, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x0a, 0x0a,
+        0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x05,
+        0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x0c, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x05, 0x05, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x05, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x05, 0x05, 0x05, 0x05, 0x05,
+        0x05, 0x05, 0x00, 0x05, 0x05, 0x00, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+        0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x05, 0x05, 0x05, 0x05, 0x05,
+    };
+
+    constexpr ClusterBreak lookup(const char32_t cp) noexcept
+    {
+        if (cp < 0x20000)
+        {
+            const auto s1 = s_stage1[cp >> 6];
+            const auto s2 = s_stage2[s1 * 8 + (cp >> 3 & 7)];
+            return static_cast<ClusterBreak>(s_stage3[s2 * 8 + (cp & 7)]);
+        }
+        // Tags and variation selectors supplement.
+        if ((cp >= 0xE0020 && cp <= 0xE007F) || (cp >= 0xE0100 && cp <= 0xE01EF))
+        {
+            return ClusterBreak::ExtendInCB;
+        }
+        if (cp >= 0xE0000 && cp <= 0xE0FFF)
+        {
+            return ClusterBreak::Control;
+        }
+        return ClusterBreak::Other;
+    }
+
+    constexpr bool isControl(const ClusterBreak cb) noexcept
+    {
+        return cb == ClusterBreak::CR || cb == ClusterBreak::LF || cb == ClusterBreak::Control;
+    }
+
+    constexpr bool isExtend(const ClusterBreak cb) noexcept
+    {
+        return cb == ClusterBreak::Extend || cb == ClusterBreak::ExtendInCB || cb == ClusterBreak::Linker;
+    }
+
+    // Implements the rules GB3 to GB9b, which only depend on the two codepoints around a potential boundary.
+    // Returns true if there's no boundary between them.
+    constexpr bool joinsPairwise(const ClusterBreak lhs, const ClusterBreak rhs) noexcept
+    {
+        // GB3
+        if (lhs == ClusterBreak::CR && rhs == ClusterBreak::LF)
+        {
+            return true;
+        }
+        // GB4, GB5
+        if (isControl(lhs) || isControl(rhs))
+        {
+            return false;
+        }
+        // GB6, GB7, GB8
+        switch (lhs)
+        {
+        case ClusterBreak::L:
+            if (rhs == ClusterBreak::L || rhs == ClusterBreak::V || rhs == ClusterBreak::LV || rhs == ClusterBreak::LVT)
+            {
+                return true;
+            }
+            break;
+        case ClusterBreak::V:
+        case ClusterBreak::LV:
+            if (rhs == ClusterBreak::V || rhs == ClusterBreak::T)
+            {
+                return true;
+            }
+            break;
+        case ClusterBreak::T:
+        case ClusterBreak::LVT:
+            if (rhs == ClusterBreak::T)
+            {
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+        // GB9, GB9a, GB9b
+        return isExtend(rhs) || rhs == ClusterBreak::ZWJ || rhs == ClusterBreak::SpacingMark || lhs == ClusterBreak::Prepend;
+    }
+
+    // Returns true if the boundary between lhs and rhs is decided by joinsPairwise() alone.
+    // The remaining rules (GB9c, GB11, GB12 and GB13) need to look further back.
+    constexpr bool isContextFree(const ClusterBreak lhs, const ClusterBreak rhs) noexcept
+    {
+        switch (rhs)
+        {
+        case ClusterBreak::Consonant:
+            return lhs != ClusterBreak::ExtendInCB && lhs != ClusterBreak::Linker && lhs != ClusterBreak::ZWJ;
+        case ClusterBreak::ExtendedPictographic:
+            return lhs != ClusterBreak::ZWJ;
+        case ClusterBreak::RegionalIndicator:
+            return lhs != ClusterBreak::RegionalIndicator;
+        default:
+            return true;
+        }
+    }
+
+    // Trivial code units always form a cluster of their own, as long as they aren't followed by a non-trivial one.
+    // This covers everything below U+0300 (except for CR, because of CR LF), CJK ideographs and Hangul syllables.
+    constexpr bool isTrivial(const wchar_t wch) noexcept
+    {
+        return (wch < 0x300 && wch != L'\r') || (wch - 0x3400u) < 0x6c00u || (wch - 0xac00u) < 0x2ba4u;
+    }
+
+    // Decodes the codepoint at text[offset] and returns its property. len receives its length in code units.
+    constexpr ClusterBreak decode(const wchar_t* data, const size_t size, const size_t offset, size_t& len) noexcept
+    {
+        const auto wch = data[offset];
+        len = 1;
+
+        if (til::is_surrogate(wch))
+        {
+            if (til::is_leading_surrogate(wch) && offset + 1 < size && til::is_trailing_surrogate(data[offset + 1]))
+            {
+                len = 2;
+                return lookup(til::combine_surrogates(wch, data[offset + 1]));
+            }
+            // Unpaired surrogates are treated like U+FFFD would be in a terminal: A broken
+            // character that we don't want to combine with anything. Control does just that.
+            return ClusterBreak::Control;
+        }
+
+        return lookup(wch);
+    }
+}
+
+size_t GraphemeBreak::Next(const std::wstring_view& text, const size_t offset) noexcept
+{
+    const auto data = text.data();
+    const auto size = text.size();
+
+    if (offset >= size)
+    {
+        return size;
+    }
+
+    // Fast-path: Two trivial code units in a row.
+    if (offset + 1 >= size || (isTrivial(data[offset]) && isTrivial(data[offset + 1])))
+    {
+        return offset + 1;
+    }
+
+    size_t len;
+    auto prev = decode(data, size, offset, len);
+    auto pos = offset + len;
+
+    // GB9c: 0 = not in a conjunct, 1 = after Consonant [Extend Linker]*, 2 = the same with at least one Linker.
+    int conjunct = prev == ClusterBreak::Consonant ? 1 : 0;
+    // GB11: 0 = not in an emoji sequence, 1 = after ExtPict Extend*, 2 = after ExtPict Extend* ZWJ.
+    int emoji = prev == ClusterBreak::ExtendedPictographic ? 1 : 0;
+    // GB12, GB13: The number of consecutive regional indicators we've seen.
+    size_t regionalIndicators = prev == ClusterBreak::RegionalIndicator ? 1 : 0;
+
+    while (pos < size)
+    {
+        const auto next = decode(data, size, pos, len);
+
+        auto joins = joinsPairwise(prev, next);
+        if (!joins)
+        {
+            switch (next)
+            {
+            case ClusterBreak::Consonant:
+                joins = conjunct == 2;
+                break;
+            case ClusterBreak::ExtendedPictographic:
+                joins = emoji == 2;
+                break;
+            case ClusterBreak::RegionalIndicator:
+                joins = (regionalIndicators & 1) != 0;
+                break;
+            default:
+                break;
+            }
+            if (!joins)
+            {
+                break;
+            }
+        }
+
+        switch (next)
+        {
+        case ClusterBreak::Consonant:
+            conjunct = 1;
+            break;
+        case ClusterBreak::Linker:
+            conjunct = conjunct ? 2 : 0;
+            break;
+        case ClusterBreak::ExtendInCB:
+        case ClusterBreak::ZWJ:
+            break;
+        default:
+            conjunct = 0;
+            break;
+        }
+
+        switch (next)
+        {
+        case ClusterBreak::ExtendedPictographic:
+            emoji = 1;
+            break;
+        case ClusterBreak::Extend:
+        case ClusterBreak::ExtendInCB:
+        case ClusterBreak::Linker:
+            emoji = emoji == 1 ? 1 : 0;
+            break;
+        case ClusterBreak::ZWJ:
+            emoji = emoji == 1 ? 2 : 0;
+            break;
+        default:
+            emoji = 0;
+            break;
+        }
+
+        regionalIndicators = next == ClusterBreak::RegionalIndicator ? regionalIndicators + 1 : 0;
+        prev = next;
+        pos += len;
+    }
+
+    return pos;
+}
+
+size_t GraphemeBreak::NextBounded(const std::wstring_view& text, const size_t offset, const size_t maxLength) noexcept
+{
+    // Clusters never extend past the end of the text and all rules only look at what precedes a boundary,
+    // so segmenting a prefix of the text yields the same boundaries up to the prefix' end. If the prefix ends
+    // in the middle of a surrogate pair, decode() sees an unpaired surrogate, which is always a cluster of its own.
+    return Next(text.substr(0, offset + maxLength), offset);
+}
+
+size_t GraphemeBreak::Prev(const std::wstring_view& text, size_t offset) noexcept
+{
+    const auto data = text.data();
+    const auto size = text.size();
+
+    offset = std::min(offset, size);
+    if (offset == 0)
+    {
+        return 0;
+    }
+
+    // Fast-path: Two trivial code units in a row.
+    if (offset == 1 || (isTrivial(data[offset - 2]) && isTrivial(data[offset - 1])))
+    {
+        return offset - 1;
+    }
+
+    // Walk backwards until we find a boundary that doesn't depend on any preceding text.
+    // Ideally that's the one right before offset, but for instance within a sequence of regional indicators we have
+    // to go back to its start in order to count them. From there we segment forward with Next() until we reach offset.
+    auto start = offset - 1;
+    if (til::is_trailing_surrogate(data[start]) && start != 0 && til::is_leading_surrogate(data[start - 1]))
+    {
+        --start;
+    }
+
+    size_t len;
+    auto next = decode(data, size, start, len);
+
+    while (start != 0)
+    {
+        auto beg = start - 1;
+        if (til::is_trailing_surrogate(data[beg]) && beg != 0 && til::is_leading_surrogate(data[beg - 1]))
+        {
+            --beg;
+        }
+
+        const auto prev = decode(data, size, beg, len);
+        if (!joinsPairwise(prev, next) && isContextFree(prev, next))
+        {
+            break;
+        }
+
+        start = beg;
+        next = prev;
+    }
+
+    for (;;)
+    {
+        const auto end = Next(text, start);
+        if (end >= offset)
+        {
+            return start;
+        }
+        start = end;
+    }
+}
+
+size_t GraphemeBreak::SkipTrivial(const std::wstring_view& text, const size_t offset) noexcept
+{
+    const auto data = text.data();
+    const auto size = text.size();
+    auto i = offset;
+
+    if (i >= size)
+    {
+        return size;
+    }
+
+#if defined(TIL_SSE_INTRINSICS)
+    // _mm_subs_epu16(x, n) is zero if x <= n, which is how we do unsigned 16-bit comparisons in SSE2.
+    const auto zero = _mm_setzero_si128();
+    for (; size - i >= 8; i += 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto latin = _mm_cmpeq_epi16(_mm_subs_epu16(wch, _mm_set1_epi16(0x2ff)), zero);
+        const auto cr = _mm_cmpeq_epi16(wch, _mm_set1_epi16(static_cast<short>(L'\r')));
+        const auto han = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(wch, _mm_set1_epi16(0x3400)), _mm_set1_epi16(0x6bff)), zero);
+        const auto hangul = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(wch, _mm_set1_epi16(static_cast<short>(0xac00))), _mm_set1_epi16(0x2ba3)), zero);
+        const auto trivial = _mm_or_si128(_mm_andnot_si128(cr, latin), _mm_or_si128(han, hangul));
+        if (_mm_movemask_epi8(trivial) != 0xffff)
+        {
+            break;
+        }
+    }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    for (; size - i >= 8; i += 8)
+    {
+        const auto wch = vld1q_u16(reinterpret_cast<const uint16_t*>(data + i));
+        const auto latin = vbicq_u16(vcleq_u16(wch, vdupq_n_u16(0x2ff)), vceqq_u16(wch, vdupq_n_u16(L'\r')));
+        const auto han = vcleq_u16(vsubq_u16(wch, vdupq_n_u16(0x3400)), vdupq_n_u16(0x6bff));
+        const auto hangul = vcleq_u16(vsubq_u16(wch, vdupq_n_u16(0xac00)), vdupq_n_u16(0x2ba3));
+        const auto nonTrivial = vmovn_u16(vmvnq_u16(vorrq_u16(latin, vorrq_u16(han, hangul))));
+        if (vget_lane_u64(vreinterpret_u64_u8(nonTrivial), 0))
+        {
+            break;
+        }
+    }
+#endif
+
+    for (; i < size && isTrivial(data[i]); ++i)
+    {
+    }
+
+    // The last trivial code unit may still be the start of a longer cluster, like "e" followed by U+0301.
+    return i == size || i == offset ? i : i - 1;
+}
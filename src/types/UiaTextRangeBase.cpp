@@ -14,6 +14,87 @@ static constexpr long _RemoveAlpha(COLORREF color) noexcept
     return color & 0x00ffffff;
 }
 
+// Calls func(y, begin, end, attr) for each run of cells [begin, end) on row y that share the same attributes.
+// The cells from first to last (inclusive) are visited in the same order a TextBufferCellIterator restricted
+// to bounds would visit them, or in the reverse order if backwards is true. func returns false to stop early.
+// This makes attribute queries scale with the number of attribute changes instead of the number of cells.
+template<typename Func>
+static void _forEachAttributeRun(const TextBuffer& buffer, const Viewport& bounds, const til::point first, const til::point last, const bool backwards, Func&& func)
+{
+    const auto left = bounds.Left();
+    const auto right = bounds.RightExclusive();
+
+    const auto visitRow = [&](const til::CoordType y) {
+        const auto begin = std::clamp(y == first.y ? first.x : left, left, right);
+        const auto end = std::clamp(y == last.y ? last.x + 1 : right, left, right);
+        if (begin >= end)
+        {
+            return true;
+        }
+
+        const auto& row = buffer.GetRowByOffset(y);
+        const auto& table = row.AttributeTable();
+        const auto& attributes = row.Attributes();
+        const auto& runs = attributes.runs();
+
+        if (!backwards)
+        {
+            til::CoordType runBegin = 0;
+            for (const auto& run : runs)
+            {
+                const auto runEnd = runBegin + run.length;
+                if (runEnd > begin)
+                {
+                    if (!func(y, std::max(runBegin, begin), std::min(runEnd, end), table.Get(run.value)))
+                    {
+                        return false;
+                    }
+                    if (runEnd >= end)
+                    {
+                        break;
+                    }
+                }
+                runBegin = runEnd;
+            }
+        }
+        else
+        {
+            til::CoordType runEnd = attributes.size();
+            for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+            {
+                const auto runBegin = runEnd - it->length;
+                if (runBegin < end)
+                {
+                    if (!func(y, std::max(runBegin, begin), std::min(runEnd, end), table.Get(it->value)))
+                    {
+                        return false;
+                    }
+                    if (runBegin <= begin)
+                    {
+                        break;
+                    }
+                }
+                runEnd = runBegin;
+            }
+        }
+
+        return true;
+    };
+
+    if (!backwards)
+    {
+        for (auto y = first.y; y <= last.y && visitRow(y); ++y)
+        {
+        }
+    }
+    else
+    {
+        for (auto y = last.y; y >= first.y && visitRow(y); --y)
+        {
+        }
+    }
+}
+
 // degenerate range constructor.
 #pragma warning(suppress : 26434) // WRL RuntimeClassInitialize base is a no-op and we need this for MakeAndInitialize
 HRESULT UiaTextRangeBase::RuntimeClassInitialize(_In_ Render::IRenderData* pData, _In_ IRawElementProviderSimple* const pProvider, _In_ std::wstring_view wordDelimiters) noexcept
@@ -496,8 +577,8 @@ try
 
     // Get some useful variables
     const auto& buffer{ _pData->GetTextBuffer() };
-    const auto bufferSize{ buffer.GetSize() };
     const auto inclusiveEnd{ _getInclusiveEnd() };
+    const auto viewportRange{ _getAttrQueryBounds(inclusiveEnd) };
 
     // Start/End for the resulting range.
     // NOTE: we store these as "first" and "second" anchor because,
@@ -505,75 +586,27 @@ try
     //       We'll do some post-processing to fix this on the way out.
     std::optional<til::point> resultFirstAnchor;
     std::optional<til::point> resultSecondAnchor;
-    const auto attemptUpdateAnchors = [=, &resultFirstAnchor, &resultSecondAnchor](const TextBufferCellIterator iter) {
-        const auto attrFound{ _verifyAttr(attributeId, val, iter->TextAttr()).value() };
-        if (attrFound)
-        {
-            // populate the first anchor if it's not populated.
-            // otherwise, populate the second anchor.
-            if (!resultFirstAnchor.has_value())
-            {
-                resultFirstAnchor = iter.Pos();
-                resultSecondAnchor = iter.Pos();
-            }
-            else
-            {
-                resultSecondAnchor = iter.Pos();
-            }
-        }
-        return attrFound;
-    };
-
-    // Start/End for the direction to perform the search in
-    // We need searchEnd to be exclusive. This allows the for-loop below to
-    // iterate up until the exclusive searchEnd, and not attempt to read the
-    // data at that position.
-    const auto searchStart{ searchBackwards ? inclusiveEnd : _start };
-    const auto searchEndInclusive{ searchBackwards ? _start : inclusiveEnd };
-    auto searchEndExclusive{ searchEndInclusive };
-    if (searchBackwards)
-    {
-        bufferSize.DecrementInBounds(searchEndExclusive, true);
-    }
-    else
-    {
-        bufferSize.IncrementInBounds(searchEndExclusive, true);
-    }
 
-    // Iterate from searchStart to searchEnd in the buffer.
+    // Walk the range in the search direction one attribute run at a time.
     // If we find the attribute we're looking for, we update resultFirstAnchor/SecondAnchor appropriately.
-#pragma warning(suppress : 26496) // TRANSITIONAL: false positive in VS 16.11
-    auto viewportRange{ bufferSize };
-    if (_blockRange)
-    {
-        const auto originX{ std::min(_start.x, inclusiveEnd.x) };
-        const auto originY{ std::min(_start.y, inclusiveEnd.y) };
-        const auto width{ std::abs(inclusiveEnd.x - _start.x + 1) };
-        const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
-        viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
-    }
-    auto iter{ buffer.GetCellDataAt(searchStart, viewportRange) };
-    const auto iterStep{ searchBackwards ? -1 : 1 };
-    for (; iter && iter.Pos() != searchEndExclusive; iter += iterStep)
-    {
-        if (!attemptUpdateAnchors(iter) && resultFirstAnchor.has_value() && resultSecondAnchor.has_value())
+    _forEachAttributeRun(buffer, viewportRange, _start, inclusiveEnd, searchBackwards, [&](const til::CoordType y, const til::CoordType begin, const til::CoordType end, const TextAttribute& attr) {
+        if (!_verifyAttr(attributeId, val, attr).value())
         {
-            // Exit the loop early if...
-            // - the cell we're looking at doesn't have the attr we're looking for
-            // - the anchors have been populated
+            // Exit the loop early if the anchors have been populated.
             // This means that we've found a contiguous range where the text attribute was found.
             // No point in searching through the rest of the search space.
-            // TLDR: keep updating the second anchor and make the range wider until the attribute changes.
-            break;
+            return !resultFirstAnchor.has_value();
         }
-    }
 
-    // Corner case: we couldn't actually move the searchEnd to make it exclusive
-    // (i.e. DecrementInBounds on Origin doesn't move it)
-    if (searchEndInclusive == searchEndExclusive)
-    {
-        attemptUpdateAnchors(iter);
-    }
+        // populate the first anchor if it's not populated.
+        // otherwise, keep making the range wider until the attribute changes.
+        if (!resultFirstAnchor.has_value())
+        {
+            resultFirstAnchor = til::point{ searchBackwards ? end - 1 : begin, y };
+        }
+        resultSecondAnchor = til::point{ searchBackwards ? begin : end - 1, y };
+        return true;
+    });
 
     // If a result was found, populate ppRetVal with the UiaTextRange
     // representing the found selection anchors.
@@ -799,34 +832,22 @@ try
         return E_INVALIDARG;
     }
 
-    // Get some useful variables
-    const auto& buffer{ _pData->GetTextBuffer() };
-    const auto bufferSize{ buffer.GetSize() };
+    // Check if the entire text range has that text attribute
     const auto inclusiveEnd{ _getInclusiveEnd() };
+    auto mixed = false;
+    _forEachAttributeRun(_pData->GetTextBuffer(), _getAttrQueryBounds(inclusiveEnd), _start, inclusiveEnd, false, [&](auto, auto, auto, const TextAttribute& attr) {
+        mixed = !_verifyAttr(attributeId, *pRetVal, attr).value();
+        return !mixed;
+    });
 
-    // Check if the entire text range has that text attribute
-#pragma warning(suppress : 26496) // TRANSITIONAL: false positive in VS 16.11
-    auto viewportRange{ bufferSize };
-    if (_blockRange)
+    if (mixed)
     {
-        const auto originX{ std::min(_start.x, inclusiveEnd.x) };
-        const auto originY{ std::min(_start.y, inclusiveEnd.y) };
-        const auto width{ std::abs(inclusiveEnd.x - _start.x + 1) };
-        const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
-        viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
-    }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
-    {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
-        {
-            // The value of the specified attribute varies over the text range
-            // return UiaGetReservedMixedAttributeValue.
-            // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
-            pRetVal->vt = VT_UNKNOWN;
-            UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
-            return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
-        }
+        // The value of the specified attribute varies over the text range
+        // return UiaGetReservedMixedAttributeValue.
+        // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
+        pRetVal->vt = VT_UNKNOWN;
+        UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
+        return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
     }
 
     UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal);
@@ -1755,3 +1776,19 @@ til::point UiaTextRangeBase::_getInclusiveEnd() const noexcept
     _pData->GetTextBuffer().GetSize().DecrementInBounds(result, true);
     return result;
 }
+
+// Returns the area that FindAttribute() and GetAttributeValue() are restricted to:
+// The entire buffer, or the rectangle spanned by the endpoints for block ranges.
+Viewport UiaTextRangeBase::_getAttrQueryBounds(const til::point inclusiveEnd) const noexcept
+{
+    if (!_blockRange)
+    {
+        return _pData->GetTextBuffer().GetSize();
+    }
+
+    const auto originX{ std::min(_start.x, inclusiveEnd.x) };
+    const auto originY{ std::min(_start.y, inclusiveEnd.y) };
+    const auto width{ std::abs(inclusiveEnd.x - _start.x + 1) };
+    const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
+    return Viewport::FromDimensions({ originX, originY }, width, height);
+}
@@ -181,6 +181,7 @@ namespace Microsoft::Console::Types
         bool _tryMoveToWordStart(const TextBuffer& buffer, const til::point documentEnd, til::point& resultingPos) const;
 
         til::point _getInclusiveEnd() const noexcept;
+        Viewport _getAttrQueryBounds(til::point inclusiveEnd) const noexcept;
 
 #ifdef UNIT_TESTING
         friend class ::UiaTextRangeTests;
@@ -20,6 +20,7 @@ class CodepointWidthDetector final
 {
 public:
     CodepointWidth GetWidth(const std::wstring_view& glyph) noexcept;
+    size_t GetWidths(const std::wstring_view& text, std::span<uint8_t> widths) noexcept;
     bool IsWide(const std::wstring_view& glyph) noexcept;
     void SetFallbackMethod(std::function<bool(const std::wstring_view&)> pfnFallback) noexcept;
     void NotifyFontChanged() noexcept;
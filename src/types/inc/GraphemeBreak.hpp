@@ -0,0 +1,37 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- GraphemeBreak.hpp
+
+Abstract:
+- Splits UTF-16 text into extended grapheme clusters according to UAX #29 ("Unicode Text Segmentation").
+- The properties of each codepoint are stored in compact tables generated by tools/Generate-GraphemeBreakTableFromUCD.ps1.
+- Unpaired surrogates are treated like control characters and thus always form a cluster of their own.
+--*/
+
+#pragma once
+
+#include <string_view>
+
+namespace Microsoft::Console::GraphemeBreak
+{
+    // Returns the end of the grapheme cluster that starts at `offset`, which must be a cluster boundary.
+    // Returns text.size() if offset is at or past the end of the text.
+    size_t Next(const std::wstring_view& text, size_t offset) noexcept;
+
+    // Like Next(), but ends the cluster after at most `maxLength` code units (which must be at least 2),
+    // without splitting a surrogate pair. UAX #29 puts no limit on the length of a cluster, but storage for it
+    // is finite. The remainder can be passed to this function again and will form clusters of its own.
+    size_t NextBounded(const std::wstring_view& text, size_t offset, size_t maxLength) noexcept;
+
+    // Returns the start of the grapheme cluster that precedes `offset`. If `offset` isn't a cluster boundary,
+    // this is the start of the cluster `offset` is in. Returns 0 if offset is 0.
+    size_t Prev(const std::wstring_view& text, size_t offset) noexcept;
+
+    // Returns the end of the run starting at `offset` in which every code unit is known to be a grapheme
+    // cluster of its own (ASCII, Latin-1, CJK ideographs, Hangul syllables and so on), without looking up
+    // any properties. Useful as a fast path before falling back to Next(). The return value is a boundary.
+    size_t SkipTrivial(const std::wstring_view& text, size_t offset) noexcept;
+}
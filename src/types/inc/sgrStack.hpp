@@ -28,12 +28,15 @@ namespace Microsoft::Console::VirtualTerminal
         // - Saves the specified text attributes onto an internal stack.
         // Arguments:
         // - currentAttributes - The attributes to save onto the stack.
+        // - hyperlinkUri - The URI of the hyperlink in currentAttributes, if any.
+        //   The stack doesn't hold a reference to the hyperlink, so see Pop().
         // - options - If none supplied, the full attributes are saved. Else only the
         //   specified parts of currentAttributes are saved.
         // Return Value:
         // - <none>
         void Push(const TextAttribute& currentAttributes,
-                  const VTParameters options) noexcept;
+                  const std::wstring_view hyperlinkUri,
+                  const VTParameters options);
 
         // Method Description:
         // - Restores text attributes by removing from the top of the internal stack,
@@ -42,10 +45,13 @@ namespace Microsoft::Console::VirtualTerminal
         // - currentAttributes - The current text attributes. If only a portion of
         //   attributes were saved on the internal stack, then those attributes will be
         //   combined with the currentAttributes passed in to form the return value.
+        // - hyperlinkUri - Receives the URI that was saved along with the hyperlink if it
+        //   gets restored, so that the caller can check that its ID still refers to it.
+        //   It's empty if the hyperlink of currentAttributes is kept.
         // Return Value:
         // - The TextAttribute that has been removed from the top of the stack, possibly
         //   combined with currentAttributes.
-        const TextAttribute Pop(const TextAttribute& currentAttributes) noexcept;
+        const TextAttribute Pop(const TextAttribute& currentAttributes, std::wstring& hyperlinkUri) noexcept;
 
         // Xterm allows the save stack to go ten deep, so we'll follow suit.
         static constexpr int c_MaxStoredSgrPushes = 10;
@@ -60,6 +66,7 @@ namespace Microsoft::Console::VirtualTerminal
         struct SavedSgrAttributes
         {
             TextAttribute TextAttributes;
+            std::wstring HyperlinkUri; // only set if TextAttributes is a hyperlink that's restored in full
             AttrBitset ValidParts; // flags that indicate which parts of TextAttributes are meaningful
         };
 
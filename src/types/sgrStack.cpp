@@ -15,7 +15,8 @@ namespace Microsoft::Console::VirtualTerminal
     }
 
     void SgrStack::Push(const TextAttribute& currentAttributes,
-                        const VTParameters options) noexcept
+                        const std::wstring_view hyperlinkUri,
+                        const VTParameters options)
     {
         AttrBitset validParts;
 
@@ -45,17 +46,26 @@ namespace Microsoft::Console::VirtualTerminal
             }
         }
 
+        // Partial pushes never restore the hyperlink, so there's no need to hold on to its URI.
+        std::wstring savedUri;
+        if (currentAttributes.IsHyperlink() && validParts.test(SgrSaveRestoreStackOptions::All))
+        {
+            savedUri = hyperlinkUri;
+        }
+
         if (_numSavedAttrs < gsl::narrow<int>(_storedSgrAttributes.size()))
         {
             _numSavedAttrs++;
         }
 
-        _storedSgrAttributes.at(_nextPushIndex) = { currentAttributes, validParts };
+        _storedSgrAttributes.at(_nextPushIndex) = { currentAttributes, std::move(savedUri), validParts };
         _nextPushIndex = (_nextPushIndex + 1) % gsl::narrow<int>(_storedSgrAttributes.size());
     }
 
-    const TextAttribute SgrStack::Pop(const TextAttribute& currentAttributes) noexcept
+    const TextAttribute SgrStack::Pop(const TextAttribute& currentAttributes, std::wstring& hyperlinkUri) noexcept
     {
+        hyperlinkUri.clear();
+
         if (_numSavedAttrs > 0)
         {
             _numSavedAttrs--;
@@ -73,6 +83,8 @@ namespace Microsoft::Console::VirtualTerminal
 
             if (restoreMe.ValidParts.test(SgrSaveRestoreStackOptions::All))
             {
+                // A popped slot is only ever read again after another Push() overwrote it.
+                hyperlinkUri = std::move(restoreMe.HyperlinkUri);
                 return restoreMe.TextAttributes;
             }
             else
@@ -0,0 +1,1315 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/GraphemeBreak.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console;
+
+// The test cases of GraphemeBreakTest.txt from Unicode 16.0.0 without their comments:
+// https://www.unicode.org/Public/16.0.0/ucd/auxiliary/GraphemeBreakTest.txt
+// "÷" marks a grapheme cluster boundary and "×" the absence of one.
+static constexpr std::wstring_view s_graphemeBreakTests[]{
+        L"÷ 0020 ÷ 0020 ÷",
+        L"÷ 0020 × 0308 ÷ 0020 ÷",
+        L"÷ 0020 ÷ 000D ÷",
+        L"÷ 0020 × 0308 ÷ 000D ÷",
+        L"÷ 0020 ÷ 000A ÷",
+        L"÷ 0020 × 0308 ÷ 000A ÷",
+        L"÷ 0020 ÷ 0001 ÷",
+        L"÷ 0020 × 0308 ÷ 0001 ÷",
+        L"÷ 0020 × 200C ÷",
+        L"÷ 0020 × 0308 × 200C ÷",
+        L"÷ 0020 ÷ 1F1E6 ÷",
+        L"÷ 0020 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0020 ÷ 0600 ÷",
+        L"÷ 0020 × 0308 ÷ 0600 ÷",
+        L"÷ 0020 ÷ 1100 ÷",
+        L"÷ 0020 × 0308 ÷ 1100 ÷",
+        L"÷ 0020 ÷ 1160 ÷",
+        L"÷ 0020 × 0308 ÷ 1160 ÷",
+        L"÷ 0020 ÷ 11A8 ÷",
+        L"÷ 0020 × 0308 ÷ 11A8 ÷",
+        L"÷ 0020 ÷ AC00 ÷",
+        L"÷ 0020 × 0308 ÷ AC00 ÷",
+        L"÷ 0020 ÷ AC01 ÷",
+        L"÷ 0020 × 0308 ÷ AC01 ÷",
+        L"÷ 0020 ÷ 0904 ÷",
+        L"÷ 0020 × 0308 ÷ 0904 ÷",
+        L"÷ 0020 ÷ 0D4E ÷",
+        L"÷ 0020 × 0308 ÷ 0D4E ÷",
+        L"÷ 0020 ÷ 0915 ÷",
+        L"÷ 0020 × 0308 ÷ 0915 ÷",
+        L"÷ 0020 ÷ 231A ÷",
+        L"÷ 0020 × 0308 ÷ 231A ÷",
+        L"÷ 0020 × 0300 ÷",
+        L"÷ 0020 × 0308 × 0300 ÷",
+        L"÷ 0020 × 0900 ÷",
+        L"÷ 0020 × 0308 × 0900 ÷",
+        L"÷ 0020 × 094D ÷",
+        L"÷ 0020 × 0308 × 094D ÷",
+        L"÷ 0020 × 200D ÷",
+        L"÷ 0020 × 0308 × 200D ÷",
+        L"÷ 0020 ÷ 0378 ÷",
+        L"÷ 0020 × 0308 ÷ 0378 ÷",
+        L"÷ 000D ÷ 0020 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0020 ÷",
+        L"÷ 000D ÷ 000D ÷",
+        L"÷ 000D ÷ 0308 ÷ 000D ÷",
+        L"÷ 000D × 000A ÷",
+        L"÷ 000D ÷ 0308 ÷ 000A ÷",
+        L"÷ 000D ÷ 0001 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0001 ÷",
+        L"÷ 000D ÷ 200C ÷",
+        L"÷ 000D ÷ 0308 × 200C ÷",
+        L"÷ 000D ÷ 1F1E6 ÷",
+        L"÷ 000D ÷ 0308 ÷ 1F1E6 ÷",
+        L"÷ 000D ÷ 0600 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0600 ÷",
+        L"÷ 000D ÷ 0A03 ÷",
+        L"÷ 000D ÷ 1100 ÷",
+        L"÷ 000D ÷ 0308 ÷ 1100 ÷",
+        L"÷ 000D ÷ 1160 ÷",
+        L"÷ 000D ÷ 0308 ÷ 1160 ÷",
+        L"÷ 000D ÷ 11A8 ÷",
+        L"÷ 000D ÷ 0308 ÷ 11A8 ÷",
+        L"÷ 000D ÷ AC00 ÷",
+        L"÷ 000D ÷ 0308 ÷ AC00 ÷",
+        L"÷ 000D ÷ AC01 ÷",
+        L"÷ 000D ÷ 0308 ÷ AC01 ÷",
+        L"÷ 000D ÷ 0903 ÷",
+        L"÷ 000D ÷ 0904 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0904 ÷",
+        L"÷ 000D ÷ 0D4E ÷",
+        L"÷ 000D ÷ 0308 ÷ 0D4E ÷",
+        L"÷ 000D ÷ 0915 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0915 ÷",
+        L"÷ 000D ÷ 231A ÷",
+        L"÷ 000D ÷ 0308 ÷ 231A ÷",
+        L"÷ 000D ÷ 0300 ÷",
+        L"÷ 000D ÷ 0308 × 0300 ÷",
+        L"÷ 000D ÷ 0900 ÷",
+        L"÷ 000D ÷ 0308 × 0900 ÷",
+        L"÷ 000D ÷ 094D ÷",
+        L"÷ 000D ÷ 0308 × 094D ÷",
+        L"÷ 000D ÷ 200D ÷",
+        L"÷ 000D ÷ 0308 × 200D ÷",
+        L"÷ 000D ÷ 0378 ÷",
+        L"÷ 000D ÷ 0308 ÷ 0378 ÷",
+        L"÷ 000A ÷ 0020 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0020 ÷",
+        L"÷ 000A ÷ 000D ÷",
+        L"÷ 000A ÷ 0308 ÷ 000D ÷",
+        L"÷ 000A ÷ 000A ÷",
+        L"÷ 000A ÷ 0308 ÷ 000A ÷",
+        L"÷ 000A ÷ 0001 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0001 ÷",
+        L"÷ 000A ÷ 200C ÷",
+        L"÷ 000A ÷ 0308 × 200C ÷",
+        L"÷ 000A ÷ 1F1E6 ÷",
+        L"÷ 000A ÷ 0308 ÷ 1F1E6 ÷",
+        L"÷ 000A ÷ 0600 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0600 ÷",
+        L"÷ 000A ÷ 0A03 ÷",
+        L"÷ 000A ÷ 1100 ÷",
+        L"÷ 000A ÷ 0308 ÷ 1100 ÷",
+        L"÷ 000A ÷ 1160 ÷",
+        L"÷ 000A ÷ 0308 ÷ 1160 ÷",
+        L"÷ 000A ÷ 11A8 ÷",
+        L"÷ 000A ÷ 0308 ÷ 11A8 ÷",
+        L"÷ 000A ÷ AC00 ÷",
+        L"÷ 000A ÷ 0308 ÷ AC00 ÷",
+        L"÷ 000A ÷ AC01 ÷",
+        L"÷ 000A ÷ 0308 ÷ AC01 ÷",
+        L"÷ 000A ÷ 0903 ÷",
+        L"÷ 000A ÷ 0904 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0904 ÷",
+        L"÷ 000A ÷ 0D4E ÷",
+        L"÷ 000A ÷ 0308 ÷ 0D4E ÷",
+        L"÷ 000A ÷ 0915 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0915 ÷",
+        L"÷ 000A ÷ 231A ÷",
+        L"÷ 000A ÷ 0308 ÷ 231A ÷",
+        L"÷ 000A ÷ 0300 ÷",
+        L"÷ 000A ÷ 0308 × 0300 ÷",
+        L"÷ 000A ÷ 0900 ÷",
+        L"÷ 000A ÷ 0308 × 0900 ÷",
+        L"÷ 000A ÷ 094D ÷",
+        L"÷ 000A ÷ 0308 × 094D ÷",
+        L"÷ 000A ÷ 200D ÷",
+        L"÷ 000A ÷ 0308 × 200D ÷",
+        L"÷ 000A ÷ 0378 ÷",
+        L"÷ 000A ÷ 0308 ÷ 0378 ÷",
+        L"÷ 0001 ÷ 0020 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0020 ÷",
+        L"÷ 0001 ÷ 000D ÷",
+        L"÷ 0001 ÷ 0308 ÷ 000D ÷",
+        L"÷ 0001 ÷ 000A ÷",
+        L"÷ 0001 ÷ 0308 ÷ 000A ÷",
+        L"÷ 0001 ÷ 0001 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0001 ÷",
+        L"÷ 0001 ÷ 200C ÷",
+        L"÷ 0001 ÷ 0308 × 200C ÷",
+        L"÷ 0001 ÷ 1F1E6 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 1F1E6 ÷",
+        L"÷ 0001 ÷ 0600 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0600 ÷",
+        L"÷ 0001 ÷ 0A03 ÷",
+        L"÷ 0001 ÷ 1100 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 1100 ÷",
+        L"÷ 0001 ÷ 1160 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 1160 ÷",
+        L"÷ 0001 ÷ 11A8 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 11A8 ÷",
+        L"÷ 0001 ÷ AC00 ÷",
+        L"÷ 0001 ÷ 0308 ÷ AC00 ÷",
+        L"÷ 0001 ÷ AC01 ÷",
+        L"÷ 0001 ÷ 0308 ÷ AC01 ÷",
+        L"÷ 0001 ÷ 0903 ÷",
+        L"÷ 0001 ÷ 0904 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0904 ÷",
+        L"÷ 0001 ÷ 0D4E ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0D4E ÷",
+        L"÷ 0001 ÷ 0915 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0915 ÷",
+        L"÷ 0001 ÷ 231A ÷",
+        L"÷ 0001 ÷ 0308 ÷ 231A ÷",
+        L"÷ 0001 ÷ 0300 ÷",
+        L"÷ 0001 ÷ 0308 × 0300 ÷",
+        L"÷ 0001 ÷ 0900 ÷",
+        L"÷ 0001 ÷ 0308 × 0900 ÷",
+        L"÷ 0001 ÷ 094D ÷",
+        L"÷ 0001 ÷ 0308 × 094D ÷",
+        L"÷ 0001 ÷ 200D ÷",
+        L"÷ 0001 ÷ 0308 × 200D ÷",
+        L"÷ 0001 ÷ 0378 ÷",
+        L"÷ 0001 ÷ 0308 ÷ 0378 ÷",
+        L"÷ 200C ÷ 0020 ÷",
+        L"÷ 200C × 0308 ÷ 0020 ÷",
+        L"÷ 200C ÷ 000D ÷",
+        L"÷ 200C × 0308 ÷ 000D ÷",
+        L"÷ 200C ÷ 000A ÷",
+        L"÷ 200C × 0308 ÷ 000A ÷",
+        L"÷ 200C ÷ 0001 ÷",
+        L"÷ 200C × 0308 ÷ 0001 ÷",
+        L"÷ 200C × 200C ÷",
+        L"÷ 200C × 0308 × 200C ÷",
+        L"÷ 200C ÷ 1F1E6 ÷",
+        L"÷ 200C × 0308 ÷ 1F1E6 ÷",
+        L"÷ 200C ÷ 0600 ÷",
+        L"÷ 200C × 0308 ÷ 0600 ÷",
+        L"÷ 200C ÷ 1100 ÷",
+        L"÷ 200C × 0308 ÷ 1100 ÷",
+        L"÷ 200C ÷ 1160 ÷",
+        L"÷ 200C × 0308 ÷ 1160 ÷",
+        L"÷ 200C ÷ 11A8 ÷",
+        L"÷ 200C × 0308 ÷ 11A8 ÷",
+        L"÷ 200C ÷ AC00 ÷",
+        L"÷ 200C × 0308 ÷ AC00 ÷",
+        L"÷ 200C ÷ AC01 ÷",
+        L"÷ 200C × 0308 ÷ AC01 ÷",
+        L"÷ 200C ÷ 0904 ÷",
+        L"÷ 200C × 0308 ÷ 0904 ÷",
+        L"÷ 200C ÷ 0D4E ÷",
+        L"÷ 200C × 0308 ÷ 0D4E ÷",
+        L"÷ 200C ÷ 0915 ÷",
+        L"÷ 200C × 0308 ÷ 0915 ÷",
+        L"÷ 200C ÷ 231A ÷",
+        L"÷ 200C × 0308 ÷ 231A ÷",
+        L"÷ 200C × 0300 ÷",
+        L"÷ 200C × 0308 × 0300 ÷",
+        L"÷ 200C × 0900 ÷",
+        L"÷ 200C × 0308 × 0900 ÷",
+        L"÷ 200C × 094D ÷",
+        L"÷ 200C × 0308 × 094D ÷",
+        L"÷ 200C × 200D ÷",
+        L"÷ 200C × 0308 × 200D ÷",
+        L"÷ 200C ÷ 0378 ÷",
+        L"÷ 200C × 0308 ÷ 0378 ÷",
+        L"÷ 1F1E6 ÷ 0020 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0020 ÷",
+        L"÷ 1F1E6 ÷ 000D ÷",
+        L"÷ 1F1E6 × 0308 ÷ 000D ÷",
+        L"÷ 1F1E6 ÷ 000A ÷",
+        L"÷ 1F1E6 × 0308 ÷ 000A ÷",
+        L"÷ 1F1E6 ÷ 0001 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0001 ÷",
+        L"÷ 1F1E6 × 200C ÷",
+        L"÷ 1F1E6 × 0308 × 200C ÷",
+        L"÷ 1F1E6 × 1F1E6 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 1F1E6 ÷ 0600 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0600 ÷",
+        L"÷ 1F1E6 ÷ 1100 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 1100 ÷",
+        L"÷ 1F1E6 ÷ 1160 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 1160 ÷",
+        L"÷ 1F1E6 ÷ 11A8 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 11A8 ÷",
+        L"÷ 1F1E6 ÷ AC00 ÷",
+        L"÷ 1F1E6 × 0308 ÷ AC00 ÷",
+        L"÷ 1F1E6 ÷ AC01 ÷",
+        L"÷ 1F1E6 × 0308 ÷ AC01 ÷",
+        L"÷ 1F1E6 ÷ 0904 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0904 ÷",
+        L"÷ 1F1E6 ÷ 0D4E ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0D4E ÷",
+        L"÷ 1F1E6 ÷ 0915 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0915 ÷",
+        L"÷ 1F1E6 ÷ 231A ÷",
+        L"÷ 1F1E6 × 0308 ÷ 231A ÷",
+        L"÷ 1F1E6 × 0300 ÷",
+        L"÷ 1F1E6 × 0308 × 0300 ÷",
+        L"÷ 1F1E6 × 0900 ÷",
+        L"÷ 1F1E6 × 0308 × 0900 ÷",
+        L"÷ 1F1E6 × 094D ÷",
+        L"÷ 1F1E6 × 0308 × 094D ÷",
+        L"÷ 1F1E6 × 200D ÷",
+        L"÷ 1F1E6 × 0308 × 200D ÷",
+        L"÷ 1F1E6 ÷ 0378 ÷",
+        L"÷ 1F1E6 × 0308 ÷ 0378 ÷",
+        L"÷ 0600 × 0308 ÷ 0020 ÷",
+        L"÷ 0600 ÷ 000D ÷",
+        L"÷ 0600 × 0308 ÷ 000D ÷",
+        L"÷ 0600 ÷ 000A ÷",
+        L"÷ 0600 × 0308 ÷ 000A ÷",
+        L"÷ 0600 ÷ 0001 ÷",
+        L"÷ 0600 × 0308 ÷ 0001 ÷",
+        L"÷ 0600 × 200C ÷",
+        L"÷ 0600 × 0308 × 200C ÷",
+        L"÷ 0600 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0600 × 0308 ÷ 0600 ÷",
+        L"÷ 0600 × 0308 ÷ 1100 ÷",
+        L"÷ 0600 × 0308 ÷ 1160 ÷",
+        L"÷ 0600 × 0308 ÷ 11A8 ÷",
+        L"÷ 0600 × 0308 ÷ AC00 ÷",
+        L"÷ 0600 × 0308 ÷ AC01 ÷",
+        L"÷ 0600 × 0308 ÷ 0904 ÷",
+        L"÷ 0600 × 0308 ÷ 0D4E ÷",
+        L"÷ 0600 × 0308 ÷ 0915 ÷",
+        L"÷ 0600 × 0308 ÷ 231A ÷",
+        L"÷ 0600 × 0300 ÷",
+        L"÷ 0600 × 0308 × 0300 ÷",
+        L"÷ 0600 × 0900 ÷",
+        L"÷ 0600 × 0308 × 0900 ÷",
+        L"÷ 0600 × 094D ÷",
+        L"÷ 0600 × 0308 × 094D ÷",
+        L"÷ 0600 × 200D ÷",
+        L"÷ 0600 × 0308 × 200D ÷",
+        L"÷ 0600 × 0308 ÷ 0378 ÷",
+        L"÷ 0A03 ÷ 0020 ÷",
+        L"÷ 0A03 × 0308 ÷ 0020 ÷",
+        L"÷ 0A03 ÷ 000D ÷",
+        L"÷ 0A03 × 0308 ÷ 000D ÷",
+        L"÷ 0A03 ÷ 000A ÷",
+        L"÷ 0A03 × 0308 ÷ 000A ÷",
+        L"÷ 0A03 ÷ 0001 ÷",
+        L"÷ 0A03 × 0308 ÷ 0001 ÷",
+        L"÷ 0A03 × 200C ÷",
+        L"÷ 0A03 × 0308 × 200C ÷",
+        L"÷ 0A03 ÷ 1F1E6 ÷",
+        L"÷ 0A03 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0A03 ÷ 0600 ÷",
+        L"÷ 0A03 × 0308 ÷ 0600 ÷",
+        L"÷ 0A03 ÷ 1100 ÷",
+        L"÷ 0A03 × 0308 ÷ 1100 ÷",
+        L"÷ 0A03 ÷ 1160 ÷",
+        L"÷ 0A03 × 0308 ÷ 1160 ÷",
+        L"÷ 0A03 ÷ 11A8 ÷",
+        L"÷ 0A03 × 0308 ÷ 11A8 ÷",
+        L"÷ 0A03 ÷ AC00 ÷",
+        L"÷ 0A03 × 0308 ÷ AC00 ÷",
+        L"÷ 0A03 ÷ AC01 ÷",
+        L"÷ 0A03 × 0308 ÷ AC01 ÷",
+        L"÷ 0A03 ÷ 0904 ÷",
+        L"÷ 0A03 × 0308 ÷ 0904 ÷",
+        L"÷ 0A03 ÷ 0D4E ÷",
+        L"÷ 0A03 × 0308 ÷ 0D4E ÷",
+        L"÷ 0A03 ÷ 0915 ÷",
+        L"÷ 0A03 × 0308 ÷ 0915 ÷",
+        L"÷ 0A03 ÷ 231A ÷",
+        L"÷ 0A03 × 0308 ÷ 231A ÷",
+        L"÷ 0A03 × 0300 ÷",
+        L"÷ 0A03 × 0308 × 0300 ÷",
+        L"÷ 0A03 × 0900 ÷",
+        L"÷ 0A03 × 0308 × 0900 ÷",
+        L"÷ 0A03 × 094D ÷",
+        L"÷ 0A03 × 0308 × 094D ÷",
+        L"÷ 0A03 × 200D ÷",
+        L"÷ 0A03 × 0308 × 200D ÷",
+        L"÷ 0A03 ÷ 0378 ÷",
+        L"÷ 0A03 × 0308 ÷ 0378 ÷",
+        L"÷ 1100 ÷ 0020 ÷",
+        L"÷ 1100 × 0308 ÷ 0020 ÷",
+        L"÷ 1100 ÷ 000D ÷",
+        L"÷ 1100 × 0308 ÷ 000D ÷",
+        L"÷ 1100 ÷ 000A ÷",
+        L"÷ 1100 × 0308 ÷ 000A ÷",
+        L"÷ 1100 ÷ 0001 ÷",
+        L"÷ 1100 × 0308 ÷ 0001 ÷",
+        L"÷ 1100 × 200C ÷",
+        L"÷ 1100 × 0308 × 200C ÷",
+        L"÷ 1100 ÷ 1F1E6 ÷",
+        L"÷ 1100 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 1100 ÷ 0600 ÷",
+        L"÷ 1100 × 0308 ÷ 0600 ÷",
+        L"÷ 1100 × 1100 ÷",
+        L"÷ 1100 × 0308 ÷ 1100 ÷",
+        L"÷ 1100 × 1160 ÷",
+        L"÷ 1100 × 0308 ÷ 1160 ÷",
+        L"÷ 1100 ÷ 11A8 ÷",
+        L"÷ 1100 × 0308 ÷ 11A8 ÷",
+        L"÷ 1100 × AC00 ÷",
+        L"÷ 1100 × 0308 ÷ AC00 ÷",
+        L"÷ 1100 × AC01 ÷",
+        L"÷ 1100 × 0308 ÷ AC01 ÷",
+        L"÷ 1100 ÷ 0904 ÷",
+        L"÷ 1100 × 0308 ÷ 0904 ÷",
+        L"÷ 1100 ÷ 0D4E ÷",
+        L"÷ 1100 × 0308 ÷ 0D4E ÷",
+        L"÷ 1100 ÷ 0915 ÷",
+        L"÷ 1100 × 0308 ÷ 0915 ÷",
+        L"÷ 1100 ÷ 231A ÷",
+        L"÷ 1100 × 0308 ÷ 231A ÷",
+        L"÷ 1100 × 0300 ÷",
+        L"÷ 1100 × 0308 × 0300 ÷",
+        L"÷ 1100 × 0900 ÷",
+        L"÷ 1100 × 0308 × 0900 ÷",
+        L"÷ 1100 × 094D ÷",
+        L"÷ 1100 × 0308 × 094D ÷",
+        L"÷ 1100 × 200D ÷",
+        L"÷ 1100 × 0308 × 200D ÷",
+        L"÷ 1100 ÷ 0378 ÷",
+        L"÷ 1100 × 0308 ÷ 0378 ÷",
+        L"÷ 1160 ÷ 0020 ÷",
+        L"÷ 1160 × 0308 ÷ 0020 ÷",
+        L"÷ 1160 ÷ 000D ÷",
+        L"÷ 1160 × 0308 ÷ 000D ÷",
+        L"÷ 1160 ÷ 000A ÷",
+        L"÷ 1160 × 0308 ÷ 000A ÷",
+        L"÷ 1160 ÷ 0001 ÷",
+        L"÷ 1160 × 0308 ÷ 0001 ÷",
+        L"÷ 1160 × 200C ÷",
+        L"÷ 1160 × 0308 × 200C ÷",
+        L"÷ 1160 ÷ 1F1E6 ÷",
+        L"÷ 1160 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 1160 ÷ 0600 ÷",
+        L"÷ 1160 × 0308 ÷ 0600 ÷",
+        L"÷ 1160 ÷ 1100 ÷",
+        L"÷ 1160 × 0308 ÷ 1100 ÷",
+        L"÷ 1160 × 1160 ÷",
+        L"÷ 1160 × 0308 ÷ 1160 ÷",
+        L"÷ 1160 × 11A8 ÷",
+        L"÷ 1160 × 0308 ÷ 11A8 ÷",
+        L"÷ 1160 ÷ AC00 ÷",
+        L"÷ 1160 × 0308 ÷ AC00 ÷",
+        L"÷ 1160 ÷ AC01 ÷",
+        L"÷ 1160 × 0308 ÷ AC01 ÷",
+        L"÷ 1160 ÷ 0904 ÷",
+        L"÷ 1160 × 0308 ÷ 0904 ÷",
+        L"÷ 1160 ÷ 0D4E ÷",
+        L"÷ 1160 × 0308 ÷ 0D4E ÷",
+        L"÷ 1160 ÷ 0915 ÷",
+        L"÷ 1160 × 0308 ÷ 0915 ÷",
+        L"÷ 1160 ÷ 231A ÷",
+        L"÷ 1160 × 0308 ÷ 231A ÷",
+        L"÷ 1160 × 0300 ÷",
+        L"÷ 1160 × 0308 × 0300 ÷",
+        L"÷ 1160 × 0900 ÷",
+        L"÷ 1160 × 0308 × 0900 ÷",
+        L"÷ 1160 × 094D ÷",
+        L"÷ 1160 × 0308 × 094D ÷",
+        L"÷ 1160 × 200D ÷",
+        L"÷ 1160 × 0308 × 200D ÷",
+        L"÷ 1160 ÷ 0378 ÷",
+        L"÷ 1160 × 0308 ÷ 0378 ÷",
+        L"÷ 11A8 ÷ 0020 ÷",
+        L"÷ 11A8 × 0308 ÷ 0020 ÷",
+        L"÷ 11A8 ÷ 000D ÷",
+        L"÷ 11A8 × 0308 ÷ 000D ÷",
+        L"÷ 11A8 ÷ 000A ÷",
+        L"÷ 11A8 × 0308 ÷ 000A ÷",
+        L"÷ 11A8 ÷ 0001 ÷",
+        L"÷ 11A8 × 0308 ÷ 0001 ÷",
+        L"÷ 11A8 × 200C ÷",
+        L"÷ 11A8 × 0308 × 200C ÷",
+        L"÷ 11A8 ÷ 1F1E6 ÷",
+        L"÷ 11A8 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 11A8 ÷ 0600 ÷",
+        L"÷ 11A8 × 0308 ÷ 0600 ÷",
+        L"÷ 11A8 ÷ 1100 ÷",
+        L"÷ 11A8 × 0308 ÷ 1100 ÷",
+        L"÷ 11A8 ÷ 1160 ÷",
+        L"÷ 11A8 × 0308 ÷ 1160 ÷",
+        L"÷ 11A8 × 11A8 ÷",
+        L"÷ 11A8 × 0308 ÷ 11A8 ÷",
+        L"÷ 11A8 ÷ AC00 ÷",
+        L"÷ 11A8 × 0308 ÷ AC00 ÷",
+        L"÷ 11A8 ÷ AC01 ÷",
+        L"÷ 11A8 × 0308 ÷ AC01 ÷",
+        L"÷ 11A8 ÷ 0904 ÷",
+        L"÷ 11A8 × 0308 ÷ 0904 ÷",
+        L"÷ 11A8 ÷ 0D4E ÷",
+        L"÷ 11A8 × 0308 ÷ 0D4E ÷",
+        L"÷ 11A8 ÷ 0915 ÷",
+        L"÷ 11A8 × 0308 ÷ 0915 ÷",
+        L"÷ 11A8 ÷ 231A ÷",
+        L"÷ 11A8 × 0308 ÷ 231A ÷",
+        L"÷ 11A8 × 0300 ÷",
+        L"÷ 11A8 × 0308 × 0300 ÷",
+        L"÷ 11A8 × 0900 ÷",
+        L"÷ 11A8 × 0308 × 0900 ÷",
+        L"÷ 11A8 × 094D ÷",
+        L"÷ 11A8 × 0308 × 094D ÷",
+        L"÷ 11A8 × 200D ÷",
+        L"÷ 11A8 × 0308 × 200D ÷",
+        L"÷ 11A8 ÷ 0378 ÷",
+        L"÷ 11A8 × 0308 ÷ 0378 ÷",
+        L"÷ AC00 ÷ 0020 ÷",
+        L"÷ AC00 × 0308 ÷ 0020 ÷",
+        L"÷ AC00 ÷ 000D ÷",
+        L"÷ AC00 × 0308 ÷ 000D ÷",
+        L"÷ AC00 ÷ 000A ÷",
+        L"÷ AC00 × 0308 ÷ 000A ÷",
+        L"÷ AC00 ÷ 0001 ÷",
+        L"÷ AC00 × 0308 ÷ 0001 ÷",
+        L"÷ AC00 × 200C ÷",
+        L"÷ AC00 × 0308 × 200C ÷",
+        L"÷ AC00 ÷ 1F1E6 ÷",
+        L"÷ AC00 × 0308 ÷ 1F1E6 ÷",
+        L"÷ AC00 ÷ 0600 ÷",
+        L"÷ AC00 × 0308 ÷ 0600 ÷",
+        L"÷ AC00 ÷ 1100 ÷",
+        L"÷ AC00 × 0308 ÷ 1100 ÷",
+        L"÷ AC00 × 1160 ÷",
+        L"÷ AC00 × 0308 ÷ 1160 ÷",
+        L"÷ AC00 × 11A8 ÷",
+        L"÷ AC00 × 0308 ÷ 11A8 ÷",
+        L"÷ AC00 ÷ AC00 ÷",
+        L"÷ AC00 × 0308 ÷ AC00 ÷",
+        L"÷ AC00 ÷ AC01 ÷",
+        L"÷ AC00 × 0308 ÷ AC01 ÷",
+        L"÷ AC00 ÷ 0904 ÷",
+        L"÷ AC00 × 0308 ÷ 0904 ÷",
+        L"÷ AC00 ÷ 0D4E ÷",
+        L"÷ AC00 × 0308 ÷ 0D4E ÷",
+        L"÷ AC00 ÷ 0915 ÷",
+        L"÷ AC00 × 0308 ÷ 0915 ÷",
+        L"÷ AC00 ÷ 231A ÷",
+        L"÷ AC00 × 0308 ÷ 231A ÷",
+        L"÷ AC00 × 0300 ÷",
+        L"÷ AC00 × 0308 × 0300 ÷",
+        L"÷ AC00 × 0900 ÷",
+        L"÷ AC00 × 0308 × 0900 ÷",
+        L"÷ AC00 × 094D ÷",
+        L"÷ AC00 × 0308 × 094D ÷",
+        L"÷ AC00 × 200D ÷",
+        L"÷ AC00 × 0308 × 200D ÷",
+        L"÷ AC00 ÷ 0378 ÷",
+        L"÷ AC00 × 0308 ÷ 0378 ÷",
+        L"÷ AC01 ÷ 0020 ÷",
+        L"÷ AC01 × 0308 ÷ 0020 ÷",
+        L"÷ AC01 ÷ 000D ÷",
+        L"÷ AC01 × 0308 ÷ 000D ÷",
+        L"÷ AC01 ÷ 000A ÷",
+        L"÷ AC01 × 0308 ÷ 000A ÷",
+        L"÷ AC01 ÷ 0001 ÷",
+        L"÷ AC01 × 0308 ÷ 0001 ÷",
+        L"÷ AC01 × 200C ÷",
+        L"÷ AC01 × 0308 × 200C ÷",
+        L"÷ AC01 ÷ 1F1E6 ÷",
+        L"÷ AC01 × 0308 ÷ 1F1E6 ÷",
+        L"÷ AC01 ÷ 0600 ÷",
+        L"÷ AC01 × 0308 ÷ 0600 ÷",
+        L"÷ AC01 ÷ 1100 ÷",
+        L"÷ AC01 × 0308 ÷ 1100 ÷",
+        L"÷ AC01 ÷ 1160 ÷",
+        L"÷ AC01 × 0308 ÷ 1160 ÷",
+        L"÷ AC01 × 11A8 ÷",
+        L"÷ AC01 × 0308 ÷ 11A8 ÷",
+        L"÷ AC01 ÷ AC00 ÷",
+        L"÷ AC01 × 0308 ÷ AC00 ÷",
+        L"÷ AC01 ÷ AC01 ÷",
+        L"÷ AC01 × 0308 ÷ AC01 ÷",
+        L"÷ AC01 ÷ 0904 ÷",
+        L"÷ AC01 × 0308 ÷ 0904 ÷",
+        L"÷ AC01 ÷ 0D4E ÷",
+        L"÷ AC01 × 0308 ÷ 0D4E ÷",
+        L"÷ AC01 ÷ 0915 ÷",
+        L"÷ AC01 × 0308 ÷ 0915 ÷",
+        L"÷ AC01 ÷ 231A ÷",
+        L"÷ AC01 × 0308 ÷ 231A ÷",
+        L"÷ AC01 × 0300 ÷",
+        L"÷ AC01 × 0308 × 0300 ÷",
+        L"÷ AC01 × 0900 ÷",
+        L"÷ AC01 × 0308 × 0900 ÷",
+        L"÷ AC01 × 094D ÷",
+        L"÷ AC01 × 0308 × 094D ÷",
+        L"÷ AC01 × 200D ÷",
+        L"÷ AC01 × 0308 × 200D ÷",
+        L"÷ AC01 ÷ 0378 ÷",
+        L"÷ AC01 × 0308 ÷ 0378 ÷",
+        L"÷ 0903 ÷ 0020 ÷",
+        L"÷ 0903 × 0308 ÷ 0020 ÷",
+        L"÷ 0903 ÷ 000D ÷",
+        L"÷ 0903 × 0308 ÷ 000D ÷",
+        L"÷ 0903 ÷ 000A ÷",
+        L"÷ 0903 × 0308 ÷ 000A ÷",
+        L"÷ 0903 ÷ 0001 ÷",
+        L"÷ 0903 × 0308 ÷ 0001 ÷",
+        L"÷ 0903 × 200C ÷",
+        L"÷ 0903 × 0308 × 200C ÷",
+        L"÷ 0903 ÷ 1F1E6 ÷",
+        L"÷ 0903 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0903 ÷ 0600 ÷",
+        L"÷ 0903 × 0308 ÷ 0600 ÷",
+        L"÷ 0903 ÷ 1100 ÷",
+        L"÷ 0903 × 0308 ÷ 1100 ÷",
+        L"÷ 0903 ÷ 1160 ÷",
+        L"÷ 0903 × 0308 ÷ 1160 ÷",
+        L"÷ 0903 ÷ 11A8 ÷",
+        L"÷ 0903 × 0308 ÷ 11A8 ÷",
+        L"÷ 0903 ÷ AC00 ÷",
+        L"÷ 0903 × 0308 ÷ AC00 ÷",
+        L"÷ 0903 ÷ AC01 ÷",
+        L"÷ 0903 × 0308 ÷ AC01 ÷",
+        L"÷ 0903 ÷ 0904 ÷",
+        L"÷ 0903 × 0308 ÷ 0904 ÷",
+        L"÷ 0903 ÷ 0D4E ÷",
+        L"÷ 0903 × 0308 ÷ 0D4E ÷",
+        L"÷ 0903 ÷ 0915 ÷",
+        L"÷ 0903 × 0308 ÷ 0915 ÷",
+        L"÷ 0903 ÷ 231A ÷",
+        L"÷ 0903 × 0308 ÷ 231A ÷",
+        L"÷ 0903 × 0300 ÷",
+        L"÷ 0903 × 0308 × 0300 ÷",
+        L"÷ 0903 × 0900 ÷",
+        L"÷ 0903 × 0308 × 0900 ÷",
+        L"÷ 0903 × 094D ÷",
+        L"÷ 0903 × 0308 × 094D ÷",
+        L"÷ 0903 × 200D ÷",
+        L"÷ 0903 × 0308 × 200D ÷",
+        L"÷ 0903 ÷ 0378 ÷",
+        L"÷ 0903 × 0308 ÷ 0378 ÷",
+        L"÷ 0904 ÷ 0020 ÷",
+        L"÷ 0904 × 0308 ÷ 0020 ÷",
+        L"÷ 0904 ÷ 000D ÷",
+        L"÷ 0904 × 0308 ÷ 000D ÷",
+        L"÷ 0904 ÷ 000A ÷",
+        L"÷ 0904 × 0308 ÷ 000A ÷",
+        L"÷ 0904 ÷ 0001 ÷",
+        L"÷ 0904 × 0308 ÷ 0001 ÷",
+        L"÷ 0904 × 200C ÷",
+        L"÷ 0904 × 0308 × 200C ÷",
+        L"÷ 0904 ÷ 1F1E6 ÷",
+        L"÷ 0904 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0904 ÷ 0600 ÷",
+        L"÷ 0904 × 0308 ÷ 0600 ÷",
+        L"÷ 0904 ÷ 1100 ÷",
+        L"÷ 0904 × 0308 ÷ 1100 ÷",
+        L"÷ 0904 ÷ 1160 ÷",
+        L"÷ 0904 × 0308 ÷ 1160 ÷",
+        L"÷ 0904 ÷ 11A8 ÷",
+        L"÷ 0904 × 0308 ÷ 11A8 ÷",
+        L"÷ 0904 ÷ AC00 ÷",
+        L"÷ 0904 × 0308 ÷ AC00 ÷",
+        L"÷ 0904 ÷ AC01 ÷",
+        L"÷ 0904 × 0308 ÷ AC01 ÷",
+        L"÷ 0904 ÷ 0904 ÷",
+        L"÷ 0904 × 0308 ÷ 0904 ÷",
+        L"÷ 0904 ÷ 0D4E ÷",
+        L"÷ 0904 × 0308 ÷ 0D4E ÷",
+        L"÷ 0904 ÷ 0915 ÷",
+        L"÷ 0904 × 0308 ÷ 0915 ÷",
+        L"÷ 0904 ÷ 231A ÷",
+        L"÷ 0904 × 0308 ÷ 231A ÷",
+        L"÷ 0904 × 0300 ÷",
+        L"÷ 0904 × 0308 × 0300 ÷",
+        L"÷ 0904 × 0900 ÷",
+        L"÷ 0904 × 0308 × 0900 ÷",
+        L"÷ 0904 × 094D ÷",
+        L"÷ 0904 × 0308 × 094D ÷",
+        L"÷ 0904 × 200D ÷",
+        L"÷ 0904 × 0308 × 200D ÷",
+        L"÷ 0904 ÷ 0378 ÷",
+        L"÷ 0904 × 0308 ÷ 0378 ÷",
+        L"÷ 0D4E × 0308 ÷ 0020 ÷",
+        L"÷ 0D4E ÷ 000D ÷",
+        L"÷ 0D4E × 0308 ÷ 000D ÷",
+        L"÷ 0D4E ÷ 000A ÷",
+        L"÷ 0D4E × 0308 ÷ 000A ÷",
+        L"÷ 0D4E ÷ 0001 ÷",
+        L"÷ 0D4E × 0308 ÷ 0001 ÷",
+        L"÷ 0D4E × 200C ÷",
+        L"÷ 0D4E × 0308 × 200C ÷",
+        L"÷ 0D4E × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0D4E × 0308 ÷ 0600 ÷",
+        L"÷ 0D4E × 0308 ÷ 1100 ÷",
+        L"÷ 0D4E × 0308 ÷ 1160 ÷",
+        L"÷ 0D4E × 0308 ÷ 11A8 ÷",
+        L"÷ 0D4E × 0308 ÷ AC00 ÷",
+        L"÷ 0D4E × 0308 ÷ AC01 ÷",
+        L"÷ 0D4E × 0308 ÷ 0904 ÷",
+        L"÷ 0D4E × 0308 ÷ 0D4E ÷",
+        L"÷ 0D4E × 0308 ÷ 0915 ÷",
+        L"÷ 0D4E × 0308 ÷ 231A ÷",
+        L"÷ 0D4E × 0300 ÷",
+        L"÷ 0D4E × 0308 × 0300 ÷",
+        L"÷ 0D4E × 0900 ÷",
+        L"÷ 0D4E × 0308 × 0900 ÷",
+        L"÷ 0D4E × 094D ÷",
+        L"÷ 0D4E × 0308 × 094D ÷",
+        L"÷ 0D4E × 200D ÷",
+        L"÷ 0D4E × 0308 × 200D ÷",
+        L"÷ 0D4E × 0308 ÷ 0378 ÷",
+        L"÷ 0915 ÷ 0020 ÷",
+        L"÷ 0915 × 0308 ÷ 0020 ÷",
+        L"÷ 0915 ÷ 000D ÷",
+        L"÷ 0915 × 0308 ÷ 000D ÷",
+        L"÷ 0915 ÷ 000A ÷",
+        L"÷ 0915 × 0308 ÷ 000A ÷",
+        L"÷ 0915 ÷ 0001 ÷",
+        L"÷ 0915 × 0308 ÷ 0001 ÷",
+        L"÷ 0915 × 200C ÷",
+        L"÷ 0915 × 0308 × 200C ÷",
+        L"÷ 0915 ÷ 1F1E6 ÷",
+        L"÷ 0915 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0915 ÷ 0600 ÷",
+        L"÷ 0915 × 0308 ÷ 0600 ÷",
+        L"÷ 0915 ÷ 1100 ÷",
+        L"÷ 0915 × 0308 ÷ 1100 ÷",
+        L"÷ 0915 ÷ 1160 ÷",
+        L"÷ 0915 × 0308 ÷ 1160 ÷",
+        L"÷ 0915 ÷ 11A8 ÷",
+        L"÷ 0915 × 0308 ÷ 11A8 ÷",
+        L"÷ 0915 ÷ AC00 ÷",
+        L"÷ 0915 × 0308 ÷ AC00 ÷",
+        L"÷ 0915 ÷ AC01 ÷",
+        L"÷ 0915 × 0308 ÷ AC01 ÷",
+        L"÷ 0915 ÷ 0904 ÷",
+        L"÷ 0915 × 0308 ÷ 0904 ÷",
+        L"÷ 0915 ÷ 0D4E ÷",
+        L"÷ 0915 × 0308 ÷ 0D4E ÷",
+        L"÷ 0915 ÷ 0915 ÷",
+        L"÷ 0915 × 0308 ÷ 0915 ÷",
+        L"÷ 0915 ÷ 231A ÷",
+        L"÷ 0915 × 0308 ÷ 231A ÷",
+        L"÷ 0915 × 0300 ÷",
+        L"÷ 0915 × 0308 × 0300 ÷",
+        L"÷ 0915 × 0900 ÷",
+        L"÷ 0915 × 0308 × 0900 ÷",
+        L"÷ 0915 × 094D ÷",
+        L"÷ 0915 × 0308 × 094D ÷",
+        L"÷ 0915 × 200D ÷",
+        L"÷ 0915 × 0308 × 200D ÷",
+        L"÷ 0915 ÷ 0378 ÷",
+        L"÷ 0915 × 0308 ÷ 0378 ÷",
+        L"÷ 231A ÷ 0020 ÷",
+        L"÷ 231A × 0308 ÷ 0020 ÷",
+        L"÷ 231A ÷ 000D ÷",
+        L"÷ 231A × 0308 ÷ 000D ÷",
+        L"÷ 231A ÷ 000A ÷",
+        L"÷ 231A × 0308 ÷ 000A ÷",
+        L"÷ 231A ÷ 0001 ÷",
+        L"÷ 231A × 0308 ÷ 0001 ÷",
+        L"÷ 231A × 200C ÷",
+        L"÷ 231A × 0308 × 200C ÷",
+        L"÷ 231A ÷ 1F1E6 ÷",
+        L"÷ 231A × 0308 ÷ 1F1E6 ÷",
+        L"÷ 231A ÷ 0600 ÷",
+        L"÷ 231A × 0308 ÷ 0600 ÷",
+        L"÷ 231A ÷ 1100 ÷",
+        L"÷ 231A × 0308 ÷ 1100 ÷",
+        L"÷ 231A ÷ 1160 ÷",
+        L"÷ 231A × 0308 ÷ 1160 ÷",
+        L"÷ 231A ÷ 11A8 ÷",
+        L"÷ 231A × 0308 ÷ 11A8 ÷",
+        L"÷ 231A ÷ AC00 ÷",
+        L"÷ 231A × 0308 ÷ AC00 ÷",
+        L"÷ 231A ÷ AC01 ÷",
+        L"÷ 231A × 0308 ÷ AC01 ÷",
+        L"÷ 231A ÷ 0904 ÷",
+        L"÷ 231A × 0308 ÷ 0904 ÷",
+        L"÷ 231A ÷ 0D4E ÷",
+        L"÷ 231A × 0308 ÷ 0D4E ÷",
+        L"÷ 231A ÷ 0915 ÷",
+        L"÷ 231A × 0308 ÷ 0915 ÷",
+        L"÷ 231A ÷ 231A ÷",
+        L"÷ 231A × 0308 ÷ 231A ÷",
+        L"÷ 231A × 0300 ÷",
+        L"÷ 231A × 0308 × 0300 ÷",
+        L"÷ 231A × 0900 ÷",
+        L"÷ 231A × 0308 × 0900 ÷",
+        L"÷ 231A × 094D ÷",
+        L"÷ 231A × 0308 × 094D ÷",
+        L"÷ 231A × 200D ÷",
+        L"÷ 231A × 0308 × 200D ÷",
+        L"÷ 231A ÷ 0378 ÷",
+        L"÷ 231A × 0308 ÷ 0378 ÷",
+        L"÷ 0300 ÷ 0020 ÷",
+        L"÷ 0300 × 0308 ÷ 0020 ÷",
+        L"÷ 0300 ÷ 000D ÷",
+        L"÷ 0300 × 0308 ÷ 000D ÷",
+        L"÷ 0300 ÷ 000A ÷",
+        L"÷ 0300 × 0308 ÷ 000A ÷",
+        L"÷ 0300 ÷ 0001 ÷",
+        L"÷ 0300 × 0308 ÷ 0001 ÷",
+        L"÷ 0300 × 200C ÷",
+        L"÷ 0300 × 0308 × 200C ÷",
+        L"÷ 0300 ÷ 1F1E6 ÷",
+        L"÷ 0300 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0300 ÷ 0600 ÷",
+        L"÷ 0300 × 0308 ÷ 0600 ÷",
+        L"÷ 0300 ÷ 1100 ÷",
+        L"÷ 0300 × 0308 ÷ 1100 ÷",
+        L"÷ 0300 ÷ 1160 ÷",
+        L"÷ 0300 × 0308 ÷ 1160 ÷",
+        L"÷ 0300 ÷ 11A8 ÷",
+        L"÷ 0300 × 0308 ÷ 11A8 ÷",
+        L"÷ 0300 ÷ AC00 ÷",
+        L"÷ 0300 × 0308 ÷ AC00 ÷",
+        L"÷ 0300 ÷ AC01 ÷",
+        L"÷ 0300 × 0308 ÷ AC01 ÷",
+        L"÷ 0300 ÷ 0904 ÷",
+        L"÷ 0300 × 0308 ÷ 0904 ÷",
+        L"÷ 0300 ÷ 0D4E ÷",
+        L"÷ 0300 × 0308 ÷ 0D4E ÷",
+        L"÷ 0300 ÷ 0915 ÷",
+        L"÷ 0300 × 0308 ÷ 0915 ÷",
+        L"÷ 0300 ÷ 231A ÷",
+        L"÷ 0300 × 0308 ÷ 231A ÷",
+        L"÷ 0300 × 0300 ÷",
+        L"÷ 0300 × 0308 × 0300 ÷",
+        L"÷ 0300 × 0900 ÷",
+        L"÷ 0300 × 0308 × 0900 ÷",
+        L"÷ 0300 × 094D ÷",
+        L"÷ 0300 × 0308 × 094D ÷",
+        L"÷ 0300 × 200D ÷",
+        L"÷ 0300 × 0308 × 200D ÷",
+        L"÷ 0300 ÷ 0378 ÷",
+        L"÷ 0300 × 0308 ÷ 0378 ÷",
+        L"÷ 0900 ÷ 0020 ÷",
+        L"÷ 0900 × 0308 ÷ 0020 ÷",
+        L"÷ 0900 ÷ 000D ÷",
+        L"÷ 0900 × 0308 ÷ 000D ÷",
+        L"÷ 0900 ÷ 000A ÷",
+        L"÷ 0900 × 0308 ÷ 000A ÷",
+        L"÷ 0900 ÷ 0001 ÷",
+        L"÷ 0900 × 0308 ÷ 0001 ÷",
+        L"÷ 0900 × 200C ÷",
+        L"÷ 0900 × 0308 × 200C ÷",
+        L"÷ 0900 ÷ 1F1E6 ÷",
+        L"÷ 0900 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0900 ÷ 0600 ÷",
+        L"÷ 0900 × 0308 ÷ 0600 ÷",
+        L"÷ 0900 ÷ 1100 ÷",
+        L"÷ 0900 × 0308 ÷ 1100 ÷",
+        L"÷ 0900 ÷ 1160 ÷",
+        L"÷ 0900 × 0308 ÷ 1160 ÷",
+        L"÷ 0900 ÷ 11A8 ÷",
+        L"÷ 0900 × 0308 ÷ 11A8 ÷",
+        L"÷ 0900 ÷ AC00 ÷",
+        L"÷ 0900 × 0308 ÷ AC00 ÷",
+        L"÷ 0900 ÷ AC01 ÷",
+        L"÷ 0900 × 0308 ÷ AC01 ÷",
+        L"÷ 0900 ÷ 0904 ÷",
+        L"÷ 0900 × 0308 ÷ 0904 ÷",
+        L"÷ 0900 ÷ 0D4E ÷",
+        L"÷ 0900 × 0308 ÷ 0D4E ÷",
+        L"÷ 0900 ÷ 0915 ÷",
+        L"÷ 0900 × 0308 ÷ 0915 ÷",
+        L"÷ 0900 ÷ 231A ÷",
+        L"÷ 0900 × 0308 ÷ 231A ÷",
+        L"÷ 0900 × 0300 ÷",
+        L"÷ 0900 × 0308 × 0300 ÷",
+        L"÷ 0900 × 0900 ÷",
+        L"÷ 0900 × 0308 × 0900 ÷",
+        L"÷ 0900 × 094D ÷",
+        L"÷ 0900 × 0308 × 094D ÷",
+        L"÷ 0900 × 200D ÷",
+        L"÷ 0900 × 0308 × 200D ÷",
+        L"÷ 0900 ÷ 0378 ÷",
+        L"÷ 0900 × 0308 ÷ 0378 ÷",
+        L"÷ 094D ÷ 0020 ÷",
+        L"÷ 094D × 0308 ÷ 0020 ÷",
+        L"÷ 094D ÷ 000D ÷",
+        L"÷ 094D × 0308 ÷ 000D ÷",
+        L"÷ 094D ÷ 000A ÷",
+        L"÷ 094D × 0308 ÷ 000A ÷",
+        L"÷ 094D ÷ 0001 ÷",
+        L"÷ 094D × 0308 ÷ 0001 ÷",
+        L"÷ 094D × 200C ÷",
+        L"÷ 094D × 0308 × 200C ÷",
+        L"÷ 094D ÷ 1F1E6 ÷",
+        L"÷ 094D × 0308 ÷ 1F1E6 ÷",
+        L"÷ 094D ÷ 0600 ÷",
+        L"÷ 094D × 0308 ÷ 0600 ÷",
+        L"÷ 094D ÷ 1100 ÷",
+        L"÷ 094D × 0308 ÷ 1100 ÷",
+        L"÷ 094D ÷ 1160 ÷",
+        L"÷ 094D × 0308 ÷ 1160 ÷",
+        L"÷ 094D ÷ 11A8 ÷",
+        L"÷ 094D × 0308 ÷ 11A8 ÷",
+        L"÷ 094D ÷ AC00 ÷",
+        L"÷ 094D × 0308 ÷ AC00 ÷",
+        L"÷ 094D ÷ AC01 ÷",
+        L"÷ 094D × 0308 ÷ AC01 ÷",
+        L"÷ 094D ÷ 0904 ÷",
+        L"÷ 094D × 0308 ÷ 0904 ÷",
+        L"÷ 094D ÷ 0D4E ÷",
+        L"÷ 094D × 0308 ÷ 0D4E ÷",
+        L"÷ 094D ÷ 0915 ÷",
+        L"÷ 094D × 0308 ÷ 0915 ÷",
+        L"÷ 094D ÷ 231A ÷",
+        L"÷ 094D × 0308 ÷ 231A ÷",
+        L"÷ 094D × 0300 ÷",
+        L"÷ 094D × 0308 × 0300 ÷",
+        L"÷ 094D × 0900 ÷",
+        L"÷ 094D × 0308 × 0900 ÷",
+        L"÷ 094D × 094D ÷",
+        L"÷ 094D × 0308 × 094D ÷",
+        L"÷ 094D × 200D ÷",
+        L"÷ 094D × 0308 × 200D ÷",
+        L"÷ 094D ÷ 0378 ÷",
+        L"÷ 094D × 0308 ÷ 0378 ÷",
+        L"÷ 200D ÷ 0020 ÷",
+        L"÷ 200D × 0308 ÷ 0020 ÷",
+        L"÷ 200D ÷ 000D ÷",
+        L"÷ 200D × 0308 ÷ 000D ÷",
+        L"÷ 200D ÷ 000A ÷",
+        L"÷ 200D × 0308 ÷ 000A ÷",
+        L"÷ 200D ÷ 0001 ÷",
+        L"÷ 200D × 0308 ÷ 0001 ÷",
+        L"÷ 200D × 200C ÷",
+        L"÷ 200D × 0308 × 200C ÷",
+        L"÷ 200D ÷ 1F1E6 ÷",
+        L"÷ 200D × 0308 ÷ 1F1E6 ÷",
+        L"÷ 200D ÷ 0600 ÷",
+        L"÷ 200D × 0308 ÷ 0600 ÷",
+        L"÷ 200D ÷ 1100 ÷",
+        L"÷ 200D × 0308 ÷ 1100 ÷",
+        L"÷ 200D ÷ 1160 ÷",
+        L"÷ 200D × 0308 ÷ 1160 ÷",
+        L"÷ 200D ÷ 11A8 ÷",
+        L"÷ 200D × 0308 ÷ 11A8 ÷",
+        L"÷ 200D ÷ AC00 ÷",
+        L"÷ 200D × 0308 ÷ AC00 ÷",
+        L"÷ 200D ÷ AC01 ÷",
+        L"÷ 200D × 0308 ÷ AC01 ÷",
+        L"÷ 200D ÷ 0904 ÷",
+        L"÷ 200D × 0308 ÷ 0904 ÷",
+        L"÷ 200D ÷ 0D4E ÷",
+        L"÷ 200D × 0308 ÷ 0D4E ÷",
+        L"÷ 200D ÷ 0915 ÷",
+        L"÷ 200D × 0308 ÷ 0915 ÷",
+        L"÷ 200D ÷ 231A ÷",
+        L"÷ 200D × 0308 ÷ 231A ÷",
+        L"÷ 200D × 0300 ÷",
+        L"÷ 200D × 0308 × 0300 ÷",
+        L"÷ 200D × 0900 ÷",
+        L"÷ 200D × 0308 × 0900 ÷",
+        L"÷ 200D × 094D ÷",
+        L"÷ 200D × 0308 × 094D ÷",
+        L"÷ 200D × 200D ÷",
+        L"÷ 200D × 0308 × 200D ÷",
+        L"÷ 200D ÷ 0378 ÷",
+        L"÷ 200D × 0308 ÷ 0378 ÷",
+        L"÷ 0378 ÷ 0020 ÷",
+        L"÷ 0378 × 0308 ÷ 0020 ÷",
+        L"÷ 0378 ÷ 000D ÷",
+        L"÷ 0378 × 0308 ÷ 000D ÷",
+        L"÷ 0378 ÷ 000A ÷",
+        L"÷ 0378 × 0308 ÷ 000A ÷",
+        L"÷ 0378 ÷ 0001 ÷",
+        L"÷ 0378 × 0308 ÷ 0001 ÷",
+        L"÷ 0378 × 200C ÷",
+        L"÷ 0378 × 0308 × 200C ÷",
+        L"÷ 0378 ÷ 1F1E6 ÷",
+        L"÷ 0378 × 0308 ÷ 1F1E6 ÷",
+        L"÷ 0378 ÷ 0600 ÷",
+        L"÷ 0378 × 0308 ÷ 0600 ÷",
+        L"÷ 0378 ÷ 1100 ÷",
+        L"÷ 0378 × 0308 ÷ 1100 ÷",
+        L"÷ 0378 ÷ 1160 ÷",
+        L"÷ 0378 × 0308 ÷ 1160 ÷",
+        L"÷ 0378 ÷ 11A8 ÷",
+        L"÷ 0378 × 0308 ÷ 11A8 ÷",
+        L"÷ 0378 ÷ AC00 ÷",
+        L"÷ 0378 × 0308 ÷ AC00 ÷",
+        L"÷ 0378 ÷ AC01 ÷",
+        L"÷ 0378 × 0308 ÷ AC01 ÷",
+        L"÷ 0378 ÷ 0904 ÷",
+        L"÷ 0378 × 0308 ÷ 0904 ÷",
+        L"÷ 0378 ÷ 0D4E ÷",
+        L"÷ 0378 × 0308 ÷ 0D4E ÷",
+        L"÷ 0378 ÷ 0915 ÷",
+        L"÷ 0378 × 0308 ÷ 0915 ÷",
+        L"÷ 0378 ÷ 231A ÷",
+        L"÷ 0378 × 0308 ÷ 231A ÷",
+        L"÷ 0378 × 0300 ÷",
+        L"÷ 0378 × 0308 × 0300 ÷",
+        L"÷ 0378 × 0900 ÷",
+        L"÷ 0378 × 0308 × 0900 ÷",
+        L"÷ 0378 × 094D ÷",
+        L"÷ 0378 × 0308 × 094D ÷",
+        L"÷ 0378 × 200D ÷",
+        L"÷ 0378 × 0308 × 200D ÷",
+        L"÷ 0378 ÷ 0378 ÷",
+        L"÷ 0378 × 0308 ÷ 0378 ÷",
+        L"÷ 000D × 000A ÷ 0061 ÷ 000A ÷ 0308 ÷",
+        L"÷ 0061 × 0308 ÷",
+        L"÷ 0020 × 200D ÷ 0646 ÷",
+        L"÷ 0646 × 200D ÷ 0020 ÷",
+        L"÷ 1100 × 1100 ÷",
+        L"÷ AC00 × 11A8 ÷ 1100 ÷",
+        L"÷ AC01 × 11A8 ÷ 1100 ÷",
+        L"÷ 1F1E6 × 1F1E7 ÷ 1F1E8 ÷ 0062 ÷",
+        L"÷ 0061 ÷ 1F1E6 × 1F1E7 ÷ 1F1E8 ÷ 0062 ÷",
+        L"÷ 0061 ÷ 1F1E6 × 1F1E7 × 200D ÷ 1F1E8 ÷ 0062 ÷",
+        L"÷ 0061 ÷ 1F1E6 × 200D ÷ 1F1E7 × 1F1E8 ÷ 0062 ÷",
+        L"÷ 0061 ÷ 1F1E6 × 1F1E7 ÷ 1F1E8 × 1F1E9 ÷ 0062 ÷",
+        L"÷ 0061 × 200D ÷",
+        L"÷ 0061 × 0308 ÷ 0062 ÷",
+        L"÷ 1F476 × 1F3FF ÷ 1F476 ÷",
+        L"÷ 0061 × 1F3FF ÷ 1F476 ÷",
+        L"÷ 0061 × 1F3FF ÷ 1F476 × 200D × 1F6D1 ÷",
+        L"÷ 1F476 × 1F3FF × 0308 × 200D × 1F476 × 1F3FF ÷",
+        L"÷ 1F6D1 × 200D × 1F6D1 ÷",
+        L"÷ 0061 × 200D ÷ 1F6D1 ÷",
+        L"÷ 2701 × 200D × 2701 ÷",
+        L"÷ 0061 × 200D ÷ 2701 ÷",
+        L"÷ 0915 ÷ 0924 ÷",
+        L"÷ 0915 × 094D ÷ 0061 ÷",
+        L"÷ 0061 × 094D ÷ 0924 ÷",
+        L"÷ 003F × 094D ÷ 0924 ÷",
+        L"÷ 0020 × 0A03 ÷",
+        L"÷ 0020 × 0308 × 0A03 ÷",
+        L"÷ 0020 × 0903 ÷",
+        L"÷ 0020 × 0308 × 0903 ÷",
+        L"÷ 000D ÷ 0308 × 0A03 ÷",
+        L"÷ 000D ÷ 0308 × 0903 ÷",
+        L"÷ 000A ÷ 0308 × 0A03 ÷",
+        L"÷ 000A ÷ 0308 × 0903 ÷",
+        L"÷ 0001 ÷ 0308 × 0A03 ÷",
+        L"÷ 0001 ÷ 0308 × 0903 ÷",
+        L"÷ 200C × 0A03 ÷",
+        L"÷ 200C × 0308 × 0A03 ÷",
+        L"÷ 200C × 0903 ÷",
+        L"÷ 200C × 0308 × 0903 ÷",
+        L"÷ 1F1E6 × 0A03 ÷",
+        L"÷ 1F1E6 × 0308 × 0A03 ÷",
+        L"÷ 1F1E6 × 0903 ÷",
+        L"÷ 1F1E6 × 0308 × 0903 ÷",
+        L"÷ 0600 × 0020 ÷",
+        L"÷ 0600 × 1F1E6 ÷",
+        L"÷ 0600 × 0600 ÷",
+        L"÷ 0600 × 0A03 ÷",
+        L"÷ 0600 × 0308 × 0A03 ÷",
+        L"÷ 0600 × 1100 ÷",
+        L"÷ 0600 × 1160 ÷",
+        L"÷ 0600 × 11A8 ÷",
+        L"÷ 0600 × AC00 ÷",
+        L"÷ 0600 × AC01 ÷",
+        L"÷ 0600 × 0903 ÷",
+        L"÷ 0600 × 0308 × 0903 ÷",
+        L"÷ 0600 × 0904 ÷",
+        L"÷ 0600 × 0D4E ÷",
+        L"÷ 0600 × 0915 ÷",
+        L"÷ 0600 × 231A ÷",
+        L"÷ 0600 × 0378 ÷",
+        L"÷ 0A03 × 0A03 ÷",
+        L"÷ 0A03 × 0308 × 0A03 ÷",
+        L"÷ 0A03 × 0903 ÷",
+        L"÷ 0A03 × 0308 × 0903 ÷",
+        L"÷ 1100 × 0A03 ÷",
+        L"÷ 1100 × 0308 × 0A03 ÷",
+        L"÷ 1100 × 0903 ÷",
+        L"÷ 1100 × 0308 × 0903 ÷",
+        L"÷ 1160 × 0A03 ÷",
+        L"÷ 1160 × 0308 × 0A03 ÷",
+        L"÷ 1160 × 0903 ÷",
+        L"÷ 1160 × 0308 × 0903 ÷",
+        L"÷ 11A8 × 0A03 ÷",
+        L"÷ 11A8 × 0308 × 0A03 ÷",
+        L"÷ 11A8 × 0903 ÷",
+        L"÷ 11A8 × 0308 × 0903 ÷",
+        L"÷ AC00 × 0A03 ÷",
+        L"÷ AC00 × 0308 × 0A03 ÷",
+        L"÷ AC00 × 0903 ÷",
+        L"÷ AC00 × 0308 × 0903 ÷",
+        L"÷ AC01 × 0A03 ÷",
+        L"÷ AC01 × 0308 × 0A03 ÷",
+        L"÷ AC01 × 0903 ÷",
+        L"÷ AC01 × 0308 × 0903 ÷",
+        L"÷ 0903 × 0A03 ÷",
+        L"÷ 0903 × 0308 × 0A03 ÷",
+        L"÷ 0903 × 0903 ÷",
+        L"÷ 0903 × 0308 × 0903 ÷",
+        L"÷ 0904 × 0A03 ÷",
+        L"÷ 0904 × 0308 × 0A03 ÷",
+        L"÷ 0904 × 0903 ÷",
+        L"÷ 0904 × 0308 × 0903 ÷",
+        L"÷ 0D4E × 0020 ÷",
+        L"÷ 0D4E × 1F1E6 ÷",
+        L"÷ 0D4E × 0600 ÷",
+        L"÷ 0D4E × 0A03 ÷",
+        L"÷ 0D4E × 0308 × 0A03 ÷",
+        L"÷ 0D4E × 1100 ÷",
+        L"÷ 0D4E × 1160 ÷",
+        L"÷ 0D4E × 11A8 ÷",
+        L"÷ 0D4E × AC00 ÷",
+        L"÷ 0D4E × AC01 ÷",
+        L"÷ 0D4E × 0903 ÷",
+        L"÷ 0D4E × 0308 × 0903 ÷",
+        L"÷ 0D4E × 0904 ÷",
+        L"÷ 0D4E × 0D4E ÷",
+        L"÷ 0D4E × 0915 ÷",
+        L"÷ 0D4E × 231A ÷",
+        L"÷ 0D4E × 0378 ÷",
+        L"÷ 0915 × 0A03 ÷",
+        L"÷ 0915 × 0308 × 0A03 ÷",
+        L"÷ 0915 × 0903 ÷",
+        L"÷ 0915 × 0308 × 0903 ÷",
+        L"÷ 231A × 0A03 ÷",
+        L"÷ 231A × 0308 × 0A03 ÷",
+        L"÷ 231A × 0903 ÷",
+        L"÷ 231A × 0308 × 0903 ÷",
+        L"÷ 0300 × 0A03 ÷",
+        L"÷ 0300 × 0308 × 0A03 ÷",
+        L"÷ 0300 × 0903 ÷",
+        L"÷ 0300 × 0308 × 0903 ÷",
+        L"÷ 0900 × 0A03 ÷",
+        L"÷ 0900 × 0308 × 0A03 ÷",
+        L"÷ 0900 × 0903 ÷",
+        L"÷ 0900 × 0308 × 0903 ÷",
+        L"÷ 094D × 0A03 ÷",
+        L"÷ 094D × 0308 × 0A03 ÷",
+        L"÷ 094D × 0903 ÷",
+        L"÷ 094D × 0308 × 0903 ÷",
+        L"÷ 200D × 0A03 ÷",
+        L"÷ 200D × 0308 × 0A03 ÷",
+        L"÷ 200D × 0903 ÷",
+        L"÷ 200D × 0308 × 0903 ÷",
+        L"÷ 0378 × 0A03 ÷",
+        L"÷ 0378 × 0308 × 0A03 ÷",
+        L"÷ 0378 × 0903 ÷",
+        L"÷ 0378 × 0308 × 0903 ÷",
+        L"÷ 0061 × 0903 ÷ 0062 ÷",
+        L"÷ 0061 ÷ 0600 × 0062 ÷",
+        L"÷ 0915 × 094D × 0924 ÷",
+        L"÷ 0915 × 094D × 094D × 0924 ÷",
+        L"÷ 0915 × 094D × 200D × 0924 ÷",
+        L"÷ 0915 × 093C × 200D × 094D × 0924 ÷",
+        L"÷ 0915 × 093C × 094D × 200D × 0924 ÷",
+        L"÷ 0915 × 094D × 0924 × 094D × 092F ÷",
+        L"÷ 0915 × 094D × 094D × 0924 ÷",
+};
+
+class GraphemeBreakTests
+{
+    TEST_CLASS(GraphemeBreakTests);
+
+    TEST_METHOD(ConformsToGraphemeBreakTest);
+    TEST_METHOD(UnpairedSurrogatesAreClustersOfTheirOwn);
+    TEST_METHOD(SkipTrivialStopsBeforeClusters);
+    TEST_METHOD(Throughput);
+
+    // Turns a line of GraphemeBreakTest.txt into its text and the offsets of all cluster boundaries.
+    static void _parse(const std::wstring_view& line, std::wstring& text, std::vector<size_t>& boundaries);
+    static std::vector<size_t> _boundariesForward(const std::wstring_view& text);
+    static std::vector<size_t> _boundariesBackward(const std::wstring_view& text);
+};
+
+void GraphemeBreakTests::_parse(const std::wstring_view& line, std::wstring& text, std::vector<size_t>& boundaries)
+{
+    text.clear();
+    boundaries.clear();
+
+    for (size_t beg = 0; beg < line.size();)
+    {
+        auto end = line.find(L' ', beg);
+        if (end == std::wstring_view::npos)
+        {
+            end = line.size();
+        }
+
+        const auto token = line.substr(beg, end - beg);
+        if (token == L"÷")
+        {
+            boundaries.emplace_back(text.size());
+        }
+        else if (token != L"×")
+        {
+            const auto codepoint = std::stoul(std::wstring{ token }, nullptr, 16);
+            if (codepoint >= 0x10000)
+            {
+                text.push_back(gsl::narrow_cast<wchar_t>(0xD7C0 + (codepoint >> 10)));
+                text.push_back(gsl::narrow_cast<wchar_t>(0xDC00 | (codepoint & 0x3FF)));
+            }
+            else
+            {
+                text.push_back(gsl::narrow_cast<wchar_t>(codepoint));
+            }
+        }
+
+        beg = end + 1;
+    }
+}
+
+std::vector<size_t> GraphemeBreakTests::_boundariesForward(const std::wstring_view& text)
+{
+    std::vector<size_t> boundaries{ 0 };
+    while (boundaries.back() < text.size())
+    {
+        boundaries.emplace_back(GraphemeBreak::Next(text, boundaries.back()));
+    }
+    return boundaries;
+}
+
+std::vector<size_t> GraphemeBreakTests::_boundariesBackward(const std::wstring_view& text)
+{
+    std::vector<size_t> boundaries{ text.size() };
+    while (boundaries.back() > 0)
+    {
+        boundaries.emplace_back(GraphemeBreak::Prev(text, boundaries.back()));
+    }
+    std::reverse(boundaries.begin(), boundaries.end());
+    return boundaries;
+}
+
+void GraphemeBreakTests::ConformsToGraphemeBreakTest()
+{
+    std::wstring text;
+    std::vector<size_t> expected;
+
+    for (const auto& line : s_graphemeBreakTests)
+    {
+        _parse(line, text, expected);
+
+        const auto forward = _boundariesForward(text);
+        const auto backward = _boundariesBackward(text);
+        if (forward != expected || backward != expected)
+        {
+            VERIFY_FAIL(NoThrowString().Format(L"%.*s", gsl::narrow_cast<int>(line.size()), line.data()));
+        }
+
+        // Prev() from the middle of a cluster returns the start of that cluster.
+        for (size_t offset = 1; offset <= text.size(); ++offset)
+        {
+            const auto it = std::upper_bound(expected.begin(), expected.end(), offset - 1);
+            VERIFY_ARE_EQUAL(*(it - 1), GraphemeBreak::Prev(text, offset));
+        }
+
+        // SkipTrivial() must never skip past the start of a longer cluster.
+        for (const auto boundary : expected)
+        {
+            const auto end = GraphemeBreak::SkipTrivial(text, boundary);
+            VERIFY_IS_TRUE(std::binary_search(expected.begin(), expected.end(), end));
+        }
+    }
+}
+
+void GraphemeBreakTests::UnpairedSurrogatesAreClustersOfTheirOwn()
+{
+    // A leading surrogate without trailer and a lone trailing surrogate, each followed by a combining mark.
+    // Just like control characters they don't combine with anything, not even combining marks.
+    static constexpr std::wstring_view text{ L"a\xD83D\x0301\xDE00\x0301" };
+    const std::vector<size_t> expected{ 0, 1, 2, 3, 4, 5 };
+    VERIFY_IS_TRUE(expected == _boundariesForward(text));
+    VERIFY_IS_TRUE(expected == _boundariesBackward(text));
+}
+
+void GraphemeBreakTests::SkipTrivialStopsBeforeClusters()
+{
+    // The SIMD implementation processes 8 characters at a time, which is why these strings are a bit longer.
+    static constexpr std::wstring_view ascii{ L"Hello, World!" };
+    static constexpr std::wstring_view cjk{ L"\x4E2D\x6587\xD55C\xAD6D\xC5B4 \x4E2D\x6587\xD55C\xAD6D\xC5B4" };
+
+    VERIFY_ARE_EQUAL(ascii.size(), GraphemeBreak::SkipTrivial(ascii, 0));
+    VERIFY_ARE_EQUAL(cjk.size(), GraphemeBreak::SkipTrivial(cjk, 0));
+    VERIFY_ARE_EQUAL(ascii.size(), GraphemeBreak::SkipTrivial(ascii, ascii.size()));
+
+    struct Test
+    {
+        std::wstring_view text;
+        size_t expected;
+    };
+    // The last trivial character before a non-trivial one is never skipped, since the two may form a cluster.
+    static constexpr std::array tests{
+        // "e" followed by a combining mark.
+        Test{ L"0123456789abcde\x0301", 14 },
+        // CR is never trivial, because it may be followed by LF.
+        Test{ L"0123456789abcde\r\n", 14 },
+        // A Hangul syllable may be followed by a trailing consonant (jamo T).
+        Test{ L"0123456789\xAC00\x11A8", 10 },
+        // A non-trivial character at the start of the text.
+        Test{ L"\x0301\x0301", 0 },
+    };
+
+    for (const auto& t : tests)
+    {
+        VERIFY_ARE_EQUAL(t.expected, GraphemeBreak::SkipTrivial(t.text, 0));
+    }
+}
+
+// Measures how fast text can be split into grapheme clusters. Run with /p:Iterations=N for more stable numbers.
+void GraphemeBreakTests::Throughput()
+{
+    auto iterations = 100;
+    RuntimeParameters::TryGetValue(L"Iterations", iterations);
+
+    struct Sample
+    {
+        const wchar_t* name;
+        std::wstring_view text;
+    };
+    static constexpr std::array samples{
+        Sample{ L"ASCII", L"The quick brown fox jumps over the lazy dog. " },
+        Sample{ L"CJK", L"\x5929\x5730\x7384\x9EC3\x3001\x5B87\x5B99\x6D2A\x8352\x3002\xD55C\xAD6D\xC5B4 " },
+        Sample{ L"combining marks", L"e\x0301 a\x0308 o\x0302\x0323 \x0928\x092E\x0938\x094D\x0924\x0947 " },
+        Sample{ L"emoji", L"\xD83D\xDC68\x200D\xD83D\xDC69\x200D\xD83D\xDC67 \xD83C\xDDE9\xD83C\xDDEA \x2764\xFE0F " },
+    };
+
+    for (const auto& sample : samples)
+    {
+        std::wstring text;
+        while (text.size() < 64 * 1024)
+        {
+            text.append(sample.text);
+        }
+
+        size_t clusters = 0;
+        const auto beg = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < iterations; ++i)
+        {
+            for (size_t offset = 0; offset < text.size();)
+            {
+                // This mirrors how ROW::ReplaceText uses the API.
+                const auto trivialEnd = GraphemeBreak::SkipTrivial(text, offset);
+                if (trivialEnd != offset)
+                {
+                    clusters += trivialEnd - offset;
+                    offset = trivialEnd;
+                }
+                else
+                {
+                    offset = GraphemeBreak::Next(text, offset);
+                    clusters++;
+                }
+            }
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        VERIFY_IS_TRUE(clusters != 0);
+        const auto seconds = std::chrono::duration<double>(end - beg).count();
+        const auto megabytes = static_cast<double>(text.size() * sizeof(wchar_t)) * iterations / 1e6;
+        Log::Comment(NoThrowString().Format(L"%-16s %8.1f MB/s", sample.name, megabytes / seconds));
+    }
+}
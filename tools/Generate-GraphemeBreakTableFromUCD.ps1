@@ -0,0 +1,214 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT license.
+
+#Requires -Version 7
+
+################################################################################
+# This script generates the property tables of src/types/GraphemeBreak.cpp
+# from a Unicode UCD XML document[1] compliant with UAX#42[2].
+#
+# The Grapheme_Cluster_Break, Indic_Conjunct_Break and Extended_Pictographic
+# properties (see UAX#29[3]) of each codepoint are folded into a single value,
+# the ClusterBreak enum in GraphemeBreak.cpp, and stored in a three stage table.
+# Codepoints at or above $Limit aren't part of the table and are instead
+# handled by hand in GraphemeBreak.cpp. This script verifies that those are
+# still correct and will fail otherwise.
+#
+# This script was developed against the flat "no han unification" UCD
+# "ucd.nounihan.flat.xml".
+# It does not support the grouped database format.
+#
+# Invoke this script from the root of this repository as:
+#   .\tools\Generate-GraphemeBreakTableFromUCD.ps1 -Path .\path\to\ucd.nounihan.flat.xml
+#
+# [1]: https://www.unicode.org/Public/UCD/latest/ucdxml/
+# [2]: https://www.unicode.org/reports/tr42/
+# [3]: https://www.unicode.org/reports/tr29/
+
+[Diagnostics.CodeAnalysis.SuppressMessageAttribute('PSAvoidUsingPositionalParameters', '')]
+[Diagnostics.CodeAnalysis.SuppressMessageAttribute('PSUseProcessBlockForPipelineCommand', '')]
+[CmdletBinding()]
+Param(
+    [Parameter(Position=0, ValueFromPipeline=$true, ParameterSetName="Parsed")]
+    [System.Xml.XmlDocument]$InputObject,
+
+    [Parameter(Position=0, ValueFromPipelineByPropertyName=$true, ParameterSetName="Unparsed")]
+    [string]$Path = "ucd.nounihan.flat.xml"
+)
+
+# Must be kept in sync with the ClusterBreak enum in GraphemeBreak.cpp.
+Enum ClusterBreak {
+    Other;
+    CR;
+    LF;
+    Control;
+    Extend;
+    ExtendInCB;
+    Linker;
+    ZWJ;
+    RegionalIndicator;
+    Prepend;
+    SpacingMark;
+    L;
+    V;
+    T;
+    LV;
+    LVT;
+    ExtendedPictographic;
+    Consonant;
+}
+
+$Limit = 0x20000
+# The table is indexed as stage3[stage2[stage1[cp >> 6] * 8 + (cp >> 3 & 7)] * 8 + (cp & 7)].
+$Stage1Shift = 6
+$Stage2Shift = 3
+
+# UCD Functions {{{
+Function Get-UCDEntryRange($entry) {
+    $s = $e = 0
+    if ($null -ne $entry.cp) {
+        # Individual Codepoint
+        $s = $e = [int]("0x"+$entry.cp)
+    } ElseIf ($null -ne $entry."first-cp") {
+        # Range of Codepoints
+        $s = [int]("0x"+$entry."first-cp")
+        $e = [int]("0x"+$entry."last-cp")
+    }
+    $s
+    $e
+}
+
+Function Get-UCDEntryClusterBreak($entry) {
+    Switch ($entry.GCB) {
+        "CR"  { [ClusterBreak]::CR; Return }
+        "LF"  { [ClusterBreak]::LF; Return }
+        "CN"  { [ClusterBreak]::Control; Return }
+        "EX"  {
+            Switch ($entry.InCB) {
+                "Extend" { [ClusterBreak]::ExtendInCB; Return }
+                "Linker" { [ClusterBreak]::Linker; Return }
+                default  { [ClusterBreak]::Extend; Return }
+            }
+        }
+        "ZWJ" { [ClusterBreak]::ZWJ; Return }
+        "RI"  { [ClusterBreak]::RegionalIndicator; Return }
+        "PP"  { [ClusterBreak]::Prepend; Return }
+        "SM"  { [ClusterBreak]::SpacingMark; Return }
+        "L"   { [ClusterBreak]::L; Return }
+        "V"   { [ClusterBreak]::V; Return }
+        "T"   { [ClusterBreak]::T; Return }
+        "LV"  { [ClusterBreak]::LV; Return }
+        "LVT" { [ClusterBreak]::LVT; Return }
+        "XX"  {
+            If ($entry.ExtPict -eq "Y") {
+                [ClusterBreak]::ExtendedPictographic
+                Return
+            }
+            If ($entry.InCB -eq "Consonant") {
+                [ClusterBreak]::Consonant
+                Return
+            }
+            [ClusterBreak]::Other
+            Return
+        }
+        default { throw "Unexpected Grapheme_Cluster_Break property" }
+    }
+}
+# }}}
+
+# Mirrors the part of lookup() in GraphemeBreak.cpp that handles codepoints at or above $Limit.
+Function Get-ClusterBreakAboveLimit([int]$cp) {
+    If (($cp -ge 0xE0020 -and $cp -le 0xE007F) -or ($cp -ge 0xE0100 -and $cp -le 0xE01EF)) {
+        [ClusterBreak]::ExtendInCB
+        Return
+    }
+    If ($cp -ge 0xE0000 -and $cp -le 0xE0FFF) {
+        [ClusterBreak]::Control
+        Return
+    }
+    [ClusterBreak]::Other
+}
+
+Function Format-Table([string]$Name, $Data) {
+    "    static constexpr uint8_t {0}[{1}]{{" -f $Name, $Data.Count
+    For ($i = 0; $i -lt $Data.Count; $i += 16) {
+        $end = [Math]::Min($i + 16, $Data.Count) - 1
+        "        " + (($Data[$i..$end] | ForEach-Object { "0x{0:x2}," -f $_ }) -join " ")
+    }
+    "    };"
+}
+
+# Ingest UCD
+If ($null -eq $InputObject) {
+    $InputObject = [xml](Get-Content $Path)
+}
+
+$props = [byte[]]::new($Limit)
+
+ForEach($v in $InputObject.ucd.repertoire.ChildNodes) {
+    If ($v -isnot [System.Xml.XmlElement]) {
+        Continue
+    }
+
+    $s, $e = Get-UCDEntryRange $v
+    $cb = Get-UCDEntryClusterBreak $v
+
+    For ($cp = $s; $cp -le $e; $cp++) {
+        If ($cp -lt $Limit) {
+            $props[$cp] = [byte]$cb
+        } ElseIf ($cb -ne (Get-ClusterBreakAboveLimit $cp)) {
+            throw "U+{0:X4} is {1}, but GraphemeBreak.cpp doesn't know that. Update lookup() and Get-ClusterBreakAboveLimit." -f $cp, $cb
+        }
+    }
+}
+
+# Split the properties into blocks of 8 (stage3) and those into blocks of 8 block indices (stage2), both deduplicated.
+$leafSize = 1 -shl $Stage2Shift
+$midSize = 1 -shl ($Stage1Shift - $Stage2Shift)
+$leaves = [System.Collections.Generic.Dictionary[string, int]]::new()
+$mids = [System.Collections.Generic.Dictionary[string, int]]::new()
+$stage1 = [System.Collections.Generic.List[byte]]::new()
+$stage2 = [System.Collections.Generic.List[byte]]::new()
+$stage3 = [System.Collections.Generic.List[byte]]::new()
+
+For ($i = 0; $i -lt $Limit; $i += 1 -shl $Stage1Shift) {
+    $mid = [byte[]]::new($midSize)
+
+    For ($j = 0; $j -lt $midSize; $j++) {
+        $off = $i + $j * $leafSize
+        $leaf = [byte[]]$props[$off..($off + $leafSize - 1)]
+        $key = $leaf -join ","
+        $index = 0
+        If (-not $leaves.TryGetValue($key, [ref]$index)) {
+            $index = $leaves.Count
+            If ($index -gt 255) {
+                throw "stage3 has more than 256 blocks, which don't fit into stage2 anymore"
+            }
+            $leaves.Add($key, $index)
+            $stage3.AddRange($leaf)
+        }
+        $mid[$j] = $index
+    }
+
+    $key = $mid -join ","
+    $index = 0
+    If (-not $mids.TryGetValue($key, [ref]$index)) {
+        $index = $mids.Count
+        If ($index -gt 255) {
+            throw "stage2 has more than 256 blocks, which don't fit into stage1 anymore"
+        }
+        $mids.Add($key, $index)
+        $stage2.AddRange($mid)
+    }
+    $stage1.Add($index)
+}
+
+# Emit Code
+"    // Generated by {0}" -f $MyInvocation.MyCommand.Name
+"    // on {0} from {1}." -f (Get-Date -AsUTC -Format "yyyy-MM-dd"), $InputObject.ucd.description
+"    // A three stage lookup table for all codepoints below 0x{0:X}:" -f $Limit
+"    //   s_stage3[s_stage2[s_stage1[cp >> {0}] * {1} + (cp >> {2} & {3})] * {4} + (cp & {5})]" -f $Stage1Shift, $midSize, $Stage2Shift, ($midSize - 1), $leafSize, ($leafSize - 1)
+"    // All codepoints at or above 0x{0:X} are handled by lookup() below." -f $Limit
+Format-Table "s_stage1" $stage1
+Format-Table "s_stage2" $stage2
+Format-Table "s_stage3" $stage3